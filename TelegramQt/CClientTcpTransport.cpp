@@ -18,6 +18,7 @@
 #include "CClientTcpTransport.hpp"
 
 #include <QTcpSocket>
+#include <QTimer>
 
 #include <QDebug>
 
@@ -25,10 +26,143 @@ namespace Telegram {
 
 namespace Client {
 
+static const int s_racingStaggerInterval = 250; // ms
+static const int s_maxRacingConnections = 3;
+
 TcpTransport::TcpTransport(QObject *parent) :
-    CTcpTransport(parent)
+    CTcpTransport(parent),
+    m_racingTimer(new QTimer(this))
 {
     setSocket(new QTcpSocket(this));
+    m_racingTimer->setSingleShot(true);
+    m_racingTimer->setInterval(s_racingStaggerInterval);
+    connect(m_racingTimer, &QTimer::timeout, this, &TcpTransport::startNextRacingConnection);
+}
+
+TcpTransport::~TcpTransport()
+{
+    abortRacing();
+}
+
+void TcpTransport::connectToHosts(const QVector<DcOption> &addresses)
+{
+    if (addresses.count() < 2) {
+        CTcpTransport::connectToHosts(addresses);
+        return;
+    }
+#ifdef DEVELOPER_BUILD
+    qDebug() << Q_FUNC_INFO << addresses.count() << "addresses";
+#endif
+    abortRacing();
+    m_racingAddresses = addresses.mid(0, s_maxRacingConnections);
+    setState(QAbstractSocket::ConnectingState);
+    startNextRacingConnection();
+}
+
+int TcpTransport::racingStaggerInterval() const
+{
+    return m_racingTimer->interval();
+}
+
+void TcpTransport::setRacingStaggerInterval(int ms)
+{
+    m_racingTimer->setInterval(ms);
+}
+
+void TcpTransport::disconnectFromHost()
+{
+    if (isRacing()) {
+        abortRacing();
+        if (m_socket->state() == QAbstractSocket::UnconnectedState) {
+            setState(QAbstractSocket::UnconnectedState);
+            return;
+        }
+    }
+    CTcpTransport::disconnectFromHost();
+}
+
+void TcpTransport::startNextRacingConnection()
+{
+    if (m_racingAddresses.isEmpty()) {
+        return;
+    }
+    const DcOption address = m_racingAddresses.takeFirst();
+#ifdef DEVELOPER_BUILD
+    qDebug() << Q_FUNC_INFO << address.address << address.port;
+#endif
+    QTcpSocket *socket = new QTcpSocket(this);
+    socket->setProxy(m_socket->proxy());
+    connect(socket, &QAbstractSocket::connected, this, &TcpTransport::onRacingSocketConnected);
+    connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), SLOT(onRacingSocketError()));
+    m_racingSockets.insert(socket, address);
+    socket->connectToHost(address.address, address.port);
+
+    if (!m_racingAddresses.isEmpty()) {
+        m_racingTimer->start();
+    }
+}
+
+void TcpTransport::onRacingSocketConnected()
+{
+    QAbstractSocket *socket = qobject_cast<QAbstractSocket*>(sender());
+    if (!socket || !m_racingSockets.contains(socket)) {
+        return;
+    }
+    const DcOption address = m_racingSockets.take(socket);
+    disconnect(socket, nullptr, this, nullptr);
+    abortRacing();
+
+#ifdef DEVELOPER_BUILD
+    qDebug() << Q_FUNC_INFO << "Won:" << address.address << address.port;
+#endif
+
+    // Replace the idle socket by the connected one
+    disconnect(m_socket, nullptr, this, nullptr);
+    m_socket->deleteLater();
+    m_socket = nullptr;
+    setSocket(socket);
+    setRemoteAddress(address);
+    setState(socket->state());
+}
+
+void TcpTransport::onRacingSocketError()
+{
+    QAbstractSocket *socket = qobject_cast<QAbstractSocket*>(sender());
+    if (!socket || !m_racingSockets.contains(socket)) {
+        return;
+    }
+#ifdef DEVELOPER_BUILD
+    qDebug() << Q_FUNC_INFO << m_racingSockets.value(socket).address << socket->error();
+#endif
+    m_racingSockets.remove(socket);
+    disconnect(socket, nullptr, this, nullptr);
+    socket->deleteLater();
+
+    if (!m_racingAddresses.isEmpty()) {
+        // Do not wait for the stagger interval if an attempt has already failed
+        m_racingTimer->stop();
+        startNextRacingConnection();
+    } else if (m_racingSockets.isEmpty()) {
+        setError(socket->error());
+        setState(QAbstractSocket::UnconnectedState);
+    }
+}
+
+void TcpTransport::abortRacing()
+{
+    m_racingTimer->stop();
+    m_racingAddresses.clear();
+    for (QAbstractSocket *socket : m_racingSockets.keys()) {
+        disconnect(socket, nullptr, this, nullptr);
+        socket->abort();
+        socket->deleteLater();
+    }
+    m_racingSockets.clear();
+}
+
+bool TcpTransport::isRacing() const
+{
+    return !m_racingSockets.isEmpty() || !m_racingAddresses.isEmpty();
 }
 
 bool TcpTransport::setProxy(const QNetworkProxy &proxy)
@@ -41,13 +175,31 @@ bool TcpTransport::setProxy(const QNetworkProxy &proxy)
     return true;
 }
 
+void TcpTransport::setPreferredSessionType(SessionType sessionType)
+{
+    switch (sessionType) {
+    case Abridged:
+    case Intermediate:
+        m_preferredSessionType = sessionType;
+        break;
+    default:
+        qWarning() << Q_FUNC_INFO << "Unsupported session type" << sessionType;
+        break;
+    }
+}
+
 void TcpTransport::writeEvent()
 {
     if (Q_LIKELY(m_sessionType != Unknown)) {
         return;
     }
-    m_socket->putChar(char(0xef)); // Start session in Abridged format
-    setSessionType(Abridged);
+    // Start session in the preferred format
+    if (m_preferredSessionType == Intermediate) {
+        m_writeBuffer.append("\xee\xee\xee\xee", 4);
+    } else {
+        m_writeBuffer.append(char(0xef));
+    }
+    setSessionType(m_preferredSessionType);
 }
 
 } // Client
@@ -20,6 +20,8 @@
 
 #include "CTcpTransport.hpp"
 
+#include <QHash>
+
 namespace Telegram {
 
 namespace Client {
@@ -29,11 +31,36 @@ class TcpTransport : public CTcpTransport
     Q_OBJECT
 public:
     explicit TcpTransport(QObject *parent = nullptr);
+    ~TcpTransport();
+
+    // Race the connections to the given addresses with staggered starts.
+    // The first established connection is used and the others are aborted.
+    void connectToHosts(const QVector<Telegram::DcOption> &addresses) override;
+    // The delay before the next address is tried if the previous attempts are still pending
+    int racingStaggerInterval() const;
+    void setRacingStaggerInterval(int ms);
+    void disconnectFromHost() override;
 
     bool setProxy(const QNetworkProxy &proxy);
 
+    SessionType preferredSessionType() const { return m_preferredSessionType; }
+    void setPreferredSessionType(SessionType sessionType);
+
+protected slots:
+    void startNextRacingConnection();
+    void onRacingSocketConnected();
+    void onRacingSocketError();
+
 protected:
     void writeEvent() final;
+    void abortRacing();
+    bool isRacing() const;
+
+    SessionType m_preferredSessionType = Abridged;
+
+    QVector<Telegram::DcOption> m_racingAddresses; // Not tried yet
+    QHash<QAbstractSocket*, Telegram::DcOption> m_racingSockets;
+    QTimer *m_racingTimer;
 };
 
 } // Client
@@ -0,0 +1,164 @@
+/*
+   Copyright (C) 2026 agent <agent@local>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+
+#include "CLoopbackTransport.hpp"
+#include "RandomGenerator.hpp"
+
+#include <QTimer>
+
+#include <QDebug>
+
+CLoopbackTransport::CLoopbackTransport(QObject *parent) :
+    CTelegramTransport(parent),
+    m_deliveryTimer(new QTimer(this))
+{
+    m_deliveryTimer->setSingleShot(true);
+    connect(m_deliveryTimer, &QTimer::timeout, this, &CLoopbackTransport::deliverPackages);
+    m_clock.start();
+}
+
+CLoopbackTransport::~CLoopbackTransport()
+{
+    if (m_peer) {
+        m_peer->m_peer = nullptr;
+    }
+}
+
+void CLoopbackTransport::connectPeers(CLoopbackTransport *first, CLoopbackTransport *second)
+{
+    if (first->m_peer) {
+        first->m_peer->m_peer = nullptr;
+    }
+    if (second->m_peer) {
+        second->m_peer->m_peer = nullptr;
+    }
+    first->m_peer = second;
+    second->m_peer = first;
+}
+
+void CLoopbackTransport::setLatency(quint32 ms)
+{
+    m_latency = ms;
+}
+
+void CLoopbackTransport::setBandwidth(quint32 bytesPerSecond)
+{
+    m_bandwidth = bytesPerSecond;
+}
+
+void CLoopbackTransport::setLossRate(double rate)
+{
+    m_lossRate = qBound(0.0, rate, 1.0);
+}
+
+void CLoopbackTransport::connectToHost(const QString &ipAddress, quint32 port)
+{
+#ifdef DEVELOPER_BUILD
+    qDebug() << Q_FUNC_INFO << ipAddress << port;
+#else
+    Q_UNUSED(ipAddress)
+    Q_UNUSED(port)
+#endif
+    if (!m_peer) {
+        qWarning() << Q_FUNC_INFO << "The transport has no peer";
+        setError(QAbstractSocket::ConnectionRefusedError);
+        setState(QAbstractSocket::UnconnectedState);
+        return;
+    }
+
+    setState(QAbstractSocket::ConnectingState);
+    // Finish the connection in the next event loop iteration, as a socket does
+    QTimer::singleShot(0, this, [this]() {
+        if (!m_peer || (state() != QAbstractSocket::ConnectingState)) {
+            return;
+        }
+        m_linkFreeTime = 0;
+        m_peer->m_linkFreeTime = 0;
+        m_peer->setState(QAbstractSocket::ConnectedState);
+        setState(QAbstractSocket::ConnectedState);
+    });
+}
+
+void CLoopbackTransport::disconnectFromHost()
+{
+#ifdef DEVELOPER_BUILD
+    qDebug() << Q_FUNC_INFO;
+#endif
+    m_deliveryTimer->stop();
+    m_pendingPackages.clear();
+    if (state() != QAbstractSocket::UnconnectedState) {
+        setState(QAbstractSocket::UnconnectedState);
+    }
+    if (m_peer && (m_peer->state() != QAbstractSocket::UnconnectedState)) {
+        m_peer->disconnectFromHost();
+    }
+}
+
+void CLoopbackTransport::deliverPackages()
+{
+    while (!m_pendingPackages.isEmpty() && (m_pendingPackages.head().deliveryTime <= m_clock.elapsed())) {
+        const PendingPackage package = m_pendingPackages.dequeue();
+        if (m_peer) {
+            emit m_peer->packageReceived(package.data);
+        }
+    }
+    scheduleDelivery();
+}
+
+void CLoopbackTransport::sendPackageImplementation(const QByteArray &package)
+{
+    if (!m_peer || (state() != QAbstractSocket::ConnectedState)) {
+        qWarning() << Q_FUNC_INFO << "Unable to send a package: the transport is not connected";
+        return;
+    }
+
+    if (isPackageLost()) {
+        ++m_lostPackagesCount;
+        return;
+    }
+
+    // The packages are transmitted one by one, so a package waits until the link is free.
+    qint64 transmittedTime = qMax(m_clock.elapsed(), m_linkFreeTime);
+    if (m_bandwidth) {
+        transmittedTime += qint64(package.size()) * 1000 / m_bandwidth;
+    }
+    m_linkFreeTime = transmittedTime;
+
+    PendingPackage pendingPackage;
+    pendingPackage.deliveryTime = transmittedTime + m_latency;
+    pendingPackage.data = package;
+    m_pendingPackages.enqueue(pendingPackage);
+    scheduleDelivery();
+}
+
+void CLoopbackTransport::scheduleDelivery()
+{
+    if (m_pendingPackages.isEmpty() || m_deliveryTimer->isActive()) {
+        return;
+    }
+    const qint64 delay = m_pendingPackages.head().deliveryTime - m_clock.elapsed();
+    m_deliveryTimer->start(qMax<qint64>(0, delay));
+}
+
+bool CLoopbackTransport::isPackageLost() const
+{
+    if (m_lossRate <= 0) {
+        return false;
+    }
+    const quint32 value = Telegram::RandomGenerator::instance()->generate<quint32>();
+    return value < m_lossRate * 0xffffffffu;
+}
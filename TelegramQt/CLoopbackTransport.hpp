@@ -0,0 +1,81 @@
+/*
+   Copyright (C) 2026 agent <agent@local>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+
+#ifndef CLOOPBACKTRANSPORT_HPP
+#define CLOOPBACKTRANSPORT_HPP
+
+#include "CTelegramTransport.hpp"
+
+#include <QElapsedTimer>
+#include <QQueue>
+
+QT_FORWARD_DECLARE_CLASS(QTimer)
+
+// In-process transport. The packages sent by one transport are received by its peer.
+// The link latency, bandwidth and loss rate are configurable to emulate a network.
+class CLoopbackTransport : public CTelegramTransport
+{
+    Q_OBJECT
+public:
+    explicit CLoopbackTransport(QObject *parent = nullptr);
+    ~CLoopbackTransport();
+
+    CLoopbackTransport *peer() const { return m_peer; }
+    static void connectPeers(CLoopbackTransport *first, CLoopbackTransport *second);
+
+    quint32 latency() const { return m_latency; }
+    void setLatency(quint32 ms);
+
+    // Bytes per second, zero means unlimited
+    quint32 bandwidth() const { return m_bandwidth; }
+    void setBandwidth(quint32 bytesPerSecond);
+
+    // The probability of a package loss in range [0, 1]
+    double lossRate() const { return m_lossRate; }
+    void setLossRate(double rate);
+
+    quint64 lostPackagesCount() const { return m_lostPackagesCount; }
+
+    void connectToHost(const QString &ipAddress, quint32 port) override;
+    void disconnectFromHost() override;
+
+protected slots:
+    void deliverPackages();
+
+protected:
+    struct PendingPackage {
+        qint64 deliveryTime;
+        QByteArray data;
+    };
+
+    void sendPackageImplementation(const QByteArray &package) override;
+    void scheduleDelivery();
+    bool isPackageLost() const;
+
+    CLoopbackTransport *m_peer = nullptr;
+    QTimer *m_deliveryTimer;
+    QElapsedTimer m_clock;
+    QQueue<PendingPackage> m_pendingPackages;
+    qint64 m_linkFreeTime = 0;
+    quint64 m_lostPackagesCount = 0;
+
+    quint32 m_latency = 0;
+    quint32 m_bandwidth = 0;
+    double m_lossRate = 0;
+};
+
+#endif // CLOOPBACKTRANSPORT_HPP
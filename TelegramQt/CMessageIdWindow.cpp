@@ -0,0 +1,77 @@
+/*
+   Copyright (C) 2026 agent <agent@local>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+
+#include "CMessageIdWindow.hpp"
+
+#include <algorithm>
+
+CMessageIdWindow::CMessageIdWindow(int windowSeconds) :
+    m_slots(qMax(windowSeconds, 1)),
+    m_newestTime(0),
+    m_droppedCount(0)
+{
+}
+
+CMessageIdWindow::Result CMessageIdWindow::insert(quint64 id)
+{
+    const quint32 time = id >> 32;
+    if (isTooOld(time)) {
+        ++m_droppedCount;
+        return TooOld;
+    }
+
+    // The slot of a time out of the window is reused
+    Slot &slot = m_slots[time % m_slots.count()];
+    if (slot.time != time) {
+        slot.time = time;
+        slot.ids.clear();
+    } else if (std::find(slot.ids.constBegin(), slot.ids.constEnd(), quint32(id)) != slot.ids.constEnd()) {
+        ++m_droppedCount;
+        return Duplicate;
+    }
+
+    slot.ids.append(quint32(id));
+    m_newestTime = qMax(m_newestTime, time);
+    return Accepted;
+}
+
+CMessageIdWindow::Result CMessageIdWindow::check(quint64 id) const
+{
+    const quint32 time = id >> 32;
+    if (isTooOld(time)) {
+        return TooOld;
+    }
+    const Slot &slot = m_slots.at(time % m_slots.count());
+    if ((slot.time == time) && (std::find(slot.ids.constBegin(), slot.ids.constEnd(), quint32(id)) != slot.ids.constEnd())) {
+        return Duplicate;
+    }
+    return Accepted;
+}
+
+void CMessageIdWindow::clear()
+{
+    for (Slot &slot : m_slots) {
+        slot.time = 0;
+        slot.ids.clear();
+    }
+    m_newestTime = 0;
+}
+
+bool CMessageIdWindow::isTooOld(quint32 time) const
+{
+    return quint64(time) + m_slots.count() <= m_newestTime;
+}
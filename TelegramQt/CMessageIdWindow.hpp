@@ -0,0 +1,65 @@
+/*
+   Copyright (C) 2026 agent <agent@local>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+
+#ifndef CMESSAGEIDWINDOW_HPP
+#define CMESSAGEIDWINDOW_HPP
+
+#include <QVector>
+
+// The recently received server message ids, to drop the duplicated messages.
+// The ids are grouped by the second of the message time (the upper 32 bits of the id) in a ring of slots;
+// the ids older than the window (relative to the newest id) are rejected as they can not be verified.
+class CMessageIdWindow
+{
+public:
+    enum Result {
+        Accepted,
+        Duplicate,
+        TooOld,
+    };
+
+    explicit CMessageIdWindow(int windowSeconds = 300);
+
+    int windowSeconds() const { return m_slots.count(); }
+
+    // Adds the id to the window; the id is accepted only once
+    Result insert(quint64 id);
+    // Returns the result of the id insertion without the insertion
+    Result check(quint64 id) const;
+    bool contains(quint64 id) const { return check(id) == Duplicate; }
+    void clear();
+
+    // The number of rejected ids (not reset by clear())
+    quint64 droppedCount() const { return m_droppedCount; }
+
+protected:
+    struct Slot {
+        Slot() : time(0) { }
+
+        quint32 time;
+        QVector<quint32> ids; // The lower 32 bits of the ids
+    };
+
+    bool isTooOld(quint32 time) const;
+
+    QVector<Slot> m_slots;
+    quint32 m_newestTime;
+    quint64 m_droppedCount;
+
+};
+
+#endif // CMESSAGEIDWINDOW_HPP
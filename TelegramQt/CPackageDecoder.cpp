@@ -0,0 +1,323 @@
+/*
+   Copyright (C) 2026 agent <agent@local>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+
+#include "CPackageDecoder.hpp"
+
+#include "CRawStream.hpp"
+#include "CTelegramStream.hpp"
+#include "TLValues.hpp"
+#include "Utils.hpp"
+
+#include <openssl/sha.h>
+
+#include <QDebug>
+#include <QMutexLocker>
+
+using namespace Telegram;
+
+// auth_key_id:long msg_key:int128
+static const int s_encryptedHeaderLength = 8 + 16;
+// salt:long session_id:long message_id:long seq_no:int message_data_length:int
+static const int s_messageHeaderLength = 8 + 8 + 8 + 4 + 4;
+// rpc_result#f35c6d01 req_msg_id:long result:Object
+static const int s_rpcResultHeaderLength = 4 + 8;
+
+static TLValue valueAt(const QByteArray &data, int offset)
+{
+    if (data.size() < offset + 4) {
+        return TLValue();
+    }
+    return TLValue::firstFromArray(QByteArray::fromRawData(data.constData() + offset, 4));
+}
+
+// Returns an empty array if the data is not a valid gzip_packed object
+static QByteArray unpackGzipObject(const QByteArray &data, int offset)
+{
+    // gzip_packed#3072cfa1 packed_data:bytes = Object;
+    CRawStreamEx stream(QByteArray::fromRawData(data.constData() + offset + 4, data.size() - offset - 4));
+    const QByteArray packedData = stream.readSerializedBytesView();
+    if (stream.error()) {
+        return QByteArray();
+    }
+    return Utils::unpackGZip(packedData);
+}
+
+static QByteArray unpackContainer(const QByteArray &payload)
+{
+    // msg_container#73f1f8dc messages:vector<message> = MessageContainer;
+    // message msg_id:long seqno:int bytes:int body:Object = Message;
+    CRawStream inputStream(payload);
+    quint32 value = 0;
+    quint32 itemsCount = 0;
+    inputStream >> value;
+    inputStream >> itemsCount;
+
+    QByteArray container;
+    container.reserve(payload.size());
+    CRawStream outputStream(&container, /* write */ true);
+    outputStream << value;
+    outputStream << itemsCount;
+
+    for (quint32 i = 0; i < itemsCount; ++i) {
+        quint64 id = 0;
+        quint32 seqNo = 0;
+        quint32 size = 0;
+        inputStream >> id;
+        inputStream >> seqNo;
+        inputStream >> size;
+        if (inputStream.error() || (size > quint32(inputStream.bytesAvailable()))) {
+            // Leave the malformed container to the regular processing and error reporting
+            return payload;
+        }
+        const QByteArray body = CPackageDecoder::unpackGzipPayloads(inputStream.readBytesView(size));
+        outputStream << id;
+        outputStream << seqNo;
+        outputStream << quint32(body.size());
+        outputStream << body;
+    }
+
+    return container;
+}
+
+// Decodes the object if its type is one of the bulky ones
+static void decodeObject(const QByteArray &data, quint64 id, MessageProjection projection,
+                         QVector<CPackageDecoder::DecodedObject> *objects)
+{
+    CTelegramStream stream(data);
+    stream.setMessageProjection(projection);
+
+    CPackageDecoder::DecodedObject object;
+    object.id = id;
+    switch (valueAt(data, 0)) {
+    case TLValue::UpdatesTooLong:
+    case TLValue::UpdateShortMessage:
+    case TLValue::UpdateShortChatMessage:
+    case TLValue::UpdateShortSentMessage:
+    case TLValue::UpdateShort:
+    case TLValue::UpdatesCombined:
+    case TLValue::Updates:
+        object.updates.reset(new TLUpdates());
+        stream >> *object.updates;
+        break;
+    case TLValue::MessagesMessages:
+    case TLValue::MessagesMessagesSlice:
+    case TLValue::MessagesChannelMessages:
+        object.messages.reset(new TLMessagesMessages());
+        stream >> *object.messages;
+        break;
+    case TLValue::MessagesDialogs:
+    case TLValue::MessagesDialogsSlice:
+        object.dialogs.reset(new TLMessagesDialogs());
+        stream >> *object.dialogs;
+        break;
+    case TLValue::UploadFile:
+        object.file.reset(new TLUploadFile());
+        stream >> *object.file;
+        break;
+    default:
+        return;
+    }
+
+    if (stream.error()) {
+        // Leave the malformed object to the regular processing and error reporting
+        return;
+    }
+    objects->append(object);
+}
+
+static void decodeMessageObject(const QByteArray &data, quint64 id, MessageProjection projection,
+                                QVector<CPackageDecoder::DecodedObject> *objects)
+{
+    if (valueAt(data, 0) != TLValue::RpcResult) {
+        decodeObject(data, id, projection, objects);
+        return;
+    }
+
+    // rpc_result#f35c6d01 req_msg_id:long result:Object
+    CRawStream stream(data);
+    quint32 value = 0;
+    quint64 requestId = 0;
+    stream >> value;
+    stream >> requestId;
+    if (stream.error()) {
+        return;
+    }
+    const QByteArray result = QByteArray::fromRawData(data.constData() + s_rpcResultHeaderLength, data.size() - s_rpcResultHeaderLength);
+    decodeObject(result, requestId, projection, objects);
+}
+
+CPackageDecoder::CPackageDecoder() :
+    m_authId(0)
+{
+    memset(m_authKeyData, 0, sizeof(m_authKeyData));
+}
+
+void CPackageDecoder::setAuthKey(const QByteArray &authKey)
+{
+    memset(m_authKeyData, 0, sizeof(m_authKeyData));
+    if (authKey.isEmpty()) {
+        m_authId = 0;
+    } else {
+        memcpy(m_authKeyData, authKey.constData(), qMin<int>(authKey.size(), sizeof(m_authKeyData)));
+        m_authId = Utils::getFingerprints(authKey, Utils::Lower64Bits);
+    }
+}
+
+bool CPackageDecoder::decode(const QByteArray &package, Message *message) const
+{
+    if (package.size() < s_encryptedHeaderLength + s_messageHeaderLength) {
+        qDebug() << Q_FUNC_INFO << "The package is too small to be an encrypted message.";
+        return false;
+    }
+
+    CRawStream inputStream(package);
+    quint64 authId = 0;
+    inputStream >> authId;
+    if (!m_authId || (authId != m_authId)) {
+        qDebug() << Q_FUNC_INFO << "Incorrect auth id.";
+        return false;
+    }
+
+    const QByteArray messageKey = inputStream.readBytesView(16);
+    // The read data is a local copy, so it is decrypted in place
+    QByteArray decryptedData = inputStream.readBytes(inputStream.bytesAvailable());
+
+    SAesKeyData key;
+    Utils::generateMessageAesKey(&key, m_authKeyData, reinterpret_cast<const uchar *>(messageKey.constData()), 8);
+
+    if (!Utils::aesIgeDecrypt(decryptedData.data(), decryptedData.size(), key)) {
+        qWarning() << Q_FUNC_INFO << "Unable to decrypt the package";
+        return false;
+    }
+    CRawStream decryptedStream(decryptedData);
+
+    quint32 contentLength = 0;
+    decryptedStream >> message->serverSalt;
+    decryptedStream >> message->sessionId;
+    decryptedStream >> message->messageId;
+    decryptedStream >> message->sequence;
+    decryptedStream >> contentLength;
+
+    if (contentLength > quint32(decryptedData.length() - s_messageHeaderLength)) {
+        qDebug() << Q_FUNC_INFO << "Expected data length is more, than actual.";
+        return false;
+    }
+
+    uchar expectedMessageKey[SHA_DIGEST_LENGTH];
+    SHA1(reinterpret_cast<const uchar *>(decryptedData.constData()), s_messageHeaderLength + contentLength, expectedMessageKey);
+
+    if (memcmp(messageKey.constData(), expectedMessageKey + 4, 16)) {
+        qDebug() << Q_FUNC_INFO << "Wrong message key";
+        return false;
+    }
+
+    // Strip the header and the padding without a reallocation
+    decryptedData.remove(0, s_messageHeaderLength);
+    decryptedData.truncate(contentLength);
+    message->payload = decryptedData;
+    return true;
+}
+
+QByteArray CPackageDecoder::unpackGzipPayloads(const QByteArray &payload)
+{
+    switch (valueAt(payload, 0)) {
+    case TLValue::GzipPacked: {
+        const QByteArray data = unpackGzipObject(payload, 0);
+        if (data.isEmpty()) {
+            return payload;
+        }
+        return unpackGzipPayloads(data);
+    }
+    case TLValue::RpcResult: {
+        if (valueAt(payload, s_rpcResultHeaderLength) != TLValue::GzipPacked) {
+            return payload;
+        }
+        const QByteArray data = unpackGzipObject(payload, s_rpcResultHeaderLength);
+        if (data.isEmpty()) {
+            return payload;
+        }
+        return payload.left(s_rpcResultHeaderLength) + data;
+    }
+    case TLValue::MsgContainer:
+        return unpackContainer(payload);
+    default:
+        return payload;
+    }
+}
+
+void CPackageDecoder::decodeObjects(Message *message, MessageProjection projection)
+{
+    if (valueAt(message->payload, 0) != TLValue::MsgContainer) {
+        decodeMessageObject(message->payload, message->messageId, projection, &message->objects);
+        return;
+    }
+
+    CRawStream stream(message->payload);
+    quint32 value = 0;
+    quint32 itemsCount = 0;
+    stream >> value;
+    stream >> itemsCount;
+
+    for (quint32 i = 0; i < itemsCount; ++i) {
+        quint64 id = 0;
+        quint32 seqNo = 0;
+        quint32 size = 0;
+        stream >> id;
+        stream >> seqNo;
+        stream >> size;
+        if (stream.error() || (size > quint32(stream.bytesAvailable()))) {
+            return;
+        }
+        decodeMessageObject(stream.readBytesView(size), id, projection, &message->objects);
+    }
+}
+
+CPackageDecodingWorker::CPackageDecodingWorker(QObject *parent) :
+    QObject(parent),
+    m_messageProjection(nullptr)
+{
+    qRegisterMetaType<CPackageDecoder::Message>();
+}
+
+MessageProjection CPackageDecodingWorker::messageProjection() const
+{
+    QMutexLocker locker(&m_projectionMutex);
+    return m_messageProjection;
+}
+
+void CPackageDecodingWorker::setMessageProjection(MessageProjection projection)
+{
+    QMutexLocker locker(&m_projectionMutex);
+    m_messageProjection = projection;
+}
+
+void CPackageDecodingWorker::setAuthKey(const QByteArray &authKey)
+{
+    m_decoder.setAuthKey(authKey);
+}
+
+void CPackageDecodingWorker::decodePackage(const QByteArray &package)
+{
+    CPackageDecoder::Message message;
+    if (!m_decoder.decode(package, &message)) {
+        return;
+    }
+    // Inflate the payload and decode the bulky TL objects here as well, so the receiver thread only processes them
+    message.payload = CPackageDecoder::unpackGzipPayloads(message.payload);
+    CPackageDecoder::decodeObjects(&message, messageProjection());
+    emit messageDecoded(message);
+}
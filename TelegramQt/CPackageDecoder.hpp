@@ -0,0 +1,131 @@
+/*
+   Copyright (C) 2026 agent <agent@local>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+
+#ifndef CPACKAGEDECODER_HPP
+#define CPACKAGEDECODER_HPP
+
+#include <QObject>
+#include <QByteArray>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QVector>
+
+#include "MessageProjection.hpp"
+#include "TLTypes.hpp"
+
+// Decrypts and verifies the incoming encrypted MTProto packages.
+// The decoder has no connection state besides the auth key, so it can be used from any thread.
+class CPackageDecoder
+{
+public:
+    // A TL object decoded ahead of the processing (see decodeObjects()).
+    // The id is the message id of an update or the request id of an RPC result.
+    struct DecodedObject {
+        DecodedObject() : id(0) { }
+
+        // Moves the object to the result if the object has the type of the result
+        bool take(TLUpdates *result) { return takeObject(&updates, result); }
+        bool take(TLMessagesMessages *result) { return takeObject(&messages, result); }
+        bool take(TLMessagesDialogs *result) { return takeObject(&dialogs, result); }
+        bool take(TLUploadFile *result) { return takeObject(&file, result); }
+        template <typename T>
+        bool take(T *result) { Q_UNUSED(result) return false; }
+
+        quint64 id;
+        QSharedPointer<TLUpdates> updates;
+        QSharedPointer<TLMessagesMessages> messages;
+        QSharedPointer<TLMessagesDialogs> dialogs;
+        QSharedPointer<TLUploadFile> file;
+
+    protected:
+        template <typename T>
+        static bool takeObject(QSharedPointer<T> *object, T *result);
+    };
+
+    struct Message {
+        Message() : serverSalt(0), sessionId(0), messageId(0), sequence(0) { }
+
+        quint64 serverSalt;
+        quint64 sessionId;
+        quint64 messageId;
+        quint32 sequence;
+        QByteArray payload;
+        QVector<DecodedObject> objects;
+    };
+
+    CPackageDecoder();
+
+    quint64 authId() const { return m_authId; }
+    void setAuthKey(const QByteArray &authKey);
+
+    // Returns false if the package is not addressed to the auth key or it is corrupted
+    bool decode(const QByteArray &package, Message *message) const;
+
+    // Replaces gzip_packed objects at the top level, in msg_container items and in rpc_result
+    // bodies by their unpacked content, so the payload processing does not need to inflate.
+    static QByteArray unpackGzipPayloads(const QByteArray &payload);
+
+    // Decodes the bulky TL objects of the unpacked payload: the updates, the messages, the dialogs and the file parts.
+    // Their decoding needs no connection state, so it is done along with the decryption.
+    static void decodeObjects(Message *message, MessageProjection projection);
+
+protected:
+    uchar m_authKeyData[256];
+    quint64 m_authId;
+
+};
+
+template <typename T>
+inline bool CPackageDecoder::DecodedObject::takeObject(QSharedPointer<T> *object, T *result)
+{
+    if (!*object) {
+        return false;
+    }
+    *result = std::move(**object);
+    object->reset();
+    return true;
+}
+
+Q_DECLARE_METATYPE(CPackageDecoder::Message)
+
+// Runs the decoder in the thread it lives in, including the TL decoding of the bulky objects.
+// The decoded messages are delivered via signal, so a queued connection hands them back to the thread of the receiver.
+class CPackageDecodingWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit CPackageDecodingWorker(QObject *parent = nullptr);
+
+    // Thread-safe, the projection is used for the messages of the next decoded packages
+    MessageProjection messageProjection() const;
+    void setMessageProjection(MessageProjection projection);
+
+public slots:
+    void setAuthKey(const QByteArray &authKey);
+    void decodePackage(const QByteArray &package);
+
+signals:
+    void messageDecoded(const CPackageDecoder::Message &message);
+
+protected:
+    CPackageDecoder m_decoder;
+    mutable QMutex m_projectionMutex;
+    MessageProjection m_messageProjection;
+
+};
+
+#endif // CPACKAGEDECODER_HPP
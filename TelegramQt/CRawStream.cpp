@@ -18,40 +18,30 @@
 #include "CRawStream.hpp"
 
 #include <QIODevice>
-#include <QBuffer>
 
 static const char s_nulls[4] = { 0, 0, 0, 0 };
 
-CRawStream::CRawStream(QByteArray *data, bool write) :
-    m_device(new QBuffer(data)),
-    m_ownDevice(true)
+CRawStream::CRawStream(QByteArray *data, bool write)
 {
     if (write) {
-        m_device->open(QIODevice::Append);
+        m_output = data;
     } else {
-        m_device->open(QIODevice::ReadOnly);
+        m_data = *data;
     }
 }
 
 CRawStream::CRawStream(const QByteArray &data) :
-    m_ownDevice(true)
+    m_data(data)
 {
-    QBuffer *buffer = new QBuffer();
-    buffer->setData(data);
-    m_device = buffer;
-    m_device->open(QIODevice::ReadOnly);
 }
 
 CRawStream::CRawStream(CRawStream::Mode m, quint32 reserveBytes) :
-    m_ownDevice(true)
+    m_output(&m_data)
 {
     Q_UNUSED(m)
-    QBuffer *buffer = new QBuffer();
     if (reserveBytes) {
-        buffer->buffer().reserve(reserveBytes);
+        m_data.reserve(reserveBytes);
     }
-    m_device = buffer;
-    m_device->open(QIODevice::WriteOnly);
 }
 
 CRawStream::CRawStream(QIODevice *d) :
@@ -61,29 +51,22 @@ CRawStream::CRawStream(QIODevice *d) :
 
 CRawStream::~CRawStream()
 {
-    if (m_device && m_ownDevice) {
-        delete m_device;
-    }
 }
 
 QByteArray CRawStream::getData() const
 {
-    if (m_ownDevice) {
-        QBuffer *buffer = static_cast<QBuffer*>(m_device);
-        return buffer->data();
+    if (m_output) {
+        return *m_output;
     }
-    return QByteArray();
+    return m_data;
 }
 
 void CRawStream::setDevice(QIODevice *newDevice)
 {
-    if (m_device) {
-        if (m_ownDevice) {
-            delete m_device;
-        }
-    }
-
     m_device = newDevice;
+    m_data.clear();
+    m_output = nullptr;
+    m_position = 0;
 }
 
 void CRawStream::unsetDevice()
@@ -93,85 +76,98 @@ void CRawStream::unsetDevice()
 
 bool CRawStream::atEnd() const
 {
-    return m_device ? m_device->atEnd() : true;
+    return m_device ? m_device->atEnd() : m_position >= m_data.size();
 }
 
 int CRawStream::bytesAvailable() const
 {
-    return m_device ? m_device->bytesAvailable() : 0;
-}
-
-bool CRawStream::read(void *data, qint64 size)
-{
-    m_error = m_error || m_device->read((char *) data, size) != size;
-    return m_error;
-}
-
-bool CRawStream::write(const void *data, qint64 size)
-{
-    m_error = m_error || m_device->write((const char *) data, size) != size;
-    return m_error;
+    return m_device ? m_device->bytesAvailable() : m_data.size() - m_position;
 }
 
-QByteArray CRawStream::readBytes(int count)
+int CRawStream::position() const
 {
-    QByteArray result = m_device->read(count);
-    m_error = m_error || result.size() != count;
-    return result;
+    return m_device ? m_device->pos() : m_position;
 }
 
-CRawStream &CRawStream::operator>>(qint8 &i)
+bool CRawStream::seek(int position)
 {
-    return protectedRead(i);
+    if (m_device) {
+        return m_device->seek(position);
+    }
+    if ((position < 0) || (position > m_data.size())) {
+        return false;
+    }
+    m_position = position;
+    return true;
 }
 
-CRawStream &CRawStream::operator>>(qint16 &i)
+bool CRawStream::read(void *data, qint64 size)
 {
-    return protectedRead(i);
-}
+    if (m_device) {
+        m_error = m_error || m_device->read((char *) data, size) != size;
+        return m_error;
+    }
 
-CRawStream &CRawStream::operator>>(qint32 &i)
-{
-    return protectedRead(i);
+    const int bytesToRead = qBound<qint64>(0, size, m_data.size() - m_position);
+    memcpy(data, m_data.constData() + m_position, bytesToRead);
+    m_position += bytesToRead;
+    m_error = m_error || bytesToRead != size;
+    return m_error;
 }
 
-CRawStream &CRawStream::operator>>(qint64 &i)
+bool CRawStream::write(const void *data, qint64 size)
 {
-    return protectedRead(i);
+    if (m_output) {
+        m_output->append(static_cast<const char *>(data), int(size));
+        return m_error;
+    }
+    if (!m_device) {
+        m_error = true;
+        return m_error;
+    }
+    m_error = m_error || m_device->write((const char *) data, size) != size;
+    return m_error;
 }
 
-template<typename Int>
-CRawStream &CRawStream::protectedRead(Int &i)
+QByteArray CRawStream::readBytes(int count)
 {
-    read(&i, sizeof(Int));
-    return *this;
-}
+    if (m_device) {
+        QByteArray result = m_device->read(count);
+        m_error = m_error || result.size() != count;
+        return result;
+    }
 
-CRawStream &CRawStream::operator<<(qint8 i)
-{
-    return protectedWrite(i);
+    const int bytesToRead = qBound(0, count, m_data.size() - m_position);
+    const QByteArray result(m_data.constData() + m_position, bytesToRead);
+    m_position += bytesToRead;
+    m_error = m_error || bytesToRead != count;
+    return result;
 }
 
-CRawStream &CRawStream::operator<<(qint16 i)
+QByteArray CRawStream::readBytesView(int count)
 {
-    return protectedWrite(i);
-}
+    if (m_device) {
+        return readBytes(count);
+    }
 
-CRawStream &CRawStream::operator<<(qint32 i)
-{
-    return protectedWrite(i);
+    const int bytesToRead = qBound(0, count, m_data.size() - m_position);
+    const QByteArray result = QByteArray::fromRawData(m_data.constData() + m_position, bytesToRead);
+    m_position += bytesToRead;
+    m_error = m_error || bytesToRead != count;
+    return result;
 }
 
-CRawStream &CRawStream::operator<<(qint64 i)
+bool CRawStream::skipBytes(int count)
 {
-    return protectedWrite(i);
-}
+    if (m_device) {
+        m_error = m_error || m_device->read(count).size() != count;
+        return m_error;
+    }
 
-template<typename Int>
-CRawStream &CRawStream::protectedWrite(Int i)
-{
-    write(&i, sizeof(Int));
-    return *this;
+    const int bytesToSkip = qBound(0, count, m_data.size() - m_position);
+    m_position += bytesToSkip;
+    m_error = m_error || bytesToSkip != count;
+    return m_error;
 }
 
 CRawStream &CRawStream::operator>>(double &d)
@@ -188,6 +184,14 @@ CRawStream &CRawStream::operator<<(const double &d)
 
 CRawStream &CRawStream::operator<<(const QByteArray &data)
 {
+    if (m_output) {
+        m_output->append(data);
+        return *this;
+    }
+    if (!m_device) {
+        m_error = true;
+        return *this;
+    }
     m_error = m_error || m_device->write(data) != data.size();
 
     return *this;
@@ -210,12 +214,29 @@ CRawStreamEx &CRawStreamEx::operator>>(QByteArray &data)
     read(data.data(), data.size());
 
     if (length & 3) {
-        readBytes(4 - (length & 3));
+        skipBytes(4 - (length & 3));
     }
 
     return *this;
 }
 
+QByteArray CRawStreamEx::readSerializedBytesView()
+{
+    quint32 length = 0;
+    read(&length, 1);
+
+    if (length >= 0xfe) {
+        read(&length, 3);
+        const QByteArray data = readBytesView(length);
+        skipBytes((4 - (length & 3)) & 3);
+        return data;
+    }
+
+    const QByteArray data = readBytesView(length);
+    skipBytes((4 - ((length + 1) & 3)) & 3);
+    return data;
+}
+
 CRawStreamEx &CRawStreamEx::operator<<(const QByteArray &data)
 {
     quint32 length = data.size();
@@ -20,6 +20,8 @@
 
 #include <QByteArray>
 
+#include <string.h>
+
 QT_FORWARD_DECLARE_CLASS(QIODevice)
 
 class CRawStream
@@ -28,7 +30,10 @@ public:
     enum Mode {
         WriteOnly
     };
+    // The streams without a device read and write the data directly, with inline bounds checks.
+    // The written data is appended to the given array.
     explicit CRawStream(QByteArray *data, bool write);
+    // The data is shared, not copied.
     explicit CRawStream(const QByteArray &data);
     explicit CRawStream(Mode mode, quint32 reserveBytes = 0);
     explicit CRawStream(QIODevice *d = nullptr);
@@ -46,7 +51,15 @@ public:
     bool atEnd() const;
     int bytesAvailable() const;
 
+    // The read position; a device-based stream uses the device position
+    int position() const;
+    bool seek(int position);
+
     QByteArray readBytes(int count);
+    // Returns a non-owning view on the stream data, so the view must not outlive the data.
+    // A device-based stream returns a copy.
+    QByteArray readBytesView(int count);
+    bool skipBytes(int count);
 
     QByteArray readAll();
 
@@ -75,6 +88,8 @@ public:
     CRawStream &operator<<(const QByteArray &data);
 
 protected:
+    void setError();
+
     bool read(void *data, qint64 size);
     bool write(const void *data, qint64 size);
 
@@ -85,8 +100,12 @@ protected:
     inline CRawStream &protectedRead(Int &i);
 
 private:
+    Q_DISABLE_COPY(CRawStream)
+
     QIODevice *m_device = nullptr;
-    bool m_ownDevice = false;
+    QByteArray m_data; // The data of a device-less stream
+    QByteArray *m_output = nullptr; // The write target of a device-less stream
+    int m_position = 0;
     bool m_error = false;
 
 };
@@ -99,6 +118,8 @@ public:
     using CRawStream::operator >>;
 
     CRawStreamEx &operator>>(QByteArray &data);
+    // Reads the serialized bytes as a view on the stream data (see readBytesView())
+    QByteArray readSerializedBytesView();
     CRawStreamEx &operator<<(const QByteArray &data);
 
 };
@@ -108,11 +129,59 @@ inline void CRawStream::resetError()
     m_error = false;
 }
 
+inline void CRawStream::setError()
+{
+    m_error = true;
+}
+
 inline QByteArray CRawStream::readAll()
 {
     return readBytes(bytesAvailable());
 }
 
+template<typename Int>
+inline CRawStream &CRawStream::protectedRead(Int &i)
+{
+    if (!m_device && (m_position + int(sizeof(Int)) <= m_data.size())) {
+        memcpy(&i, m_data.constData() + m_position, sizeof(Int));
+        m_position += sizeof(Int);
+        return *this;
+    }
+    read(&i, sizeof(Int));
+    return *this;
+}
+
+template<typename Int>
+inline CRawStream &CRawStream::protectedWrite(Int i)
+{
+    if (m_output) {
+        m_output->append(reinterpret_cast<const char *>(&i), sizeof(Int));
+        return *this;
+    }
+    write(&i, sizeof(Int));
+    return *this;
+}
+
+inline CRawStream &CRawStream::operator>>(qint8 &i)
+{
+    return protectedRead(i);
+}
+
+inline CRawStream &CRawStream::operator>>(qint16 &i)
+{
+    return protectedRead(i);
+}
+
+inline CRawStream &CRawStream::operator>>(qint32 &i)
+{
+    return protectedRead(i);
+}
+
+inline CRawStream &CRawStream::operator>>(qint64 &i)
+{
+    return protectedRead(i);
+}
+
 inline CRawStream &CRawStream::operator>>(quint8 &i)
 {
     return *this >> reinterpret_cast<qint8&>(i);
@@ -133,6 +202,26 @@ inline CRawStream &CRawStream::operator>>(quint64 &i)
     return *this >> reinterpret_cast<qint64&>(i);
 }
 
+inline CRawStream &CRawStream::operator<<(qint8 i)
+{
+    return protectedWrite(i);
+}
+
+inline CRawStream &CRawStream::operator<<(qint16 i)
+{
+    return protectedWrite(i);
+}
+
+inline CRawStream &CRawStream::operator<<(qint32 i)
+{
+    return protectedWrite(i);
+}
+
+inline CRawStream &CRawStream::operator<<(qint64 i)
+{
+    return protectedWrite(i);
+}
+
 inline CRawStream &CRawStream::operator<<(quint8 i)
 {
     return *this << qint8(i);
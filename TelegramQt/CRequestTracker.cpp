@@ -0,0 +1,233 @@
+/*
+   Copyright (C) 2026 agent <agent@local>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+
+#include "CRequestTracker.hpp"
+
+#include <QDebug>
+
+static const int s_defaultMaxCount = 4096;
+static const qint64 s_defaultMaxTotalSize = 16 * 1024 * 1024;
+
+CRequestTracker::CRequestTracker() :
+    m_totalSize(0),
+    m_sentCount(0),
+    m_maxTotalSize(s_defaultMaxTotalSize),
+    m_maxCount(s_defaultMaxCount),
+    m_droppedCount(0)
+{
+}
+
+void CRequestTracker::setMaxCount(int count)
+{
+    m_maxCount = count;
+    while (m_requests.count() > m_maxCount) {
+        if (!dropOldest()) {
+            break;
+        }
+    }
+}
+
+void CRequestTracker::setMaxTotalSize(qint64 size)
+{
+    m_maxTotalSize = size;
+    while (!m_requests.isEmpty() && (m_totalSize > m_maxTotalSize)) {
+        if (!dropOldest()) {
+            break;
+        }
+    }
+}
+
+QVector<QPair<quint64, quint32> > CRequestTracker::takeDroppedRequests()
+{
+    QVector<QPair<quint64, quint32> > result;
+    result.swap(m_droppedRequests);
+    return result;
+}
+
+QByteArray CRequestTracker::data(quint64 id) const
+{
+    const auto it = m_requests.constFind(id);
+    return it == m_requests.constEnd() ? QByteArray() : it->data;
+}
+
+const CRequestTracker::Request *CRequestTracker::request(quint64 id) const
+{
+    const auto it = m_requests.constFind(id);
+    return it == m_requests.constEnd() ? nullptr : &it.value();
+}
+
+CRequestTracker::Request *CRequestTracker::request(quint64 id)
+{
+    const auto it = m_requests.find(id);
+    return it == m_requests.end() ? nullptr : &it.value();
+}
+
+quint32 CRequestTracker::fileRequestId(quint64 id) const
+{
+    const auto it = m_requests.constFind(id);
+    return it == m_requests.constEnd() ? 0 : it->fileRequestId;
+}
+
+void CRequestTracker::setFileRequestId(quint64 id, quint32 fileRequestId)
+{
+    const auto it = m_requests.find(id);
+    if (it != m_requests.end()) {
+        it->fileRequestId = fileRequestId;
+    }
+}
+
+void CRequestTracker::setSent(quint64 id)
+{
+    const auto it = m_requests.find(id);
+    if ((it != m_requests.end()) && !it->sent) {
+        it->sent = true;
+        ++m_sentCount;
+    }
+}
+
+void CRequestTracker::insert(quint64 id, const Request &request)
+{
+    remove(id);
+
+    while (!m_requests.isEmpty() && ((m_requests.count() >= m_maxCount) || (m_totalSize + request.data.size() > m_maxTotalSize))) {
+        if (!dropOldest()) {
+            // Only the queued requests are left; the outgoing queue has its own limits
+            break;
+        }
+    }
+
+    m_requests.insert(id, request);
+    m_order.enqueue(id);
+    m_totalSize += request.data.size();
+    if (request.sent) {
+        ++m_sentCount;
+    }
+}
+
+CRequestTracker::Request CRequestTracker::take(quint64 id)
+{
+    const Request request = m_requests.take(id);
+    m_totalSize -= request.data.size();
+    if (request.sent) {
+        --m_sentCount;
+    }
+    compactOrder();
+    return request;
+}
+
+void CRequestTracker::remove(quint64 id)
+{
+    const auto it = m_requests.find(id);
+    if (it == m_requests.end()) {
+        return;
+    }
+    m_totalSize -= it->data.size();
+    if (it->sent) {
+        --m_sentCount;
+    }
+    m_requests.erase(it);
+    compactOrder();
+}
+
+void CRequestTracker::clear()
+{
+    m_requests.clear();
+    m_order.clear();
+    m_totalSize = 0;
+    m_sentCount = 0;
+}
+
+qint64 CRequestTracker::oldestSentTime() const
+{
+    // The queued requests may be released out of the insertion order
+    qint64 result = 0;
+    for (const Request &request : m_requests) {
+        if (request.sent && (!result || (request.sentTime < result))) {
+            result = request.sentTime;
+        }
+    }
+    return result;
+}
+
+QVector<quint64> CRequestTracker::expiredRequests(qint64 time) const
+{
+    QVector<quint64> result;
+    for (auto it = m_requests.constBegin(); it != m_requests.constEnd(); ++it) {
+        if (it->sent && it->deadline && (it->deadline <= time)) {
+            result.append(it.key());
+        }
+    }
+    return result;
+}
+
+QVector<quint64> CRequestTracker::requestsToCheck(qint64 time) const
+{
+    QVector<quint64> result;
+    for (auto it = m_requests.constBegin(); it != m_requests.constEnd(); ++it) {
+        if (it->stateCheckTime && (it->stateCheckTime <= time)) {
+            result.append(it.key());
+        }
+    }
+    return result;
+}
+
+bool CRequestTracker::dropOldest()
+{
+    // The queued requests are kept, as they are not sent yet
+    for (const quint64 id : m_order) {
+        const auto it = m_requests.find(id);
+        if ((it == m_requests.end()) || !it->sent) {
+            continue;
+        }
+        qWarning() << Q_FUNC_INFO << "Drop the request" << id << "because of the tracker limits";
+        m_droppedRequests.append(qMakePair(id, it->fileRequestId));
+        m_totalSize -= it->data.size();
+        --m_sentCount;
+        m_requests.erase(it);
+        ++m_droppedCount;
+        compactOrder();
+        return true;
+    }
+    return false;
+}
+
+QVector<quint64> CRequestTracker::queuedRequests() const
+{
+    QVector<quint64> result;
+    for (auto it = m_requests.constBegin(); it != m_requests.constEnd(); ++it) {
+        if (!it->sent) {
+            result.append(it.key());
+        }
+    }
+    return result;
+}
+
+void CRequestTracker::compactOrder()
+{
+    // The removed ids are left in the queue; rebuild it when they prevail
+    if (m_order.count() <= m_requests.count() * 2 + 16) {
+        return;
+    }
+    QQueue<quint64> order;
+    order.reserve(m_requests.count());
+    for (const quint64 id : m_order) {
+        if (m_requests.contains(id)) {
+            order.enqueue(id);
+        }
+    }
+    m_order = order;
+}
@@ -0,0 +1,97 @@
+/*
+   Copyright (C) 2026 agent <agent@local>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+
+#ifndef CREQUESTTRACKER_HPP
+#define CREQUESTTRACKER_HPP
+
+#include <QByteArray>
+#include <QHash>
+#include <QPair>
+#include <QQueue>
+#include <QVector>
+
+// The sent content-related requests, waiting for the results.
+// The lookup is done by the message id; the memory is limited by the requests count and total size,
+// the oldest sent requests are dropped on overflow.
+class CRequestTracker
+{
+public:
+    struct Request {
+        Request() : sentTime(0), deadline(0), stateCheckTime(0), retries(0), fileRequestId(0), sent(false) { }
+
+        QByteArray data;
+        qint64 sentTime;
+        qint64 deadline;
+        qint64 stateCheckTime; // The time to ask the server about the request state; zero if not needed
+        int retries;
+        quint32 fileRequestId;
+        bool sent; // False while the request waits in the outgoing queue
+    };
+
+    CRequestTracker();
+
+    int count() const { return m_requests.count(); }
+    bool isEmpty() const { return m_requests.isEmpty(); }
+    qint64 totalSize() const { return m_totalSize; }
+    // The number of requests passed to the transport
+    int sentCount() const { return m_sentCount; }
+
+    int maxCount() const { return m_maxCount; }
+    void setMaxCount(int count);
+    qint64 maxTotalSize() const { return m_maxTotalSize; }
+    void setMaxTotalSize(qint64 size);
+
+    // The number of requests dropped because of the limits
+    quint64 droppedCount() const { return m_droppedCount; }
+    // The requests dropped because of the limits since the last call, to be reported as failed
+    QVector<QPair<quint64, quint32> > takeDroppedRequests(); // <request id, file request id>
+
+    bool contains(quint64 id) const { return m_requests.contains(id); }
+    QByteArray data(quint64 id) const;
+    const Request *request(quint64 id) const;
+    Request *request(quint64 id);
+    quint32 fileRequestId(quint64 id) const;
+    void setFileRequestId(quint64 id, quint32 fileRequestId);
+    void setSent(quint64 id);
+
+    void insert(quint64 id, const Request &request);
+    Request take(quint64 id);
+    void remove(quint64 id);
+    void clear();
+
+    // The queued (not sent yet) requests are ignored
+    qint64 oldestSentTime() const;
+    QVector<quint64> expiredRequests(qint64 time) const;
+    QVector<quint64> requestsToCheck(qint64 time) const;
+    QVector<quint64> queuedRequests() const;
+
+protected:
+    bool dropOldest();
+    void compactOrder();
+
+    QHash<quint64, Request> m_requests;
+    QQueue<quint64> m_order; // The ids in the sending order; may contain already removed ids
+    qint64 m_totalSize;
+    int m_sentCount;
+    qint64 m_maxTotalSize;
+    int m_maxCount;
+    quint64 m_droppedCount;
+    QVector<QPair<quint64, quint32> > m_droppedRequests;
+
+};
+
+#endif // CREQUESTTRACKER_HPP
@@ -25,20 +25,26 @@
 #define Q_FALLTHROUGH() (void)0
 #endif
 
-static const quint32 tcpTimeout = 15 * 1000;
+static const int s_readBufferMinimumSize = 64 * 1024;
+static const int s_writeBufferReservedSize = 16 * 1024;
+static const quint32 s_maximumPackageLength = 16 * 1024 * 1024;
+static const quint32 s_quickAckFlag = 0x80000000u;
+static const int s_maximumReadSize = s_maximumPackageLength + 4; // A package with the longest header
 
 CTcpTransport::CTcpTransport(QObject *parent) :
     CTelegramTransport(parent),
     m_socket(nullptr),
     m_timeoutTimer(new QTimer(this))
 {
-    m_timeoutTimer->setInterval(tcpTimeout);
+    m_timeoutTimer->setSingleShot(true);
     connect(m_timeoutTimer, &QTimer::timeout, this, &CTcpTransport::onTimeout);
+    m_writeBuffer.reserve(s_writeBufferReservedSize);
 }
 
 CTcpTransport::~CTcpTransport()
 {
     if (m_socket && m_socket->isWritable()) {
+        flushImplementation();
         m_socket->waitForBytesWritten(100);
         m_socket->disconnectFromHost();
     }
@@ -49,6 +55,7 @@ void CTcpTransport::connectToHost(const QString &ipAddress, quint32 port)
 #ifdef DEVELOPER_BUILD
     qDebug() << Q_FUNC_INFO << ipAddress << port;
 #endif
+    setRemoteAddress(Telegram::DcOption(ipAddress, port));
     m_socket->connectToHost(ipAddress, port);
 }
 
@@ -58,6 +65,7 @@ void CTcpTransport::disconnectFromHost()
     qDebug() << Q_FUNC_INFO;
 #endif
     if (m_socket) {
+        flushImplementation();
         m_socket->disconnectFromHost();
     }
 }
@@ -76,22 +84,49 @@ void CTcpTransport::sendPackageImplementation(const QByteArray &payload)
     //      (quint8: 0x7f, quint24: Packet length / 4)
     // Payload
 
+    // Intermediate version:
+    // quint32: 0xeeeeeeee
+    // quint32: Packet length
+    // Payload
+
     if (payload.length() % 4) {
         qCritical() << Q_FUNC_INFO << "Invalid outgoing package! The payload size is not divisible by four!";
     }
 
-    QByteArray package;
-    package.reserve(payload.size() + 4);
-    const quint32 length = payload.length() / 4;
-    if (length < 0x7f) {
-        package.append(char(length));
+    // The header and the payload are appended to the contiguous write buffer,
+    // which is written to the socket on flush.
+    if (m_sessionType == Intermediate) {
+        const quint32 length = payload.length();
+        m_writeBuffer.append(reinterpret_cast<const char *>(&length), 4);
     } else {
-        package.append(char(0x7f));
-        package.append(reinterpret_cast<const char *>(&length), 3);
+        const quint32 length = payload.length() / 4;
+        if (length < 0x7f) {
+            m_writeBuffer.append(char(length));
+        } else {
+            m_writeBuffer.append(char(0x7f));
+            m_writeBuffer.append(reinterpret_cast<const char *>(&length), 3);
+        }
+    }
+    m_writeBuffer.append(payload);
+}
+
+void CTcpTransport::flushImplementation()
+{
+    if (m_writeBuffer.isEmpty()) {
+        return;
+    }
+    m_socket->write(m_writeBuffer.constData(), m_writeBuffer.size());
+    ++m_writeCallsCount;
+    // Keep the reserved capacity for the next packages
+    m_writeBuffer.resize(0);
+}
+
+qint64 CTcpTransport::bytesToWrite() const
+{
+    if (!m_socket) {
+        return m_writeBuffer.size();
     }
-    package.append(payload);
-    m_socket->write(package);
-    emit packageSent(package);
+    return m_writeBuffer.size() + m_socket->bytesToWrite();
 }
 
 void CTcpTransport::setSessionType(CTcpTransport::SessionType sessionType)
@@ -105,10 +140,11 @@ void CTcpTransport::setState(QAbstractSocket::SocketState newState)
     switch (newState) {
     case QAbstractSocket::HostLookupState:
     case QAbstractSocket::ConnectingState:
-        m_timeoutTimer->start();
+        m_timeoutTimer->start(connectionTimeout());
         break;
     case QAbstractSocket::ConnectedState:
-        m_expectedLength = 0;
+        resetReadBuffer();
+        m_writeBuffer.resize(0);
         setSessionType(Unknown);
         Q_FALLTHROUGH();
     default:
@@ -121,33 +157,115 @@ void CTcpTransport::setState(QAbstractSocket::SocketState newState)
 void CTcpTransport::onReadyRead()
 {
     readEvent();
-    while (m_socket->bytesAvailable() > 0) {
+
+    // Drain the socket into the reusable buffer; a read is limited to one maximal package
+    // to keep the buffer size bound no matter how much data the socket has buffered.
+    while (m_socket->state() == QAbstractSocket::ConnectedState) {
+        const int available = static_cast<int>(qMin<qint64>(m_socket->bytesAvailable(), s_maximumReadSize));
+        if (available <= 0) {
+            return;
+        }
+
+        reserveReadBuffer(available);
+        const qint64 bytesRead = m_socket->read(m_readBuffer.data() + m_readBufferEnd, available);
+        if (bytesRead <= 0) {
+            return;
+        }
+        m_readBufferEnd += bytesRead;
+
+        readPackages();
+    }
+}
+
+void CTcpTransport::readPackages()
+{
+    while (m_readBufferEnd > m_readBufferBegin) {
+        const uchar *data = reinterpret_cast<const uchar *>(m_readBuffer.constData()) + m_readBufferBegin;
+        int bytesInBuffer = m_readBufferEnd - m_readBufferBegin;
+
         if (m_expectedLength == 0) {
-            if (m_socket->bytesAvailable() < 4) {
+            if (bytesInBuffer < 4) {
                 // Four bytes is minimum readable size for new package
-                return;
+                break;
             }
 
-            char length;
-            m_socket->getChar(&length);
-
-            if (length < char(0x7f)) {
-                m_expectedLength = length * 4;
-            } else if (length == char(0x7f)) {
-                m_socket->read((char *) &m_expectedLength, 3);
-                m_expectedLength *= 4;
+            int headerLength = 1;
+            if (m_sessionType == Intermediate) {
+                const quint32 length = data[0] | (data[1] << 8) | (data[2] << 16) | (quint32(data[3]) << 24);
+                if (length & s_quickAckFlag) {
+                    // A quick ack token has no payload
+                    m_readBufferBegin += 4;
+                    continue;
+                }
+                m_expectedLength = length;
+                headerLength = 4;
+            } else if (data[0] < 0x7f) {
+                m_expectedLength = data[0] * 4;
+            } else if (data[0] == 0x7f) {
+                m_expectedLength = (data[1] | (data[2] << 8) | (data[3] << 16)) * 4;
+                headerLength = 4;
             } else {
-                qDebug() << "Incorrect TCP package!";
+                // A quick ack token (big endian, with the most significant bit set) has no payload
+                m_readBufferBegin += 4;
+                continue;
+            }
+
+            if ((m_expectedLength % 4) || (m_expectedLength > s_maximumPackageLength)) {
+                qWarning() << Q_FUNC_INFO << "Invalid package length" << m_expectedLength;
+                resetReadBuffer();
+                setError(QAbstractSocket::UnknownSocketError);
+                disconnectFromHost();
+                return;
+            }
+            m_readBufferBegin += headerLength;
+            bytesInBuffer -= headerLength;
+            data += headerLength;
+
+            if (m_expectedLength == 0) {
+                continue;
             }
         }
 
-        if (m_socket->bytesAvailable() < m_expectedLength) {
-            return;
+        if (bytesInBuffer < static_cast<int>(m_expectedLength)) {
+            break;
         }
 
-        const QByteArray readPackage = m_socket->read(m_expectedLength);
+        // The package is a view on the read buffer; it stays valid only during the signal emission.
+        const QByteArray readPackage = QByteArray::fromRawData(reinterpret_cast<const char *>(data), m_expectedLength);
+        m_readBufferBegin += m_expectedLength;
         m_expectedLength = 0;
-        packageReceived(readPackage);
+        emit packageReceived(readPackage);
+    }
+
+    if (m_readBufferBegin == m_readBufferEnd) {
+        m_readBufferBegin = 0;
+        m_readBufferEnd = 0;
+    }
+}
+
+void CTcpTransport::resetReadBuffer()
+{
+    m_expectedLength = 0;
+    m_readBufferBegin = 0;
+    m_readBufferEnd = 0;
+}
+
+void CTcpTransport::reserveReadBuffer(int size)
+{
+    if (m_readBuffer.size() - m_readBufferEnd >= size) {
+        return;
+    }
+
+    // Move the pending (not processed yet) bytes to the beginning of the buffer
+    const int pendingBytes = m_readBufferEnd - m_readBufferBegin;
+    if (m_readBufferBegin) {
+        memmove(m_readBuffer.data(), m_readBuffer.constData() + m_readBufferBegin, pendingBytes);
+        m_readBufferBegin = 0;
+        m_readBufferEnd = pendingBytes;
+    }
+
+    if (m_readBuffer.size() - m_readBufferEnd < size) {
+        m_readBuffer.resize(qMax(pendingBytes + size, s_readBufferMinimumSize));
     }
 }
 
@@ -157,7 +275,7 @@ void CTcpTransport::onTimeout()
     qDebug() << Q_FUNC_INFO << "(connection to " << m_socket->peerName() << m_socket->peerPort() << ").";
 #endif
     emit timeout();
-    m_socket->disconnectFromHost();
+    disconnectFromHost();
 }
 
 void CTcpTransport::setSocket(QAbstractSocket *socket)
@@ -169,4 +287,5 @@ void CTcpTransport::setSocket(QAbstractSocket *socket)
     connect(m_socket, &QAbstractSocket::stateChanged, this, &CTcpTransport::setState);
     connect(m_socket, SIGNAL(error(QAbstractSocket::SocketError)), SLOT(setError(QAbstractSocket::SocketError)));
     connect(m_socket, &QIODevice::readyRead, this, &CTcpTransport::onReadyRead);
+    connect(m_socket, &QIODevice::bytesWritten, this, &CTelegramTransport::bytesWritten);
 }
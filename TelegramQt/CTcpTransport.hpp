@@ -29,6 +29,7 @@ public:
     enum SessionType {
         Unknown,
         Abridged, // char(0xef)
+        Intermediate, // quint32(0xeeeeeeee)
         FullSize
     };
     Q_ENUM(SessionType)
@@ -39,6 +40,8 @@ public:
     void connectToHost(const QString &ipAddress, quint32 port) override;
     void disconnectFromHost() override;
 
+    qint64 bytesToWrite() const override;
+
 protected slots:
     void setState(QAbstractSocket::SocketState newState) override;
     void onReadyRead();
@@ -47,13 +50,27 @@ protected slots:
 protected:
     void setSocket(QAbstractSocket *socket);
     void sendPackageImplementation(const QByteArray &payload) override;
+    void flushImplementation() override;
 
     void setSessionType(SessionType sessionType);
 
+    void readPackages();
+    void resetReadBuffer();
+    void reserveReadBuffer(int size);
+
     quint32 m_packetNumber = 0;
     quint32 m_expectedLength = 0;
     SessionType m_sessionType = Unknown;
 
+    // The received data is kept between m_readBufferBegin and m_readBufferEnd.
+    // The buffer is reused for all packages to avoid per-package allocations.
+    QByteArray m_readBuffer;
+    int m_readBufferBegin = 0;
+    int m_readBufferEnd = 0;
+
+    // Framed outgoing packages which are not written to the socket yet
+    QByteArray m_writeBuffer;
+
     QAbstractSocket *m_socket = nullptr;
     QTimer *m_timeoutTimer = nullptr;
 };
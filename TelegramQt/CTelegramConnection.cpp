@@ -21,21 +21,17 @@
 
 #include <QDateTime>
 #include <QStringList>
+#include <QThread>
 #include <QTimer>
 
 #include <QtEndian>
 
+#include <algorithm>
+
+
 #ifdef NETWORK_LOGGING
 #include <QDir>
 #include <QFile>
-#include <QTextStream>
-
-const int valFieldWidth = 32;
-QString formatTLValue(const TLValue &val)
-{
-    const QString text = val.toString();
-    return QString(valFieldWidth - text.length(), QLatin1Char(' ')) + text;
-}
 #endif
 
 #include "CAppInformation.hpp"
@@ -54,24 +50,80 @@ using namespace TelegramUtils;
 using namespace Telegram;
 
 static const quint32 s_defaultAuthInterval = 15000; // 15 sec
+static const int s_maxContainerMessages = 1020; // Protocol limit
+static const int s_maxContainerSize = 64 * 1024;
+static const int s_maxBatchedMessageSize = 16 * 1024; // Larger messages (e.g. file parts) are sent alone
+static const int s_maxRememberedContainers = 64;
+static const int s_maxPendingAcks = 6; // A standalone ack is sent on overflow if there are no queued messages
+static const int s_encryptedHeaderSize = 8 + 16; // Auth key id, message key
+static const int s_encryptedEnvelopeSize = 8 + 8 + 8 + 4 + 4; // Salt, session id, message id, sequence number, length
+// The bytes released per a flush for each priority class; zero means no limit
+static const int s_priorityByteBudgets[CTelegramConnection::PriorityCount] = {
+    0, // Control
+    64 * 1024, // Interactive
+    32 * 1024, // Background
+    64 * 1024, // Bulk
+};
+static const qint64 s_bulkReleaseThreshold = 16 * 1024; // Keep the transport buffer short for the higher classes
+static const qint64 s_maxMessageQueueTime = 60 * 1000; // Renew the older message ids, the server rejects the ids older than 300 sec
+static const int s_defaultMaxInFlightRequests = 64;
+static const int s_sendQueueHighWaterCount = 256;
+static const int s_sendQueueHighWaterSize = 1024 * 1024;
+static const int s_defaultGzipPackingThreshold = 1024;
+static const quint32 s_defaultRequestTimeout = 5 * 60 * 1000;
+static const int s_requestCheckInterval = 1000;
+static const int s_maxRequestRetries = 5;
+static const int s_maxRememberedStateRequests = 64;
+static const int s_maxStateRequestIds = 1024;
+static const quint32 s_minimalStateRequestTimeout = 3000;
+static const quint32 s_futureSaltsCount = 32; // Up to 64 salts are returned by the server
+static const quint32 s_futureSaltsPrefetchPeriod = 2 * 60 * 60; // Fetch more salts if the known ones expire earlier (in sec)
+static const quint32 s_serverSaltSwitchMargin = 60; // Switch to the next salt before the current one expires (in sec)
+static const int s_futureSaltsRequestTimeout = 30 * 1000; // The get_future_salts is not tracked; ask again if got no answer
+static const quint32 s_defaultRetransmissionTimeout = 15000; // Used until the first RTT sample
+static const quint32 s_minimalRetransmissionTimeout = 1000;
+static const quint32 s_maximalRetransmissionTimeout = 60000;
+static const quint32 s_minimalConnectionTimeout = 3000;
+static const quint32 s_maximalConnectionTimeout = 30000;
+static const quint32 s_minimalPongTimeout = 2000;
+static const qint64 s_maximalRttSample = 5 * 60 * 1000; // Larger samples are treated as clock issues
 
 CTelegramConnection::CTelegramConnection(const CAppInformation *appInfo, QObject *parent) :
     QObject(parent),
     m_status(ConnectionStatusDisconnected),
     m_appInfo(appInfo),
+    m_requestTimeout(s_defaultRequestTimeout),
+    m_expiredRequestsCount(0),
+    m_recoveredRequestsCount(0),
     m_transport(0),
     m_authTimer(0),
     m_pingTimer(0),
+    m_pongTimer(0),
     m_ackTimer(new QTimer(this)),
+    m_requestTimer(new QTimer(this)),
+    m_saltTimer(new QTimer(this)),
+    m_futureSaltsTimer(new QTimer(this)),
     m_authState(AuthStateNone),
     m_authId(0),
     m_authKeyAuxHash(0),
     m_serverSalt(0),
+    m_futureSaltsRequestId(0),
     m_sessionId(0),
+    m_messageProjection(nullptr),
     m_lastSentPingId(0),
     m_lastReceivedPingTime(0),
     m_lastSentPingTime(0),
+    m_smoothedRtt(0),
+    m_rttVariance(0),
     m_sequenceNumber(0),
+    m_outgoingMessagesCount(0),
+    m_outgoingMessagesSize(0),
+    m_maxInFlightRequests(s_defaultMaxInFlightRequests),
+    m_backpressureActive(false),
+    m_outgoingFlushScheduled(false),
+    m_messageBatchingEnabled(true),
+    m_savedAckPackagesCount(0),
+    m_gzipPackingThreshold(s_defaultGzipPackingThreshold),
     m_contentRelatedMessages(0),
     m_pingInterval(0),
     m_serverDisconnectionExtraTime(0),
@@ -84,6 +136,13 @@ CTelegramConnection::CTelegramConnection(const CAppInformation *appInfo, QObject
     m_ackTimer->setInterval(90 * 1000);
     m_ackTimer->setSingleShot(true);
     connect(m_ackTimer, &QTimer::timeout, this, &CTelegramConnection::onTimeToAckMessages);
+    m_requestTimer->setInterval(s_requestCheckInterval);
+    connect(m_requestTimer, &QTimer::timeout, this, &CTelegramConnection::onTimeToCheckRequests);
+    m_saltTimer->setSingleShot(true);
+    connect(m_saltTimer, &QTimer::timeout, this, &CTelegramConnection::updateServerSalt);
+    m_futureSaltsTimer->setSingleShot(true);
+    m_futureSaltsTimer->setInterval(s_futureSaltsRequestTimeout);
+    connect(m_futureSaltsTimer, &QTimer::timeout, this, &CTelegramConnection::onFutureSaltsTimeout);
 }
 
 void CTelegramConnection::setDcInfo(const TLDcOption &newDcInfo)
@@ -112,7 +171,31 @@ void CTelegramConnection::connectToDc()
 
     setStatus(ConnectionStatusConnecting, ConnectionStatusReasonLocal);
     setAuthState(AuthStateNone);
-    m_transport->connectToHost(m_dcInfo.ipAddress, m_dcInfo.port);
+    m_transport->setConnectionTimeout(connectionTimeout());
+    if (m_alternativeAddresses.isEmpty()) {
+        m_transport->connectToHost(m_dcInfo.ipAddress, m_dcInfo.port);
+    } else {
+        QVector<Telegram::DcOption> addresses = { Telegram::DcOption(m_dcInfo.ipAddress, m_dcInfo.port) };
+        for (const Telegram::DcOption &address : m_alternativeAddresses) {
+            if ((address.address != m_dcInfo.ipAddress) || (address.port != m_dcInfo.port)) {
+                addresses.append(address);
+            }
+        }
+        m_transport->connectToHosts(addresses);
+    }
+}
+
+void CTelegramConnection::setAlternativeAddresses(const QVector<Telegram::DcOption> &addresses)
+{
+    m_alternativeAddresses = addresses;
+}
+
+void CTelegramConnection::setMessageBatchingEnabled(bool enabled)
+{
+    m_messageBatchingEnabled = enabled;
+    if (!enabled) {
+        flushOutgoingMessages();
+    }
 }
 
 void CTelegramConnection::disconnectFromDc()
@@ -137,24 +220,105 @@ void CTelegramConnection::setTransport(CTelegramTransport *newTransport)
     connect(m_transport, &CTelegramTransport::stateChanged, this, &CTelegramConnection::onTransportStateChanged);
     connect(m_transport, &CTelegramTransport::packageReceived, this, &CTelegramConnection::onTransportPackageReceived);
     connect(m_transport, &CTelegramTransport::timeout, this, &CTelegramConnection::onTransportTimeout);
+    connect(m_transport, &CTelegramTransport::bytesWritten, this, &CTelegramConnection::onTransportBytesWritten);
+    if (m_capture) {
+        m_capture->attachTransport(m_transport);
+    }
+}
+
+void CTelegramConnection::setCapture(CTransportCapture *capture)
+{
+    m_capture = capture;
+    if (m_capture && m_transport) {
+        m_capture->attachTransport(m_transport);
+    }
+}
+
+void CTelegramConnection::prepareReplay(quint64 sessionId)
+{
+    // Continue the captured session, otherwise the messages are dropped.
+    // The auth state is kept as is, so the replay does not start the ping and the salts requests.
+    m_sessionId = sessionId;
+}
+
+void CTelegramConnection::setDecodingThread(QThread *thread)
+{
+    if (m_decodingWorker) {
+        m_decodingWorker->deleteLater();
+        m_decodingWorker = nullptr;
+    }
+    if (!thread) {
+        return;
+    }
+
+    // The worker has no parent to be moved to the thread. It is deleted in the thread,
+    // after the packages posted to it are decoded.
+    m_decodingWorker = new CPackageDecodingWorker();
+    m_decodingWorker->setAuthKey(m_authKey);
+    m_decodingWorker->setMessageProjection(m_messageProjection);
+    m_decodingWorker->moveToThread(thread);
+    connect(thread, &QThread::finished, m_decodingWorker.data(), &QObject::deleteLater);
+    connect(this, &QObject::destroyed, m_decodingWorker.data(), &QObject::deleteLater);
+    connect(m_decodingWorker.data(), &CPackageDecodingWorker::messageDecoded, this, &CTelegramConnection::onMessageDecoded);
+}
+
+void CTelegramConnection::setMessageProjection(MessageProjection projection)
+{
+    m_messageProjection = projection;
+    if (m_decodingWorker) {
+        m_decodingWorker->setMessageProjection(projection);
+    }
 }
 
 void CTelegramConnection::setAuthKey(const QByteArray &newAuthKey)
 {
+    memset(m_authKeyData, 0, sizeof(m_authKeyData));
     if (newAuthKey.isEmpty()) {
         m_authKey.clear();
         m_authId = 0;
         m_authKeyAuxHash = 0;
     } else {
         m_authKey = newAuthKey;
+        memcpy(m_authKeyData, m_authKey.constData(), qMin<int>(m_authKey.size(), sizeof(m_authKeyData)));
         m_authId = Utils::getFingerprints(m_authKey, Utils::Lower64Bits);
         m_authKeyAuxHash = Utils::getFingerprints(m_authKey, Utils::Lower64Bits);
     }
+    m_packageDecoder.setAuthKey(m_authKey);
+    m_incomingMessageIds.clear();
+    // The salts are bound to the auth key
+    m_futureSalts.clear();
+    m_futureSaltsRequestId = 0;
+    m_futureSaltsTimer->stop();
+    if (m_decodingWorker) {
+        QMetaObject::invokeMethod(m_decodingWorker, "setAuthKey", Qt::QueuedConnection, Q_ARG(QByteArray, m_authKey));
+    }
 #ifdef TELEGRAMQT_DEBUG_REVEAL_SECRETS
     qDebug() << Q_FUNC_INFO << "key:" << newAuthKey.toHex() << "keyId:" << m_authId << "auxHash:" << m_authKeyAuxHash;
 #endif
 }
 
+void CTelegramConnection::setFutureSalts(const QVector<SFutureSalt> &salts)
+{
+    m_futureSalts = salts;
+    std::sort(m_futureSalts.begin(), m_futureSalts.end(), [](const SFutureSalt &left, const SFutureSalt &right) {
+        return left.validSince < right.validSince;
+    });
+    updateServerSalt();
+}
+
+quint64 CTelegramConnection::getFutureSalts(quint32 count)
+{
+    QByteArray output;
+    CTelegramStream outputStream(&output, /* write */ true);
+
+    outputStream << TLValue::GetFutureSalts;
+    outputStream << count;
+
+    m_futureSaltsRequestId = sendEncryptedPackage(output, /* save package */ false);
+    m_futureSaltsTimer->start();
+    return m_futureSaltsRequestId;
+}
+
 void CTelegramConnection::setDeltaTime(const qint32 newDt)
 {
     m_deltaTime = newDt;
@@ -201,6 +365,56 @@ void CTelegramConnection::setKeepAliveSettings(quint32 interval, quint32 serverD
     }
 }
 
+quint32 CTelegramConnection::retransmissionTimeout() const
+{
+    if (!m_smoothedRtt) {
+        return s_defaultRetransmissionTimeout;
+    }
+    const qint64 timeout = m_smoothedRtt + qMax<qint64>(1, 4 * m_rttVariance);
+    return qBound<qint64>(s_minimalRetransmissionTimeout, timeout, s_maximalRetransmissionTimeout);
+}
+
+quint32 CTelegramConnection::connectionTimeout() const
+{
+    if (!m_smoothedRtt) {
+        return s_defaultRetransmissionTimeout;
+    }
+    // TCP handshake takes one round trip, the rest is a margin for the host lookup and a proxy
+    return qBound<quint32>(s_minimalConnectionTimeout, 2 * retransmissionTimeout(), s_maximalConnectionTimeout);
+}
+
+quint32 CTelegramConnection::pongTimeout() const
+{
+    // There is no sense to wait for the pong longer than the server keeps the connection,
+    // but the timeout must outlast the ping interval to let the next ping restart it.
+    const quint32 maximalTimeout = m_pingInterval + qMax(m_serverDisconnectionExtraTime, s_minimalPongTimeout);
+    if (!m_smoothedRtt) {
+        return maximalTimeout;
+    }
+    return qBound<quint32>(s_minimalPongTimeout, 2 * retransmissionTimeout(), maximalTimeout);
+}
+
+quint32 CTelegramConnection::stateRequestTimeout() const
+{
+    // Give the server a chance to answer before asking about the request state
+    return qMax(s_minimalStateRequestTimeout, 2 * retransmissionTimeout());
+}
+
+void CTelegramConnection::addRttSample(qint64 rtt)
+{
+    if ((rtt < 0) || (rtt > s_maximalRttSample)) {
+        return;
+    }
+
+    if (!m_smoothedRtt) {
+        m_smoothedRtt = qMax<qint64>(1, rtt);
+        m_rttVariance = rtt / 2;
+    } else {
+        m_rttVariance = (3 * m_rttVariance + qAbs(m_smoothedRtt - rtt)) / 4;
+        m_smoothedRtt = qMax<qint64>(1, (7 * m_smoothedRtt + rtt) / 8);
+    }
+}
+
 quint64 CTelegramConnection::requestPhoneCode(const QString &phoneNumber)
 {
     if (!m_appInfo || !m_appInfo->isValid()) {
@@ -226,15 +440,10 @@ quint64 CTelegramConnection::signUp(const QString &phoneNumber, const QString &a
 
 void CTelegramConnection::downloadFile(const TLInputFileLocation &inputLocation, quint32 offset, quint32 limit, quint32 requestId)
 {
-    if (m_requestedFilesIds.contains(requestId)) {
-        // Prevent from (really possible) repeated request.
-        return;
-    }
-
     const quint64 messageId = uploadGetFile(inputLocation, offset, limit);
     qDebug() << Q_FUNC_INFO << messageId << "offset:" << offset << "limit:" << limit << "request:" << requestId;
 
-    m_requestedFilesIds.insert(messageId, requestId);
+    m_requestTracker.setFileRequestId(messageId, requestId);
 }
 
 void CTelegramConnection::uploadFile(quint64 fileId, quint32 filePart, const QByteArray &bytes, quint32 requestId)
@@ -242,7 +451,7 @@ void CTelegramConnection::uploadFile(quint64 fileId, quint32 filePart, const QBy
     qDebug() << Q_FUNC_INFO << "id" << fileId << "part" << filePart << "size" << bytes.count() << "request" << requestId;
     const quint64 messageId = uploadSaveFilePart(fileId, filePart, bytes);
 
-    m_requestedFilesIds.insert(messageId, requestId);
+    m_requestTracker.setFileRequestId(messageId, requestId);
 }
 
 quint64 CTelegramConnection::sendMessage(const TLInputPeer &peer, const QString &message, quint64 randomMessageId)
@@ -267,7 +476,12 @@ quint64 CTelegramConnection::sendMedia(const TLInputPeer &peer, const TLInputMed
 // Generated Telegram API methods implementation
 quint64 CTelegramConnection::accountChangePhone(const QString &phoneNumber, const QString &phoneCodeHash, const QString &phoneCode)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(phoneNumber);
+    outputSize += CTelegramStream::serializedSize(phoneCodeHash);
+    outputSize += CTelegramStream::serializedSize(phoneCode);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AccountChangePhone;
     outputStream << phoneNumber;
@@ -278,7 +492,10 @@ quint64 CTelegramConnection::accountChangePhone(const QString &phoneNumber, cons
 
 quint64 CTelegramConnection::accountCheckUsername(const QString &username)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(username);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AccountCheckUsername;
     outputStream << username;
@@ -287,7 +504,10 @@ quint64 CTelegramConnection::accountCheckUsername(const QString &username)
 
 quint64 CTelegramConnection::accountDeleteAccount(const QString &reason)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(reason);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AccountDeleteAccount;
     outputStream << reason;
@@ -296,7 +516,9 @@ quint64 CTelegramConnection::accountDeleteAccount(const QString &reason)
 
 quint64 CTelegramConnection::accountGetAccountTTL()
 {
+    quint32 outputSize = 4;
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AccountGetAccountTTL;
     return sendEncryptedPackage(output);
@@ -304,7 +526,9 @@ quint64 CTelegramConnection::accountGetAccountTTL()
 
 quint64 CTelegramConnection::accountGetAuthorizations()
 {
+    quint32 outputSize = 4;
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AccountGetAuthorizations;
     return sendEncryptedPackage(output);
@@ -312,7 +536,10 @@ quint64 CTelegramConnection::accountGetAuthorizations()
 
 quint64 CTelegramConnection::accountGetNotifySettings(const TLInputNotifyPeer &peer)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(peer);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AccountGetNotifySettings;
     outputStream << peer;
@@ -321,7 +548,9 @@ quint64 CTelegramConnection::accountGetNotifySettings(const TLInputNotifyPeer &p
 
 quint64 CTelegramConnection::accountGetPassword()
 {
+    quint32 outputSize = 4;
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AccountGetPassword;
     return sendEncryptedPackage(output);
@@ -329,7 +558,10 @@ quint64 CTelegramConnection::accountGetPassword()
 
 quint64 CTelegramConnection::accountGetPasswordSettings(const QByteArray &currentPasswordHash)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(currentPasswordHash);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AccountGetPasswordSettings;
     outputStream << currentPasswordHash;
@@ -338,7 +570,10 @@ quint64 CTelegramConnection::accountGetPasswordSettings(const QByteArray &curren
 
 quint64 CTelegramConnection::accountGetPrivacy(const TLInputPrivacyKey &key)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(key);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AccountGetPrivacy;
     outputStream << key;
@@ -347,7 +582,9 @@ quint64 CTelegramConnection::accountGetPrivacy(const TLInputPrivacyKey &key)
 
 quint64 CTelegramConnection::accountGetWallPapers()
 {
+    quint32 outputSize = 4;
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AccountGetWallPapers;
     return sendEncryptedPackage(output);
@@ -355,7 +592,16 @@ quint64 CTelegramConnection::accountGetWallPapers()
 
 quint64 CTelegramConnection::accountRegisterDevice(quint32 tokenType, const QString &token, const QString &deviceModel, const QString &systemVersion, const QString &appVersion, bool appSandbox, const QString &langCode)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(tokenType);
+    outputSize += CTelegramStream::serializedSize(token);
+    outputSize += CTelegramStream::serializedSize(deviceModel);
+    outputSize += CTelegramStream::serializedSize(systemVersion);
+    outputSize += CTelegramStream::serializedSize(appVersion);
+    outputSize += CTelegramStream::serializedSize(appSandbox);
+    outputSize += CTelegramStream::serializedSize(langCode);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AccountRegisterDevice;
     outputStream << tokenType;
@@ -370,7 +616,11 @@ quint64 CTelegramConnection::accountRegisterDevice(quint32 tokenType, const QStr
 
 quint64 CTelegramConnection::accountReportPeer(const TLInputPeer &peer, const TLReportReason &reason)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(reason);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AccountReportPeer;
     outputStream << peer;
@@ -380,7 +630,10 @@ quint64 CTelegramConnection::accountReportPeer(const TLInputPeer &peer, const TL
 
 quint64 CTelegramConnection::accountResetAuthorization(quint64 hash)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(hash);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AccountResetAuthorization;
     outputStream << hash;
@@ -389,7 +642,9 @@ quint64 CTelegramConnection::accountResetAuthorization(quint64 hash)
 
 quint64 CTelegramConnection::accountResetNotifySettings()
 {
+    quint32 outputSize = 4;
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AccountResetNotifySettings;
     return sendEncryptedPackage(output);
@@ -397,7 +652,10 @@ quint64 CTelegramConnection::accountResetNotifySettings()
 
 quint64 CTelegramConnection::accountSendChangePhoneCode(const QString &phoneNumber)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(phoneNumber);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AccountSendChangePhoneCode;
     outputStream << phoneNumber;
@@ -406,7 +664,10 @@ quint64 CTelegramConnection::accountSendChangePhoneCode(const QString &phoneNumb
 
 quint64 CTelegramConnection::accountSetAccountTTL(const TLAccountDaysTTL &ttl)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(ttl);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AccountSetAccountTTL;
     outputStream << ttl;
@@ -415,7 +676,11 @@ quint64 CTelegramConnection::accountSetAccountTTL(const TLAccountDaysTTL &ttl)
 
 quint64 CTelegramConnection::accountSetPrivacy(const TLInputPrivacyKey &key, const TLVector<TLInputPrivacyRule> &rules)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(key);
+    outputSize += CTelegramStream::serializedSize(rules);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AccountSetPrivacy;
     outputStream << key;
@@ -425,7 +690,11 @@ quint64 CTelegramConnection::accountSetPrivacy(const TLInputPrivacyKey &key, con
 
 quint64 CTelegramConnection::accountUnregisterDevice(quint32 tokenType, const QString &token)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(tokenType);
+    outputSize += CTelegramStream::serializedSize(token);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AccountUnregisterDevice;
     outputStream << tokenType;
@@ -435,7 +704,10 @@ quint64 CTelegramConnection::accountUnregisterDevice(quint32 tokenType, const QS
 
 quint64 CTelegramConnection::accountUpdateDeviceLocked(quint32 period)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(period);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AccountUpdateDeviceLocked;
     outputStream << period;
@@ -444,7 +716,11 @@ quint64 CTelegramConnection::accountUpdateDeviceLocked(quint32 period)
 
 quint64 CTelegramConnection::accountUpdateNotifySettings(const TLInputNotifyPeer &peer, const TLInputPeerNotifySettings &settings)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(settings);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AccountUpdateNotifySettings;
     outputStream << peer;
@@ -454,7 +730,11 @@ quint64 CTelegramConnection::accountUpdateNotifySettings(const TLInputNotifyPeer
 
 quint64 CTelegramConnection::accountUpdatePasswordSettings(const QByteArray &currentPasswordHash, const TLAccountPasswordInputSettings &newSettings)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(currentPasswordHash);
+    outputSize += CTelegramStream::serializedSize(newSettings);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AccountUpdatePasswordSettings;
     outputStream << currentPasswordHash;
@@ -464,7 +744,11 @@ quint64 CTelegramConnection::accountUpdatePasswordSettings(const QByteArray &cur
 
 quint64 CTelegramConnection::accountUpdateProfile(const QString &firstName, const QString &lastName)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(firstName);
+    outputSize += CTelegramStream::serializedSize(lastName);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AccountUpdateProfile;
     outputStream << firstName;
@@ -474,7 +758,10 @@ quint64 CTelegramConnection::accountUpdateProfile(const QString &firstName, cons
 
 quint64 CTelegramConnection::accountUpdateStatus(bool offline)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(offline);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AccountUpdateStatus;
     outputStream << offline;
@@ -483,7 +770,10 @@ quint64 CTelegramConnection::accountUpdateStatus(bool offline)
 
 quint64 CTelegramConnection::accountUpdateUsername(const QString &username)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(username);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AccountUpdateUsername;
     outputStream << username;
@@ -492,7 +782,13 @@ quint64 CTelegramConnection::accountUpdateUsername(const QString &username)
 
 quint64 CTelegramConnection::authBindTempAuthKey(quint64 permAuthKeyId, quint64 nonce, quint32 expiresAt, const QByteArray &encryptedMessage)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(permAuthKeyId);
+    outputSize += CTelegramStream::serializedSize(nonce);
+    outputSize += CTelegramStream::serializedSize(expiresAt);
+    outputSize += CTelegramStream::serializedSize(encryptedMessage);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AuthBindTempAuthKey;
     outputStream << permAuthKeyId;
@@ -504,7 +800,10 @@ quint64 CTelegramConnection::authBindTempAuthKey(quint64 permAuthKeyId, quint64
 
 quint64 CTelegramConnection::authCheckPassword(const QByteArray &passwordHash)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(passwordHash);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AuthCheckPassword;
     outputStream << passwordHash;
@@ -513,7 +812,10 @@ quint64 CTelegramConnection::authCheckPassword(const QByteArray &passwordHash)
 
 quint64 CTelegramConnection::authCheckPhone(const QString &phoneNumber)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(phoneNumber);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AuthCheckPhone;
     outputStream << phoneNumber;
@@ -522,7 +824,10 @@ quint64 CTelegramConnection::authCheckPhone(const QString &phoneNumber)
 
 quint64 CTelegramConnection::authExportAuthorization(quint32 dcId)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(dcId);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AuthExportAuthorization;
     outputStream << dcId;
@@ -531,7 +836,11 @@ quint64 CTelegramConnection::authExportAuthorization(quint32 dcId)
 
 quint64 CTelegramConnection::authImportAuthorization(quint32 id, const QByteArray &bytes)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(id);
+    outputSize += CTelegramStream::serializedSize(bytes);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AuthImportAuthorization;
     outputStream << id;
@@ -541,7 +850,13 @@ quint64 CTelegramConnection::authImportAuthorization(quint32 id, const QByteArra
 
 quint64 CTelegramConnection::authImportBotAuthorization(quint32 flags, quint32 apiId, const QString &apiHash, const QString &botAuthToken)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(flags);
+    outputSize += CTelegramStream::serializedSize(apiId);
+    outputSize += CTelegramStream::serializedSize(apiHash);
+    outputSize += CTelegramStream::serializedSize(botAuthToken);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AuthImportBotAuthorization;
     outputStream << flags;
@@ -553,7 +868,9 @@ quint64 CTelegramConnection::authImportBotAuthorization(quint32 flags, quint32 a
 
 quint64 CTelegramConnection::authLogOut()
 {
+    quint32 outputSize = 4;
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AuthLogOut;
     return sendEncryptedPackage(output);
@@ -561,7 +878,10 @@ quint64 CTelegramConnection::authLogOut()
 
 quint64 CTelegramConnection::authRecoverPassword(const QString &code)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(code);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AuthRecoverPassword;
     outputStream << code;
@@ -570,7 +890,9 @@ quint64 CTelegramConnection::authRecoverPassword(const QString &code)
 
 quint64 CTelegramConnection::authRequestPasswordRecovery()
 {
+    quint32 outputSize = 4;
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AuthRequestPasswordRecovery;
     return sendEncryptedPackage(output);
@@ -578,7 +900,9 @@ quint64 CTelegramConnection::authRequestPasswordRecovery()
 
 quint64 CTelegramConnection::authResetAuthorizations()
 {
+    quint32 outputSize = 4;
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AuthResetAuthorizations;
     return sendEncryptedPackage(output);
@@ -586,7 +910,11 @@ quint64 CTelegramConnection::authResetAuthorizations()
 
 quint64 CTelegramConnection::authSendCall(const QString &phoneNumber, const QString &phoneCodeHash)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(phoneNumber);
+    outputSize += CTelegramStream::serializedSize(phoneCodeHash);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AuthSendCall;
     outputStream << phoneNumber;
@@ -596,7 +924,14 @@ quint64 CTelegramConnection::authSendCall(const QString &phoneNumber, const QStr
 
 quint64 CTelegramConnection::authSendCode(const QString &phoneNumber, quint32 smsType, quint32 apiId, const QString &apiHash, const QString &langCode)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(phoneNumber);
+    outputSize += CTelegramStream::serializedSize(smsType);
+    outputSize += CTelegramStream::serializedSize(apiId);
+    outputSize += CTelegramStream::serializedSize(apiHash);
+    outputSize += CTelegramStream::serializedSize(langCode);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AuthSendCode;
     outputStream << phoneNumber;
@@ -609,7 +944,11 @@ quint64 CTelegramConnection::authSendCode(const QString &phoneNumber, quint32 sm
 
 quint64 CTelegramConnection::authSendInvites(const TLVector<QString> &phoneNumbers, const QString &message)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(phoneNumbers);
+    outputSize += CTelegramStream::serializedSize(message);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AuthSendInvites;
     outputStream << phoneNumbers;
@@ -619,7 +958,11 @@ quint64 CTelegramConnection::authSendInvites(const TLVector<QString> &phoneNumbe
 
 quint64 CTelegramConnection::authSendSms(const QString &phoneNumber, const QString &phoneCodeHash)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(phoneNumber);
+    outputSize += CTelegramStream::serializedSize(phoneCodeHash);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AuthSendSms;
     outputStream << phoneNumber;
@@ -629,7 +972,12 @@ quint64 CTelegramConnection::authSendSms(const QString &phoneNumber, const QStri
 
 quint64 CTelegramConnection::authSignIn(const QString &phoneNumber, const QString &phoneCodeHash, const QString &phoneCode)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(phoneNumber);
+    outputSize += CTelegramStream::serializedSize(phoneCodeHash);
+    outputSize += CTelegramStream::serializedSize(phoneCode);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AuthSignIn;
     outputStream << phoneNumber;
@@ -640,7 +988,14 @@ quint64 CTelegramConnection::authSignIn(const QString &phoneNumber, const QStrin
 
 quint64 CTelegramConnection::authSignUp(const QString &phoneNumber, const QString &phoneCodeHash, const QString &phoneCode, const QString &firstName, const QString &lastName)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(phoneNumber);
+    outputSize += CTelegramStream::serializedSize(phoneCodeHash);
+    outputSize += CTelegramStream::serializedSize(phoneCode);
+    outputSize += CTelegramStream::serializedSize(firstName);
+    outputSize += CTelegramStream::serializedSize(lastName);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::AuthSignUp;
     outputStream << phoneNumber;
@@ -653,7 +1008,11 @@ quint64 CTelegramConnection::authSignUp(const QString &phoneNumber, const QStrin
 
 quint64 CTelegramConnection::channelsCheckUsername(const TLInputChannel &channel, const QString &username)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(channel);
+    outputSize += CTelegramStream::serializedSize(username);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsCheckUsername;
     outputStream << channel;
@@ -663,7 +1022,12 @@ quint64 CTelegramConnection::channelsCheckUsername(const TLInputChannel &channel
 
 quint64 CTelegramConnection::channelsCreateChannel(quint32 flags, const QString &title, const QString &about)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(flags);
+    outputSize += CTelegramStream::serializedSize(title);
+    outputSize += CTelegramStream::serializedSize(about);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsCreateChannel;
     outputStream << flags;
@@ -676,7 +1040,10 @@ quint64 CTelegramConnection::channelsCreateChannel(quint32 flags, const QString
 
 quint64 CTelegramConnection::channelsDeleteChannel(const TLInputChannel &channel)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(channel);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsDeleteChannel;
     outputStream << channel;
@@ -685,7 +1052,11 @@ quint64 CTelegramConnection::channelsDeleteChannel(const TLInputChannel &channel
 
 quint64 CTelegramConnection::channelsDeleteMessages(const TLInputChannel &channel, const TLVector<quint32> &id)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(channel);
+    outputSize += CTelegramStream::serializedSize(id);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsDeleteMessages;
     outputStream << channel;
@@ -695,7 +1066,11 @@ quint64 CTelegramConnection::channelsDeleteMessages(const TLInputChannel &channe
 
 quint64 CTelegramConnection::channelsDeleteUserHistory(const TLInputChannel &channel, const TLInputUser &userId)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(channel);
+    outputSize += CTelegramStream::serializedSize(userId);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsDeleteUserHistory;
     outputStream << channel;
@@ -705,7 +1080,11 @@ quint64 CTelegramConnection::channelsDeleteUserHistory(const TLInputChannel &cha
 
 quint64 CTelegramConnection::channelsEditAbout(const TLInputChannel &channel, const QString &about)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(channel);
+    outputSize += CTelegramStream::serializedSize(about);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsEditAbout;
     outputStream << channel;
@@ -715,7 +1094,12 @@ quint64 CTelegramConnection::channelsEditAbout(const TLInputChannel &channel, co
 
 quint64 CTelegramConnection::channelsEditAdmin(const TLInputChannel &channel, const TLInputUser &userId, const TLChannelParticipantRole &role)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(channel);
+    outputSize += CTelegramStream::serializedSize(userId);
+    outputSize += CTelegramStream::serializedSize(role);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsEditAdmin;
     outputStream << channel;
@@ -726,7 +1110,11 @@ quint64 CTelegramConnection::channelsEditAdmin(const TLInputChannel &channel, co
 
 quint64 CTelegramConnection::channelsEditPhoto(const TLInputChannel &channel, const TLInputChatPhoto &photo)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(channel);
+    outputSize += CTelegramStream::serializedSize(photo);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsEditPhoto;
     outputStream << channel;
@@ -736,7 +1124,11 @@ quint64 CTelegramConnection::channelsEditPhoto(const TLInputChannel &channel, co
 
 quint64 CTelegramConnection::channelsEditTitle(const TLInputChannel &channel, const QString &title)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(channel);
+    outputSize += CTelegramStream::serializedSize(title);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsEditTitle;
     outputStream << channel;
@@ -746,7 +1138,10 @@ quint64 CTelegramConnection::channelsEditTitle(const TLInputChannel &channel, co
 
 quint64 CTelegramConnection::channelsExportInvite(const TLInputChannel &channel)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(channel);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsExportInvite;
     outputStream << channel;
@@ -755,7 +1150,10 @@ quint64 CTelegramConnection::channelsExportInvite(const TLInputChannel &channel)
 
 quint64 CTelegramConnection::channelsGetChannels(const TLVector<TLInputChannel> &id)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(id);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsGetChannels;
     outputStream << id;
@@ -764,7 +1162,11 @@ quint64 CTelegramConnection::channelsGetChannels(const TLVector<TLInputChannel>
 
 quint64 CTelegramConnection::channelsGetDialogs(quint32 offset, quint32 limit)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(offset);
+    outputSize += CTelegramStream::serializedSize(limit);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsGetDialogs;
     outputStream << offset;
@@ -774,7 +1176,10 @@ quint64 CTelegramConnection::channelsGetDialogs(quint32 offset, quint32 limit)
 
 quint64 CTelegramConnection::channelsGetFullChannel(const TLInputChannel &channel)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(channel);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsGetFullChannel;
     outputStream << channel;
@@ -783,7 +1188,15 @@ quint64 CTelegramConnection::channelsGetFullChannel(const TLInputChannel &channe
 
 quint64 CTelegramConnection::channelsGetImportantHistory(const TLInputChannel &channel, quint32 offsetId, quint32 addOffset, quint32 limit, quint32 maxId, quint32 minId)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(channel);
+    outputSize += CTelegramStream::serializedSize(offsetId);
+    outputSize += CTelegramStream::serializedSize(addOffset);
+    outputSize += CTelegramStream::serializedSize(limit);
+    outputSize += CTelegramStream::serializedSize(maxId);
+    outputSize += CTelegramStream::serializedSize(minId);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsGetImportantHistory;
     outputStream << channel;
@@ -797,7 +1210,11 @@ quint64 CTelegramConnection::channelsGetImportantHistory(const TLInputChannel &c
 
 quint64 CTelegramConnection::channelsGetMessages(const TLInputChannel &channel, const TLVector<quint32> &id)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(channel);
+    outputSize += CTelegramStream::serializedSize(id);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsGetMessages;
     outputStream << channel;
@@ -807,7 +1224,11 @@ quint64 CTelegramConnection::channelsGetMessages(const TLInputChannel &channel,
 
 quint64 CTelegramConnection::channelsGetParticipant(const TLInputChannel &channel, const TLInputUser &userId)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(channel);
+    outputSize += CTelegramStream::serializedSize(userId);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsGetParticipant;
     outputStream << channel;
@@ -817,7 +1238,13 @@ quint64 CTelegramConnection::channelsGetParticipant(const TLInputChannel &channe
 
 quint64 CTelegramConnection::channelsGetParticipants(const TLInputChannel &channel, const TLChannelParticipantsFilter &filter, quint32 offset, quint32 limit)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(channel);
+    outputSize += CTelegramStream::serializedSize(filter);
+    outputSize += CTelegramStream::serializedSize(offset);
+    outputSize += CTelegramStream::serializedSize(limit);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsGetParticipants;
     outputStream << channel;
@@ -829,7 +1256,11 @@ quint64 CTelegramConnection::channelsGetParticipants(const TLInputChannel &chann
 
 quint64 CTelegramConnection::channelsInviteToChannel(const TLInputChannel &channel, const TLVector<TLInputUser> &users)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(channel);
+    outputSize += CTelegramStream::serializedSize(users);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsInviteToChannel;
     outputStream << channel;
@@ -839,7 +1270,10 @@ quint64 CTelegramConnection::channelsInviteToChannel(const TLInputChannel &chann
 
 quint64 CTelegramConnection::channelsJoinChannel(const TLInputChannel &channel)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(channel);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsJoinChannel;
     outputStream << channel;
@@ -848,7 +1282,12 @@ quint64 CTelegramConnection::channelsJoinChannel(const TLInputChannel &channel)
 
 quint64 CTelegramConnection::channelsKickFromChannel(const TLInputChannel &channel, const TLInputUser &userId, bool kicked)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(channel);
+    outputSize += CTelegramStream::serializedSize(userId);
+    outputSize += CTelegramStream::serializedSize(kicked);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsKickFromChannel;
     outputStream << channel;
@@ -859,7 +1298,10 @@ quint64 CTelegramConnection::channelsKickFromChannel(const TLInputChannel &chann
 
 quint64 CTelegramConnection::channelsLeaveChannel(const TLInputChannel &channel)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(channel);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsLeaveChannel;
     outputStream << channel;
@@ -868,7 +1310,11 @@ quint64 CTelegramConnection::channelsLeaveChannel(const TLInputChannel &channel)
 
 quint64 CTelegramConnection::channelsReadHistory(const TLInputChannel &channel, quint32 maxId)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(channel);
+    outputSize += CTelegramStream::serializedSize(maxId);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsReadHistory;
     outputStream << channel;
@@ -878,7 +1324,12 @@ quint64 CTelegramConnection::channelsReadHistory(const TLInputChannel &channel,
 
 quint64 CTelegramConnection::channelsReportSpam(const TLInputChannel &channel, const TLInputUser &userId, const TLVector<quint32> &id)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(channel);
+    outputSize += CTelegramStream::serializedSize(userId);
+    outputSize += CTelegramStream::serializedSize(id);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsReportSpam;
     outputStream << channel;
@@ -889,7 +1340,11 @@ quint64 CTelegramConnection::channelsReportSpam(const TLInputChannel &channel, c
 
 quint64 CTelegramConnection::channelsToggleComments(const TLInputChannel &channel, bool enabled)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(channel);
+    outputSize += CTelegramStream::serializedSize(enabled);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsToggleComments;
     outputStream << channel;
@@ -899,7 +1354,11 @@ quint64 CTelegramConnection::channelsToggleComments(const TLInputChannel &channe
 
 quint64 CTelegramConnection::channelsUpdateUsername(const TLInputChannel &channel, const QString &username)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(channel);
+    outputSize += CTelegramStream::serializedSize(username);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ChannelsUpdateUsername;
     outputStream << channel;
@@ -909,7 +1368,10 @@ quint64 CTelegramConnection::channelsUpdateUsername(const TLInputChannel &channe
 
 quint64 CTelegramConnection::contactsBlock(const TLInputUser &id)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(id);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ContactsBlock;
     outputStream << id;
@@ -918,7 +1380,10 @@ quint64 CTelegramConnection::contactsBlock(const TLInputUser &id)
 
 quint64 CTelegramConnection::contactsDeleteContact(const TLInputUser &id)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(id);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ContactsDeleteContact;
     outputStream << id;
@@ -927,7 +1392,10 @@ quint64 CTelegramConnection::contactsDeleteContact(const TLInputUser &id)
 
 quint64 CTelegramConnection::contactsDeleteContacts(const TLVector<TLInputUser> &id)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(id);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ContactsDeleteContacts;
     outputStream << id;
@@ -936,7 +1404,9 @@ quint64 CTelegramConnection::contactsDeleteContacts(const TLVector<TLInputUser>
 
 quint64 CTelegramConnection::contactsExportCard()
 {
+    quint32 outputSize = 4;
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ContactsExportCard;
     return sendEncryptedPackage(output);
@@ -944,7 +1414,11 @@ quint64 CTelegramConnection::contactsExportCard()
 
 quint64 CTelegramConnection::contactsGetBlocked(quint32 offset, quint32 limit)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(offset);
+    outputSize += CTelegramStream::serializedSize(limit);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ContactsGetBlocked;
     outputStream << offset;
@@ -954,7 +1428,10 @@ quint64 CTelegramConnection::contactsGetBlocked(quint32 offset, quint32 limit)
 
 quint64 CTelegramConnection::contactsGetContacts(const QString &hash)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(hash);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ContactsGetContacts;
     outputStream << hash;
@@ -963,7 +1440,9 @@ quint64 CTelegramConnection::contactsGetContacts(const QString &hash)
 
 quint64 CTelegramConnection::contactsGetStatuses()
 {
+    quint32 outputSize = 4;
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ContactsGetStatuses;
     return sendEncryptedPackage(output);
@@ -971,7 +1450,10 @@ quint64 CTelegramConnection::contactsGetStatuses()
 
 quint64 CTelegramConnection::contactsGetSuggested(quint32 limit)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(limit);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ContactsGetSuggested;
     outputStream << limit;
@@ -980,7 +1462,10 @@ quint64 CTelegramConnection::contactsGetSuggested(quint32 limit)
 
 quint64 CTelegramConnection::contactsImportCard(const TLVector<quint32> &exportCard)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(exportCard);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ContactsImportCard;
     outputStream << exportCard;
@@ -989,7 +1474,11 @@ quint64 CTelegramConnection::contactsImportCard(const TLVector<quint32> &exportC
 
 quint64 CTelegramConnection::contactsImportContacts(const TLVector<TLInputContact> &contacts, bool replace)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(contacts);
+    outputSize += CTelegramStream::serializedSize(replace);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ContactsImportContacts;
     outputStream << contacts;
@@ -999,7 +1488,10 @@ quint64 CTelegramConnection::contactsImportContacts(const TLVector<TLInputContac
 
 quint64 CTelegramConnection::contactsResolveUsername(const QString &username)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(username);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ContactsResolveUsername;
     outputStream << username;
@@ -1008,7 +1500,11 @@ quint64 CTelegramConnection::contactsResolveUsername(const QString &username)
 
 quint64 CTelegramConnection::contactsSearch(const QString &q, quint32 limit)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(q);
+    outputSize += CTelegramStream::serializedSize(limit);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ContactsSearch;
     outputStream << q;
@@ -1018,7 +1514,10 @@ quint64 CTelegramConnection::contactsSearch(const QString &q, quint32 limit)
 
 quint64 CTelegramConnection::contactsUnblock(const TLInputUser &id)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(id);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::ContactsUnblock;
     outputStream << id;
@@ -1027,7 +1526,13 @@ quint64 CTelegramConnection::contactsUnblock(const TLInputUser &id)
 
 quint64 CTelegramConnection::helpGetAppChangelog(const QString &deviceModel, const QString &systemVersion, const QString &appVersion, const QString &langCode)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(deviceModel);
+    outputSize += CTelegramStream::serializedSize(systemVersion);
+    outputSize += CTelegramStream::serializedSize(appVersion);
+    outputSize += CTelegramStream::serializedSize(langCode);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::HelpGetAppChangelog;
     outputStream << deviceModel;
@@ -1039,7 +1544,13 @@ quint64 CTelegramConnection::helpGetAppChangelog(const QString &deviceModel, con
 
 quint64 CTelegramConnection::helpGetAppUpdate(const QString &deviceModel, const QString &systemVersion, const QString &appVersion, const QString &langCode)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(deviceModel);
+    outputSize += CTelegramStream::serializedSize(systemVersion);
+    outputSize += CTelegramStream::serializedSize(appVersion);
+    outputSize += CTelegramStream::serializedSize(langCode);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::HelpGetAppUpdate;
     outputStream << deviceModel;
@@ -1051,7 +1562,9 @@ quint64 CTelegramConnection::helpGetAppUpdate(const QString &deviceModel, const
 
 quint64 CTelegramConnection::helpGetConfig()
 {
+    quint32 outputSize = 4;
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::HelpGetConfig;
     return sendEncryptedPackage(output);
@@ -1059,7 +1572,10 @@ quint64 CTelegramConnection::helpGetConfig()
 
 quint64 CTelegramConnection::helpGetInviteText(const QString &langCode)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(langCode);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::HelpGetInviteText;
     outputStream << langCode;
@@ -1068,7 +1584,9 @@ quint64 CTelegramConnection::helpGetInviteText(const QString &langCode)
 
 quint64 CTelegramConnection::helpGetNearestDc()
 {
+    quint32 outputSize = 4;
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::HelpGetNearestDc;
     return sendEncryptedPackage(output);
@@ -1076,7 +1594,9 @@ quint64 CTelegramConnection::helpGetNearestDc()
 
 quint64 CTelegramConnection::helpGetSupport()
 {
+    quint32 outputSize = 4;
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::HelpGetSupport;
     return sendEncryptedPackage(output);
@@ -1084,7 +1604,10 @@ quint64 CTelegramConnection::helpGetSupport()
 
 quint64 CTelegramConnection::helpGetTermsOfService(const QString &langCode)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(langCode);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::HelpGetTermsOfService;
     outputStream << langCode;
@@ -1093,7 +1616,10 @@ quint64 CTelegramConnection::helpGetTermsOfService(const QString &langCode)
 
 quint64 CTelegramConnection::helpSaveAppLog(const TLVector<TLInputAppEvent> &events)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(events);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::HelpSaveAppLog;
     outputStream << events;
@@ -1102,7 +1628,12 @@ quint64 CTelegramConnection::helpSaveAppLog(const TLVector<TLInputAppEvent> &eve
 
 quint64 CTelegramConnection::messagesAcceptEncryption(const TLInputEncryptedChat &peer, const QByteArray &gB, quint64 keyFingerprint)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(gB);
+    outputSize += CTelegramStream::serializedSize(keyFingerprint);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesAcceptEncryption;
     outputStream << peer;
@@ -1113,7 +1644,12 @@ quint64 CTelegramConnection::messagesAcceptEncryption(const TLInputEncryptedChat
 
 quint64 CTelegramConnection::messagesAddChatUser(quint32 chatId, const TLInputUser &userId, quint32 fwdLimit)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(chatId);
+    outputSize += CTelegramStream::serializedSize(userId);
+    outputSize += CTelegramStream::serializedSize(fwdLimit);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesAddChatUser;
     outputStream << chatId;
@@ -1124,7 +1660,10 @@ quint64 CTelegramConnection::messagesAddChatUser(quint32 chatId, const TLInputUs
 
 quint64 CTelegramConnection::messagesCheckChatInvite(const QString &hash)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(hash);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesCheckChatInvite;
     outputStream << hash;
@@ -1133,7 +1672,11 @@ quint64 CTelegramConnection::messagesCheckChatInvite(const QString &hash)
 
 quint64 CTelegramConnection::messagesCreateChat(const TLVector<TLInputUser> &users, const QString &title)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(users);
+    outputSize += CTelegramStream::serializedSize(title);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesCreateChat;
     outputStream << users;
@@ -1143,7 +1686,11 @@ quint64 CTelegramConnection::messagesCreateChat(const TLVector<TLInputUser> &use
 
 quint64 CTelegramConnection::messagesDeleteChatUser(quint32 chatId, const TLInputUser &userId)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(chatId);
+    outputSize += CTelegramStream::serializedSize(userId);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesDeleteChatUser;
     outputStream << chatId;
@@ -1153,7 +1700,11 @@ quint64 CTelegramConnection::messagesDeleteChatUser(quint32 chatId, const TLInpu
 
 quint64 CTelegramConnection::messagesDeleteHistory(const TLInputPeer &peer, quint32 maxId)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(maxId);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesDeleteHistory;
     outputStream << peer;
@@ -1163,7 +1714,10 @@ quint64 CTelegramConnection::messagesDeleteHistory(const TLInputPeer &peer, quin
 
 quint64 CTelegramConnection::messagesDeleteMessages(const TLVector<quint32> &id)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(id);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesDeleteMessages;
     outputStream << id;
@@ -1172,7 +1726,10 @@ quint64 CTelegramConnection::messagesDeleteMessages(const TLVector<quint32> &id)
 
 quint64 CTelegramConnection::messagesDiscardEncryption(quint32 chatId)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(chatId);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesDiscardEncryption;
     outputStream << chatId;
@@ -1181,7 +1738,12 @@ quint64 CTelegramConnection::messagesDiscardEncryption(quint32 chatId)
 
 quint64 CTelegramConnection::messagesEditChatAdmin(quint32 chatId, const TLInputUser &userId, bool isAdmin)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(chatId);
+    outputSize += CTelegramStream::serializedSize(userId);
+    outputSize += CTelegramStream::serializedSize(isAdmin);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesEditChatAdmin;
     outputStream << chatId;
@@ -1192,7 +1754,11 @@ quint64 CTelegramConnection::messagesEditChatAdmin(quint32 chatId, const TLInput
 
 quint64 CTelegramConnection::messagesEditChatPhoto(quint32 chatId, const TLInputChatPhoto &photo)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(chatId);
+    outputSize += CTelegramStream::serializedSize(photo);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesEditChatPhoto;
     outputStream << chatId;
@@ -1202,7 +1768,11 @@ quint64 CTelegramConnection::messagesEditChatPhoto(quint32 chatId, const TLInput
 
 quint64 CTelegramConnection::messagesEditChatTitle(quint32 chatId, const QString &title)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(chatId);
+    outputSize += CTelegramStream::serializedSize(title);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesEditChatTitle;
     outputStream << chatId;
@@ -1212,7 +1782,10 @@ quint64 CTelegramConnection::messagesEditChatTitle(quint32 chatId, const QString
 
 quint64 CTelegramConnection::messagesExportChatInvite(quint32 chatId)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(chatId);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesExportChatInvite;
     outputStream << chatId;
@@ -1221,7 +1794,12 @@ quint64 CTelegramConnection::messagesExportChatInvite(quint32 chatId)
 
 quint64 CTelegramConnection::messagesForwardMessage(const TLInputPeer &peer, quint32 id, quint64 randomId)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(id);
+    outputSize += CTelegramStream::serializedSize(randomId);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesForwardMessage;
     outputStream << peer;
@@ -1232,7 +1810,14 @@ quint64 CTelegramConnection::messagesForwardMessage(const TLInputPeer &peer, qui
 
 quint64 CTelegramConnection::messagesForwardMessages(quint32 flags, const TLInputPeer &fromPeer, const TLVector<quint32> &id, const TLVector<quint64> &randomId, const TLInputPeer &toPeer)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(flags);
+    outputSize += CTelegramStream::serializedSize(fromPeer);
+    outputSize += CTelegramStream::serializedSize(id);
+    outputSize += CTelegramStream::serializedSize(randomId);
+    outputSize += CTelegramStream::serializedSize(toPeer);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesForwardMessages;
     outputStream << flags;
@@ -1246,7 +1831,10 @@ quint64 CTelegramConnection::messagesForwardMessages(quint32 flags, const TLInpu
 
 quint64 CTelegramConnection::messagesGetAllStickers(quint32 hash)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(hash);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesGetAllStickers;
     outputStream << hash;
@@ -1255,7 +1843,10 @@ quint64 CTelegramConnection::messagesGetAllStickers(quint32 hash)
 
 quint64 CTelegramConnection::messagesGetChats(const TLVector<quint32> &id)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(id);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesGetChats;
     outputStream << id;
@@ -1264,7 +1855,11 @@ quint64 CTelegramConnection::messagesGetChats(const TLVector<quint32> &id)
 
 quint64 CTelegramConnection::messagesGetDhConfig(quint32 version, quint32 randomLength)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(version);
+    outputSize += CTelegramStream::serializedSize(randomLength);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesGetDhConfig;
     outputStream << version;
@@ -1274,7 +1869,13 @@ quint64 CTelegramConnection::messagesGetDhConfig(quint32 version, quint32 random
 
 quint64 CTelegramConnection::messagesGetDialogs(quint32 offsetDate, quint32 offsetId, const TLInputPeer &offsetPeer, quint32 limit)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(offsetDate);
+    outputSize += CTelegramStream::serializedSize(offsetId);
+    outputSize += CTelegramStream::serializedSize(offsetPeer);
+    outputSize += CTelegramStream::serializedSize(limit);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesGetDialogs;
     outputStream << offsetDate;
@@ -1286,7 +1887,12 @@ quint64 CTelegramConnection::messagesGetDialogs(quint32 offsetDate, quint32 offs
 
 quint64 CTelegramConnection::messagesGetDocumentByHash(const QByteArray &sha256, quint32 size, const QString &mimeType)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(sha256);
+    outputSize += CTelegramStream::serializedSize(size);
+    outputSize += CTelegramStream::serializedSize(mimeType);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesGetDocumentByHash;
     outputStream << sha256;
@@ -1297,7 +1903,10 @@ quint64 CTelegramConnection::messagesGetDocumentByHash(const QByteArray &sha256,
 
 quint64 CTelegramConnection::messagesGetFullChat(quint32 chatId)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(chatId);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesGetFullChat;
     outputStream << chatId;
@@ -1306,7 +1915,15 @@ quint64 CTelegramConnection::messagesGetFullChat(quint32 chatId)
 
 quint64 CTelegramConnection::messagesGetHistory(const TLInputPeer &peer, quint32 offsetId, quint32 addOffset, quint32 limit, quint32 maxId, quint32 minId)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(offsetId);
+    outputSize += CTelegramStream::serializedSize(addOffset);
+    outputSize += CTelegramStream::serializedSize(limit);
+    outputSize += CTelegramStream::serializedSize(maxId);
+    outputSize += CTelegramStream::serializedSize(minId);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesGetHistory;
     outputStream << peer;
@@ -1320,7 +1937,12 @@ quint64 CTelegramConnection::messagesGetHistory(const TLInputPeer &peer, quint32
 
 quint64 CTelegramConnection::messagesGetInlineBotResults(const TLInputUser &bot, const QString &query, const QString &offset)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(bot);
+    outputSize += CTelegramStream::serializedSize(query);
+    outputSize += CTelegramStream::serializedSize(offset);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesGetInlineBotResults;
     outputStream << bot;
@@ -1331,7 +1953,10 @@ quint64 CTelegramConnection::messagesGetInlineBotResults(const TLInputUser &bot,
 
 quint64 CTelegramConnection::messagesGetMessages(const TLVector<quint32> &id)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(id);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesGetMessages;
     outputStream << id;
@@ -1340,7 +1965,12 @@ quint64 CTelegramConnection::messagesGetMessages(const TLVector<quint32> &id)
 
 quint64 CTelegramConnection::messagesGetMessagesViews(const TLInputPeer &peer, const TLVector<quint32> &id, bool increment)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(id);
+    outputSize += CTelegramStream::serializedSize(increment);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesGetMessagesViews;
     outputStream << peer;
@@ -1351,7 +1981,10 @@ quint64 CTelegramConnection::messagesGetMessagesViews(const TLInputPeer &peer, c
 
 quint64 CTelegramConnection::messagesGetSavedGifs(quint32 hash)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(hash);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesGetSavedGifs;
     outputStream << hash;
@@ -1360,7 +1993,10 @@ quint64 CTelegramConnection::messagesGetSavedGifs(quint32 hash)
 
 quint64 CTelegramConnection::messagesGetStickerSet(const TLInputStickerSet &stickerset)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(stickerset);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesGetStickerSet;
     outputStream << stickerset;
@@ -1369,7 +2005,11 @@ quint64 CTelegramConnection::messagesGetStickerSet(const TLInputStickerSet &stic
 
 quint64 CTelegramConnection::messagesGetStickers(const QString &emoticon, const QString &hash)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(emoticon);
+    outputSize += CTelegramStream::serializedSize(hash);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesGetStickers;
     outputStream << emoticon;
@@ -1379,7 +2019,10 @@ quint64 CTelegramConnection::messagesGetStickers(const QString &emoticon, const
 
 quint64 CTelegramConnection::messagesGetWebPagePreview(const QString &message)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(message);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesGetWebPagePreview;
     outputStream << message;
@@ -1388,7 +2031,10 @@ quint64 CTelegramConnection::messagesGetWebPagePreview(const QString &message)
 
 quint64 CTelegramConnection::messagesImportChatInvite(const QString &hash)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(hash);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesImportChatInvite;
     outputStream << hash;
@@ -1397,7 +2043,11 @@ quint64 CTelegramConnection::messagesImportChatInvite(const QString &hash)
 
 quint64 CTelegramConnection::messagesInstallStickerSet(const TLInputStickerSet &stickerset, bool disabled)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(stickerset);
+    outputSize += CTelegramStream::serializedSize(disabled);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesInstallStickerSet;
     outputStream << stickerset;
@@ -1407,7 +2057,10 @@ quint64 CTelegramConnection::messagesInstallStickerSet(const TLInputStickerSet &
 
 quint64 CTelegramConnection::messagesMigrateChat(quint32 chatId)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(chatId);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesMigrateChat;
     outputStream << chatId;
@@ -1416,7 +2069,11 @@ quint64 CTelegramConnection::messagesMigrateChat(quint32 chatId)
 
 quint64 CTelegramConnection::messagesReadEncryptedHistory(const TLInputEncryptedChat &peer, quint32 maxDate)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(maxDate);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesReadEncryptedHistory;
     outputStream << peer;
@@ -1426,7 +2083,11 @@ quint64 CTelegramConnection::messagesReadEncryptedHistory(const TLInputEncrypted
 
 quint64 CTelegramConnection::messagesReadHistory(const TLInputPeer &peer, quint32 maxId)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(maxId);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesReadHistory;
     outputStream << peer;
@@ -1436,7 +2097,10 @@ quint64 CTelegramConnection::messagesReadHistory(const TLInputPeer &peer, quint3
 
 quint64 CTelegramConnection::messagesReadMessageContents(const TLVector<quint32> &id)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(id);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesReadMessageContents;
     outputStream << id;
@@ -1445,7 +2109,10 @@ quint64 CTelegramConnection::messagesReadMessageContents(const TLVector<quint32>
 
 quint64 CTelegramConnection::messagesReceivedMessages(quint32 maxId)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(maxId);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesReceivedMessages;
     outputStream << maxId;
@@ -1454,7 +2121,10 @@ quint64 CTelegramConnection::messagesReceivedMessages(quint32 maxId)
 
 quint64 CTelegramConnection::messagesReceivedQueue(quint32 maxQts)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(maxQts);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesReceivedQueue;
     outputStream << maxQts;
@@ -1463,7 +2133,10 @@ quint64 CTelegramConnection::messagesReceivedQueue(quint32 maxQts)
 
 quint64 CTelegramConnection::messagesReorderStickerSets(const TLVector<quint64> &order)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(order);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesReorderStickerSets;
     outputStream << order;
@@ -1472,7 +2145,10 @@ quint64 CTelegramConnection::messagesReorderStickerSets(const TLVector<quint64>
 
 quint64 CTelegramConnection::messagesReportSpam(const TLInputPeer &peer)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(peer);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesReportSpam;
     outputStream << peer;
@@ -1481,7 +2157,12 @@ quint64 CTelegramConnection::messagesReportSpam(const TLInputPeer &peer)
 
 quint64 CTelegramConnection::messagesRequestEncryption(const TLInputUser &userId, quint32 randomId, const QByteArray &gA)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(userId);
+    outputSize += CTelegramStream::serializedSize(randomId);
+    outputSize += CTelegramStream::serializedSize(gA);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesRequestEncryption;
     outputStream << userId;
@@ -1492,7 +2173,11 @@ quint64 CTelegramConnection::messagesRequestEncryption(const TLInputUser &userId
 
 quint64 CTelegramConnection::messagesSaveGif(const TLInputDocument &id, bool unsave)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(id);
+    outputSize += CTelegramStream::serializedSize(unsave);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesSaveGif;
     outputStream << id;
@@ -1502,7 +2187,18 @@ quint64 CTelegramConnection::messagesSaveGif(const TLInputDocument &id, bool uns
 
 quint64 CTelegramConnection::messagesSearch(quint32 flags, const TLInputPeer &peer, const QString &q, const TLMessagesFilter &filter, quint32 minDate, quint32 maxDate, quint32 offset, quint32 maxId, quint32 limit)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(flags);
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(q);
+    outputSize += CTelegramStream::serializedSize(filter);
+    outputSize += CTelegramStream::serializedSize(minDate);
+    outputSize += CTelegramStream::serializedSize(maxDate);
+    outputSize += CTelegramStream::serializedSize(offset);
+    outputSize += CTelegramStream::serializedSize(maxId);
+    outputSize += CTelegramStream::serializedSize(limit);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesSearch;
     outputStream << flags;
@@ -1520,7 +2216,11 @@ quint64 CTelegramConnection::messagesSearch(quint32 flags, const TLInputPeer &pe
 
 quint64 CTelegramConnection::messagesSearchGifs(const QString &q, quint32 offset)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(q);
+    outputSize += CTelegramStream::serializedSize(offset);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesSearchGifs;
     outputStream << q;
@@ -1530,7 +2230,14 @@ quint64 CTelegramConnection::messagesSearchGifs(const QString &q, quint32 offset
 
 quint64 CTelegramConnection::messagesSearchGlobal(const QString &q, quint32 offsetDate, const TLInputPeer &offsetPeer, quint32 offsetId, quint32 limit)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(q);
+    outputSize += CTelegramStream::serializedSize(offsetDate);
+    outputSize += CTelegramStream::serializedSize(offsetPeer);
+    outputSize += CTelegramStream::serializedSize(offsetId);
+    outputSize += CTelegramStream::serializedSize(limit);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesSearchGlobal;
     outputStream << q;
@@ -1543,7 +2250,13 @@ quint64 CTelegramConnection::messagesSearchGlobal(const QString &q, quint32 offs
 
 quint64 CTelegramConnection::messagesSendBroadcast(const TLVector<TLInputUser> &contacts, const TLVector<quint64> &randomId, const QString &message, const TLInputMedia &media)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(contacts);
+    outputSize += CTelegramStream::serializedSize(randomId);
+    outputSize += CTelegramStream::serializedSize(message);
+    outputSize += CTelegramStream::serializedSize(media);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesSendBroadcast;
     outputStream << contacts;
@@ -1555,7 +2268,12 @@ quint64 CTelegramConnection::messagesSendBroadcast(const TLVector<TLInputUser> &
 
 quint64 CTelegramConnection::messagesSendEncrypted(const TLInputEncryptedChat &peer, quint64 randomId, const QByteArray &data)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(randomId);
+    outputSize += CTelegramStream::serializedSize(data);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesSendEncrypted;
     outputStream << peer;
@@ -1566,7 +2284,13 @@ quint64 CTelegramConnection::messagesSendEncrypted(const TLInputEncryptedChat &p
 
 quint64 CTelegramConnection::messagesSendEncryptedFile(const TLInputEncryptedChat &peer, quint64 randomId, const QByteArray &data, const TLInputEncryptedFile &file)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(randomId);
+    outputSize += CTelegramStream::serializedSize(data);
+    outputSize += CTelegramStream::serializedSize(file);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesSendEncryptedFile;
     outputStream << peer;
@@ -1578,7 +2302,12 @@ quint64 CTelegramConnection::messagesSendEncryptedFile(const TLInputEncryptedCha
 
 quint64 CTelegramConnection::messagesSendEncryptedService(const TLInputEncryptedChat &peer, quint64 randomId, const QByteArray &data)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(randomId);
+    outputSize += CTelegramStream::serializedSize(data);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesSendEncryptedService;
     outputStream << peer;
@@ -1589,7 +2318,17 @@ quint64 CTelegramConnection::messagesSendEncryptedService(const TLInputEncrypted
 
 quint64 CTelegramConnection::messagesSendInlineBotResult(quint32 flags, const TLInputPeer &peer, quint32 replyToMsgId, quint64 randomId, quint64 queryId, const QString &id)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(flags);
+    outputSize += CTelegramStream::serializedSize(peer);
+    if (flags & 1 << 0) {
+        outputSize += CTelegramStream::serializedSize(replyToMsgId);
+    }
+    outputSize += CTelegramStream::serializedSize(randomId);
+    outputSize += CTelegramStream::serializedSize(queryId);
+    outputSize += CTelegramStream::serializedSize(id);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesSendInlineBotResult;
     outputStream << flags;
@@ -1606,7 +2345,19 @@ quint64 CTelegramConnection::messagesSendInlineBotResult(quint32 flags, const TL
 
 quint64 CTelegramConnection::messagesSendMedia(quint32 flags, const TLInputPeer &peer, quint32 replyToMsgId, const TLInputMedia &media, quint64 randomId, const TLReplyMarkup &replyMarkup)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(flags);
+    outputSize += CTelegramStream::serializedSize(peer);
+    if (flags & 1 << 0) {
+        outputSize += CTelegramStream::serializedSize(replyToMsgId);
+    }
+    outputSize += CTelegramStream::serializedSize(media);
+    outputSize += CTelegramStream::serializedSize(randomId);
+    if (flags & 1 << 2) {
+        outputSize += CTelegramStream::serializedSize(replyMarkup);
+    }
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesSendMedia;
     outputStream << flags;
@@ -1625,7 +2376,22 @@ quint64 CTelegramConnection::messagesSendMedia(quint32 flags, const TLInputPeer
 
 quint64 CTelegramConnection::messagesSendMessage(quint32 flags, const TLInputPeer &peer, quint32 replyToMsgId, const QString &message, quint64 randomId, const TLReplyMarkup &replyMarkup, const TLVector<TLMessageEntity> &entities)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(flags);
+    outputSize += CTelegramStream::serializedSize(peer);
+    if (flags & 1 << 0) {
+        outputSize += CTelegramStream::serializedSize(replyToMsgId);
+    }
+    outputSize += CTelegramStream::serializedSize(message);
+    outputSize += CTelegramStream::serializedSize(randomId);
+    if (flags & 1 << 2) {
+        outputSize += CTelegramStream::serializedSize(replyMarkup);
+    }
+    if (flags & 1 << 3) {
+        outputSize += CTelegramStream::serializedSize(entities);
+    }
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesSendMessage;
     outputStream << flags;
@@ -1648,7 +2414,11 @@ quint64 CTelegramConnection::messagesSendMessage(quint32 flags, const TLInputPee
 
 quint64 CTelegramConnection::messagesSetEncryptedTyping(const TLInputEncryptedChat &peer, bool typing)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(typing);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesSetEncryptedTyping;
     outputStream << peer;
@@ -1658,7 +2428,16 @@ quint64 CTelegramConnection::messagesSetEncryptedTyping(const TLInputEncryptedCh
 
 quint64 CTelegramConnection::messagesSetInlineBotResults(quint32 flags, quint64 queryId, const TLVector<TLInputBotInlineResult> &results, quint32 cacheTime, const QString &nextOffset)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(flags);
+    outputSize += CTelegramStream::serializedSize(queryId);
+    outputSize += CTelegramStream::serializedSize(results);
+    outputSize += CTelegramStream::serializedSize(cacheTime);
+    if (flags & 1 << 2) {
+        outputSize += CTelegramStream::serializedSize(nextOffset);
+    }
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesSetInlineBotResults;
     outputStream << flags;
@@ -1675,7 +2454,11 @@ quint64 CTelegramConnection::messagesSetInlineBotResults(quint32 flags, quint64
 
 quint64 CTelegramConnection::messagesSetTyping(const TLInputPeer &peer, const TLSendMessageAction &action)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(action);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesSetTyping;
     outputStream << peer;
@@ -1685,7 +2468,13 @@ quint64 CTelegramConnection::messagesSetTyping(const TLInputPeer &peer, const TL
 
 quint64 CTelegramConnection::messagesStartBot(const TLInputUser &bot, const TLInputPeer &peer, quint64 randomId, const QString &startParam)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(bot);
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(randomId);
+    outputSize += CTelegramStream::serializedSize(startParam);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesStartBot;
     outputStream << bot;
@@ -1697,7 +2486,11 @@ quint64 CTelegramConnection::messagesStartBot(const TLInputUser &bot, const TLIn
 
 quint64 CTelegramConnection::messagesToggleChatAdmins(quint32 chatId, bool enabled)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(chatId);
+    outputSize += CTelegramStream::serializedSize(enabled);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesToggleChatAdmins;
     outputStream << chatId;
@@ -1707,7 +2500,10 @@ quint64 CTelegramConnection::messagesToggleChatAdmins(quint32 chatId, bool enabl
 
 quint64 CTelegramConnection::messagesUninstallStickerSet(const TLInputStickerSet &stickerset)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(stickerset);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::MessagesUninstallStickerSet;
     outputStream << stickerset;
@@ -1716,7 +2512,13 @@ quint64 CTelegramConnection::messagesUninstallStickerSet(const TLInputStickerSet
 
 quint64 CTelegramConnection::updatesGetChannelDifference(const TLInputChannel &channel, const TLChannelMessagesFilter &filter, quint32 pts, quint32 limit)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(channel);
+    outputSize += CTelegramStream::serializedSize(filter);
+    outputSize += CTelegramStream::serializedSize(pts);
+    outputSize += CTelegramStream::serializedSize(limit);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::UpdatesGetChannelDifference;
     outputStream << channel;
@@ -1728,7 +2530,12 @@ quint64 CTelegramConnection::updatesGetChannelDifference(const TLInputChannel &c
 
 quint64 CTelegramConnection::updatesGetDifference(quint32 pts, quint32 date, quint32 qts)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(pts);
+    outputSize += CTelegramStream::serializedSize(date);
+    outputSize += CTelegramStream::serializedSize(qts);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::UpdatesGetDifference;
     outputStream << pts;
@@ -1739,7 +2546,9 @@ quint64 CTelegramConnection::updatesGetDifference(quint32 pts, quint32 date, qui
 
 quint64 CTelegramConnection::updatesGetState()
 {
+    quint32 outputSize = 4;
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::UpdatesGetState;
     return sendEncryptedPackage(output);
@@ -1747,7 +2556,12 @@ quint64 CTelegramConnection::updatesGetState()
 
 quint64 CTelegramConnection::uploadGetFile(const TLInputFileLocation &location, quint32 offset, quint32 limit)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(location);
+    outputSize += CTelegramStream::serializedSize(offset);
+    outputSize += CTelegramStream::serializedSize(limit);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::UploadGetFile;
     outputStream << location;
@@ -1758,7 +2572,13 @@ quint64 CTelegramConnection::uploadGetFile(const TLInputFileLocation &location,
 
 quint64 CTelegramConnection::uploadSaveBigFilePart(quint64 fileId, quint32 filePart, quint32 fileTotalParts, const QByteArray &bytes)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(fileId);
+    outputSize += CTelegramStream::serializedSize(filePart);
+    outputSize += CTelegramStream::serializedSize(fileTotalParts);
+    outputSize += CTelegramStream::serializedSize(bytes);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::UploadSaveBigFilePart;
     outputStream << fileId;
@@ -1770,7 +2590,12 @@ quint64 CTelegramConnection::uploadSaveBigFilePart(quint64 fileId, quint32 fileP
 
 quint64 CTelegramConnection::uploadSaveFilePart(quint64 fileId, quint32 filePart, const QByteArray &bytes)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(fileId);
+    outputSize += CTelegramStream::serializedSize(filePart);
+    outputSize += CTelegramStream::serializedSize(bytes);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::UploadSaveFilePart;
     outputStream << fileId;
@@ -1781,7 +2606,10 @@ quint64 CTelegramConnection::uploadSaveFilePart(quint64 fileId, quint32 filePart
 
 quint64 CTelegramConnection::usersGetFullUser(const TLInputUser &id)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(id);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::UsersGetFullUser;
     outputStream << id;
@@ -1790,7 +2618,10 @@ quint64 CTelegramConnection::usersGetFullUser(const TLInputUser &id)
 
 quint64 CTelegramConnection::usersGetUsers(const TLVector<TLInputUser> &id)
 {
+    quint32 outputSize = 4;
+    outputSize += CTelegramStream::serializedSize(id);
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
     outputStream << TLValue::UsersGetUsers;
     outputStream << id;
@@ -1837,6 +2668,33 @@ quint64 CTelegramConnection::acknowledgeMessages(const TLVector<quint64> &idsVec
     return sendEncryptedPackage(output, /* save package */ false);
 }
 
+quint64 CTelegramConnection::requestMessagesState(const TLVector<quint64> &idsVector)
+{
+    QByteArray output;
+    CTelegramStream outputStream(&output, /* write */ true);
+
+    outputStream << TLValue::MsgsStateReq;
+    outputStream << idsVector;
+
+    const quint64 id = sendEncryptedPackage(output, /* save package */ false);
+    m_stateRequests.insert(id, idsVector);
+    if (m_stateRequests.count() > s_maxRememberedStateRequests) {
+        m_stateRequests.erase(m_stateRequests.begin());
+    }
+    return id;
+}
+
+quint64 CTelegramConnection::requestMessagesResend(const TLVector<quint64> &idsVector)
+{
+    QByteArray output;
+    CTelegramStream outputStream(&output, /* write */ true);
+
+    outputStream << TLValue::MsgResendReq;
+    outputStream << idsVector;
+
+    return sendEncryptedPackage(output, /* save package */ false);
+}
+
 bool CTelegramConnection::acceptPqAuthorization(const QByteArray &payload)
 {
     qDebug() << Q_FUNC_INFO;
@@ -2177,12 +3035,13 @@ void CTelegramConnection::processRedirectedPackage(const QByteArray &data)
     sendEncryptedPackage(data);
 }
 
-TLValue CTelegramConnection::processRpcQuery(const QByteArray &data)
+TLValue CTelegramConnection::processRpcQuery(const QByteArray &data, quint64 messageId)
 {
     CTelegramStream stream(data);
+    stream.setMessageProjection(m_messageProjection);
 
     bool isUpdate;
-    TLValue value = processUpdate(stream, &isUpdate, /* requestId */ 0); // Doubtfully that this approach will work in next time.
+    TLValue value = processUpdate(stream, &isUpdate, /* requestId */ 0, decodedObject(messageId)); // Doubtfully that this approach will work in next time.
 
     if (isUpdate) {
         return value;
@@ -2211,6 +3070,18 @@ TLValue CTelegramConnection::processRpcQuery(const QByteArray &data)
     case TLValue::Pong:
         processPingPong(stream);
         break;
+    case TLValue::MsgsStateInfo:
+        processMessagesStateInfo(stream);
+        break;
+    case TLValue::MsgDetailedInfo:
+        processMessageDetailedInfo(stream);
+        break;
+    case TLValue::MsgNewDetailedInfo:
+        processMessageNewDetailedInfo(stream);
+        break;
+    case TLValue::FutureSalts:
+        processFutureSalts(stream);
+        break;
     default:
         qDebug() << Q_FUNC_INFO << "value:" << value;
         break;
@@ -2257,7 +3128,16 @@ void CTelegramConnection::processContainer(CTelegramStream &stream)
 
         stream >> size;
 
-        processRpcQuery(stream.readBytes(size));
+        // The message is processed in place, as a view on the container data
+        const QByteArray data = stream.readBytesView(size);
+        if (m_incomingMessageIds.insert(id) != CMessageIdWindow::Accepted) {
+            qDebug() << Q_FUNC_INFO << "Drop the already processed message" << id;
+            if (seqNo & 1) {
+                addMessageToAck(id);
+            }
+            continue;
+        }
+        processRpcQuery(data, id);
     }
 }
 
@@ -2269,8 +3149,16 @@ void CTelegramConnection::processRpcResult(CTelegramStream &stream, quint64 idHi
         stream >> id;
     }
 
-    RpcProcessingContext context(stream, id, m_submittedPackages.value(id));
+    RpcProcessingContext context(stream, id, m_requestTracker.data(id));
+    context.setDecodedObject(decodedObject(id));
     if (context.hasRequestData()) {
+        // The time spent in the outgoing queue is not a part of the RTT, and the result of a retransmitted
+        // request can not be matched to a particular transmission (Karn's algorithm)
+        const CRequestTracker::Request *request = m_requestTracker.request(id);
+        if (request && request->sent && !request->retries) {
+            addRttSample(QDateTime::currentMSecsSinceEpoch() - request->sentTime);
+        }
+
         if (!context.requestType().isValid()) {
             qWarning() << Q_FUNC_INFO << "Invalid request type from the saved package. Package with id" << id << "ignored.";
             return;
@@ -2683,7 +3571,7 @@ void CTelegramConnection::processRpcResult(CTelegramStream &stream, quint64 idHi
         // End of generated RPC processing switch updates cases
         {
             bool ok;
-            context.setReadCode(processUpdate(context.inputStream(), &ok, context.requestId()));
+            context.setReadCode(processUpdate(context.inputStream(), &ok, context.requestId(), decodedObject(id)));
         }
             break;
         default:
@@ -2702,7 +3590,7 @@ void CTelegramConnection::processRpcResult(CTelegramStream &stream, quint64 idHi
             break;
         default:
             // Any other results considered as success
-            m_submittedPackages.remove(id);
+            m_requestTracker.remove(id);
             addMessageToAck(id);
             break;
         }
@@ -2718,9 +3606,7 @@ void CTelegramConnection::processRpcResult(CTelegramStream &stream, quint64 idHi
 
 void CTelegramConnection::processGzipPackedRpcQuery(CTelegramStream &stream)
 {
-    QByteArray packedData;
-    stream >> packedData;
-
+    const QByteArray packedData = stream.readSerializedBytesView();
     const QByteArray data = Utils::unpackGZip(packedData);
 
     if (!data.isEmpty()) {
@@ -2730,13 +3616,12 @@ void CTelegramConnection::processGzipPackedRpcQuery(CTelegramStream &stream)
 
 void CTelegramConnection::processGzipPackedRpcResult(CTelegramStream &stream, quint64 id)
 {
-    QByteArray packedData;
-    stream >> packedData;
-
+    const QByteArray packedData = stream.readSerializedBytesView();
     const QByteArray data = Utils::unpackGZip(packedData);
 
     if (!data.isEmpty()) {
         CTelegramStream unpackedStream(data);
+        unpackedStream.setMessageProjection(m_messageProjection);
         processRpcResult(unpackedStream, id);
     }
 }
@@ -2760,8 +3645,8 @@ bool CTelegramConnection::processRpcError(CTelegramStream &stream, quint64 id, T
         break;
     case 400: // BAD_REQUEST
 #ifdef DEVELOPER_BUILD
-        if (m_submittedPackages.contains(id)) {
-            const QByteArray data = m_submittedPackages.value(id);
+        if (m_requestTracker.contains(id)) {
+            const QByteArray data = m_requestTracker.data(id);
             CTelegramStream outputStream(data);
             dumpRpc(outputStream);
         } else {
@@ -2816,7 +3701,7 @@ bool CTelegramConnection::processRpcError(CTelegramStream &stream, quint64 id, T
             break;
         case TLValue::MessagesGetChats:
         {
-            const QByteArray data = m_submittedPackages.value(id);
+            const QByteArray data = m_requestTracker.data(id);
             CTelegramStream stream(data);
 
             TLValue request;
@@ -2876,7 +3761,11 @@ void CTelegramConnection::processMessageAck(CTelegramStream &stream)
 
     foreach (quint64 id, idsVector) {
         qDebug() << Q_FUNC_INFO << "Package" << id << "acked";
-//        m_submittedPackages.remove(id);
+        CRequestTracker::Request *request = m_requestTracker.request(id);
+        if (request) {
+            // The server has the request, there is no need to ask about its state
+            request->stateCheckTime = 0;
+        }
     }
 }
 
@@ -2963,7 +3852,142 @@ void CTelegramConnection::processIgnoredMessageNotification(CTelegramStream &str
         m_serverSalt = m_receivedServerSalt;
         qDebug() << "Local serverSalt fixed to" << m_serverSalt;
         sendEncryptedPackageAgain(id);
+        // The salts schedule is outdated (or there is no schedule yet)
+        m_futureSalts.clear();
+        updateServerSalt();
+    }
+}
+
+void CTelegramConnection::processMessagesStateInfo(CTelegramStream &stream)
+{
+    // https://core.telegram.org/mtproto/service_messages_about_messages#request-for-message-status-information
+    quint64 stateRequestId;
+    stream >> stateRequestId;
+
+    QByteArray info;
+    stream >> info;
+
+    const TLVector<quint64> ids = m_stateRequests.take(stateRequestId);
+    if (ids.count() != info.size()) {
+        qDebug() << Q_FUNC_INFO << "Unexpected state info for the request" << stateRequestId;
+        return;
+    }
+
+    for (int i = 0; i < ids.count(); ++i) {
+        const quint64 id = ids.at(i);
+        if (!m_requestTracker.contains(id)) {
+            // The result is received meanwhile
+            continue;
+        }
+        const quint8 state = static_cast<quint8>(info.at(i)) & 7;
+        switch (state) {
+        case 1: // Nothing is known about the message (the id is too low)
+        case 2: // The message is not received (the id is within the range of the received ids)
+        case 3: // The message is not received (the id is too high)
+            qDebug() << Q_FUNC_INFO << "The request" << id << "is lost, send it again";
+            if (sendEncryptedPackageAgain(id)) {
+                ++m_recoveredRequestsCount;
+            }
+            break;
+        case 4: // The message is received; the result or msg_detailed_info is on the way
+            m_requestTracker.request(id)->stateCheckTime = 0;
+            break;
+        default:
+            qDebug() << Q_FUNC_INFO << "Unexpected state" << state << "of the request" << id;
+            break;
+        }
+    }
+}
+
+void CTelegramConnection::processMessageDetailedInfo(CTelegramStream &stream)
+{
+    // https://core.telegram.org/mtproto/service_messages_about_messages#extended-voluntary-communication-of-status-of-one-message
+    quint64 id;
+    stream >> id;
+
+    quint64 answerId;
+    stream >> answerId;
+
+    quint32 bytes;
+    stream >> bytes;
+
+    quint32 status;
+    stream >> status;
+
+    if (m_requestTracker.contains(id)) {
+        // The request is executed, but the answer is lost; ask for the answer instead of the execution
+        qDebug() << Q_FUNC_INFO << "Request the answer" << answerId << "of" << id << "size:" << bytes;
+        requestMessagesResend(TLVector<quint64>({ answerId }));
+    } else {
+        addMessageToAck(answerId);
+    }
+}
+
+void CTelegramConnection::processMessageNewDetailedInfo(CTelegramStream &stream)
+{
+    quint64 answerId;
+    stream >> answerId;
+
+    quint32 bytes;
+    stream >> bytes;
+
+    quint32 status;
+    stream >> status;
+
+    switch (m_incomingMessageIds.check(answerId)) {
+    case CMessageIdWindow::Duplicate:
+        addMessageToAck(answerId);
+        break;
+    case CMessageIdWindow::TooOld:
+        // The answer can not be verified and its resend would be dropped anyway
+        qDebug() << Q_FUNC_INFO << "The answer" << answerId << "is too old, acknowledge it";
+        addMessageToAck(answerId);
+        break;
+    case CMessageIdWindow::Accepted:
+        // The answer is lost; the server expects a resend request
+        qDebug() << Q_FUNC_INFO << "Request the answer" << answerId << "size:" << bytes;
+        requestMessagesResend(TLVector<quint64>({ answerId }));
+        break;
+    }
+}
+
+void CTelegramConnection::processFutureSalts(CTelegramStream &stream)
+{
+    // https://core.telegram.org/mtproto/service_messages#request-for-several-future-salts
+    quint64 requestId;
+    stream >> requestId;
+
+    quint32 serverTime;
+    stream >> serverTime;
+
+    // Bare vector of bare future_salt
+    quint32 count;
+    stream >> count;
+    if (count > 64) {
+        qWarning() << Q_FUNC_INFO << "Unexpected salts count" << count;
+        return;
     }
+
+    QVector<SFutureSalt> salts(count);
+    for (SFutureSalt &salt : salts) {
+        stream >> salt.validSince;
+        stream >> salt.validUntil;
+        stream >> salt.salt;
+    }
+
+    if (stream.error()) {
+        qWarning() << Q_FUNC_INFO << "Unable to read the salts";
+        return;
+    }
+
+    if (!requestId || (requestId != m_futureSaltsRequestId)) {
+        qDebug() << Q_FUNC_INFO << "Unexpected salts for the request" << requestId;
+        return;
+    }
+
+    m_futureSaltsRequestId = 0;
+    m_futureSaltsTimer->stop();
+    setFutureSalts(salts);
 }
 
 void CTelegramConnection::processPingPong(CTelegramStream &stream)
@@ -2976,6 +4000,10 @@ void CTelegramConnection::processPingPong(CTelegramStream &stream)
     m_lastReceivedPingId = pid;
     m_lastReceivedPingTime = QDateTime::currentMSecsSinceEpoch();
 
+    if (pid == m_lastSentPingId) {
+        addRttSample(m_lastReceivedPingTime - m_lastSentPingTime);
+    }
+
 //    qDebug() << Q_FUNC_INFO << m_lastReceivedPingId << m_lastReceivedPingTime;
 }
 
@@ -4060,7 +5088,7 @@ void CTelegramConnection::processUploadGetFile(RpcProcessingContext *context)
     stream >> location;
     stream >> offset;
 
-    emit fileDataReceived(result, m_requestedFilesIds.value(context->requestId()), offset);
+    emit fileDataReceived(result, m_requestTracker.fileRequestId(context->requestId()), offset);
 }
 
 void CTelegramConnection::processUploadSaveBigFilePart(RpcProcessingContext *context)
@@ -4076,7 +5104,7 @@ void CTelegramConnection::processUploadSaveFilePart(RpcProcessingContext *contex
     context->inputStream() >> result;
     context->setReadCode(result);
     if (result == TLValue::BoolTrue) {
-        emit fileDataSent(m_requestedFilesIds.take(context->requestId()));
+        emit fileDataSent(m_requestTracker.fileRequestId(context->requestId()));
     } else {
         qWarning() << "Unhandled UploadSaveFilePart result"; // retry putFile() call?
     }
@@ -4126,7 +5154,7 @@ bool CTelegramConnection::processErrorSeeOther(const QString errorMessage, quint
     if (!ok) {
         return false;
     }
-    const QByteArray data = m_submittedPackages.take(id);
+    const QByteArray data = m_requestTracker.take(id).data;
     if (data.isEmpty()) {
         qDebug() << Q_FUNC_INFO << "Can not restore message" << id;
         return false;
@@ -4155,13 +5183,15 @@ bool CTelegramConnection::processErrorSeeOther(const QString errorMessage, quint
     return true;
 }
 
-TLValue CTelegramConnection::processUpdate(CTelegramStream &stream, bool *ok, quint64 id)
+TLValue CTelegramConnection::processUpdate(CTelegramStream &stream, bool *ok, quint64 id, CPackageDecoder::DecodedObject *decodedObject)
 {
     TLUpdates updates;
-    stream >> updates;
+    if (!decodedObject || !decodedObject->take(&updates)) {
+        stream >> updates;
 
-    if (stream.error()) {
-        qWarning() << Q_FUNC_INFO << "Read of an update caused an error.";
+        if (stream.error()) {
+            qWarning() << Q_FUNC_INFO << "Read of an update caused an error.";
+        }
     }
 
     switch (updates.tlType) {
@@ -4190,8 +5220,12 @@ void CTelegramConnection::onTransportStateChanged()
         QDir dir;
         dir.mkdir(QLatin1String("network"));
 
-        m_logFile = new QFile(QLatin1String("network/") + m_dcInfo.ipAddress + QLatin1String(".log"));
+        m_logFile = new QFile(QLatin1String("network/") + m_dcInfo.ipAddress + QLatin1String(".tqcap"), this);
         m_logFile->open(QIODevice::WriteOnly);
+
+        CTransportCapture *capture = new CTransportCapture(m_logFile, this);
+        capture->setPayloadCaptureEnabled(true);
+        setCapture(capture);
     }
 
     qDebug() << Q_FUNC_INFO << m_dcInfo.id << m_dcInfo.ipAddress << m_transport->state();
@@ -4199,6 +5233,14 @@ void CTelegramConnection::onTransportStateChanged()
 
     switch (m_transport->state()) {
     case QAbstractSocket::ConnectedState:
+        if (!m_alternativeAddresses.isEmpty()) {
+            // Keep the address which won the connection race
+            const Telegram::DcOption address = m_transport->remoteAddress();
+            if (!address.address.isEmpty()) {
+                m_dcInfo.ipAddress = address.address;
+                m_dcInfo.port = address.port;
+            }
+        }
         startAuthTimer();
 
         if (m_authKey.isEmpty()) {
@@ -4210,7 +5252,27 @@ void CTelegramConnection::onTransportStateChanged()
         setStatus(ConnectionStatusConnected, ConnectionStatusReasonRemote);
         break;
     case QAbstractSocket::UnconnectedState:
+        // The queued messages are lost as well as the sent ones
+        for (QVector<OutgoingMessage> &queue : m_outgoingQueues) {
+            queue.clear();
+        }
+        m_outgoingMessagesCount = 0;
+        m_outgoingMessagesSize = 0;
+        m_stateRequests.clear();
+        m_futureSaltsRequestId = 0;
+        m_futureSaltsTimer->stop();
         setStatus(ConnectionStatusDisconnected, status() == ConnectionStatusDisconnecting ? ConnectionStatusReasonLocal : ConnectionStatusReasonRemote);
+        // Report the drained queue only after the status change, so nobody resumes sending into the dead connection
+        updateBackpressure();
+        // The tracked requests of the drained queue would never be sent, nor expire
+        for (const quint64 id : m_requestTracker.queuedRequests()) {
+            const quint32 fileRequestId = m_requestTracker.fileRequestId(id);
+            m_requestTracker.remove(id);
+            emit requestFailed(id, fileRequestId);
+        }
+        if (m_requestTracker.isEmpty()) {
+            m_requestTimer->stop();
+        }
         break;
     default:
         break;
@@ -4273,73 +5335,117 @@ void CTelegramConnection::onTransportPackageReceived(const QByteArray &input)
 
         if (authId != m_authId) {
             qDebug() << Q_FUNC_INFO << "Incorrect auth id.";
-
-#ifdef NETWORK_LOGGING
-            QTextStream str(m_logFile);
-
-            str << QDateTime::currentDateTime().toString(QLatin1String("yyyyMMdd HH:mm:ss:zzz")) << QLatin1Char('|');
-            str << QLatin1String("pln|");
-            str << QString(QLatin1String("size: %1|")).arg(input.length(), 4, 10, QLatin1Char('0'));
-            str << QLatin1Char('|');
-            str << input.toHex();
-            str << endl;
-            str.flush();
-#endif
-
             return;
         }
         // Encrypted Message
-        const QByteArray messageKey = inputStream.readBytes(16);
-        const QByteArray data = inputStream.readBytes(inputStream.bytesAvailable());
+        if (m_decodingWorker) {
+            // The package is a view on the transport buffer, so the worker gets a deep copy
+            QMetaObject::invokeMethod(m_decodingWorker, "decodePackage", Qt::QueuedConnection,
+                                      Q_ARG(QByteArray, QByteArray(input.constData(), input.size())));
+            return;
+        }
 
-        const SAesKey key = generateServerToClientAesKey(messageKey);
+        CPackageDecoder::Message message;
+        if (!m_packageDecoder.decode(input, &message)) {
+            return;
+        }
+        payload = message.payload;
+        processDecodedMessage(message);
+    }
+
+#ifdef DEVELOPER_BUILD
+    static int packagesCount = 0;
+    qDebug() << Q_FUNC_INFO << "Got package" << ++packagesCount << TLValue::firstFromArray(payload);
+#endif
+}
 
-        QByteArray decryptedData = Utils::aesDecrypt(data, key).left(data.length());
-        CRawStream decryptedStream(decryptedData);
+void CTelegramConnection::onMessageDecoded(const CPackageDecoder::Message &message)
+{
+#ifdef DEVELOPER_BUILD
+    qDebug() << Q_FUNC_INFO << "Got package" << TLValue::firstFromArray(message.payload);
+#endif
+    processDecodedMessage(message);
+}
 
-        quint64 sessionId = 0;
-        quint64 messageId  = 0;
-        quint32 sequence = 0;
-        quint32 contentLength = 0;
+void CTelegramConnection::processDecodedMessage(const CPackageDecoder::Message &message)
+{
+    m_receivedServerSalt = message.serverSalt;
 
-        decryptedStream >> m_receivedServerSalt;
-        decryptedStream >> sessionId;
-        decryptedStream >> messageId;
-        decryptedStream >> sequence;
-        decryptedStream >> contentLength;
+    if (m_serverSalt != m_receivedServerSalt) {
+        qDebug() << Q_FUNC_INFO << "Received different server salt:" << m_receivedServerSalt << "(remote) vs" << m_serverSalt << "(local)";
+    }
 
-        if (m_serverSalt != m_receivedServerSalt) {
-            qDebug() << Q_FUNC_INFO << "Received different server salt:" << m_receivedServerSalt << "(remote) vs" << m_serverSalt << "(local)";
-//            return;
-        }
+    // The session can be changed while the package is decoded in other thread
+    if (m_sessionId != message.sessionId) {
+        qDebug() << Q_FUNC_INFO << "Session Id is wrong.";
+        return;
+    }
 
-        if (m_sessionId != sessionId) {
-            qDebug() << Q_FUNC_INFO << "Session Id is wrong.";
-            return;
-        }
+    // Any message from the server proves that the connection is alive, not only the pong
+    if (m_pongTimer) {
+        m_pongTimer->stop();
+    }
 
-        if (int(contentLength) > decryptedData.length()) {
-            qDebug() << Q_FUNC_INFO << "Expected data length is more, than actual.";
-            return;
+    if (m_incomingMessageIds.insert(message.messageId) != CMessageIdWindow::Accepted) {
+        qDebug() << Q_FUNC_INFO << "Drop the already processed message" << message.messageId;
+        if (message.sequence & 1) {
+            // The content-related message is resent if the ack is lost
+            addMessageToAck(message.messageId);
         }
+        return;
+    }
 
-        const int headerLength = sizeof(m_receivedServerSalt) + sizeof(sessionId) + sizeof(messageId) + sizeof(sequence) + sizeof(contentLength);
-        QByteArray expectedMessageKey = Utils::sha1(decryptedData.left(headerLength + contentLength)).mid(4);
+    if (m_capture && m_capture->isPayloadCaptureEnabled()) {
+        m_capture->addRecord(CTransportCapture::IncomingPayload, message.payload);
+    }
 
-        if (messageKey != expectedMessageKey) {
-            qDebug() << Q_FUNC_INFO << "Wrong message key";
-            return;
+    // The objects decoded in the decoding thread are taken by the processing of their messages
+    m_decodedObjects = message.objects;
+    processRpcQuery(message.payload, message.messageId);
+    m_decodedObjects.clear();
+
+    if (m_outgoingMessagesCount && hasInFlightRoom()) {
+        // The results may free the in-flight window
+        scheduleOutgoingMessagesFlush();
+    }
+}
+
+CPackageDecoder::DecodedObject *CTelegramConnection::decodedObject(quint64 id)
+{
+    if (!id) {
+        return nullptr;
+    }
+    for (CPackageDecoder::DecodedObject &object : m_decodedObjects) {
+        if (object.id == id) {
+            return &object;
         }
+    }
+    return nullptr;
+}
 
-        payload = decryptedStream.readAll();
+QByteArray CTelegramConnection::gzipPackedMessage(const QByteArray &body)
+{
+    switch (TLValue::firstFromArray(body)) {
+    case TLValue::UploadSaveFilePart:
+    case TLValue::UploadSaveBigFilePart:
+        // The file parts are usually already compressed
+        return QByteArray();
+    default:
+        break;
+    }
 
-        processRpcQuery(payload);
+    const QByteArray packedData = Utils::packGZip(body);
+    // gzip_packed#3072cfa1 packed_data:bytes = Object; up to 12 bytes for the type, the length and the padding
+    if (packedData.isEmpty() || (packedData.size() + 12 >= body.size())) {
+        return QByteArray();
     }
 
-#ifdef DEVELOPER_BUILD
-    static int packagesCount = 0;
-    qDebug() << Q_FUNC_INFO << "Got package" << ++packagesCount << TLValue::firstFromArray(payload);
-#endif
+    QByteArray packedBody;
+    packedBody.reserve(packedData.size() + 12);
+    CTelegramStream stream(&packedBody, /* write */ true);
+    stream << TLValue::GzipPacked;
+    stream << packedData;
+    return packedBody;
 }
 
 void CTelegramConnection::onTransportTimeout()
@@ -4356,15 +5462,21 @@ void CTelegramConnection::onTimeToPing()
         return;
     }
 
-    if (m_lastSentPingTime && (m_lastSentPingTime > m_lastReceivedPingTime + m_pingInterval)) {
-        qDebug() << Q_FUNC_INFO << "pong time is out";
-        setStatus(ConnectionStatusDisconnected, ConnectionStatusReasonTimeout);
-        return;
-    }
-
     m_lastSentPingTime = QDateTime::currentMSecsSinceEpoch();
 
     pingDelayDisconnect(m_pingInterval + m_serverDisconnectionExtraTime); // Server will close the connection after m_serverDisconnectionExtraTime ms more, than our ping interval.
+
+    // Any incoming message stops the timer (see processDecodedMessage())
+    m_pongTimer->start(pongTimeout());
+}
+
+void CTelegramConnection::onPongTimeout()
+{
+    if (status() < ConnectionStatusConnected) {
+        return;
+    }
+    qDebug() << Q_FUNC_INFO << "pong time is out" << pongTimeout() << "ms";
+    setStatus(ConnectionStatusDisconnected, ConnectionStatusReasonTimeout);
 }
 
 void CTelegramConnection::onTimeToAckMessages()
@@ -4373,8 +5485,97 @@ void CTelegramConnection::onTimeToAckMessages()
         return;
     }
 
-    acknowledgeMessages(m_messagesToAck);
+    const TLVector<quint64> ids = m_messagesToAck;
     m_messagesToAck.clear();
+    acknowledgeMessages(ids);
+}
+
+void CTelegramConnection::onTimeToCheckRequests()
+{
+    const qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
+    for (const quint64 id : m_requestTracker.expiredRequests(currentTime)) {
+        qWarning() << Q_FUNC_INFO << "No result for the request" << id << TLValue::firstFromArray(m_requestTracker.data(id))
+                   << "in" << m_requestTimeout << "ms";
+        const quint32 fileRequestId = m_requestTracker.fileRequestId(id);
+        m_requestTracker.remove(id);
+        ++m_expiredRequestsCount;
+        emit requestFailed(id, fileRequestId);
+    }
+
+    if ((m_status >= ConnectionStatusConnected) && (m_authState >= AuthStateHaveAKey)) {
+        QVector<quint64> ids = m_requestTracker.requestsToCheck(currentTime);
+        if (!ids.isEmpty()) {
+            if (ids.count() > s_maxStateRequestIds) {
+                ids.resize(s_maxStateRequestIds);
+            }
+            const qint64 nextCheckTime = currentTime + stateRequestTimeout();
+            for (const quint64 id : ids) {
+                m_requestTracker.request(id)->stateCheckTime = nextCheckTime;
+            }
+            requestMessagesState(ids);
+        }
+    }
+
+    if (m_outgoingMessagesCount && hasInFlightRoom()) {
+        // The expired requests free the in-flight window
+        scheduleOutgoingMessagesFlush();
+    }
+
+    if (m_requestTracker.isEmpty()) {
+        m_requestTimer->stop();
+    }
+}
+
+void CTelegramConnection::updateServerSalt()
+{
+    const quint32 currentTime = QDateTime::currentMSecsSinceEpoch() / 1000 + deltaTime();
+
+    m_futureSalts.erase(std::remove_if(m_futureSalts.begin(), m_futureSalts.end(), [currentTime](const SFutureSalt &salt) {
+        return salt.validUntil <= currentTime + s_serverSaltSwitchMargin;
+    }), m_futureSalts.end());
+
+    // The salts are sorted by the validSince, so the latest valid salt wins
+    quint32 nextUpdateTime = 0;
+    for (const SFutureSalt &salt : m_futureSalts) {
+        if (salt.validSince > currentTime) {
+            if (!nextUpdateTime || (salt.validSince < nextUpdateTime)) {
+                nextUpdateTime = salt.validSince;
+            }
+            break;
+        }
+        if (m_serverSalt != salt.salt) {
+            qDebug() << Q_FUNC_INFO << "Switch to the server salt" << salt.salt << "valid until" << salt.validUntil;
+            m_serverSalt = salt.salt;
+        }
+        nextUpdateTime = salt.validUntil - s_serverSaltSwitchMargin;
+    }
+
+    if (nextUpdateTime) {
+        m_saltTimer->start(qMax<quint32>(1, nextUpdateTime - currentTime) * 1000);
+    } else {
+        m_saltTimer->stop();
+    }
+
+    const bool needMoreSalts = m_futureSalts.isEmpty() || (m_futureSalts.last().validUntil < currentTime + s_futureSaltsPrefetchPeriod);
+    if (needMoreSalts && !m_futureSaltsRequestId && (m_status >= ConnectionStatusConnected) && (m_authState >= AuthStateHaveAKey)) {
+        getFutureSalts(s_futureSaltsCount);
+    }
+}
+
+void CTelegramConnection::onFutureSaltsTimeout()
+{
+    qWarning() << Q_FUNC_INFO << "No answer for the future salts request" << m_futureSaltsRequestId;
+    m_futureSaltsRequestId = 0;
+    updateServerSalt();
+}
+
+qint64 CTelegramConnection::oldestPendingRequestAge() const
+{
+    const qint64 sentTime = m_requestTracker.oldestSentTime();
+    if (!sentTime) {
+        return 0;
+    }
+    return QDateTime::currentMSecsSinceEpoch() - sentTime;
 }
 
 bool CTelegramConnection::checkClientServerNonse(CTelegramStream &stream) const
@@ -4414,15 +5615,14 @@ SAesKey CTelegramConnection::generateTmpAesKey() const
 
 SAesKey CTelegramConnection::generateAesKey(const QByteArray &messageKey, int x) const
 {
-    QByteArray sha1_a = Utils::sha1(messageKey + m_authKey.mid(x, 32));
-    QByteArray sha1_b = Utils::sha1(m_authKey.mid(32 + x, 16) + messageKey + m_authKey.mid(48 + x, 16));
-    QByteArray sha1_c = Utils::sha1(m_authKey.mid(64 + x, 32) + messageKey);
-    QByteArray sha1_d = Utils::sha1(messageKey + m_authKey.mid(96 + x, 32));
-
-    const QByteArray key = sha1_a.mid(0, 8) + sha1_b.mid(8, 12) + sha1_c.mid(4, 12);
-    const QByteArray iv  = sha1_a.mid(8, 12) + sha1_b.mid(0, 8) + sha1_c.mid(16, 4) + sha1_d.mid(0, 8);
+    SAesKeyData keyData;
+    generateAesKey(&keyData, reinterpret_cast<const uchar *>(messageKey.constData()), x);
+    return keyData.toAesKey();
+}
 
-    return SAesKey(key, iv);
+void CTelegramConnection::generateAesKey(SAesKeyData *aesKey, const uchar *messageKey, int x) const
+{
+    Utils::generateMessageAesKey(aesKey, m_authKeyData, messageKey, x);
 }
 
 void CTelegramConnection::insertInitConnection(QByteArray *data) const
@@ -4459,115 +5659,404 @@ quint64 CTelegramConnection::sendPlainPackage(const QByteArray &buffer)
     qDebug() << output.size();
     m_transport->sendPackage(output);
 
-#ifdef NETWORK_LOGGING
-    CTelegramStream readBack(buffer);
-    TLValue val1;
-    readBack >> val1;
-
-    QTextStream str(m_logFile);
-
-    str << QDateTime::currentDateTime().toString(QLatin1String("yyyyMMdd HH:mm:ss:zzz")) << QLatin1Char('|');
-    str << QLatin1String("pln|");
-    str << QString(QLatin1String("size: %1|")).arg(buffer.length(), 4, 10, QLatin1Char('0'));
-    str << formatTLValue(val1) << QLatin1Char('|');
-    str << buffer.toHex();
-    str << endl;
-    str.flush();
-#endif
-
     return messageId;
 }
 
 quint64 CTelegramConnection::sendEncryptedPackage(const QByteArray &buffer, bool savePackage)
 {
-    QByteArray encryptedPackage;
-    QByteArray messageKey;
-    quint64 messageId = newMessageId();
-    {
-        m_sequenceNumber = m_contentRelatedMessages * 2 + 1;
-        ++m_contentRelatedMessages;
+    const quint64 messageId = newMessageId();
+    m_sequenceNumber = m_contentRelatedMessages * 2 + 1;
+    ++m_contentRelatedMessages;
+
+    if (savePackage) {
+        // Story only content-related messages
+        // The timeouts start when the message is released to the transport
+        CRequestTracker::Request request;
+        request.data = buffer;
+        m_requestTracker.insert(messageId, request);
+        if (!m_requestTimer->isActive()) {
+            m_requestTimer->start();
+        }
+        reportDroppedRequests();
+    }
+
+    QByteArray body;
+    if (m_sequenceNumber == 1) {
+        insertInitConnection(&body);
+    }
+    body.append(buffer);
 
-        if (savePackage) {
-            // Story only content-related messages
-            m_submittedPackages.insert(messageId, buffer);
+    if (m_gzipPackingThreshold && (body.size() >= m_gzipPackingThreshold)) {
+        const QByteArray packedBody = gzipPackedMessage(body);
+        if (!packedBody.isEmpty()) {
+            body = packedBody;
         }
+    }
 
-        QByteArray innerData;
-        CRawStream stream(&innerData, /* write */ true);
+    qDebug() << this << "sendEncryptedPackage()" << TLValue::firstFromArray(buffer).toString() << "message id:" << messageId << "dc: " << m_dcInfo.id;
 
-        stream << m_serverSalt;
-        stream << m_sessionId;
-        stream << messageId;
-        stream << m_sequenceNumber;
+    OutgoingMessage message;
+    message.id = messageId;
+    message.seqNo = m_sequenceNumber;
+    // The message with initConnection must not be overtaken
+    message.priority = m_sequenceNumber == 1 ? PriorityControl : messagePriority(TLValue::firstFromArray(buffer));
+    message.queuedTime = QDateTime::currentMSecsSinceEpoch();
+    message.data = body;
+    m_outgoingQueues[message.priority].append(message);
+    ++m_outgoingMessagesCount;
+    m_outgoingMessagesSize += body.size();
+
+    if (!m_messageBatchingEnabled || (body.size() > s_maxBatchedMessageSize)) {
+        flushOutgoingMessages();
+    } else {
+        // Pack all messages sent during this event loop iteration
+        scheduleOutgoingMessagesFlush();
+        updateBackpressure();
+    }
 
-        QByteArray header;
-        if (m_sequenceNumber == 1) {
-            insertInitConnection(&header);
-        }
+    return messageId;
+}
 
-        stream << quint32(header.length() + buffer.length());
-        stream << header + buffer;
+CTelegramConnection::MessagePriority CTelegramConnection::messagePriority(TLValue value)
+{
+    switch (value) {
+    case TLValue::MsgsAck:
+    case TLValue::Ping:
+    case TLValue::PingDelayDisconnect:
+    case TLValue::MsgsStateReq:
+    case TLValue::MsgResendReq:
+    case TLValue::GetFutureSalts:
+        return PriorityControl;
+    case TLValue::UpdatesGetDifference:
+    case TLValue::UpdatesGetChannelDifference:
+    case TLValue::MessagesGetDialogs:
+    case TLValue::MessagesGetHistory:
+    case TLValue::ChannelsGetImportantHistory:
+    case TLValue::ContactsGetContacts:
+    case TLValue::ContactsGetStatuses:
+        return PriorityBackground;
+    case TLValue::UploadGetFile:
+    case TLValue::UploadSaveFilePart:
+    case TLValue::UploadSaveBigFilePart:
+        return PriorityBulk;
+    default:
+        return PriorityInteractive;
+    }
+}
 
-        messageKey = Utils::sha1(innerData).mid(4);
-        const SAesKey key = generateClientToServerAesKey(messageKey);
+qint64 CTelegramConnection::averageQueueLatency(MessagePriority priority) const
+{
+    const QueueStats &stats = m_queueStats[priority];
+    if (!stats.count) {
+        return 0;
+    }
+    return stats.totalLatency / qint64(stats.count);
+}
 
-        quint32 packageLength = innerData.length();
+void CTelegramConnection::scheduleOutgoingMessagesFlush()
+{
+    if (m_outgoingFlushScheduled) {
+        return;
+    }
+    m_outgoingFlushScheduled = true;
+    QTimer::singleShot(0, this, &CTelegramConnection::flushOutgoingMessages);
+}
 
-        if ((packageLength) % 16) {
-            QByteArray randomPadding;
-            randomPadding.resize(16 - (packageLength % 16));
-            Utils::randomBytes(&randomPadding);
+void CTelegramConnection::setMaxInFlightRequests(int count)
+{
+    m_maxInFlightRequests = count;
+    if (m_outgoingMessagesCount && hasInFlightRoom()) {
+        scheduleOutgoingMessagesFlush();
+    }
+}
 
-            packageLength += randomPadding.size();
+bool CTelegramConnection::hasInFlightRoom() const
+{
+    return !m_maxInFlightRequests || (m_requestTracker.sentCount() < m_maxInFlightRequests);
+}
+
+void CTelegramConnection::updateBackpressure()
+{
+    bool active;
+    if (m_backpressureActive) {
+        active = (m_outgoingMessagesCount > s_sendQueueHighWaterCount / 2) || (m_outgoingMessagesSize > s_sendQueueHighWaterSize / 2);
+    } else {
+        active = (m_outgoingMessagesCount >= s_sendQueueHighWaterCount) || (m_outgoingMessagesSize >= s_sendQueueHighWaterSize);
+    }
+    if (m_backpressureActive == active) {
+        return;
+    }
+    m_backpressureActive = active;
+    qDebug() << Q_FUNC_INFO << "dc:" << m_dcInfo.id << "active:" << active << "queued messages:" << m_outgoingMessagesCount << "bytes:" << m_outgoingMessagesSize;
+    emit backpressureChanged(active, m_outgoingMessagesCount, m_outgoingMessagesSize, m_dcInfo.id);
+}
+
+void CTelegramConnection::onTransportBytesWritten()
+{
+    if (!m_outgoingQueues[PriorityBulk].isEmpty()) {
+        scheduleOutgoingMessagesFlush();
+    }
+}
+
+void CTelegramConnection::flushOutgoingMessages()
+{
+    m_outgoingFlushScheduled = false;
+
+    bool budgetExceeded = false;
+    QVector<OutgoingMessage> messages = takeOutgoingMessages(&budgetExceeded);
+    updateBackpressure();
+    if (messages.isEmpty()) {
+        return;
+    }
+
+    if (m_messageBatchingEnabled && !m_messagesToAck.isEmpty()) {
+        // Piggyback the pending acknowledgements instead of a separate package
+        QByteArray ackData;
+        CTelegramStream ackStream(&ackData, /* write */ true);
+        ackStream << TLValue::MsgsAck;
+        ackStream << m_messagesToAck;
+
+        OutgoingMessage ackMessage;
+        ackMessage.id = newMessageId();
+        ackMessage.seqNo = m_contentRelatedMessages * 2; // Not content-related
+        ackMessage.priority = PriorityControl;
+        ackMessage.queuedTime = QDateTime::currentMSecsSinceEpoch();
+        ackMessage.data = ackData;
+        messages.append(ackMessage);
+
+        m_messagesToAck.clear();
+        m_ackTimer->stop();
+        ++m_savedAckPackagesCount;
+    }
 
-            stream << randomPadding;
+    QVector<OutgoingMessage> pack;
+    int packSize = 0;
+    for (const OutgoingMessage &message : messages) {
+        const int size = message.data.size();
+        if (!m_messageBatchingEnabled || (size > s_maxBatchedMessageSize)) {
+            sendOutgoingMessages(QVector<OutgoingMessage>({ message }));
+            continue;
         }
+        if (!pack.isEmpty() && ((packSize + size > s_maxContainerSize) || (pack.count() >= s_maxContainerMessages))) {
+            sendOutgoingMessages(pack);
+            pack.clear();
+            packSize = 0;
+        }
+        pack.append(message);
+        packSize += size;
+    }
+    if (!pack.isEmpty()) {
+        sendOutgoingMessages(pack);
+    }
 
-        encryptedPackage = Utils::aesEncrypt(innerData, key).left(packageLength);
+    if (budgetExceeded) {
+        // Continue on the next event loop iteration
+        scheduleOutgoingMessagesFlush();
     }
+}
 
-    qDebug() << this << "sendEncryptedPackage()" << TLValue::firstFromArray(buffer).toString() << "message id:" << messageId << "dc: " << m_dcInfo.id;
+QVector<CTelegramConnection::OutgoingMessage> CTelegramConnection::takeOutgoingMessages(bool *budgetExceeded)
+{
+    const qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
+    const quint32 stateCheckTimeout = stateRequestTimeout();
 
-    QByteArray output;
-    CRawStream outputStream(&output, /* write */ true);
+    QVector<OutgoingMessage> messages;
+    bool higherPrioritiesIdle = true;
+    for (int priority = PriorityControl; priority < PriorityCount; ++priority) {
+        QVector<OutgoingMessage> &queue = m_outgoingQueues[priority];
+        if (queue.isEmpty()) {
+            continue;
+        }
+        if ((priority == PriorityBulk) && (!higherPrioritiesIdle || (m_transport && (m_transport->bytesToWrite() > s_bulkReleaseThreshold)))) {
+            // Wait for the transport bytesWritten() or for the next flush
+            break;
+        }
 
-    outputStream << m_authId;
-    outputStream << messageKey;
-    outputStream << encryptedPackage;
+        // At least one message is released even if it exceeds the budget
+        const int budget = s_priorityByteBudgets[priority];
+        QueueStats &stats = m_queueStats[priority];
+        int count = 0;
+        int size = 0;
+        while (count < queue.count()) {
+            OutgoingMessage &message = queue[count];
+            if (budget && count && (size + message.data.size() > budget)) {
+                *budgetExceeded = true;
+                break;
+            }
+            const bool tracked = m_requestTracker.contains(message.id);
+            if (tracked && (priority != PriorityControl) && !hasInFlightRoom()) {
+                // Wait for the results of the sent requests
+                break;
+            }
+            if (currentTime - message.queuedTime > s_maxMessageQueueTime) {
+                renewMessageId(&message);
+            }
+            if (tracked) {
+                // The timeouts and the state checks start only when the request is actually sent
+                CRequestTracker::Request *request = m_requestTracker.request(message.id);
+                request->sentTime = currentTime;
+                request->deadline = m_requestTimeout ? currentTime + m_requestTimeout : 0;
+                request->stateCheckTime = currentTime + stateCheckTimeout;
+                m_requestTracker.setSent(message.id);
+            }
 
-    m_transport->sendPackage(output);
+            const qint64 latency = currentTime - message.queuedTime;
+            ++stats.count;
+            stats.totalLatency += latency;
+            stats.maxLatency = qMax(stats.maxLatency, latency);
 
-#ifdef NETWORK_LOGGING
-    CTelegramStream readBack(buffer);
-    TLValue val1;
-    readBack >> val1;
+            messages.append(message);
+            size += message.data.size();
+            ++count;
+        }
+        queue.remove(0, count);
+        m_outgoingMessagesCount -= count;
+        m_outgoingMessagesSize -= size;
+
+        if (!queue.isEmpty()) {
+            higherPrioritiesIdle = false;
+        }
+    }
+    return messages;
+}
 
-    QTextStream str(m_logFile);
+void CTelegramConnection::renewMessageId(OutgoingMessage *message)
+{
+    // The message id and the sequence number of the message must grow together
+    const quint64 newId = newMessageId();
+    if (message->seqNo & 1) {
+        message->seqNo = m_contentRelatedMessages * 2 + 1;
+        ++m_contentRelatedMessages;
+    } else {
+        message->seqNo = m_contentRelatedMessages * 2;
+    }
+    if (m_requestTracker.contains(message->id)) {
+        m_requestTracker.insert(newId, m_requestTracker.take(message->id));
+    }
+#ifdef DEVELOPER_BUILD
+    qDebug() << Q_FUNC_INFO << "message id:" << message->id << "->" << newId;
+#endif
+    message->id = newId;
+}
+
+void CTelegramConnection::sendOutgoingMessages(const QVector<OutgoingMessage> &messages)
+{
+    if (messages.count() == 1) {
+        const OutgoingMessage &message = messages.first();
+        sendEncryptedMessage(message.id, message.seqNo, message.data);
+        return;
+    }
 
-    str << QString(QLatin1String("%1|enc|mId%2|seq%3|"))
-           .arg(QDateTime::currentDateTime().toString(QLatin1String("yyyyMMdd HH:mm:ss:zzz")))
-           .arg(messageId, 10, 10, QLatin1Char('0'))
-           .arg(m_sequenceNumber, 4, 10, QLatin1Char('0'));
+    int messagesSize = 0;
+    for (const OutgoingMessage &message : messages) {
+        messagesSize += message.data.size();
+    }
 
-    str << QString(QLatin1String("size: %1|")).arg(buffer.length(), 4, 10, QLatin1Char('0'));
+    // https://core.telegram.org/mtproto/service_messages#simple-container
+    QByteArray container;
+    container.reserve(8 + messagesSize + messages.count() * 16);
+    CRawStream stream(&container, /* write */ true);
+    stream << quint32(TLValue::MsgContainer);
+    stream << quint32(messages.count());
+
+    QVector<quint64> messageIds;
+    messageIds.reserve(messages.count());
+    for (const OutgoingMessage &message : messages) {
+        stream << message.id;
+        stream << message.seqNo;
+        stream << quint32(message.data.size());
+        stream << message.data;
+        messageIds.append(message.id);
+    }
 
-    str << formatTLValue(val1) << QLatin1Char('|');
-    str << buffer.toHex();
-    str << endl;
-    str.flush();
+    // The container id must be greater than the ids of the contained messages
+    const quint64 containerId = newMessageId();
+    m_sentContainers.insert(containerId, messageIds);
+    if (m_sentContainers.count() > s_maxRememberedContainers) {
+        m_sentContainers.erase(m_sentContainers.begin());
+    }
+#ifdef DEVELOPER_BUILD
+    qDebug() << Q_FUNC_INFO << "container id:" << containerId << "messages:" << messageIds;
 #endif
+    // A container is not content-related
+    sendEncryptedMessage(containerId, m_contentRelatedMessages * 2, container);
+}
 
-    return messageId;
+void CTelegramConnection::sendEncryptedMessage(quint64 messageId, quint32 sequenceNumber, const QByteArray &body)
+{
+    if (m_capture && m_capture->isPayloadCaptureEnabled()) {
+        m_capture->addRecord(CTransportCapture::OutgoingPayload, body);
+    }
+
+    // The envelope, the body and the padding are written into a single allocation and encrypted in place
+    const int contentSize = s_encryptedEnvelopeSize + body.size();
+    const int paddingSize = (16 - contentSize % 16) % 16;
+
+    QByteArray output;
+    output.reserve(s_encryptedHeaderSize + contentSize + paddingSize);
+    CRawStream outputStream(&output, /* write */ true);
+
+    outputStream << m_authId;
+    output.resize(s_encryptedHeaderSize); // The message key is filled after the content is written
+
+    outputStream << m_serverSalt;
+    outputStream << m_sessionId;
+    outputStream << messageId;
+    outputStream << sequenceNumber;
+    outputStream << quint32(body.length());
+    outputStream << body;
+
+    char *content = output.data() + s_encryptedHeaderSize;
+    const QByteArray messageKey = Utils::sha1(QByteArray::fromRawData(content, contentSize)).mid(4);
+    memcpy(output.data() + 8, messageKey.constData(), messageKey.size());
+
+    output.resize(s_encryptedHeaderSize + contentSize + paddingSize);
+    content = output.data() + s_encryptedHeaderSize;
+    if (paddingSize) {
+        Utils::randomBytes(content + contentSize, paddingSize);
+    }
+
+    SAesKeyData key;
+    generateClientToServerAesKey(&key, messageKey);
+    if (!Utils::aesIgeEncrypt(content, contentSize + paddingSize, key)) {
+        qWarning() << Q_FUNC_INFO << "Unable to encrypt the message" << messageId;
+        return;
+    }
+
+    m_transport->sendPackage(output);
 }
 
 quint64 CTelegramConnection::sendEncryptedPackageAgain(quint64 id)
 {
-    --m_contentRelatedMessages;
-    const QByteArray data = m_submittedPackages.take(id);
+    if (m_sentContainers.contains(id)) {
+        // Resend the content of the container
+        quint64 lastId = 0;
+        for (const quint64 messageId : m_sentContainers.take(id)) {
+            if (m_requestTracker.contains(messageId)) {
+                lastId = sendEncryptedPackageAgain(messageId);
+            }
+        }
+        return lastId;
+    }
+
+    const CRequestTracker::Request request = m_requestTracker.take(id);
 #ifdef DEVELOPER_BUILD
-    qDebug() << Q_FUNC_INFO << id << TLValue::firstFromArray(data);
+    qDebug() << Q_FUNC_INFO << id << TLValue::firstFromArray(request.data) << "retries:" << request.retries;
 #endif
-    return sendEncryptedPackage(data);
+    if (request.retries >= s_maxRequestRetries) {
+        qWarning() << Q_FUNC_INFO << "Give up the request" << id << TLValue::firstFromArray(request.data) << "after" << request.retries << "retries";
+        emit requestFailed(id, request.fileRequestId);
+        return 0;
+    }
+
+    // The resent request gets a new id and a new sequence number, as the ids and the sequence numbers must grow together
+    const quint64 newId = sendEncryptedPackage(request.data);
+    CRequestTracker::Request *newRequest = m_requestTracker.request(newId);
+    if (newRequest) {
+        newRequest->retries = request.retries + 1;
+        newRequest->fileRequestId = request.fileRequestId;
+    }
+    return newId;
 }
 
 void CTelegramConnection::setStatus(ConnectionStatus status, ConnectionStatusReason reason)
@@ -4581,6 +6070,8 @@ void CTelegramConnection::setStatus(ConnectionStatus status, ConnectionStatusRea
 
     if (status < ConnectionStatusConnected) {
         stopPingTimer();
+    } else if (m_authState >= AuthStateHaveAKey) {
+        updateServerSalt();
     }
 }
 
@@ -4603,6 +6094,10 @@ void CTelegramConnection::setAuthState(CTelegramConnection::AuthState newState)
         if (m_pingInterval) {
             startPingTimer();
         }
+
+        if (m_status >= ConnectionStatusConnected) {
+            updateServerSalt();
+        }
     }
 }
 
@@ -4614,7 +6109,7 @@ quint64 CTelegramConnection::newMessageId()
 
 QString CTelegramConnection::userNameFromPackage(quint64 id) const
 {
-    const QByteArray data = m_submittedPackages.value(id);
+    const QByteArray data = m_requestTracker.data(id);
 
     if (data.isEmpty()) {
         return QString();
@@ -4671,6 +6166,9 @@ void CTelegramConnection::startPingTimer()
         m_pingTimer = new QTimer(this);
         m_pingTimer->setSingleShot(false);
         connect(m_pingTimer, &QTimer::timeout, this, &CTelegramConnection::onTimeToPing);
+        m_pongTimer = new QTimer(this);
+        m_pongTimer->setSingleShot(true);
+        connect(m_pongTimer, &QTimer::timeout, this, &CTelegramConnection::onPongTimeout);
     }
 
     if (m_pingTimer->interval() != static_cast<int>(m_pingInterval)) {
@@ -4694,20 +6192,34 @@ void CTelegramConnection::stopPingTimer()
     if (m_pingTimer && m_pingTimer->isActive()) {
         qDebug() << Q_FUNC_INFO;
         m_pingTimer->stop();
+        m_pongTimer->stop();
     }
 }
 
 void CTelegramConnection::addMessageToAck(quint64 id)
 {
 //    qDebug() << Q_FUNC_INFO << id;
+    // The timer is a fallback for the case of no outgoing traffic
     if (!m_ackTimer->isActive()) {
         m_ackTimer->start();
     }
 
     m_messagesToAck.append(id);
 
-    if (m_messagesToAck.count() > 6) {
+    if (m_outgoingFlushScheduled) {
+        // The acknowledgements will be sent along with the queued messages
+        return;
+    }
+
+    if (m_messagesToAck.count() > s_maxPendingAcks) {
         onTimeToAckMessages();
         m_ackTimer->stop();
     }
 }
+
+void CTelegramConnection::reportDroppedRequests()
+{
+    for (const auto &request : m_requestTracker.takeDroppedRequests()) {
+        emit requestFailed(request.first, request.second);
+    }
+}
@@ -22,6 +22,7 @@
 #include <QByteArray>
 #include <QVector>
 #include <QMap>
+#include <QPointer>
 #include <QStringList>
 
 #include "TelegramNamespace.hpp"
@@ -29,6 +30,12 @@
 #include "TLNumbers.hpp"
 #include "crypto-rsa.hpp"
 #include "crypto-aes.hpp"
+#include "CPackageDecoder.hpp"
+#include "CMessageIdWindow.hpp"
+#include "CRequestTracker.hpp"
+#include "CTransportCapture.hpp"
+#include "FutureSalt.hpp"
+#include "MessageProjection.hpp"
 
 class CAppInformation;
 class CTelegramStream;
@@ -39,6 +46,7 @@ class RpcProcessingContext;
 QT_FORWARD_DECLARE_CLASS(QFile)
 #endif
 
+QT_FORWARD_DECLARE_CLASS(QThread)
 QT_FORWARD_DECLARE_CLASS(QTimer)
 
 class CTelegramConnection : public QObject
@@ -90,8 +98,32 @@ public:
 
     TLDcOption dcInfo() const { return m_dcInfo; }
 
+    // The addresses to race against the dcInfo() address on connection
+    QVector<Telegram::DcOption> alternativeAddresses() const { return m_alternativeAddresses; }
+    void setAlternativeAddresses(const QVector<Telegram::DcOption> &addresses);
+
+    CTelegramTransport *transport() const { return m_transport; }
     void setTransport(CTelegramTransport *newTransport);
 
+    // Decrypt, unpack and decode the incoming packages in the given thread; nullptr means the connection thread.
+    // The bulky TL objects (see CPackageDecoder::decodeObjects()) are decoded in the thread as well,
+    // the decoded objects are processed in the connection thread.
+    bool isThreadedDecodingEnabled() const { return m_decodingWorker; }
+    void setDecodingThread(QThread *thread);
+
+    // The capture records the transport packages and, if enabled, the decrypted messages
+    CTransportCapture *capture() const { return m_capture; }
+    void setCapture(CTransportCapture *capture);
+
+    // The entry points of an offline replay of the captured traffic (see CTransportCapture)
+    void prepareReplay(quint64 sessionId);
+    void replayPackage(const QByteArray &package) { onTransportPackageReceived(package); }
+    void replayPayload(const QByteArray &payload) { processRpcQuery(payload); }
+
+    // The incoming messages are read by the projection, if any (see CTelegramStream::setMessageProjection())
+    MessageProjection messageProjection() const { return m_messageProjection; }
+    void setMessageProjection(MessageProjection projection);
+
 public slots:
     void connectToDc();
     void disconnectFromDc();
@@ -104,6 +136,67 @@ public:
     void initAuth();
     void setKeepAliveSettings(quint32 interval, quint32 serverDisconnectionExtraTime);
 
+    enum MessagePriority {
+        PriorityControl, // Acknowledgements and other service messages
+        PriorityInteractive,
+        PriorityBackground, // Updates and history fetching
+        PriorityBulk, // File transfer; released only when the higher classes are idle
+        PriorityCount
+    };
+
+    static MessagePriority messagePriority(TLValue value);
+
+    // Monitoring of the time (in ms) spent by the messages in the outgoing queue
+    quint64 releasedMessagesCount(MessagePriority priority) const { return m_queueStats[priority].count; }
+    qint64 averageQueueLatency(MessagePriority priority) const;
+    qint64 maxQueueLatency(MessagePriority priority) const { return m_queueStats[priority].maxLatency; }
+
+    // The requests are kept in the outgoing queue while the number of the sent requests without results
+    // reaches the limit; zero means no limit
+    int maxInFlightRequests() const { return m_maxInFlightRequests; }
+    void setMaxInFlightRequests(int count);
+    int inFlightRequestsCount() const { return m_requestTracker.sentCount(); }
+
+    // The backpressure is active from the outgoing queue high water mark till the queue is half drained
+    int queuedMessagesCount() const { return m_outgoingMessagesCount; }
+    int queuedMessagesSize() const { return m_outgoingMessagesSize; }
+    bool isBackpressureActive() const { return m_backpressureActive; }
+
+    // Pack the messages sent during an event loop iteration into a container
+    bool isMessageBatchingEnabled() const { return m_messageBatchingEnabled; }
+    void setMessageBatchingEnabled(bool enabled);
+
+    // Messages at least of the threshold size are sent as gzip_packed, if it makes them smaller; zero disables the packing
+    int gzipPackingThreshold() const { return m_gzipPackingThreshold; }
+    void setGzipPackingThreshold(int bytes) { m_gzipPackingThreshold = bytes; }
+
+    // The requests without a result are dropped after the timeout (in ms); zero disables the expiration
+    quint32 requestTimeout() const { return m_requestTimeout; }
+    void setRequestTimeout(quint32 timeout) { m_requestTimeout = timeout; }
+
+    // Monitoring of the requests waiting for the results
+    int pendingRequestsCount() const { return m_requestTracker.count(); }
+    qint64 pendingRequestsSize() const { return m_requestTracker.totalSize(); }
+    qint64 oldestPendingRequestAge() const;
+    quint64 expiredRequestsCount() const { return m_expiredRequestsCount; }
+    quint64 droppedRequestsCount() const { return m_requestTracker.droppedCount(); }
+    // The number of requests sent again after the server reported them as not received
+    quint64 recoveredRequestsCount() const { return m_recoveredRequestsCount; }
+
+    // The number of incoming messages dropped as already processed (or too old to check)
+    quint64 duplicateMessagesCount() const { return m_incomingMessageIds.droppedCount(); }
+
+    // The number of acknowledgement packages saved by attaching the acks to other messages
+    quint64 savedAckPackagesCount() const { return m_savedAckPackagesCount; }
+
+    // Round trip time estimation (RFC 6298) from ping/pong pairs and RPC results
+    qint64 smoothedRtt() const { return m_smoothedRtt; }
+    qint64 rttVariance() const { return m_rttVariance; }
+    quint32 retransmissionTimeout() const;
+    quint32 connectionTimeout() const;
+    quint32 pongTimeout() const;
+    quint32 stateRequestTimeout() const;
+
     // Generated Telegram API methods declaration
     quint64 accountChangePhone(const QString &phoneNumber, const QString &phoneCodeHash, const QString &phoneCode);
     quint64 accountCheckUsername(const QString &username);
@@ -261,6 +354,8 @@ public:
     quint64 pingDelayDisconnect(quint32 disconnectInSec);
 
     quint64 acknowledgeMessages(const TLVector<quint64> &idsVector);
+    quint64 requestMessagesState(const TLVector<quint64> &idsVector);
+    quint64 requestMessagesResend(const TLVector<quint64> &idsVector);
 
     quint64 requestPhoneCode(const QString &phoneNumber);
     quint64 signIn(const QString &phoneNumber, const QString &authCode);
@@ -296,6 +391,11 @@ public:
 
     quint64 serverSalt() const { return m_serverSalt; }
     void setServerSalt(const quint64 salt) { m_serverSalt = salt; }
+    // The server salts schedule, used to switch the salt before the current one expires
+    QVector<SFutureSalt> futureSalts() const { return m_futureSalts; }
+    void setFutureSalts(const QVector<SFutureSalt> &salts);
+    quint64 getFutureSalts(quint32 count);
+    quint64 futureSaltsRequestId() const { return m_futureSaltsRequestId; }
     quint64 sessionId() const { return m_sessionId; }
 
     QVector<TLDcOption> dcConfiguration() const { return m_dcConfiguration; }
@@ -327,6 +427,9 @@ signals:
     void contactListChanged(const QVector<quint32> &added, const QVector<quint32> &removed);
     void fileDataReceived(const TLUploadFile &file, quint32 requestId, quint32 offset);
     void fileDataSent(quint32 requestId);
+    // The request got no result: it is dropped because of the tracker limits, expired, given up after the retries
+    // or lost in the outgoing queue on the disconnection
+    void requestFailed(quint64 requestId, quint32 fileRequestId);
 
     void messagesChatsReceived(const QVector<TLChat> &chats);
     void messagesFullChatReceived(const TLChatFull &chat, const QVector<TLChat> &chats, const QVector<TLUser> &users);
@@ -345,8 +448,10 @@ signals:
 
     void authExportedAuthorizationReceived(quint32 dc, quint32 id, const QByteArray &data);
 
+    void backpressureChanged(bool active, int queuedMessages, int queuedBytes, quint32 dc);
+
 protected:
-    TLValue processRpcQuery(const QByteArray &data);
+    TLValue processRpcQuery(const QByteArray &data, quint64 messageId = 0);
 
     void processSessionCreated(CTelegramStream &stream);
     void processContainer(CTelegramStream &stream);
@@ -357,6 +462,10 @@ protected:
 
     void processMessageAck(CTelegramStream &stream);
     void processIgnoredMessageNotification(CTelegramStream &stream);
+    void processMessagesStateInfo(CTelegramStream &stream);
+    void processMessageDetailedInfo(CTelegramStream &stream);
+    void processMessageNewDetailedInfo(CTelegramStream &stream);
+    void processFutureSalts(CTelegramStream &stream);
     void processPingPong(CTelegramStream &stream);
 
     // Generated Telegram API RPC process declarations
@@ -490,19 +599,23 @@ protected:
     void processAuthSign(RpcProcessingContext *context);
     bool processErrorSeeOther(const QString errorMessage, quint64 id);
 
-    TLValue processUpdate(CTelegramStream &stream, bool *ok, quint64 id);
+    TLValue processUpdate(CTelegramStream &stream, bool *ok, quint64 id, CPackageDecoder::DecodedObject *decodedObject = nullptr);
 
     SAesKey generateTmpAesKey() const;
     SAesKey generateClientToServerAesKey(const QByteArray &messageKey) const;
     SAesKey generateServerToClientAesKey(const QByteArray &messageKey) const;
+    void generateClientToServerAesKey(SAesKeyData *aesKey, const QByteArray &messageKey) const;
+    void generateServerToClientAesKey(SAesKeyData *aesKey, const QByteArray &messageKey) const;
 
     SAesKey generateAesKey(const QByteArray &messageKey, int xValue) const;
+    void generateAesKey(SAesKeyData *aesKey, const uchar *messageKey, int xValue) const;
 
     void insertInitConnection(QByteArray *data) const;
 
     quint64 sendPlainPackage(const QByteArray &buffer);
     quint64 sendEncryptedPackage(const QByteArray &buffer, bool savePackage = true);
     quint64 sendEncryptedPackageAgain(quint64 id);
+    void sendEncryptedMessage(quint64 messageId, quint32 sequenceNumber, const QByteArray &body);
 
     void setStatus(ConnectionStatus status, ConnectionStatusReason reason);
     void setAuthState(AuthState newState);
@@ -517,45 +630,110 @@ protected:
     void startPingTimer();
     void stopPingTimer();
 
+    void addRttSample(qint64 rtt);
+
     void addMessageToAck(quint64 id);
+    void reportDroppedRequests();
 
 protected slots:
     void onTransportStateChanged();
     void onTransportPackageReceived(const QByteArray &package);
+    void onMessageDecoded(const CPackageDecoder::Message &message);
     void onTransportTimeout();
     void onTimeToPing();
+    void onPongTimeout();
+    void flushOutgoingMessages();
     void onTimeToAckMessages();
+    void onTimeToCheckRequests();
+    void onTransportBytesWritten();
+    void updateServerSalt();
+    void onFutureSaltsTimeout();
 
 protected:
     bool checkClientServerNonse(CTelegramStream &stream) const;
+    void processDecodedMessage(const CPackageDecoder::Message &message);
+    CPackageDecoder::DecodedObject *decodedObject(quint64 id);
+    static QByteArray gzipPackedMessage(const QByteArray &body);
 
     ConnectionStatus m_status;
     const CAppInformation *m_appInfo;
 
-    QMap<quint64, QByteArray> m_submittedPackages; // <message id, package data>
-    QMap<quint64, quint32> m_requestedFilesIds; // <message id, file id>
+    CRequestTracker m_requestTracker;
+    quint32 m_requestTimeout;
+    quint64 m_expiredRequestsCount;
+    quint64 m_recoveredRequestsCount;
+    QMap<quint64, TLVector<quint64> > m_stateRequests; // <msgs_state_req id, requested message ids>
+    CMessageIdWindow m_incomingMessageIds;
 
     CTelegramTransport *m_transport;
     QTimer *m_authTimer;
     QTimer *m_pingTimer;
+    QTimer *m_pongTimer;
     QTimer *m_ackTimer;
+    QTimer *m_requestTimer;
+    QTimer *m_saltTimer;
+    QTimer *m_futureSaltsTimer;
 
     AuthState m_authState;
 
     QByteArray m_authKey;
+    uchar m_authKeyData[256]; // The auth key copy for the AES key derivation
     quint64 m_authId;
     quint64 m_authKeyAuxHash;
     quint64 m_serverSalt;
     quint64 m_receivedServerSalt;
+    QVector<SFutureSalt> m_futureSalts; // Sorted by the validSince
+    quint64 m_futureSaltsRequestId;
     quint64 m_sessionId;
+    CPackageDecoder m_packageDecoder;
+    QPointer<CPackageDecodingWorker> m_decodingWorker;
+    QVector<CPackageDecoder::DecodedObject> m_decodedObjects; // The objects of the message in processing
+    QPointer<CTransportCapture> m_capture;
+    MessageProjection m_messageProjection;
     quint64 m_lastMessageId;
     quint64 m_lastSentPingId;
     quint64 m_lastReceivedPingId;
     qint64 m_lastReceivedPingTime;
     qint64 m_lastSentPingTime;
+    qint64 m_smoothedRtt;
+    qint64 m_rttVariance;
     quint32 m_sequenceNumber;
     quint32 m_contentRelatedMessages;
 
+    struct OutgoingMessage {
+        quint64 id;
+        quint32 seqNo;
+        MessagePriority priority;
+        qint64 queuedTime;
+        QByteArray data;
+    };
+    struct QueueStats {
+        QueueStats() : count(0), totalLatency(0), maxLatency(0) { }
+
+        quint64 count;
+        qint64 totalLatency;
+        qint64 maxLatency;
+    };
+
+    QVector<OutgoingMessage> takeOutgoingMessages(bool *budgetExceeded);
+    void renewMessageId(OutgoingMessage *message);
+    void sendOutgoingMessages(const QVector<OutgoingMessage> &messages);
+    void scheduleOutgoingMessagesFlush();
+    bool hasInFlightRoom() const;
+    void updateBackpressure();
+
+    QVector<OutgoingMessage> m_outgoingQueues[PriorityCount]; // Waiting to be packed into a container
+    QueueStats m_queueStats[PriorityCount];
+    int m_outgoingMessagesCount;
+    int m_outgoingMessagesSize; // The total size of the queued messages
+    int m_maxInFlightRequests;
+    bool m_backpressureActive;
+    bool m_outgoingFlushScheduled;
+    bool m_messageBatchingEnabled;
+    quint64 m_savedAckPackagesCount;
+    int m_gzipPackingThreshold;
+    QMap<quint64, QVector<quint64> > m_sentContainers; // <container id, message ids>
+
     TLVector<quint64> m_messagesToAck;
 
     quint32 m_pingInterval;
@@ -582,6 +760,7 @@ protected:
     quint64 m_authRetryId;
 
     TLDcOption m_dcInfo;
+    QVector<Telegram::DcOption> m_alternativeAddresses;
 
     QVector<TLDcOption> m_dcConfiguration;
 
@@ -603,4 +782,14 @@ inline SAesKey CTelegramConnection::generateServerToClientAesKey(const QByteArra
     return generateAesKey(messageKey, 8);
 }
 
+inline void CTelegramConnection::generateClientToServerAesKey(SAesKeyData *aesKey, const QByteArray &messageKey) const
+{
+    generateAesKey(aesKey, reinterpret_cast<const uchar *>(messageKey.constData()), 0);
+}
+
+inline void CTelegramConnection::generateServerToClientAesKey(SAesKeyData *aesKey, const QByteArray &messageKey) const
+{
+    generateAesKey(aesKey, reinterpret_cast<const uchar *>(messageKey.constData()), 8);
+}
+
 #endif // CTELEGRAMCONNECTION_HPP
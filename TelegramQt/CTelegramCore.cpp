@@ -124,6 +124,8 @@ CTelegramCore::CTelegramCore(QObject *parent) :
             this, &CTelegramCore::filePartUploaded);
     connect(m_private->m_mediaModule, &CTelegramMediaModule::fileRequestFinished,
             this, &CTelegramCore::fileRequestFinished);
+    connect(m_private->m_mediaModule, &CTelegramMediaModule::fileRequestFailed,
+            this, &CTelegramCore::fileRequestFailed);
 }
 
 CTelegramCore::~CTelegramCore()
@@ -455,6 +457,16 @@ void CTelegramCore::setAutoReconnection(bool enable)
     return m_private->m_dispatcher->setAutoReconnection(enable);
 }
 
+void CTelegramCore::setConnectionRacingEnabled(bool enable)
+{
+    return m_private->m_dispatcher->setConnectionRacingEnabled(enable);
+}
+
+void CTelegramCore::setThreadedDecodingEnabled(bool enable)
+{
+    return m_private->m_dispatcher->setThreadedDecodingEnabled(enable);
+}
+
 void CTelegramCore::setUpdatesEnabled(bool enable)
 {
     return m_private->m_dispatcher->setUpdatesEnabled(enable);
@@ -84,6 +84,8 @@ public Q_SLOTS:
     void setMessageReceivingFilter(TelegramNamespace::MessageFlags flags); // Messages with at least one of the passed flags will be filtered out.
     void setAcceptableMessageTypes(TelegramNamespace::MessageTypeFlags types);
     void setAutoReconnection(bool enable);
+    void setConnectionRacingEnabled(bool enable); // Race the connections to several addresses of a DC
+    void setThreadedDecodingEnabled(bool enable); // Decrypt, unpack and decode the incoming packages in a worker thread
     void setUpdatesEnabled(bool enable);
 
     // By default, the app would ping server every 15 000 ms and instruct the server to close connection after 10 000 more ms. Pass interval = 0 to disable ping.
@@ -191,6 +193,7 @@ Q_SIGNALS:
     void filePartReceived(quint32 requestId, const QByteArray &data, const QString &mimeType, quint32 offset, quint32 totalSize);
     void filePartUploaded(quint32 requestId, quint32 offset, quint32 totalSize);
     void fileRequestFinished(quint32 requestId, Telegram::RemoteFile requestResult);
+    void fileRequestFailed(quint32 requestId); // The request is finished without the result (e.g. got no answer in time)
 
 public:
     // Deprecated:
@@ -22,6 +22,7 @@
 #include "CTelegramConnection.hpp"
 #include "CTelegramModule.hpp"
 #include "CRawStream.hpp"
+#include "CTelegramStream.hpp"
 #include "Debug_p.hpp"
 #include "Utils.hpp"
 #include "TelegramUtils.hpp"
@@ -29,6 +30,7 @@
 using namespace TelegramUtils;
 using namespace Telegram;
 
+#include <QThread>
 #include <QTimer>
 
 #include <QCryptographicHash>
@@ -47,8 +49,8 @@ static const QVector<Telegram::DcOption> s_builtInDcs = {
         Telegram::DcOption(QLatin1String("91.108.56.165")  , 443),
 };
 
-const quint32 secretFormatVersion = 4;
-//Format v4:
+const quint32 secretFormatVersion = 5;
+//Format v5:
 //quint32 secretFormatVersion
 //qint32 deltaTime
 
@@ -82,6 +84,13 @@ const quint32 secretFormatVersion = 4;
 //    }
 //}
 
+//quint32 futureSaltsCount
+//FutureSalt (N = futureSaltsCount) {
+//    quint32 validSince
+//    quint32 validUntil
+//    quint64 salt
+//}
+
 const int s_userTypingActionPeriod = 6000; // 6 sec
 const int s_localTypingDuration = 5000; // 5 sec
 const int s_localTypingRecommendedRepeatInterval = 400; // (s_userTypingActionPeriod - s_localTypingDuration) / 2. Minus 100 ms for insurance.
@@ -92,6 +101,11 @@ static const int s_autoConnectionIndexInvalid = -1; // App logic rely on (s_auto
 static const quint32 s_legacyDcInfoTlType = 0x2ec2a43cu; // Scheme23_DcOption
 static const quint32 s_legacyVectorTlType = 0x1cb5c415u; // Scheme23_Vector;
 
+// The message fields used by the dispatcher, the rest are skipped on the messages decoding
+static const quint32 s_mediaMessageFields = TLMessage::FieldAll
+        & ~(TLMessage::FieldViaBotId | TLMessage::FieldReplyMarkup | TLMessage::FieldEntities | TLMessage::FieldViews);
+static const quint32 s_textMessageFields = s_mediaMessageFields & ~TLMessage::FieldMedia;
+
 enum DialogType {
     DialogTypeDialog,
     DialogTypeChannel
@@ -105,7 +119,12 @@ CTelegramDispatcher::CTelegramDispatcher(QObject *parent) :
     m_deltaTime(0),
     m_messageReceivingFilterFlags(TelegramNamespace::MessageFlagRead),
     m_acceptableMessageTypes(TelegramNamespace::MessageTypeAll),
+    m_messageProjection(nullptr),
+    m_decodedMessageFields(TLMessage::FieldAll),
     m_autoReconnectionEnabled(false),
+    m_connectionRacingEnabled(false),
+    m_threadedDecodingEnabled(false),
+    m_decodingThread(nullptr),
     m_initializationState(0),
     m_requestedSteps(0),
     m_wantedActiveDc(0),
@@ -123,17 +142,23 @@ CTelegramDispatcher::CTelegramDispatcher(QObject *parent) :
 
     resetConnectionData();
     resetDcConfiguration();
+    updateMessageProjection();
 }
 
 CTelegramDispatcher::~CTelegramDispatcher()
 {
     disconnectFromServer();
+    if (m_decodingThread) {
+        m_decodingThread->quit();
+        m_decodingThread->wait();
+    }
 }
 
 void CTelegramDispatcher::plugModule(CTelegramModule *module)
 {
     m_modules.append(module);
     module->setDispatcher(this);
+    updateMessageProjection();
 }
 
 QVector<Telegram::DcOption> CTelegramDispatcher::defaultDcConfiguration()
@@ -304,6 +329,14 @@ QByteArray CTelegramDispatcher::connectionSecretInfo() const
         outputStream << quint32(0); // dialogs count
     }
 
+    const QVector<SFutureSalt> futureSalts = mainConnection()->futureSalts();
+    outputStream << quint32(futureSalts.count());
+    for (const SFutureSalt &salt : futureSalts) {
+        outputStream << salt.validSince;
+        outputStream << salt.validUntil;
+        outputStream << salt.salt;
+    }
+
     return output;
 }
 
@@ -315,6 +348,7 @@ void CTelegramDispatcher::setMessageReceivingFilter(TelegramNamespace::MessageFl
 void CTelegramDispatcher::setAcceptableMessageTypes(TelegramNamespace::MessageTypeFlags types)
 {
     m_acceptableMessageTypes = types;
+    updateMessageProjection();
 }
 
 void CTelegramDispatcher::setAutoReconnection(bool enable)
@@ -322,6 +356,23 @@ void CTelegramDispatcher::setAutoReconnection(bool enable)
     m_autoReconnectionEnabled = enable;
 }
 
+void CTelegramDispatcher::setConnectionRacingEnabled(bool enable)
+{
+    m_connectionRacingEnabled = enable;
+}
+
+void CTelegramDispatcher::setThreadedDecodingEnabled(bool enable)
+{
+    // The thread is shared by the connections and it is kept until the dispatcher destruction,
+    // as the already created connections continue to use it.
+    m_threadedDecodingEnabled = enable;
+    if (enable && !m_decodingThread) {
+        m_decodingThread = new QThread(this);
+        m_decodingThread->setObjectName(QLatin1String("TelegramQt package decoding"));
+        m_decodingThread->start();
+    }
+}
+
 bool CTelegramDispatcher::setDcConfiguration(const QVector<Telegram::DcOption> &dcs)
 {
     if (connectionState() != TelegramNamespace::ConnectionStateDisconnected) {
@@ -379,6 +430,7 @@ void CTelegramDispatcher::connectToTheWantedDc()
     setMainConnection(createConnection(m_mainDcInfo));
     m_mainConnection->setAuthKey(m_authKey);
     m_mainConnection->setServerSalt(m_serverSalt);
+    m_mainConnection->setFutureSalts(m_futureSalts);
     initConnectionSharedFinal();
 }
 
@@ -521,11 +573,32 @@ bool CTelegramDispatcher::setSecretInfo(const QByteArray &secret)
         }
     }
 
+    QVector<SFutureSalt> futureSalts;
+    if (format >= 5) {
+        quint32 futureSaltsCount = 0;
+        inputStream >> futureSaltsCount;
+        if (futureSaltsCount > 64) {
+            qWarning() << Q_FUNC_INFO << "Session data contains invalid salts count";
+            return false;
+        }
+        futureSalts.resize(futureSaltsCount);
+        for (SFutureSalt &salt : futureSalts) {
+            inputStream >> salt.validSince;
+            inputStream >> salt.validUntil;
+            inputStream >> salt.salt;
+        }
+        if (inputStream.error()) {
+            qWarning() << Q_FUNC_INFO << "Read error occurred.";
+            return false;
+        }
+    }
+
     m_deltaTime = deltaTime;
     m_mainDcInfo = dcInfo;
     m_wantedActiveDc = dcInfo.id;
     m_authKey = authKey;
     m_serverSalt = serverSalt;
+    m_futureSalts = futureSalts;
 
     return true;
 }
@@ -591,6 +664,7 @@ void CTelegramDispatcher::disconnectFromServer()
     clearExtraConnections();
 
     m_askedUserIds.clear();
+    m_throttledHistoryRequests.clear();
 }
 
 bool CTelegramDispatcher::requestHistory(const Telegram::Peer &peer, quint32 offset, quint32 limit)
@@ -606,14 +680,29 @@ bool CTelegramDispatcher::requestHistory(const Telegram::Peer &peer, quint32 off
         return false;
     }
 
+    if (mainConnection()->isBackpressureActive()) {
+        // The request is sent when the connection queue is drained
+        HistoryRequest request;
+        request.peer = peer;
+        request.offset = offset;
+        request.limit = limit;
+        m_throttledHistoryRequests.append(request);
+        return true;
+    }
+
+    sendHistoryRequest(inputPeer, peer, offset, limit);
+
+    return true;
+}
+
+void CTelegramDispatcher::sendHistoryRequest(const TLInputPeer &inputPeer, const Telegram::Peer &peer, quint32 offset, quint32 limit)
+{
     quint32 offsetId = m_maxMessageId + 1;
     if (m_dialogs.contains(peer)) {
         offsetId = m_dialogs.value(peer).topMessage + 1;
     }
 
     mainConnection()->messagesGetHistory(inputPeer, /* offsetId */ offsetId, /* addOffset */ offset, limit, /* maxId */ 0, /* minId */ 0);
-
-    return true;
 }
 
 quint32 CTelegramDispatcher::resolveUsername(const QString &userName)
@@ -1751,6 +1840,36 @@ void CTelegramDispatcher::processUpdate(const TLUpdate &update)
     }
 }
 
+void CTelegramDispatcher::updateMessageProjection()
+{
+    quint32 fields = s_textMessageFields;
+    if (m_acceptableMessageTypes & ~TelegramNamespace::MessageTypeText) {
+        fields |= TLMessage::FieldMedia;
+    }
+    for (const CTelegramModule *module : m_modules) {
+        fields |= module->requiredMessageFields();
+    }
+
+    // The projections are instantiated at compile time, so pick the smallest one that has the fields
+    if ((fields & s_textMessageFields) == fields) {
+        m_messageProjection = &CTelegramStream::readProjection<s_textMessageFields>;
+        m_decodedMessageFields = s_textMessageFields;
+    } else if ((fields & s_mediaMessageFields) == fields) {
+        m_messageProjection = &CTelegramStream::readProjection<s_mediaMessageFields>;
+        m_decodedMessageFields = s_mediaMessageFields;
+    } else {
+        m_messageProjection = nullptr;
+        m_decodedMessageFields = TLMessage::FieldAll;
+    }
+
+    if (m_mainConnection) {
+        m_mainConnection->setMessageProjection(m_messageProjection);
+    }
+    for (CTelegramConnection *connection : m_extraConnections) {
+        connection->setMessageProjection(m_messageProjection);
+    }
+}
+
 void CTelegramDispatcher::processMessageReceived(const TLMessage &message)
 {
 #ifdef DEVELOPER_BUILD
@@ -1832,7 +1951,11 @@ void CTelegramDispatcher::internalProcessMessageReceived(const TLMessage &messag
         return;
     }
 
-    const TelegramNamespace::MessageType messageType = telegramMessageTypeToPublicMessageType(message.media.tlType);
+    TelegramNamespace::MessageType messageType = telegramMessageTypeToPublicMessageType(message.media.tlType);
+    if (!(m_decodedMessageFields & TLMessage::FieldMedia) && (message.flags & TLMessage::Media)) {
+        // The media is skipped only if the text messages are the only acceptable ones
+        messageType = TelegramNamespace::MessageTypeUnsupported;
+    }
 
     if (!(messageType & m_acceptableMessageTypes)) {
         return;
@@ -2248,6 +2371,9 @@ void CTelegramDispatcher::onConnectionStatusChanged(int newStatusInt, int reason
 
     if (connection == mainConnection()) {
         if (newStatus == CTelegramConnection::ConnectionStatusDisconnected) {
+            // The requests queued in the connection are lost as well
+            m_throttledHistoryRequests.clear();
+
             if (connectionState() == TelegramNamespace::ConnectionStateDisconnected) {
                 return;
             }
@@ -2316,6 +2442,28 @@ void CTelegramDispatcher::onConnectionDcIdUpdated(quint32 connectionId, quint32
     }
 }
 
+void CTelegramDispatcher::onConnectionBackpressureChanged(bool active)
+{
+    if (active || (sender() != mainConnection())) {
+        return;
+    }
+    if (mainConnection()->status() < CTelegramConnection::ConnectionStatusConnected) {
+        // The queue is drained by a disconnection; the throttled requests are dropped with the connection
+        return;
+    }
+
+    int sentCount = 0;
+    while ((sentCount < m_throttledHistoryRequests.count()) && !mainConnection()->isBackpressureActive()) {
+        const HistoryRequest &request = m_throttledHistoryRequests.at(sentCount);
+        const TLInputPeer inputPeer = toInputPeer(request.peer);
+        if (inputPeer.tlType != TLValue::InputPeerEmpty) {
+            sendHistoryRequest(inputPeer, request.peer, request.offset, request.limit);
+        }
+        ++sentCount;
+    }
+    m_throttledHistoryRequests.remove(0, sentCount);
+}
+
 void CTelegramDispatcher::onPackageRedirected(const QByteArray &data, quint32 dc)
 {
 #ifdef DEVELOPER_BUILD
@@ -2554,6 +2702,7 @@ void CTelegramDispatcher::continueInitialization(CTelegramDispatcher::Initializa
         m_deltaTime = mainConnection()->deltaTime();
         m_authKey = mainConnection()->authKey();
         m_serverSalt = mainConnection()->serverSalt();
+        m_futureSalts = mainConnection()->futureSalts();
         m_mainDcInfo = mainConnection()->dcInfo();
     }
 
@@ -2718,6 +2867,11 @@ void CTelegramDispatcher::checkStateAndCallGetDifference()
     }
 }
 
+void CTelegramDispatcher::setTransportFactory(const TransportFactory &factory)
+{
+    m_transportFactory = factory;
+}
+
 CTelegramConnection *CTelegramDispatcher::createConnection(const TLDcOption &dcInfo)
 {
     qDebug() << Q_FUNC_INFO << dcInfo.id << dcInfo.ipAddress << dcInfo.port;
@@ -2725,6 +2879,13 @@ CTelegramConnection *CTelegramDispatcher::createConnection(const TLDcOption &dcI
     CTelegramConnection *connection = new CTelegramConnection(m_appInformation, this);
     connection->setDcInfo(dcInfo);
     connection->setDeltaTime(m_deltaTime);
+    if (m_connectionRacingEnabled) {
+        connection->setAlternativeAddresses(alternativeAddresses(dcInfo));
+    }
+    if (m_threadedDecodingEnabled) {
+        connection->setDecodingThread(m_decodingThread);
+    }
+    connection->setMessageProjection(m_messageProjection);
 
     connect(connection, &CTelegramConnection::connectionFailed, this, &CTelegramDispatcher::onConnectionFailed);
     connect(connection, &CTelegramConnection::authStateChanged, this, &CTelegramDispatcher::onConnectionAuthChanged);
@@ -2732,9 +2893,16 @@ CTelegramConnection *CTelegramDispatcher::createConnection(const TLDcOption &dcI
     connect(connection, &CTelegramConnection::dcConfigurationReceived, this, &CTelegramDispatcher::onDcConfigurationUpdated);
     connect(connection, &CTelegramConnection::actualDcIdReceived, this, &CTelegramDispatcher::onConnectionDcIdUpdated);
     connect(connection, &CTelegramConnection::newRedirectedPackage, this, &CTelegramDispatcher::onPackageRedirected);
+    connect(connection, &CTelegramConnection::backpressureChanged, this, &CTelegramDispatcher::onConnectionBackpressureChanged);
 
     connect(connection, &CTelegramConnection::usersReceived, this, &CTelegramDispatcher::onUsersReceived);
     connect(connection, &CTelegramConnection::channelsParticipantsReceived, this, &CTelegramDispatcher::onChannelsParticipantsReceived);
+    if (m_transportFactory) {
+        CTelegramTransport *transport = m_transportFactory(connection);
+        if (transport) {
+            connection->setTransport(transport);
+        }
+    }
     for (CTelegramModule *module : m_modules) {
         module->onNewConnection(connection);
     }
@@ -2830,7 +2998,7 @@ void CTelegramDispatcher::ensureMainConnectToWantedDc()
 
 TLDcOption CTelegramDispatcher::dcInfoById(quint32 dc) const
 {
-    foreach (const TLDcOption option, m_dcConfiguration) {
+    foreach (const TLDcOption &option, m_dcConfiguration) {
         if (option.id == dc) {
             return option;
         }
@@ -2839,6 +3007,29 @@ TLDcOption CTelegramDispatcher::dcInfoById(quint32 dc) const
     return TLDcOption();
 }
 
+QVector<Telegram::DcOption> CTelegramDispatcher::alternativeAddresses(const TLDcOption &dcInfo) const
+{
+    QVector<Telegram::DcOption> result;
+    if (dcInfo.id) {
+        // All known (IPv4 and IPv6) addresses of the same DC
+        foreach (const TLDcOption &option, m_dcConfiguration) {
+            if ((option.id != dcInfo.id) || option.mediaOnly()) {
+                continue;
+            }
+            if ((option.ipAddress == dcInfo.ipAddress) && (option.port == dcInfo.port)) {
+                continue;
+            }
+            result.append(Telegram::DcOption(option.ipAddress, option.port));
+        }
+    } else if (m_autoConnectionDcIndex >= 0) {
+        // Initial connection: race the next built-in addresses
+        for (int i = 1; (i < m_connectionAddresses.count()) && (result.count() < 2); ++i) {
+            result.append(m_connectionAddresses.at((m_autoConnectionDcIndex + i) % m_connectionAddresses.count()));
+        }
+    }
+    return result;
+}
+
 const TLUser *CTelegramDispatcher::getUser(quint32 userId) const
 {
     return m_users.value(userId);
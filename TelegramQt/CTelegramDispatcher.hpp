@@ -25,17 +25,23 @@
 #include <QStringList>
 #include <QVector>
 
+#include <functional>
+
 #include "FileRequestDescriptor.hpp"
+#include "FutureSalt.hpp"
+#include "MessageProjection.hpp"
 #include "TLTypes.hpp"
 #include "TelegramNamespace.hpp"
 
 QT_FORWARD_DECLARE_CLASS(QCryptographicHash)
 QT_FORWARD_DECLARE_CLASS(QIODevice)
+QT_FORWARD_DECLARE_CLASS(QThread)
 QT_FORWARD_DECLARE_CLASS(QTimer)
 
 class CAppInformation;
 class CTelegramConnection;
 class CTelegramModule;
+class CTelegramTransport;
 
 namespace Telegram
 {
@@ -101,8 +107,11 @@ public:
 
     quint32 messageReceivingFilterFlags() const { return m_messageReceivingFilterFlags; }
     void setMessageReceivingFilter(TelegramNamespace::MessageFlags flags);
+    TelegramNamespace::MessageTypeFlags acceptableMessageTypes() const { return m_acceptableMessageTypes; }
     void setAcceptableMessageTypes(TelegramNamespace::MessageTypeFlags types);
     void setAutoReconnection(bool enable);
+    void setConnectionRacingEnabled(bool enable);
+    void setThreadedDecodingEnabled(bool enable);
 
     bool setDcConfiguration(const QVector<Telegram::DcOption> &dcs);
     bool connectToServer();
@@ -136,6 +145,11 @@ public:
     CTelegramConnection *mainConnection() const { return m_mainConnection; }
     CTelegramConnection *getExtraConnection(quint32 dc);
 
+    // The factory creates a transport for each new connection (e.g. a loopback transport for tests)
+    // instead of the default transport provided by the transport module.
+    using TransportFactory = std::function<CTelegramTransport *(CTelegramConnection *connection)>;
+    void setTransportFactory(const TransportFactory &factory);
+
     CTelegramConnection *createConnection(const TLDcOption &dcInfo);
     void ensureSignedConnection(CTelegramConnection *connection);
     void clearConnection(CTelegramConnection *connection);
@@ -143,6 +157,7 @@ public:
     void ensureMainConnectToWantedDc();
 
     TLDcOption dcInfoById(quint32 dc) const;
+    QVector<Telegram::DcOption> alternativeAddresses(const TLDcOption &dcInfo) const;
 
     // Getters
     const TLUser *getUser(quint32 userId) const;
@@ -197,6 +212,7 @@ protected slots:
     void onDcConfigurationUpdated();
     void onConnectionDcIdUpdated(quint32 connectionId, quint32 newDcId);
     void onPackageRedirected(const QByteArray &data, quint32 dc);
+    void onConnectionBackpressureChanged(bool active);
     void onConnectionFailed(CTelegramConnection *connection);
     void onMainConnectionRetryTimerTriggered();
 
@@ -231,6 +247,7 @@ protected:
 
     void processUpdate(const TLUpdate &update);
 
+    void updateMessageProjection();
     void processMessageReceived(const TLMessage &message);
     void internalProcessMessageReceived(const TLMessage &message);
 
@@ -242,6 +259,7 @@ protected:
 
     void getInitialUsers();
     void getInitialDialogs();
+    void sendHistoryRequest(const TLInputPeer &inputPeer, const Telegram::Peer &peer, quint32 offset, quint32 limit);
 
     bool filterReceivedMessage(quint32 messageFlags) const;
 
@@ -298,6 +316,12 @@ protected:
         }
     };
 
+    struct HistoryRequest {
+        Telegram::Peer peer;
+        quint32 offset;
+        quint32 limit;
+    };
+
     TelegramNamespace::ConnectionState m_connectionState;
 
     const CAppInformation *m_appInformation;
@@ -306,11 +330,17 @@ protected:
     qint32 m_deltaTime;
     QByteArray m_authKey;
     quint64 m_serverSalt;
+    QVector<SFutureSalt> m_futureSalts;
     TLDcOption m_mainDcInfo;
 
     TelegramNamespace::MessageFlags m_messageReceivingFilterFlags;
     TelegramNamespace::MessageTypeFlags m_acceptableMessageTypes;
+    MessageProjection m_messageProjection;
+    quint32 m_decodedMessageFields; // The TLMessage fields decoded by the projection
     bool m_autoReconnectionEnabled;
+    bool m_connectionRacingEnabled;
+    bool m_threadedDecodingEnabled;
+    QThread *m_decodingThread;
 
     InitializationStepFlags m_initializationState;
     InitializationStepFlags m_requestedSteps;
@@ -335,6 +365,7 @@ protected:
     QHash<quint32, QByteArray> m_delayedPackages; // dc, package data
     QHash<quint32, TLUser*> m_users;
     QVector<quint32> m_askedUserIds;
+    QVector<HistoryRequest> m_throttledHistoryRequests; // Not sent because of the main connection backpressure
     QVector<TLInputUser> m_askedInitialUsers;
 
     QHash<quint32, TLMessage*> m_knownMediaMessages; // message id, message
@@ -361,6 +392,7 @@ protected:
     QHash<quint32, TLVector<TLChannelParticipant> > m_channelParticipants; // Telegram chat id to ChatFull map
 
     QVector<CTelegramModule*> m_modules;
+    TransportFactory m_transportFactory;
 
 };
 
@@ -210,9 +210,19 @@ quint64 CTelegramMediaModule::sendMedia(const Telegram::Peer &peer, const Telegr
 void CTelegramMediaModule::clear()
 {
     m_requestedFileDescriptors.clear();
+    m_throttledFileRequests.clear();
     m_fileRequestCounter = 0;
 }
 
+quint32 CTelegramMediaModule::requiredMessageFields() const
+{
+    // The accepted media messages are kept to download the media, the rest is dropped on receiving
+    if (acceptableMessageTypes() & ~TelegramNamespace::MessageTypeText) {
+        return TLMessage::FieldMedia;
+    }
+    return 0;
+}
+
 void CTelegramMediaModule::onFileDataReceived(const TLUploadFile &file, quint32 requestId, quint32 offset)
 {
     if (!m_requestedFileDescriptors.contains(requestId)) {
@@ -341,16 +351,43 @@ void CTelegramMediaModule::onConnectionAuthChanged(CTelegramConnection *connecti
             }
 
             if (state == CTelegramConnection::AuthStateSignedIn) {
+                m_throttledFileRequests.removeOne(fileId);
                 processFileRequestForConnection(connection, fileId);
             }
         }
     }
 }
 
+void CTelegramMediaModule::onConnectionRequestFailed(quint64 messageId, quint32 requestId)
+{
+    if (!requestId || !m_requestedFileDescriptors.contains(requestId)) {
+        return;
+    }
+
+    qWarning() << Q_FUNC_INFO << "File request" << requestId << "failed (message" << messageId << ")";
+    m_requestedFileDescriptors.remove(requestId);
+    m_throttledFileRequests.removeOne(requestId);
+    emit fileRequestFailed(requestId);
+}
+
 void CTelegramMediaModule::onNewConnection(CTelegramConnection *connection)
 {
     connect(connection, &CTelegramConnection::fileDataReceived, this, &CTelegramMediaModule::onFileDataReceived);
     connect(connection, &CTelegramConnection::fileDataSent, this, &CTelegramMediaModule::onFileDataUploaded);
+    connect(connection, &CTelegramConnection::requestFailed, this, &CTelegramMediaModule::onConnectionRequestFailed);
+    connect(connection, &CTelegramConnection::backpressureChanged, this, &CTelegramMediaModule::onConnectionBackpressureChanged);
+}
+
+void CTelegramMediaModule::onConnectionBackpressureChanged(bool active)
+{
+    if (active) {
+        return;
+    }
+
+    CTelegramConnection *connection = qobject_cast<CTelegramConnection*>(sender());
+    if (connection && (connection->authState() == CTelegramConnection::AuthStateSignedIn)) {
+        processThrottledFileRequests(connection);
+    }
 }
 
 template<typename T>
@@ -398,7 +435,12 @@ quint32 CTelegramMediaModule::addFileRequest(const FileRequestDescriptor &descri
     CTelegramConnection *connection = getExtraConnection(descriptor.dcId());
 
     if (connection->authState() == CTelegramConnection::AuthStateSignedIn) {
-        processFileRequestForConnection(connection, m_fileRequestCounter);
+        if (connection->isBackpressureActive()) {
+            // The request will be started when the connection queue is drained
+            m_throttledFileRequests.append(m_fileRequestCounter);
+        } else {
+            processFileRequestForConnection(connection, m_fileRequestCounter);
+        }
     }
 
     if (connection->status() == CTelegramConnection::ConnectionStatusDisconnected) {
@@ -408,6 +450,21 @@ quint32 CTelegramMediaModule::addFileRequest(const FileRequestDescriptor &descri
     return m_fileRequestCounter;
 }
 
+void CTelegramMediaModule::processThrottledFileRequests(CTelegramConnection *connection)
+{
+    const quint32 dcId = connection->dcInfo().id;
+    int i = 0;
+    while ((i < m_throttledFileRequests.count()) && !connection->isBackpressureActive()) {
+        const quint32 requestId = m_throttledFileRequests.at(i);
+        if (m_requestedFileDescriptors.value(requestId).dcId() != dcId) {
+            ++i;
+            continue;
+        }
+        m_throttledFileRequests.remove(i);
+        processFileRequestForConnection(connection, requestId);
+    }
+}
+
 void CTelegramMediaModule::processFileRequestForConnection(CTelegramConnection *connection, quint32 requestId)
 {
     const FileRequestDescriptor descriptor = m_requestedFileDescriptors.value(requestId);
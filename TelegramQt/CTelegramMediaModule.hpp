@@ -21,6 +21,7 @@
 #include "CTelegramModule.hpp"
 
 #include <QMap>
+#include <QVector>
 
 #include "TLTypes.hpp"
 #include "TelegramNamespace.hpp"
@@ -46,10 +47,12 @@ public:
     quint64 sendMedia(const Telegram::Peer &peer, const Telegram::MessageMediaInfo &messageInfo);
 
     void clear() override;
+    quint32 requiredMessageFields() const override;
 
 signals:
     void filePartUploaded(quint32 requestId, quint32 offset, quint32 size);
     void fileRequestFinished(quint32 requestId, Telegram::RemoteFile uploadInfo);
+    void fileRequestFailed(quint32 requestId);
     void filePartReceived(quint32 requestId, const QByteArray &data, const QString &mimeType, quint32 offset, quint32 totalSize);
 
     void avatarReceived(quint32 userId, const QByteArray &data, const QString &mimeType, const QString &avatarToken);
@@ -58,6 +61,8 @@ signals:
 protected slots:
     void onFileDataReceived(const TLUploadFile &file, quint32 requestId, quint32 offset);
     void onFileDataUploaded(quint32 requestId);
+    void onConnectionRequestFailed(quint64 messageId, quint32 requestId);
+    void onConnectionBackpressureChanged(bool active);
 
 protected:
     void onConnectionStateChanged(TelegramNamespace::ConnectionState newConnectionState) override;
@@ -72,10 +77,12 @@ protected:
 
     quint32 addFileRequest(const FileRequestDescriptor &descriptor);
     void processFileRequestForConnection(CTelegramConnection *connection, quint32 requestId);
+    void processThrottledFileRequests(CTelegramConnection *connection);
 
     quint32 m_mediaDataBufferSize;
     QMap<quint32, FileRequestDescriptor> m_requestedFileDescriptors; // fileId, file request descriptor
     quint32 m_fileRequestCounter;
+    QVector<quint32> m_throttledFileRequests; // Not started because of the connection backpressure
 
 };
 
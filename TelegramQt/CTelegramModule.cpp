@@ -33,6 +33,11 @@ void CTelegramModule::clear()
 {
 }
 
+quint32 CTelegramModule::requiredMessageFields() const
+{
+    return 0;
+}
+
 bool CTelegramModule::setWantedDc(quint32 dcId)
 {
     return m_dispatcher->setWantedDc(dcId);
@@ -75,6 +80,11 @@ quint64 CTelegramModule::sendMedia(const Telegram::Peer &peer, const TLInputMedi
     return m_dispatcher->sendMedia(peer, media);
 }
 
+TelegramNamespace::MessageTypeFlags CTelegramModule::acceptableMessageTypes() const
+{
+    return m_dispatcher->acceptableMessageTypes();
+}
+
 bool CTelegramModule::getUserInfo(Telegram::UserInfo *userInfo, quint32 userId) const
 {
     return m_dispatcher->getUserInfo(userInfo, userId);
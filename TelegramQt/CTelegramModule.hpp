@@ -35,6 +35,9 @@ public:
 
     virtual void clear();
 
+    // The TLMessage fields (see TLMessage::Fields) the module needs in the received messages
+    virtual quint32 requiredMessageFields() const;
+
     // Connections API
     bool setWantedDc(quint32 dcId);
     CTelegramConnection *mainConnection() const;
@@ -47,6 +50,7 @@ public:
     quint64 sendMedia(const Telegram::Peer &peer, const TLInputMedia &media);
 
     // Getters
+    TelegramNamespace::MessageTypeFlags acceptableMessageTypes() const;
     bool getUserInfo(Telegram::UserInfo *userInfo, quint32 userId) const;
     bool getChatInfo(Telegram::ChatInfo *outputChat, const Telegram::Peer &peer) const;
     bool getChatParticipants(QVector<quint32> *participants, quint32 chatId);
@@ -126,6 +126,53 @@ CTelegramStream &CTelegramStream::operator<<(const TLDcOption &dcOption)
     return *this;
 }
 
+CTelegramStream &CTelegramStream::skip(const QByteArray *)
+{
+    quint32 length = 0;
+    quint32 headerLength = 1;
+    read(&length, 1);
+
+    if (length >= 0xfe) {
+        read(&length, 3);
+        headerLength = 4;
+    }
+
+    skipBytes(length + ((4 - ((headerLength + length) & 3)) & 3));
+    return *this;
+}
+
+static quint32 serializedBytesSize(quint32 length)
+{
+    // The length is prepended by one byte for the short data or four bytes otherwise; the result is aligned by 4
+    const quint32 size = length < 0xfe ? length + 1 : length + 4;
+    return (size + 3) & ~3u;
+}
+
+quint32 CTelegramStream::serializedSize(const QByteArray &data)
+{
+    return serializedBytesSize(data.size());
+}
+
+quint32 CTelegramStream::serializedSize(const QString &str)
+{
+    // The UTF-8 length, without the conversion
+    quint32 length = 0;
+    for (int i = 0; i < str.size(); ++i) {
+        const ushort c = str.at(i).unicode();
+        if (c < 0x80) {
+            length += 1;
+        } else if (c < 0x800) {
+            length += 2;
+        } else if (QChar::isHighSurrogate(c) && (i + 1 < str.size()) && str.at(i + 1).isLowSurrogate()) {
+            length += 4;
+            ++i;
+        } else {
+            length += 3;
+        }
+    }
+    return serializedBytesSize(length);
+}
+
 // Generated read operators implementation
 CTelegramStream &CTelegramStream::operator>>(TLAccountDaysTTL &accountDaysTTLValue)
 {
@@ -141,7 +188,7 @@ CTelegramStream &CTelegramStream::operator>>(TLAccountDaysTTL &accountDaysTTLVal
         break;
     }
 
-    accountDaysTTLValue = result;
+    accountDaysTTLValue = std::move(result);
 
     return *this;
 }
@@ -168,7 +215,7 @@ CTelegramStream &CTelegramStream::operator>>(TLAccountPassword &accountPasswordV
         break;
     }
 
-    accountPasswordValue = result;
+    accountPasswordValue = std::move(result);
 
     return *this;
 }
@@ -199,7 +246,7 @@ CTelegramStream &CTelegramStream::operator>>(TLAccountPasswordInputSettings &acc
         break;
     }
 
-    accountPasswordInputSettingsValue = result;
+    accountPasswordInputSettingsValue = std::move(result);
 
     return *this;
 }
@@ -218,7 +265,7 @@ CTelegramStream &CTelegramStream::operator>>(TLAccountPasswordSettings &accountP
         break;
     }
 
-    accountPasswordSettingsValue = result;
+    accountPasswordSettingsValue = std::move(result);
 
     return *this;
 }
@@ -238,7 +285,7 @@ CTelegramStream &CTelegramStream::operator>>(TLAccountSentChangePhoneCode &accou
         break;
     }
 
-    accountSentChangePhoneCodeValue = result;
+    accountSentChangePhoneCodeValue = std::move(result);
 
     return *this;
 }
@@ -266,7 +313,7 @@ CTelegramStream &CTelegramStream::operator>>(TLAudio &audioValue)
         break;
     }
 
-    audioValue = result;
+    audioValue = std::move(result);
 
     return *this;
 }
@@ -285,7 +332,7 @@ CTelegramStream &CTelegramStream::operator>>(TLAuthCheckedPhone &authCheckedPhon
         break;
     }
 
-    authCheckedPhoneValue = result;
+    authCheckedPhoneValue = std::move(result);
 
     return *this;
 }
@@ -305,7 +352,7 @@ CTelegramStream &CTelegramStream::operator>>(TLAuthExportedAuthorization &authEx
         break;
     }
 
-    authExportedAuthorizationValue = result;
+    authExportedAuthorizationValue = std::move(result);
 
     return *this;
 }
@@ -324,7 +371,7 @@ CTelegramStream &CTelegramStream::operator>>(TLAuthPasswordRecovery &authPasswor
         break;
     }
 
-    authPasswordRecoveryValue = result;
+    authPasswordRecoveryValue = std::move(result);
 
     return *this;
 }
@@ -347,7 +394,7 @@ CTelegramStream &CTelegramStream::operator>>(TLAuthSentCode &authSentCodeValue)
         break;
     }
 
-    authSentCodeValue = result;
+    authSentCodeValue = std::move(result);
 
     return *this;
 }
@@ -378,7 +425,7 @@ CTelegramStream &CTelegramStream::operator>>(TLAuthorization &authorizationValue
         break;
     }
 
-    authorizationValue = result;
+    authorizationValue = std::move(result);
 
     return *this;
 }
@@ -398,7 +445,7 @@ CTelegramStream &CTelegramStream::operator>>(TLBotCommand &botCommandValue)
         break;
     }
 
-    botCommandValue = result;
+    botCommandValue = std::move(result);
 
     return *this;
 }
@@ -423,7 +470,7 @@ CTelegramStream &CTelegramStream::operator>>(TLBotInfo &botInfoValue)
         break;
     }
 
-    botInfoValue = result;
+    botInfoValue = std::move(result);
 
     return *this;
 }
@@ -458,7 +505,7 @@ CTelegramStream &CTelegramStream::operator>>(TLChannelParticipant &channelPartic
         break;
     }
 
-    channelParticipantValue = result;
+    channelParticipantValue = std::move(result);
 
     return *this;
 }
@@ -478,7 +525,7 @@ CTelegramStream &CTelegramStream::operator>>(TLChannelParticipantRole &channelPa
         break;
     }
 
-    channelParticipantRoleValue = result;
+    channelParticipantRoleValue = std::move(result);
 
     return *this;
 }
@@ -499,7 +546,7 @@ CTelegramStream &CTelegramStream::operator>>(TLChannelParticipantsFilter &channe
         break;
     }
 
-    channelParticipantsFilterValue = result;
+    channelParticipantsFilterValue = std::move(result);
 
     return *this;
 }
@@ -524,7 +571,7 @@ CTelegramStream &CTelegramStream::operator>>(TLChatParticipant &chatParticipantV
         break;
     }
 
-    chatParticipantValue = result;
+    chatParticipantValue = std::move(result);
 
     return *this;
 }
@@ -552,7 +599,7 @@ CTelegramStream &CTelegramStream::operator>>(TLChatParticipants &chatParticipant
         break;
     }
 
-    chatParticipantsValue = result;
+    chatParticipantsValue = std::move(result);
 
     return *this;
 }
@@ -572,7 +619,7 @@ CTelegramStream &CTelegramStream::operator>>(TLContact &contactValue)
         break;
     }
 
-    contactValue = result;
+    contactValue = std::move(result);
 
     return *this;
 }
@@ -592,7 +639,7 @@ CTelegramStream &CTelegramStream::operator>>(TLContactBlocked &contactBlockedVal
         break;
     }
 
-    contactBlockedValue = result;
+    contactBlockedValue = std::move(result);
 
     return *this;
 }
@@ -613,7 +660,7 @@ CTelegramStream &CTelegramStream::operator>>(TLContactLink &contactLinkValue)
         break;
     }
 
-    contactLinkValue = result;
+    contactLinkValue = std::move(result);
 
     return *this;
 }
@@ -633,7 +680,7 @@ CTelegramStream &CTelegramStream::operator>>(TLContactSuggested &contactSuggeste
         break;
     }
 
-    contactSuggestedValue = result;
+    contactSuggestedValue = std::move(result);
 
     return *this;
 }
@@ -653,7 +700,7 @@ CTelegramStream &CTelegramStream::operator>>(TLDisabledFeature &disabledFeatureV
         break;
     }
 
-    disabledFeatureValue = result;
+    disabledFeatureValue = std::move(result);
 
     return *this;
 }
@@ -697,7 +744,7 @@ CTelegramStream &CTelegramStream::operator>>(TLEncryptedChat &encryptedChatValue
         break;
     }
 
-    encryptedChatValue = result;
+    encryptedChatValue = std::move(result);
 
     return *this;
 }
@@ -722,7 +769,7 @@ CTelegramStream &CTelegramStream::operator>>(TLEncryptedFile &encryptedFileValue
         break;
     }
 
-    encryptedFileValue = result;
+    encryptedFileValue = std::move(result);
 
     return *this;
 }
@@ -751,7 +798,7 @@ CTelegramStream &CTelegramStream::operator>>(TLEncryptedMessage &encryptedMessag
         break;
     }
 
-    encryptedMessageValue = result;
+    encryptedMessageValue = std::move(result);
 
     return *this;
 }
@@ -771,7 +818,7 @@ CTelegramStream &CTelegramStream::operator>>(TLError &errorValue)
         break;
     }
 
-    errorValue = result;
+    errorValue = std::move(result);
 
     return *this;
 }
@@ -792,7 +839,7 @@ CTelegramStream &CTelegramStream::operator>>(TLExportedChatInvite &exportedChatI
         break;
     }
 
-    exportedChatInviteValue = result;
+    exportedChatInviteValue = std::move(result);
 
     return *this;
 }
@@ -819,7 +866,7 @@ CTelegramStream &CTelegramStream::operator>>(TLFileLocation &fileLocationValue)
         break;
     }
 
-    fileLocationValue = result;
+    fileLocationValue = std::move(result);
 
     return *this;
 }
@@ -841,7 +888,7 @@ CTelegramStream &CTelegramStream::operator>>(TLGeoPoint &geoPointValue)
         break;
     }
 
-    geoPointValue = result;
+    geoPointValue = std::move(result);
 
     return *this;
 }
@@ -862,7 +909,7 @@ CTelegramStream &CTelegramStream::operator>>(TLHelpAppChangelog &helpAppChangelo
         break;
     }
 
-    helpAppChangelogValue = result;
+    helpAppChangelogValue = std::move(result);
 
     return *this;
 }
@@ -886,7 +933,7 @@ CTelegramStream &CTelegramStream::operator>>(TLHelpAppUpdate &helpAppUpdateValue
         break;
     }
 
-    helpAppUpdateValue = result;
+    helpAppUpdateValue = std::move(result);
 
     return *this;
 }
@@ -905,7 +952,7 @@ CTelegramStream &CTelegramStream::operator>>(TLHelpInviteText &helpInviteTextVal
         break;
     }
 
-    helpInviteTextValue = result;
+    helpInviteTextValue = std::move(result);
 
     return *this;
 }
@@ -924,7 +971,7 @@ CTelegramStream &CTelegramStream::operator>>(TLHelpTermsOfService &helpTermsOfSe
         break;
     }
 
-    helpTermsOfServiceValue = result;
+    helpTermsOfServiceValue = std::move(result);
 
     return *this;
 }
@@ -944,7 +991,7 @@ CTelegramStream &CTelegramStream::operator>>(TLImportedContact &importedContactV
         break;
     }
 
-    importedContactValue = result;
+    importedContactValue = std::move(result);
 
     return *this;
 }
@@ -966,7 +1013,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputAppEvent &inputAppEventValue
         break;
     }
 
-    inputAppEventValue = result;
+    inputAppEventValue = std::move(result);
 
     return *this;
 }
@@ -988,7 +1035,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputAudio &inputAudioValue)
         break;
     }
 
-    inputAudioValue = result;
+    inputAudioValue = std::move(result);
 
     return *this;
 }
@@ -1010,7 +1057,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputChannel &inputChannelValue)
         break;
     }
 
-    inputChannelValue = result;
+    inputChannelValue = std::move(result);
 
     return *this;
 }
@@ -1032,7 +1079,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputContact &inputContactValue)
         break;
     }
 
-    inputContactValue = result;
+    inputContactValue = std::move(result);
 
     return *this;
 }
@@ -1054,7 +1101,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputDocument &inputDocumentValue
         break;
     }
 
-    inputDocumentValue = result;
+    inputDocumentValue = std::move(result);
 
     return *this;
 }
@@ -1074,7 +1121,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputEncryptedChat &inputEncrypte
         break;
     }
 
-    inputEncryptedChatValue = result;
+    inputEncryptedChatValue = std::move(result);
 
     return *this;
 }
@@ -1107,7 +1154,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputEncryptedFile &inputEncrypte
         break;
     }
 
-    inputEncryptedFileValue = result;
+    inputEncryptedFileValue = std::move(result);
 
     return *this;
 }
@@ -1134,7 +1181,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputFile &inputFileValue)
         break;
     }
 
-    inputFileValue = result;
+    inputFileValue = std::move(result);
 
     return *this;
 }
@@ -1162,7 +1209,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputFileLocation &inputFileLocat
         break;
     }
 
-    inputFileLocationValue = result;
+    inputFileLocationValue = std::move(result);
 
     return *this;
 }
@@ -1184,7 +1231,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputGeoPoint &inputGeoPointValue
         break;
     }
 
-    inputGeoPointValue = result;
+    inputGeoPointValue = std::move(result);
 
     return *this;
 }
@@ -1214,7 +1261,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputPeer &inputPeerValue)
         break;
     }
 
-    inputPeerValue = result;
+    inputPeerValue = std::move(result);
 
     return *this;
 }
@@ -1233,7 +1280,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputPeerNotifyEvents &inputPeerN
         break;
     }
 
-    inputPeerNotifyEventsValue = result;
+    inputPeerNotifyEventsValue = std::move(result);
 
     return *this;
 }
@@ -1255,7 +1302,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputPeerNotifySettings &inputPee
         break;
     }
 
-    inputPeerNotifySettingsValue = result;
+    inputPeerNotifySettingsValue = std::move(result);
 
     return *this;
 }
@@ -1277,7 +1324,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputPhoto &inputPhotoValue)
         break;
     }
 
-    inputPhotoValue = result;
+    inputPhotoValue = std::move(result);
 
     return *this;
 }
@@ -1300,7 +1347,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputPhotoCrop &inputPhotoCropVal
         break;
     }
 
-    inputPhotoCropValue = result;
+    inputPhotoCropValue = std::move(result);
 
     return *this;
 }
@@ -1318,7 +1365,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputPrivacyKey &inputPrivacyKeyV
         break;
     }
 
-    inputPrivacyKeyValue = result;
+    inputPrivacyKeyValue = std::move(result);
 
     return *this;
 }
@@ -1343,7 +1390,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputStickerSet &inputStickerSetV
         break;
     }
 
-    inputStickerSetValue = result;
+    inputStickerSetValue = std::move(result);
 
     return *this;
 }
@@ -1366,7 +1413,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputUser &inputUserValue)
         break;
     }
 
-    inputUserValue = result;
+    inputUserValue = std::move(result);
 
     return *this;
 }
@@ -1388,7 +1435,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputVideo &inputVideoValue)
         break;
     }
 
-    inputVideoValue = result;
+    inputVideoValue = std::move(result);
 
     return *this;
 }
@@ -1407,7 +1454,7 @@ CTelegramStream &CTelegramStream::operator>>(TLKeyboardButton &keyboardButtonVal
         break;
     }
 
-    keyboardButtonValue = result;
+    keyboardButtonValue = std::move(result);
 
     return *this;
 }
@@ -1426,7 +1473,7 @@ CTelegramStream &CTelegramStream::operator>>(TLKeyboardButtonRow &keyboardButton
         break;
     }
 
-    keyboardButtonRowValue = result;
+    keyboardButtonRowValue = std::move(result);
 
     return *this;
 }
@@ -1464,7 +1511,7 @@ CTelegramStream &CTelegramStream::operator>>(TLMessageEntity &messageEntityValue
         break;
     }
 
-    messageEntityValue = result;
+    messageEntityValue = std::move(result);
 
     return *this;
 }
@@ -1486,7 +1533,7 @@ CTelegramStream &CTelegramStream::operator>>(TLMessageGroup &messageGroupValue)
         break;
     }
 
-    messageGroupValue = result;
+    messageGroupValue = std::move(result);
 
     return *this;
 }
@@ -1506,7 +1553,7 @@ CTelegramStream &CTelegramStream::operator>>(TLMessageRange &messageRangeValue)
         break;
     }
 
-    messageRangeValue = result;
+    messageRangeValue = std::move(result);
 
     return *this;
 }
@@ -1527,7 +1574,7 @@ CTelegramStream &CTelegramStream::operator>>(TLMessagesAffectedHistory &messages
         break;
     }
 
-    messagesAffectedHistoryValue = result;
+    messagesAffectedHistoryValue = std::move(result);
 
     return *this;
 }
@@ -1547,7 +1594,7 @@ CTelegramStream &CTelegramStream::operator>>(TLMessagesAffectedMessages &message
         break;
     }
 
-    messagesAffectedMessagesValue = result;
+    messagesAffectedMessagesValue = std::move(result);
 
     return *this;
 }
@@ -1572,7 +1619,7 @@ CTelegramStream &CTelegramStream::operator>>(TLMessagesDhConfig &messagesDhConfi
         break;
     }
 
-    messagesDhConfigValue = result;
+    messagesDhConfigValue = std::move(result);
 
     return *this;
 }
@@ -1599,7 +1646,7 @@ CTelegramStream &CTelegramStream::operator>>(TLMessagesFilter &messagesFilterVal
         break;
     }
 
-    messagesFilterValue = result;
+    messagesFilterValue = std::move(result);
 
     return *this;
 }
@@ -1622,7 +1669,7 @@ CTelegramStream &CTelegramStream::operator>>(TLMessagesSentEncryptedMessage &mes
         break;
     }
 
-    messagesSentEncryptedMessageValue = result;
+    messagesSentEncryptedMessageValue = std::move(result);
 
     return *this;
 }
@@ -1643,7 +1690,7 @@ CTelegramStream &CTelegramStream::operator>>(TLNearestDc &nearestDcValue)
         break;
     }
 
-    nearestDcValue = result;
+    nearestDcValue = std::move(result);
 
     return *this;
 }
@@ -1668,7 +1715,7 @@ CTelegramStream &CTelegramStream::operator>>(TLPeer &peerValue)
         break;
     }
 
-    peerValue = result;
+    peerValue = std::move(result);
 
     return *this;
 }
@@ -1687,7 +1734,7 @@ CTelegramStream &CTelegramStream::operator>>(TLPeerNotifyEvents &peerNotifyEvent
         break;
     }
 
-    peerNotifyEventsValue = result;
+    peerNotifyEventsValue = std::move(result);
 
     return *this;
 }
@@ -1711,7 +1758,7 @@ CTelegramStream &CTelegramStream::operator>>(TLPeerNotifySettings &peerNotifySet
         break;
     }
 
-    peerNotifySettingsValue = result;
+    peerNotifySettingsValue = std::move(result);
 
     return *this;
 }
@@ -1744,7 +1791,7 @@ CTelegramStream &CTelegramStream::operator>>(TLPhotoSize &photoSizeValue)
         break;
     }
 
-    photoSizeValue = result;
+    photoSizeValue = std::move(result);
 
     return *this;
 }
@@ -1762,7 +1809,7 @@ CTelegramStream &CTelegramStream::operator>>(TLPrivacyKey &privacyKeyValue)
         break;
     }
 
-    privacyKeyValue = result;
+    privacyKeyValue = std::move(result);
 
     return *this;
 }
@@ -1787,7 +1834,7 @@ CTelegramStream &CTelegramStream::operator>>(TLPrivacyRule &privacyRuleValue)
         break;
     }
 
-    privacyRuleValue = result;
+    privacyRuleValue = std::move(result);
 
     return *this;
 }
@@ -1807,7 +1854,7 @@ CTelegramStream &CTelegramStream::operator>>(TLReceivedNotifyMessage &receivedNo
         break;
     }
 
-    receivedNotifyMessageValue = result;
+    receivedNotifyMessageValue = std::move(result);
 
     return *this;
 }
@@ -1830,7 +1877,7 @@ CTelegramStream &CTelegramStream::operator>>(TLReportReason &reportReasonValue)
         break;
     }
 
-    reportReasonValue = result;
+    reportReasonValue = std::move(result);
 
     return *this;
 }
@@ -1859,7 +1906,7 @@ CTelegramStream &CTelegramStream::operator>>(TLSendMessageAction &sendMessageAct
         break;
     }
 
-    sendMessageActionValue = result;
+    sendMessageActionValue = std::move(result);
 
     return *this;
 }
@@ -1879,7 +1926,7 @@ CTelegramStream &CTelegramStream::operator>>(TLStickerPack &stickerPackValue)
         break;
     }
 
-    stickerPackValue = result;
+    stickerPackValue = std::move(result);
 
     return *this;
 }
@@ -1906,7 +1953,7 @@ CTelegramStream &CTelegramStream::operator>>(TLStorageFileType &storageFileTypeV
         break;
     }
 
-    storageFileTypeValue = result;
+    storageFileTypeValue = std::move(result);
 
     return *this;
 }
@@ -1929,7 +1976,7 @@ CTelegramStream &CTelegramStream::operator>>(TLUpdatesState &updatesStateValue)
         break;
     }
 
-    updatesStateValue = result;
+    updatesStateValue = std::move(result);
 
     return *this;
 }
@@ -1950,7 +1997,7 @@ CTelegramStream &CTelegramStream::operator>>(TLUploadFile &uploadFileValue)
         break;
     }
 
-    uploadFileValue = result;
+    uploadFileValue = std::move(result);
 
     return *this;
 }
@@ -1973,7 +2020,7 @@ CTelegramStream &CTelegramStream::operator>>(TLUserProfilePhoto &userProfilePhot
         break;
     }
 
-    userProfilePhotoValue = result;
+    userProfilePhotoValue = std::move(result);
 
     return *this;
 }
@@ -2000,7 +2047,7 @@ CTelegramStream &CTelegramStream::operator>>(TLUserStatus &userStatusValue)
         break;
     }
 
-    userStatusValue = result;
+    userStatusValue = std::move(result);
 
     return *this;
 }
@@ -2031,7 +2078,7 @@ CTelegramStream &CTelegramStream::operator>>(TLVideo &videoValue)
         break;
     }
 
-    videoValue = result;
+    videoValue = std::move(result);
 
     return *this;
 }
@@ -2059,7 +2106,7 @@ CTelegramStream &CTelegramStream::operator>>(TLWallPaper &wallPaperValue)
         break;
     }
 
-    wallPaperValue = result;
+    wallPaperValue = std::move(result);
 
     return *this;
 }
@@ -2078,7 +2125,7 @@ CTelegramStream &CTelegramStream::operator>>(TLAccountAuthorizations &accountAut
         break;
     }
 
-    accountAuthorizationsValue = result;
+    accountAuthorizationsValue = std::move(result);
 
     return *this;
 }
@@ -2104,7 +2151,7 @@ CTelegramStream &CTelegramStream::operator>>(TLBotInlineMessage &botInlineMessag
         break;
     }
 
-    botInlineMessageValue = result;
+    botInlineMessageValue = std::move(result);
 
     return *this;
 }
@@ -2127,7 +2174,7 @@ CTelegramStream &CTelegramStream::operator>>(TLChannelMessagesFilter &channelMes
         break;
     }
 
-    channelMessagesFilterValue = result;
+    channelMessagesFilterValue = std::move(result);
 
     return *this;
 }
@@ -2149,7 +2196,7 @@ CTelegramStream &CTelegramStream::operator>>(TLChatPhoto &chatPhotoValue)
         break;
     }
 
-    chatPhotoValue = result;
+    chatPhotoValue = std::move(result);
 
     return *this;
 }
@@ -2169,7 +2216,7 @@ CTelegramStream &CTelegramStream::operator>>(TLContactStatus &contactStatusValue
         break;
     }
 
-    contactStatusValue = result;
+    contactStatusValue = std::move(result);
 
     return *this;
 }
@@ -2191,7 +2238,7 @@ CTelegramStream &CTelegramStream::operator>>(TLDcOption &dcOptionValue)
         break;
     }
 
-    dcOptionValue = result;
+    dcOptionValue = std::move(result);
 
     return *this;
 }
@@ -2224,7 +2271,7 @@ CTelegramStream &CTelegramStream::operator>>(TLDialog &dialogValue)
         break;
     }
 
-    dialogValue = result;
+    dialogValue = std::move(result);
 
     return *this;
 }
@@ -2263,7 +2310,7 @@ CTelegramStream &CTelegramStream::operator>>(TLDocumentAttribute &documentAttrib
         break;
     }
 
-    documentAttributeValue = result;
+    documentAttributeValue = std::move(result);
 
     return *this;
 }
@@ -2289,7 +2336,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputBotInlineMessage &inputBotIn
         break;
     }
 
-    inputBotInlineMessageValue = result;
+    inputBotInlineMessageValue = std::move(result);
 
     return *this;
 }
@@ -2338,7 +2385,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputBotInlineResult &inputBotInl
         break;
     }
 
-    inputBotInlineResultValue = result;
+    inputBotInlineResultValue = std::move(result);
 
     return *this;
 }
@@ -2364,7 +2411,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputChatPhoto &inputChatPhotoVal
         break;
     }
 
-    inputChatPhotoValue = result;
+    inputChatPhotoValue = std::move(result);
 
     return *this;
 }
@@ -2455,7 +2502,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputMedia &inputMediaValue)
         break;
     }
 
-    inputMediaValue = result;
+    inputMediaValue = std::move(result);
 
     return *this;
 }
@@ -2478,7 +2525,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputNotifyPeer &inputNotifyPeerV
         break;
     }
 
-    inputNotifyPeerValue = result;
+    inputNotifyPeerValue = std::move(result);
 
     return *this;
 }
@@ -2503,7 +2550,7 @@ CTelegramStream &CTelegramStream::operator>>(TLInputPrivacyRule &inputPrivacyRul
         break;
     }
 
-    inputPrivacyRuleValue = result;
+    inputPrivacyRuleValue = std::move(result);
 
     return *this;
 }
@@ -2526,7 +2573,7 @@ CTelegramStream &CTelegramStream::operator>>(TLNotifyPeer &notifyPeerValue)
         break;
     }
 
-    notifyPeerValue = result;
+    notifyPeerValue = std::move(result);
 
     return *this;
 }
@@ -2551,7 +2598,7 @@ CTelegramStream &CTelegramStream::operator>>(TLPhoto &photoValue)
         break;
     }
 
-    photoValue = result;
+    photoValue = std::move(result);
 
     return *this;
 }
@@ -2575,7 +2622,7 @@ CTelegramStream &CTelegramStream::operator>>(TLReplyMarkup &replyMarkupValue)
         break;
     }
 
-    replyMarkupValue = result;
+    replyMarkupValue = std::move(result);
 
     return *this;
 }
@@ -2600,7 +2647,7 @@ CTelegramStream &CTelegramStream::operator>>(TLStickerSet &stickerSetValue)
         break;
     }
 
-    stickerSetValue = result;
+    stickerSetValue = std::move(result);
 
     return *this;
 }
@@ -2653,7 +2700,7 @@ CTelegramStream &CTelegramStream::operator>>(TLUser &userValue)
         break;
     }
 
-    userValue = result;
+    userValue = std::move(result);
 
     return *this;
 }
@@ -2673,7 +2720,7 @@ CTelegramStream &CTelegramStream::operator>>(TLAccountPrivacyRules &accountPriva
         break;
     }
 
-    accountPrivacyRulesValue = result;
+    accountPrivacyRulesValue = std::move(result);
 
     return *this;
 }
@@ -2692,7 +2739,7 @@ CTelegramStream &CTelegramStream::operator>>(TLAuthAuthorization &authAuthorizat
         break;
     }
 
-    authAuthorizationValue = result;
+    authAuthorizationValue = std::move(result);
 
     return *this;
 }
@@ -2712,7 +2759,7 @@ CTelegramStream &CTelegramStream::operator>>(TLChannelsChannelParticipant &chann
         break;
     }
 
-    channelsChannelParticipantValue = result;
+    channelsChannelParticipantValue = std::move(result);
 
     return *this;
 }
@@ -2733,7 +2780,7 @@ CTelegramStream &CTelegramStream::operator>>(TLChannelsChannelParticipants &chan
         break;
     }
 
-    channelsChannelParticipantsValue = result;
+    channelsChannelParticipantsValue = std::move(result);
 
     return *this;
 }
@@ -2788,7 +2835,7 @@ CTelegramStream &CTelegramStream::operator>>(TLChat &chatValue)
         break;
     }
 
-    chatValue = result;
+    chatValue = std::move(result);
 
     return *this;
 }
@@ -2839,7 +2886,7 @@ CTelegramStream &CTelegramStream::operator>>(TLChatFull &chatFullValue)
         break;
     }
 
-    chatFullValue = result;
+    chatFullValue = std::move(result);
 
     return *this;
 }
@@ -2862,7 +2909,7 @@ CTelegramStream &CTelegramStream::operator>>(TLChatInvite &chatInviteValue)
         break;
     }
 
-    chatInviteValue = result;
+    chatInviteValue = std::move(result);
 
     return *this;
 }
@@ -2899,7 +2946,7 @@ CTelegramStream &CTelegramStream::operator>>(TLConfig &configValue)
         break;
     }
 
-    configValue = result;
+    configValue = std::move(result);
 
     return *this;
 }
@@ -2924,7 +2971,7 @@ CTelegramStream &CTelegramStream::operator>>(TLContactsBlocked &contactsBlockedV
         break;
     }
 
-    contactsBlockedValue = result;
+    contactsBlockedValue = std::move(result);
 
     return *this;
 }
@@ -2946,7 +2993,7 @@ CTelegramStream &CTelegramStream::operator>>(TLContactsContacts &contactsContact
         break;
     }
 
-    contactsContactsValue = result;
+    contactsContactsValue = std::move(result);
 
     return *this;
 }
@@ -2967,7 +3014,7 @@ CTelegramStream &CTelegramStream::operator>>(TLContactsFound &contactsFoundValue
         break;
     }
 
-    contactsFoundValue = result;
+    contactsFoundValue = std::move(result);
 
     return *this;
 }
@@ -2988,7 +3035,7 @@ CTelegramStream &CTelegramStream::operator>>(TLContactsImportedContacts &contact
         break;
     }
 
-    contactsImportedContactsValue = result;
+    contactsImportedContactsValue = std::move(result);
 
     return *this;
 }
@@ -3009,7 +3056,7 @@ CTelegramStream &CTelegramStream::operator>>(TLContactsLink &contactsLinkValue)
         break;
     }
 
-    contactsLinkValue = result;
+    contactsLinkValue = std::move(result);
 
     return *this;
 }
@@ -3030,7 +3077,7 @@ CTelegramStream &CTelegramStream::operator>>(TLContactsResolvedPeer &contactsRes
         break;
     }
 
-    contactsResolvedPeerValue = result;
+    contactsResolvedPeerValue = std::move(result);
 
     return *this;
 }
@@ -3050,7 +3097,7 @@ CTelegramStream &CTelegramStream::operator>>(TLContactsSuggested &contactsSugges
         break;
     }
 
-    contactsSuggestedValue = result;
+    contactsSuggestedValue = std::move(result);
 
     return *this;
 }
@@ -3079,7 +3126,7 @@ CTelegramStream &CTelegramStream::operator>>(TLDocument &documentValue)
         break;
     }
 
-    documentValue = result;
+    documentValue = std::move(result);
 
     return *this;
 }
@@ -3108,7 +3155,7 @@ CTelegramStream &CTelegramStream::operator>>(TLFoundGif &foundGifValue)
         break;
     }
 
-    foundGifValue = result;
+    foundGifValue = std::move(result);
 
     return *this;
 }
@@ -3128,7 +3175,7 @@ CTelegramStream &CTelegramStream::operator>>(TLHelpSupport &helpSupportValue)
         break;
     }
 
-    helpSupportValue = result;
+    helpSupportValue = std::move(result);
 
     return *this;
 }
@@ -3174,7 +3221,7 @@ CTelegramStream &CTelegramStream::operator>>(TLMessageAction &messageActionValue
         break;
     }
 
-    messageActionValue = result;
+    messageActionValue = std::move(result);
 
     return *this;
 }
@@ -3196,7 +3243,7 @@ CTelegramStream &CTelegramStream::operator>>(TLMessagesAllStickers &messagesAllS
         break;
     }
 
-    messagesAllStickersValue = result;
+    messagesAllStickersValue = std::move(result);
 
     return *this;
 }
@@ -3217,7 +3264,7 @@ CTelegramStream &CTelegramStream::operator>>(TLMessagesChatFull &messagesChatFul
         break;
     }
 
-    messagesChatFullValue = result;
+    messagesChatFullValue = std::move(result);
 
     return *this;
 }
@@ -3236,7 +3283,7 @@ CTelegramStream &CTelegramStream::operator>>(TLMessagesChats &messagesChatsValue
         break;
     }
 
-    messagesChatsValue = result;
+    messagesChatsValue = std::move(result);
 
     return *this;
 }
@@ -3256,7 +3303,7 @@ CTelegramStream &CTelegramStream::operator>>(TLMessagesFoundGifs &messagesFoundG
         break;
     }
 
-    messagesFoundGifsValue = result;
+    messagesFoundGifsValue = std::move(result);
 
     return *this;
 }
@@ -3278,7 +3325,7 @@ CTelegramStream &CTelegramStream::operator>>(TLMessagesSavedGifs &messagesSavedG
         break;
     }
 
-    messagesSavedGifsValue = result;
+    messagesSavedGifsValue = std::move(result);
 
     return *this;
 }
@@ -3299,7 +3346,7 @@ CTelegramStream &CTelegramStream::operator>>(TLMessagesStickerSet &messagesStick
         break;
     }
 
-    messagesStickerSetValue = result;
+    messagesStickerSetValue = std::move(result);
 
     return *this;
 }
@@ -3321,7 +3368,7 @@ CTelegramStream &CTelegramStream::operator>>(TLMessagesStickers &messagesSticker
         break;
     }
 
-    messagesStickersValue = result;
+    messagesStickersValue = std::move(result);
 
     return *this;
 }
@@ -3341,7 +3388,7 @@ CTelegramStream &CTelegramStream::operator>>(TLPhotosPhoto &photosPhotoValue)
         break;
     }
 
-    photosPhotoValue = result;
+    photosPhotoValue = std::move(result);
 
     return *this;
 }
@@ -3366,7 +3413,7 @@ CTelegramStream &CTelegramStream::operator>>(TLPhotosPhotos &photosPhotosValue)
         break;
     }
 
-    photosPhotosValue = result;
+    photosPhotosValue = std::move(result);
 
     return *this;
 }
@@ -3390,7 +3437,7 @@ CTelegramStream &CTelegramStream::operator>>(TLUserFull &userFullValue)
         break;
     }
 
-    userFullValue = result;
+    userFullValue = std::move(result);
 
     return *this;
 }
@@ -3455,7 +3502,7 @@ CTelegramStream &CTelegramStream::operator>>(TLWebPage &webPageValue)
         break;
     }
 
-    webPageValue = result;
+    webPageValue = std::move(result);
 
     return *this;
 }
@@ -3516,7 +3563,7 @@ CTelegramStream &CTelegramStream::operator>>(TLBotInlineResult &botInlineResultV
         break;
     }
 
-    botInlineResultValue = result;
+    botInlineResultValue = std::move(result);
 
     return *this;
 }
@@ -3569,7 +3616,7 @@ CTelegramStream &CTelegramStream::operator>>(TLMessageMedia &messageMediaValue)
         break;
     }
 
-    messageMediaValue = result;
+    messageMediaValue = std::move(result);
 
     return *this;
 }
@@ -3593,13 +3640,17 @@ CTelegramStream &CTelegramStream::operator>>(TLMessagesBotResults &messagesBotRe
         break;
     }
 
-    messagesBotResultsValue = result;
+    messagesBotResultsValue = std::move(result);
 
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLMessage &messageValue)
 {
+    if (m_messageProjection) {
+        return (this->*m_messageProjection)(messageValue);
+    }
+
     TLMessage result;
 
     *this >> result.tlType;
@@ -3656,7 +3707,7 @@ CTelegramStream &CTelegramStream::operator>>(TLMessage &messageValue)
         break;
     }
 
-    messageValue = result;
+    messageValue = std::move(result);
 
     return *this;
 }
@@ -3685,7 +3736,7 @@ CTelegramStream &CTelegramStream::operator>>(TLMessagesDialogs &messagesDialogsV
         break;
     }
 
-    messagesDialogsValue = result;
+    messagesDialogsValue = std::move(result);
 
     return *this;
 }
@@ -3723,7 +3774,7 @@ CTelegramStream &CTelegramStream::operator>>(TLMessagesMessages &messagesMessage
         break;
     }
 
-    messagesMessagesValue = result;
+    messagesMessagesValue = std::move(result);
 
     return *this;
 }
@@ -3912,7 +3963,7 @@ CTelegramStream &CTelegramStream::operator>>(TLUpdate &updateValue)
         break;
     }
 
-    updateValue = result;
+    updateValue = std::move(result);
 
     return *this;
 }
@@ -4011,7 +4062,7 @@ CTelegramStream &CTelegramStream::operator>>(TLUpdates &updatesValue)
         break;
     }
 
-    updatesValue = result;
+    updatesValue = std::move(result);
 
     return *this;
 }
@@ -4060,7 +4111,7 @@ CTelegramStream &CTelegramStream::operator>>(TLUpdatesChannelDifference &updates
         break;
     }
 
-    updatesChannelDifferenceValue = result;
+    updatesChannelDifferenceValue = std::move(result);
 
     return *this;
 }
@@ -4096,414 +4147,4078 @@ CTelegramStream &CTelegramStream::operator>>(TLUpdatesDifference &updatesDiffere
         break;
     }
 
-    updatesDifferenceValue = result;
+    updatesDifferenceValue = std::move(result);
 
     return *this;
 }
 
 // End of generated read operators implementation
 
-// Generated write operators implementation
-CTelegramStream &CTelegramStream::operator<<(const TLAccountDaysTTL &accountDaysTTLValue)
+// Generated skip functions implementation
+CTelegramStream &CTelegramStream::skip(const TLAccountDaysTTL *)
 {
-    *this << accountDaysTTLValue.tlType;
+    TLValue tlType;
+    *this >> tlType;
 
-    switch (accountDaysTTLValue.tlType) {
+    switch (tlType) {
     case TLValue::AccountDaysTTL:
-        *this << accountDaysTTLValue.days;
+        skip<quint32>();
         break;
     default:
+        setError();
         break;
     }
 
     return *this;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLAccountPasswordInputSettings &accountPasswordInputSettingsValue)
+CTelegramStream &CTelegramStream::skip(const TLAccountPassword *)
 {
-    *this << accountPasswordInputSettingsValue.tlType;
+    TLValue tlType;
+    *this >> tlType;
 
-    switch (accountPasswordInputSettingsValue.tlType) {
-    case TLValue::AccountPasswordInputSettings:
-        *this << accountPasswordInputSettingsValue.flags;
-        if (accountPasswordInputSettingsValue.flags & 1 << 0) {
-            *this << accountPasswordInputSettingsValue.newSalt;
-        }
-        if (accountPasswordInputSettingsValue.flags & 1 << 0) {
-            *this << accountPasswordInputSettingsValue.newPasswordHash;
-        }
-        if (accountPasswordInputSettingsValue.flags & 1 << 0) {
-            *this << accountPasswordInputSettingsValue.hint;
-        }
-        if (accountPasswordInputSettingsValue.flags & 1 << 1) {
-            *this << accountPasswordInputSettingsValue.email;
-        }
+    switch (tlType) {
+    case TLValue::AccountNoPassword:
+        skip<QByteArray>();
+        skip<QString>();
+        break;
+    case TLValue::AccountPassword:
+        skip<QByteArray>();
+        skip<QByteArray>();
+        skip<QString>();
+        skip<bool>();
+        skip<QString>();
         break;
     default:
+        setError();
         break;
     }
 
     return *this;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLChannelParticipantRole &channelParticipantRoleValue)
+CTelegramStream &CTelegramStream::skip(const TLAccountPasswordInputSettings *)
 {
-    *this << channelParticipantRoleValue.tlType;
+    quint32 flags = 0;
+    TLValue tlType;
+    *this >> tlType;
 
-    switch (channelParticipantRoleValue.tlType) {
-    case TLValue::ChannelRoleEmpty:
-    case TLValue::ChannelRoleModerator:
-    case TLValue::ChannelRoleEditor:
+    switch (tlType) {
+    case TLValue::AccountPasswordInputSettings:
+        *this >> flags;
+        if (flags & 1 << 0) {
+            skip<QByteArray>();
+        }
+        if (flags & 1 << 0) {
+            skip<QByteArray>();
+        }
+        if (flags & 1 << 0) {
+            skip<QString>();
+        }
+        if (flags & 1 << 1) {
+            skip<QString>();
+        }
         break;
     default:
+        setError();
         break;
     }
 
     return *this;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLChannelParticipantsFilter &channelParticipantsFilterValue)
+CTelegramStream &CTelegramStream::skip(const TLAccountPasswordSettings *)
 {
-    *this << channelParticipantsFilterValue.tlType;
+    TLValue tlType;
+    *this >> tlType;
 
-    switch (channelParticipantsFilterValue.tlType) {
-    case TLValue::ChannelParticipantsRecent:
-    case TLValue::ChannelParticipantsAdmins:
-    case TLValue::ChannelParticipantsKicked:
-    case TLValue::ChannelParticipantsBots:
+    switch (tlType) {
+    case TLValue::AccountPasswordSettings:
+        skip<QString>();
         break;
     default:
+        setError();
         break;
     }
 
     return *this;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLInputAppEvent &inputAppEventValue)
+CTelegramStream &CTelegramStream::skip(const TLAccountSentChangePhoneCode *)
 {
-    *this << inputAppEventValue.tlType;
+    TLValue tlType;
+    *this >> tlType;
 
-    switch (inputAppEventValue.tlType) {
-    case TLValue::InputAppEvent:
-        *this << inputAppEventValue.time;
-        *this << inputAppEventValue.type;
-        *this << inputAppEventValue.peer;
-        *this << inputAppEventValue.data;
+    switch (tlType) {
+    case TLValue::AccountSentChangePhoneCode:
+        skip<QString>();
+        skip<quint32>();
         break;
     default:
+        setError();
         break;
     }
 
     return *this;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLInputAudio &inputAudioValue)
+CTelegramStream &CTelegramStream::skip(const TLAudio *)
 {
-    *this << inputAudioValue.tlType;
+    TLValue tlType;
+    *this >> tlType;
 
-    switch (inputAudioValue.tlType) {
-    case TLValue::InputAudioEmpty:
+    switch (tlType) {
+    case TLValue::AudioEmpty:
+        skip<quint64>();
         break;
-    case TLValue::InputAudio:
-        *this << inputAudioValue.id;
-        *this << inputAudioValue.accessHash;
+    case TLValue::Audio:
+        skip<quint64>();
+        skip<quint64>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<QString>();
+        skip<quint32>();
+        skip<quint32>();
         break;
     default:
+        setError();
         break;
     }
 
     return *this;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLInputChannel &inputChannelValue)
+CTelegramStream &CTelegramStream::skip(const TLAuthCheckedPhone *)
 {
-    *this << inputChannelValue.tlType;
+    TLValue tlType;
+    *this >> tlType;
 
-    switch (inputChannelValue.tlType) {
-    case TLValue::InputChannelEmpty:
-        break;
-    case TLValue::InputChannel:
-        *this << inputChannelValue.channelId;
-        *this << inputChannelValue.accessHash;
+    switch (tlType) {
+    case TLValue::AuthCheckedPhone:
+        skip<bool>();
         break;
     default:
+        setError();
         break;
     }
 
     return *this;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLInputContact &inputContactValue)
+CTelegramStream &CTelegramStream::skip(const TLAuthExportedAuthorization *)
 {
-    *this << inputContactValue.tlType;
+    TLValue tlType;
+    *this >> tlType;
 
-    switch (inputContactValue.tlType) {
-    case TLValue::InputPhoneContact:
-        *this << inputContactValue.clientId;
-        *this << inputContactValue.phone;
-        *this << inputContactValue.firstName;
-        *this << inputContactValue.lastName;
+    switch (tlType) {
+    case TLValue::AuthExportedAuthorization:
+        skip<quint32>();
+        skip<QByteArray>();
         break;
     default:
+        setError();
         break;
     }
 
     return *this;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLInputDocument &inputDocumentValue)
+CTelegramStream &CTelegramStream::skip(const TLAuthPasswordRecovery *)
 {
-    *this << inputDocumentValue.tlType;
+    TLValue tlType;
+    *this >> tlType;
 
-    switch (inputDocumentValue.tlType) {
-    case TLValue::InputDocumentEmpty:
-        break;
-    case TLValue::InputDocument:
-        *this << inputDocumentValue.id;
-        *this << inputDocumentValue.accessHash;
+    switch (tlType) {
+    case TLValue::AuthPasswordRecovery:
+        skip<QString>();
         break;
     default:
+        setError();
         break;
     }
 
     return *this;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLInputEncryptedChat &inputEncryptedChatValue)
+CTelegramStream &CTelegramStream::skip(const TLAuthSentCode *)
 {
-    *this << inputEncryptedChatValue.tlType;
+    TLValue tlType;
+    *this >> tlType;
 
-    switch (inputEncryptedChatValue.tlType) {
-    case TLValue::InputEncryptedChat:
-        *this << inputEncryptedChatValue.chatId;
-        *this << inputEncryptedChatValue.accessHash;
+    switch (tlType) {
+    case TLValue::AuthSentCode:
+    case TLValue::AuthSentAppCode:
+        skip<bool>();
+        skip<QString>();
+        skip<quint32>();
+        skip<bool>();
         break;
     default:
+        setError();
         break;
     }
 
     return *this;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLInputEncryptedFile &inputEncryptedFileValue)
+CTelegramStream &CTelegramStream::skip(const TLAuthorization *)
 {
-    *this << inputEncryptedFileValue.tlType;
+    TLValue tlType;
+    *this >> tlType;
 
-    switch (inputEncryptedFileValue.tlType) {
-    case TLValue::InputEncryptedFileEmpty:
-        break;
-    case TLValue::InputEncryptedFileUploaded:
-        *this << inputEncryptedFileValue.id;
-        *this << inputEncryptedFileValue.parts;
-        *this << inputEncryptedFileValue.md5Checksum;
-        *this << inputEncryptedFileValue.keyFingerprint;
-        break;
-    case TLValue::InputEncryptedFile:
-        *this << inputEncryptedFileValue.id;
-        *this << inputEncryptedFileValue.accessHash;
-        break;
-    case TLValue::InputEncryptedFileBigUploaded:
-        *this << inputEncryptedFileValue.id;
-        *this << inputEncryptedFileValue.parts;
-        *this << inputEncryptedFileValue.keyFingerprint;
+    switch (tlType) {
+    case TLValue::Authorization:
+        skip<quint64>();
+        skip<quint32>();
+        skip<QString>();
+        skip<QString>();
+        skip<QString>();
+        skip<quint32>();
+        skip<QString>();
+        skip<QString>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<QString>();
+        skip<QString>();
+        skip<QString>();
         break;
     default:
+        setError();
         break;
     }
 
     return *this;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLInputFile &inputFileValue)
+CTelegramStream &CTelegramStream::skip(const TLBotCommand *)
 {
-    *this << inputFileValue.tlType;
+    TLValue tlType;
+    *this >> tlType;
 
-    switch (inputFileValue.tlType) {
-    case TLValue::InputFile:
-        *this << inputFileValue.id;
-        *this << inputFileValue.parts;
-        *this << inputFileValue.name;
-        *this << inputFileValue.md5Checksum;
-        break;
-    case TLValue::InputFileBig:
-        *this << inputFileValue.id;
-        *this << inputFileValue.parts;
-        *this << inputFileValue.name;
+    switch (tlType) {
+    case TLValue::BotCommand:
+        skip<QString>();
+        skip<QString>();
         break;
     default:
+        setError();
         break;
     }
 
     return *this;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLInputFileLocation &inputFileLocationValue)
+CTelegramStream &CTelegramStream::skip(const TLBotInfo *)
 {
-    *this << inputFileLocationValue.tlType;
+    TLValue tlType;
+    *this >> tlType;
 
-    switch (inputFileLocationValue.tlType) {
-    case TLValue::InputFileLocation:
-        *this << inputFileLocationValue.volumeId;
-        *this << inputFileLocationValue.localId;
-        *this << inputFileLocationValue.secret;
+    switch (tlType) {
+    case TLValue::BotInfoEmpty:
         break;
-    case TLValue::InputVideoFileLocation:
-    case TLValue::InputEncryptedFileLocation:
-    case TLValue::InputAudioFileLocation:
-    case TLValue::InputDocumentFileLocation:
-        *this << inputFileLocationValue.id;
-        *this << inputFileLocationValue.accessHash;
+    case TLValue::BotInfo:
+        skip<quint32>();
+        skip<quint32>();
+        skip<QString>();
+        skip<QString>();
+        skip<TLVector<TLBotCommand>>();
         break;
     default:
+        setError();
         break;
     }
 
     return *this;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLInputGeoPoint &inputGeoPointValue)
+CTelegramStream &CTelegramStream::skip(const TLChannelParticipant *)
 {
-    *this << inputGeoPointValue.tlType;
+    TLValue tlType;
+    *this >> tlType;
 
-    switch (inputGeoPointValue.tlType) {
-    case TLValue::InputGeoPointEmpty:
+    switch (tlType) {
+    case TLValue::ChannelParticipant:
+        skip<quint32>();
+        skip<quint32>();
         break;
-    case TLValue::InputGeoPoint:
-        *this << inputGeoPointValue.latitude;
-        *this << inputGeoPointValue.longitude;
+    case TLValue::ChannelParticipantSelf:
+    case TLValue::ChannelParticipantModerator:
+    case TLValue::ChannelParticipantEditor:
+    case TLValue::ChannelParticipantKicked:
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    case TLValue::ChannelParticipantCreator:
+        skip<quint32>();
         break;
     default:
+        setError();
         break;
     }
 
     return *this;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLInputPeer &inputPeerValue)
+CTelegramStream &CTelegramStream::skip(const TLChannelParticipantRole *)
 {
-    *this << inputPeerValue.tlType;
+    TLValue tlType;
+    *this >> tlType;
 
-    switch (inputPeerValue.tlType) {
-    case TLValue::InputPeerEmpty:
-    case TLValue::InputPeerSelf:
-        break;
-    case TLValue::InputPeerChat:
-        *this << inputPeerValue.chatId;
-        break;
-    case TLValue::InputPeerUser:
-        *this << inputPeerValue.userId;
-        *this << inputPeerValue.accessHash;
-        break;
-    case TLValue::InputPeerChannel:
-        *this << inputPeerValue.channelId;
-        *this << inputPeerValue.accessHash;
+    switch (tlType) {
+    case TLValue::ChannelRoleEmpty:
+    case TLValue::ChannelRoleModerator:
+    case TLValue::ChannelRoleEditor:
         break;
     default:
+        setError();
         break;
     }
 
     return *this;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLInputPeerNotifySettings &inputPeerNotifySettingsValue)
+CTelegramStream &CTelegramStream::skip(const TLChannelParticipantsFilter *)
 {
-    *this << inputPeerNotifySettingsValue.tlType;
+    TLValue tlType;
+    *this >> tlType;
 
-    switch (inputPeerNotifySettingsValue.tlType) {
-    case TLValue::InputPeerNotifySettings:
-        *this << inputPeerNotifySettingsValue.muteUntil;
-        *this << inputPeerNotifySettingsValue.sound;
-        *this << inputPeerNotifySettingsValue.showPreviews;
-        *this << inputPeerNotifySettingsValue.eventsMask;
+    switch (tlType) {
+    case TLValue::ChannelParticipantsRecent:
+    case TLValue::ChannelParticipantsAdmins:
+    case TLValue::ChannelParticipantsKicked:
+    case TLValue::ChannelParticipantsBots:
         break;
     default:
+        setError();
         break;
     }
 
     return *this;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLInputPhoto &inputPhotoValue)
+CTelegramStream &CTelegramStream::skip(const TLChatParticipant *)
 {
-    *this << inputPhotoValue.tlType;
+    TLValue tlType;
+    *this >> tlType;
 
-    switch (inputPhotoValue.tlType) {
-    case TLValue::InputPhotoEmpty:
+    switch (tlType) {
+    case TLValue::ChatParticipant:
+    case TLValue::ChatParticipantAdmin:
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
         break;
-    case TLValue::InputPhoto:
-        *this << inputPhotoValue.id;
-        *this << inputPhotoValue.accessHash;
+    case TLValue::ChatParticipantCreator:
+        skip<quint32>();
         break;
     default:
+        setError();
         break;
     }
 
     return *this;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLInputPhotoCrop &inputPhotoCropValue)
+CTelegramStream &CTelegramStream::skip(const TLChatParticipants *)
 {
-    *this << inputPhotoCropValue.tlType;
+    quint32 flags = 0;
+    TLValue tlType;
+    *this >> tlType;
 
-    switch (inputPhotoCropValue.tlType) {
-    case TLValue::InputPhotoCropAuto:
+    switch (tlType) {
+    case TLValue::ChatParticipantsForbidden:
+        *this >> flags;
+        skip<quint32>();
+        if (flags & 1 << 0) {
+            skip<TLChatParticipant>();
+        }
         break;
-    case TLValue::InputPhotoCrop:
-        *this << inputPhotoCropValue.cropLeft;
-        *this << inputPhotoCropValue.cropTop;
-        *this << inputPhotoCropValue.cropWidth;
+    case TLValue::ChatParticipants:
+        skip<quint32>();
+        skip<TLVector<TLChatParticipant>>();
+        skip<quint32>();
         break;
     default:
+        setError();
         break;
     }
 
     return *this;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLInputPrivacyKey &inputPrivacyKeyValue)
+CTelegramStream &CTelegramStream::skip(const TLContact *)
 {
-    *this << inputPrivacyKeyValue.tlType;
+    TLValue tlType;
+    *this >> tlType;
 
-    switch (inputPrivacyKeyValue.tlType) {
-    case TLValue::InputPrivacyKeyStatusTimestamp:
+    switch (tlType) {
+    case TLValue::Contact:
+        skip<quint32>();
+        skip<bool>();
         break;
     default:
+        setError();
         break;
     }
 
     return *this;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLInputStickerSet &inputStickerSetValue)
+CTelegramStream &CTelegramStream::skip(const TLContactBlocked *)
 {
-    *this << inputStickerSetValue.tlType;
+    TLValue tlType;
+    *this >> tlType;
 
-    switch (inputStickerSetValue.tlType) {
-    case TLValue::InputStickerSetEmpty:
-        break;
-    case TLValue::InputStickerSetID:
-        *this << inputStickerSetValue.id;
-        *this << inputStickerSetValue.accessHash;
-        break;
-    case TLValue::InputStickerSetShortName:
-        *this << inputStickerSetValue.shortName;
+    switch (tlType) {
+    case TLValue::ContactBlocked:
+        skip<quint32>();
+        skip<quint32>();
         break;
     default:
+        setError();
         break;
     }
 
     return *this;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLInputUser &inputUserValue)
+CTelegramStream &CTelegramStream::skip(const TLContactLink *)
 {
-    *this << inputUserValue.tlType;
+    TLValue tlType;
+    *this >> tlType;
 
-    switch (inputUserValue.tlType) {
-    case TLValue::InputUserEmpty:
-    case TLValue::InputUserSelf:
-        break;
-    case TLValue::InputUser:
+    switch (tlType) {
+    case TLValue::ContactLinkUnknown:
+    case TLValue::ContactLinkNone:
+    case TLValue::ContactLinkHasPhone:
+    case TLValue::ContactLinkContact:
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLContactSuggested *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::ContactSuggested:
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLDisabledFeature *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::DisabledFeature:
+        skip<QString>();
+        skip<QString>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLEncryptedChat *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::EncryptedChatEmpty:
+    case TLValue::EncryptedChatDiscarded:
+        skip<quint32>();
+        break;
+    case TLValue::EncryptedChatWaiting:
+        skip<quint32>();
+        skip<quint64>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    case TLValue::EncryptedChatRequested:
+        skip<quint32>();
+        skip<quint64>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<QByteArray>();
+        break;
+    case TLValue::EncryptedChat:
+        skip<quint32>();
+        skip<quint64>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<QByteArray>();
+        skip<quint64>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLEncryptedFile *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::EncryptedFileEmpty:
+        break;
+    case TLValue::EncryptedFile:
+        skip<quint64>();
+        skip<quint64>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLEncryptedMessage *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::EncryptedMessage:
+        skip<quint64>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<QByteArray>();
+        skip<TLEncryptedFile>();
+        break;
+    case TLValue::EncryptedMessageService:
+        skip<quint64>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<QByteArray>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLError *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::Error:
+        skip<quint32>();
+        skip<QString>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLExportedChatInvite *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::ChatInviteEmpty:
+        break;
+    case TLValue::ChatInviteExported:
+        skip<QString>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLFileLocation *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::FileLocationUnavailable:
+        skip<quint64>();
+        skip<quint32>();
+        skip<quint64>();
+        break;
+    case TLValue::FileLocation:
+        skip<quint32>();
+        skip<quint64>();
+        skip<quint32>();
+        skip<quint64>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLGeoPoint *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::GeoPointEmpty:
+        break;
+    case TLValue::GeoPoint:
+        skip<double>();
+        skip<double>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLHelpAppChangelog *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::HelpAppChangelogEmpty:
+        break;
+    case TLValue::HelpAppChangelog:
+        skip<QString>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLHelpAppUpdate *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::HelpAppUpdate:
+        skip<quint32>();
+        skip<bool>();
+        skip<QString>();
+        skip<QString>();
+        break;
+    case TLValue::HelpNoAppUpdate:
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLHelpInviteText *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::HelpInviteText:
+        skip<QString>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLHelpTermsOfService *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::HelpTermsOfService:
+        skip<QString>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLImportedContact *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::ImportedContact:
+        skip<quint32>();
+        skip<quint64>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputAppEvent *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputAppEvent:
+        skip<double>();
+        skip<QString>();
+        skip<quint64>();
+        skip<QString>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputAudio *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputAudioEmpty:
+        break;
+    case TLValue::InputAudio:
+        skip<quint64>();
+        skip<quint64>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputChannel *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputChannelEmpty:
+        break;
+    case TLValue::InputChannel:
+        skip<quint32>();
+        skip<quint64>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputContact *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputPhoneContact:
+        skip<quint64>();
+        skip<QString>();
+        skip<QString>();
+        skip<QString>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputDocument *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputDocumentEmpty:
+        break;
+    case TLValue::InputDocument:
+        skip<quint64>();
+        skip<quint64>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputEncryptedChat *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputEncryptedChat:
+        skip<quint32>();
+        skip<quint64>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputEncryptedFile *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputEncryptedFileEmpty:
+        break;
+    case TLValue::InputEncryptedFileUploaded:
+        skip<quint64>();
+        skip<quint32>();
+        skip<QString>();
+        skip<quint32>();
+        break;
+    case TLValue::InputEncryptedFile:
+        skip<quint64>();
+        skip<quint64>();
+        break;
+    case TLValue::InputEncryptedFileBigUploaded:
+        skip<quint64>();
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputFile *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputFile:
+        skip<quint64>();
+        skip<quint32>();
+        skip<QString>();
+        skip<QString>();
+        break;
+    case TLValue::InputFileBig:
+        skip<quint64>();
+        skip<quint32>();
+        skip<QString>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputFileLocation *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputFileLocation:
+        skip<quint64>();
+        skip<quint32>();
+        skip<quint64>();
+        break;
+    case TLValue::InputVideoFileLocation:
+    case TLValue::InputEncryptedFileLocation:
+    case TLValue::InputAudioFileLocation:
+    case TLValue::InputDocumentFileLocation:
+        skip<quint64>();
+        skip<quint64>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputGeoPoint *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputGeoPointEmpty:
+        break;
+    case TLValue::InputGeoPoint:
+        skip<double>();
+        skip<double>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputPeer *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputPeerEmpty:
+    case TLValue::InputPeerSelf:
+        break;
+    case TLValue::InputPeerChat:
+        skip<quint32>();
+        break;
+    case TLValue::InputPeerUser:
+    case TLValue::InputPeerChannel:
+        skip<quint32>();
+        skip<quint64>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputPeerNotifyEvents *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputPeerNotifyEventsEmpty:
+    case TLValue::InputPeerNotifyEventsAll:
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputPeerNotifySettings *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputPeerNotifySettings:
+        skip<quint32>();
+        skip<QString>();
+        skip<bool>();
+        skip<quint32>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputPhoto *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputPhotoEmpty:
+        break;
+    case TLValue::InputPhoto:
+        skip<quint64>();
+        skip<quint64>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputPhotoCrop *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputPhotoCropAuto:
+        break;
+    case TLValue::InputPhotoCrop:
+        skip<double>();
+        skip<double>();
+        skip<double>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputPrivacyKey *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputPrivacyKeyStatusTimestamp:
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputStickerSet *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputStickerSetEmpty:
+        break;
+    case TLValue::InputStickerSetID:
+        skip<quint64>();
+        skip<quint64>();
+        break;
+    case TLValue::InputStickerSetShortName:
+        skip<QString>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputUser *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputUserEmpty:
+    case TLValue::InputUserSelf:
+        break;
+    case TLValue::InputUser:
+        skip<quint32>();
+        skip<quint64>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputVideo *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputVideoEmpty:
+        break;
+    case TLValue::InputVideo:
+        skip<quint64>();
+        skip<quint64>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLKeyboardButton *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::KeyboardButton:
+        skip<QString>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLKeyboardButtonRow *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::KeyboardButtonRow:
+        skip<TLVector<TLKeyboardButton>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLMessageEntity *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::MessageEntityUnknown:
+    case TLValue::MessageEntityMention:
+    case TLValue::MessageEntityHashtag:
+    case TLValue::MessageEntityBotCommand:
+    case TLValue::MessageEntityUrl:
+    case TLValue::MessageEntityEmail:
+    case TLValue::MessageEntityBold:
+    case TLValue::MessageEntityItalic:
+    case TLValue::MessageEntityCode:
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    case TLValue::MessageEntityPre:
+    case TLValue::MessageEntityTextUrl:
+        skip<quint32>();
+        skip<quint32>();
+        skip<QString>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLMessageGroup *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::MessageGroup:
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLMessageRange *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::MessageRange:
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLMessagesAffectedHistory *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::MessagesAffectedHistory:
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLMessagesAffectedMessages *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::MessagesAffectedMessages:
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLMessagesDhConfig *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::MessagesDhConfigNotModified:
+        skip<QByteArray>();
+        break;
+    case TLValue::MessagesDhConfig:
+        skip<quint32>();
+        skip<QByteArray>();
+        skip<quint32>();
+        skip<QByteArray>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLMessagesFilter *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputMessagesFilterEmpty:
+    case TLValue::InputMessagesFilterPhotos:
+    case TLValue::InputMessagesFilterVideo:
+    case TLValue::InputMessagesFilterPhotoVideo:
+    case TLValue::InputMessagesFilterPhotoVideoDocuments:
+    case TLValue::InputMessagesFilterDocument:
+    case TLValue::InputMessagesFilterAudio:
+    case TLValue::InputMessagesFilterAudioDocuments:
+    case TLValue::InputMessagesFilterUrl:
+    case TLValue::InputMessagesFilterGif:
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLMessagesSentEncryptedMessage *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::MessagesSentEncryptedMessage:
+        skip<quint32>();
+        break;
+    case TLValue::MessagesSentEncryptedFile:
+        skip<quint32>();
+        skip<TLEncryptedFile>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLNearestDc *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::NearestDc:
+        skip<QString>();
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLPeer *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::PeerUser:
+    case TLValue::PeerChat:
+    case TLValue::PeerChannel:
+        skip<quint32>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLPeerNotifyEvents *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::PeerNotifyEventsEmpty:
+    case TLValue::PeerNotifyEventsAll:
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLPeerNotifySettings *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::PeerNotifySettingsEmpty:
+        break;
+    case TLValue::PeerNotifySettings:
+        skip<quint32>();
+        skip<QString>();
+        skip<bool>();
+        skip<quint32>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLPhotoSize *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::PhotoSizeEmpty:
+        skip<QString>();
+        break;
+    case TLValue::PhotoSize:
+        skip<QString>();
+        skip<TLFileLocation>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    case TLValue::PhotoCachedSize:
+        skip<QString>();
+        skip<TLFileLocation>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<QByteArray>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLPrivacyKey *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::PrivacyKeyStatusTimestamp:
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLPrivacyRule *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::PrivacyValueAllowContacts:
+    case TLValue::PrivacyValueAllowAll:
+    case TLValue::PrivacyValueDisallowContacts:
+    case TLValue::PrivacyValueDisallowAll:
+        break;
+    case TLValue::PrivacyValueAllowUsers:
+    case TLValue::PrivacyValueDisallowUsers:
+        skip<TLVector<quint32>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLReceivedNotifyMessage *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::ReceivedNotifyMessage:
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLReportReason *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputReportReasonSpam:
+    case TLValue::InputReportReasonViolence:
+    case TLValue::InputReportReasonPornography:
+        break;
+    case TLValue::InputReportReasonOther:
+        skip<QString>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLSendMessageAction *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::SendMessageTypingAction:
+    case TLValue::SendMessageCancelAction:
+    case TLValue::SendMessageRecordVideoAction:
+    case TLValue::SendMessageRecordAudioAction:
+    case TLValue::SendMessageGeoLocationAction:
+    case TLValue::SendMessageChooseContactAction:
+        break;
+    case TLValue::SendMessageUploadVideoAction:
+    case TLValue::SendMessageUploadAudioAction:
+    case TLValue::SendMessageUploadPhotoAction:
+    case TLValue::SendMessageUploadDocumentAction:
+        skip<quint32>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLStickerPack *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::StickerPack:
+        skip<QString>();
+        skip<TLVector<quint64>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLStorageFileType *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::StorageFileUnknown:
+    case TLValue::StorageFileJpeg:
+    case TLValue::StorageFileGif:
+    case TLValue::StorageFilePng:
+    case TLValue::StorageFilePdf:
+    case TLValue::StorageFileMp3:
+    case TLValue::StorageFileMov:
+    case TLValue::StorageFilePartial:
+    case TLValue::StorageFileMp4:
+    case TLValue::StorageFileWebp:
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLUpdatesState *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::UpdatesState:
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLUploadFile *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::UploadFile:
+        skip<TLStorageFileType>();
+        skip<quint32>();
+        skip<QByteArray>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLUserProfilePhoto *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::UserProfilePhotoEmpty:
+        break;
+    case TLValue::UserProfilePhoto:
+        skip<quint64>();
+        skip<TLFileLocation>();
+        skip<TLFileLocation>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLUserStatus *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::UserStatusEmpty:
+    case TLValue::UserStatusRecently:
+    case TLValue::UserStatusLastWeek:
+    case TLValue::UserStatusLastMonth:
+        break;
+    case TLValue::UserStatusOnline:
+    case TLValue::UserStatusOffline:
+        skip<quint32>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLVideo *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::VideoEmpty:
+        skip<quint64>();
+        break;
+    case TLValue::Video:
+        skip<quint64>();
+        skip<quint64>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<QString>();
+        skip<quint32>();
+        skip<TLPhotoSize>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLWallPaper *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::WallPaper:
+        skip<quint32>();
+        skip<QString>();
+        skip<TLVector<TLPhotoSize>>();
+        skip<quint32>();
+        break;
+    case TLValue::WallPaperSolid:
+        skip<quint32>();
+        skip<QString>();
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLAccountAuthorizations *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::AccountAuthorizations:
+        skip<TLVector<TLAuthorization>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLBotInlineMessage *)
+{
+    quint32 flags = 0;
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::BotInlineMessageMediaAuto:
+        skip<QString>();
+        break;
+    case TLValue::BotInlineMessageText:
+        *this >> flags;
+        skip<QString>();
+        if (flags & 1 << 1) {
+            skip<TLVector<TLMessageEntity>>();
+        }
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLChannelMessagesFilter *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::ChannelMessagesFilterEmpty:
+    case TLValue::ChannelMessagesFilterCollapsed:
+        break;
+    case TLValue::ChannelMessagesFilter:
+        skip<quint32>();
+        skip<TLVector<TLMessageRange>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLChatPhoto *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::ChatPhotoEmpty:
+        break;
+    case TLValue::ChatPhoto:
+        skip<TLFileLocation>();
+        skip<TLFileLocation>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLContactStatus *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::ContactStatus:
+        skip<quint32>();
+        skip<TLUserStatus>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLDcOption *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::DcOption:
+        skip<quint32>();
+        skip<quint32>();
+        skip<QString>();
+        skip<quint32>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLDialog *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::Dialog:
+        skip<TLPeer>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<TLPeerNotifySettings>();
+        break;
+    case TLValue::DialogChannel:
+        skip<TLPeer>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<TLPeerNotifySettings>();
+        skip<quint32>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLDocumentAttribute *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::DocumentAttributeImageSize:
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    case TLValue::DocumentAttributeAnimated:
+        break;
+    case TLValue::DocumentAttributeSticker:
+        skip<QString>();
+        skip<TLInputStickerSet>();
+        break;
+    case TLValue::DocumentAttributeVideo:
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    case TLValue::DocumentAttributeAudio:
+        skip<quint32>();
+        skip<QString>();
+        skip<QString>();
+        break;
+    case TLValue::DocumentAttributeFilename:
+        skip<QString>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputBotInlineMessage *)
+{
+    quint32 flags = 0;
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputBotInlineMessageMediaAuto:
+        skip<QString>();
+        break;
+    case TLValue::InputBotInlineMessageText:
+        *this >> flags;
+        skip<QString>();
+        if (flags & 1 << 1) {
+            skip<TLVector<TLMessageEntity>>();
+        }
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputBotInlineResult *)
+{
+    quint32 flags = 0;
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputBotInlineResult:
+        *this >> flags;
+        skip<QString>();
+        skip<QString>();
+        if (flags & 1 << 1) {
+            skip<QString>();
+        }
+        if (flags & 1 << 2) {
+            skip<QString>();
+        }
+        if (flags & 1 << 3) {
+            skip<QString>();
+        }
+        if (flags & 1 << 4) {
+            skip<QString>();
+        }
+        if (flags & 1 << 5) {
+            skip<QString>();
+        }
+        if (flags & 1 << 5) {
+            skip<QString>();
+        }
+        if (flags & 1 << 6) {
+            skip<quint32>();
+        }
+        if (flags & 1 << 6) {
+            skip<quint32>();
+        }
+        if (flags & 1 << 7) {
+            skip<quint32>();
+        }
+        skip<TLInputBotInlineMessage>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputChatPhoto *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputChatPhotoEmpty:
+        break;
+    case TLValue::InputChatUploadedPhoto:
+        skip<TLInputFile>();
+        skip<TLInputPhotoCrop>();
+        break;
+    case TLValue::InputChatPhoto:
+        skip<TLInputPhoto>();
+        skip<TLInputPhotoCrop>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputMedia *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputMediaEmpty:
+        break;
+    case TLValue::InputMediaUploadedPhoto:
+        skip<TLInputFile>();
+        skip<QString>();
+        break;
+    case TLValue::InputMediaPhoto:
+        skip<TLInputPhoto>();
+        skip<QString>();
+        break;
+    case TLValue::InputMediaGeoPoint:
+        skip<TLInputGeoPoint>();
+        break;
+    case TLValue::InputMediaContact:
+        skip<QString>();
+        skip<QString>();
+        skip<QString>();
+        break;
+    case TLValue::InputMediaUploadedVideo:
+        skip<TLInputFile>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<QString>();
+        skip<QString>();
+        break;
+    case TLValue::InputMediaUploadedThumbVideo:
+        skip<TLInputFile>();
+        skip<TLInputFile>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<QString>();
+        skip<QString>();
+        break;
+    case TLValue::InputMediaVideo:
+        skip<TLInputVideo>();
+        skip<QString>();
+        break;
+    case TLValue::InputMediaUploadedAudio:
+        skip<TLInputFile>();
+        skip<quint32>();
+        skip<QString>();
+        break;
+    case TLValue::InputMediaAudio:
+        skip<TLInputAudio>();
+        break;
+    case TLValue::InputMediaUploadedDocument:
+        skip<TLInputFile>();
+        skip<QString>();
+        skip<TLVector<TLDocumentAttribute>>();
+        skip<QString>();
+        break;
+    case TLValue::InputMediaUploadedThumbDocument:
+        skip<TLInputFile>();
+        skip<TLInputFile>();
+        skip<QString>();
+        skip<TLVector<TLDocumentAttribute>>();
+        skip<QString>();
+        break;
+    case TLValue::InputMediaDocument:
+        skip<TLInputDocument>();
+        skip<QString>();
+        break;
+    case TLValue::InputMediaVenue:
+        skip<TLInputGeoPoint>();
+        skip<QString>();
+        skip<QString>();
+        skip<QString>();
+        skip<QString>();
+        break;
+    case TLValue::InputMediaGifExternal:
+        skip<QString>();
+        skip<QString>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputNotifyPeer *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputNotifyPeer:
+        skip<TLInputPeer>();
+        break;
+    case TLValue::InputNotifyUsers:
+    case TLValue::InputNotifyChats:
+    case TLValue::InputNotifyAll:
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLInputPrivacyRule *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::InputPrivacyValueAllowContacts:
+    case TLValue::InputPrivacyValueAllowAll:
+    case TLValue::InputPrivacyValueDisallowContacts:
+    case TLValue::InputPrivacyValueDisallowAll:
+        break;
+    case TLValue::InputPrivacyValueAllowUsers:
+    case TLValue::InputPrivacyValueDisallowUsers:
+        skip<TLVector<TLInputUser>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLNotifyPeer *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::NotifyPeer:
+        skip<TLPeer>();
+        break;
+    case TLValue::NotifyUsers:
+    case TLValue::NotifyChats:
+    case TLValue::NotifyAll:
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLPhoto *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::PhotoEmpty:
+        skip<quint64>();
+        break;
+    case TLValue::Photo:
+        skip<quint64>();
+        skip<quint64>();
+        skip<quint32>();
+        skip<TLVector<TLPhotoSize>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLReplyMarkup *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::ReplyKeyboardHide:
+    case TLValue::ReplyKeyboardForceReply:
+        skip<quint32>();
+        break;
+    case TLValue::ReplyKeyboardMarkup:
+        skip<quint32>();
+        skip<TLVector<TLKeyboardButtonRow>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLStickerSet *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::StickerSet:
+        skip<quint32>();
+        skip<quint64>();
+        skip<quint64>();
+        skip<QString>();
+        skip<QString>();
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLUser *)
+{
+    quint32 flags = 0;
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::UserEmpty:
+        skip<quint32>();
+        break;
+    case TLValue::User:
+        *this >> flags;
+        skip<quint32>();
+        if (flags & 1 << 0) {
+            skip<quint64>();
+        }
+        if (flags & 1 << 1) {
+            skip<QString>();
+        }
+        if (flags & 1 << 2) {
+            skip<QString>();
+        }
+        if (flags & 1 << 3) {
+            skip<QString>();
+        }
+        if (flags & 1 << 4) {
+            skip<QString>();
+        }
+        if (flags & 1 << 5) {
+            skip<TLUserProfilePhoto>();
+        }
+        if (flags & 1 << 6) {
+            skip<TLUserStatus>();
+        }
+        if (flags & 1 << 14) {
+            skip<quint32>();
+        }
+        if (flags & 1 << 18) {
+            skip<QString>();
+        }
+        if (flags & 1 << 19) {
+            skip<QString>();
+        }
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLAccountPrivacyRules *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::AccountPrivacyRules:
+        skip<TLVector<TLPrivacyRule>>();
+        skip<TLVector<TLUser>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLAuthAuthorization *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::AuthAuthorization:
+        skip<TLUser>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLChannelsChannelParticipant *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::ChannelsChannelParticipant:
+        skip<TLChannelParticipant>();
+        skip<TLVector<TLUser>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLChannelsChannelParticipants *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::ChannelsChannelParticipants:
+        skip<quint32>();
+        skip<TLVector<TLChannelParticipant>>();
+        skip<TLVector<TLUser>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLChat *)
+{
+    quint32 flags = 0;
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::ChatEmpty:
+        skip<quint32>();
+        break;
+    case TLValue::Chat:
+        *this >> flags;
+        skip<quint32>();
+        skip<QString>();
+        skip<TLChatPhoto>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        if (flags & 1 << 6) {
+            skip<TLInputChannel>();
+        }
+        break;
+    case TLValue::ChatForbidden:
+        skip<quint32>();
+        skip<QString>();
+        break;
+    case TLValue::Channel:
+        *this >> flags;
+        skip<quint32>();
+        skip<quint64>();
+        skip<QString>();
+        if (flags & 1 << 6) {
+            skip<QString>();
+        }
+        skip<TLChatPhoto>();
+        skip<quint32>();
+        skip<quint32>();
+        if (flags & 1 << 9) {
+            skip<QString>();
+        }
+        break;
+    case TLValue::ChannelForbidden:
+        skip<quint32>();
+        skip<quint64>();
+        skip<QString>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLChatFull *)
+{
+    quint32 flags = 0;
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::ChatFull:
+        skip<quint32>();
+        skip<TLChatParticipants>();
+        skip<TLPhoto>();
+        skip<TLPeerNotifySettings>();
+        skip<TLExportedChatInvite>();
+        skip<TLVector<TLBotInfo>>();
+        break;
+    case TLValue::ChannelFull:
+        *this >> flags;
+        skip<quint32>();
+        skip<QString>();
+        if (flags & 1 << 0) {
+            skip<quint32>();
+        }
+        if (flags & 1 << 1) {
+            skip<quint32>();
+        }
+        if (flags & 1 << 2) {
+            skip<quint32>();
+        }
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<TLPhoto>();
+        skip<TLPeerNotifySettings>();
+        skip<TLExportedChatInvite>();
+        skip<TLVector<TLBotInfo>>();
+        if (flags & 1 << 4) {
+            skip<quint32>();
+        }
+        if (flags & 1 << 4) {
+            skip<quint32>();
+        }
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLChatInvite *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::ChatInviteAlready:
+        skip<TLChat>();
+        break;
+    case TLValue::ChatInvite:
+        skip<quint32>();
+        skip<QString>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLConfig *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::Config:
+        skip<quint32>();
+        skip<quint32>();
+        skip<bool>();
+        skip<quint32>();
+        skip<TLVector<TLDcOption>>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<TLVector<TLDisabledFeature>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLContactsBlocked *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::ContactsBlocked:
+        skip<TLVector<TLContactBlocked>>();
+        skip<TLVector<TLUser>>();
+        break;
+    case TLValue::ContactsBlockedSlice:
+        skip<quint32>();
+        skip<TLVector<TLContactBlocked>>();
+        skip<TLVector<TLUser>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLContactsContacts *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::ContactsContactsNotModified:
+        break;
+    case TLValue::ContactsContacts:
+        skip<TLVector<TLContact>>();
+        skip<TLVector<TLUser>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLContactsFound *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::ContactsFound:
+        skip<TLVector<TLPeer>>();
+        skip<TLVector<TLChat>>();
+        skip<TLVector<TLUser>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLContactsImportedContacts *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::ContactsImportedContacts:
+        skip<TLVector<TLImportedContact>>();
+        skip<TLVector<quint64>>();
+        skip<TLVector<TLUser>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLContactsLink *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::ContactsLink:
+        skip<TLContactLink>();
+        skip<TLContactLink>();
+        skip<TLUser>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLContactsResolvedPeer *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::ContactsResolvedPeer:
+        skip<TLPeer>();
+        skip<TLVector<TLChat>>();
+        skip<TLVector<TLUser>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLContactsSuggested *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::ContactsSuggested:
+        skip<TLVector<TLContactSuggested>>();
+        skip<TLVector<TLUser>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLDocument *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::DocumentEmpty:
+        skip<quint64>();
+        break;
+    case TLValue::Document:
+        skip<quint64>();
+        skip<quint64>();
+        skip<quint32>();
+        skip<QString>();
+        skip<quint32>();
+        skip<TLPhotoSize>();
+        skip<quint32>();
+        skip<TLVector<TLDocumentAttribute>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLFoundGif *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::FoundGif:
+        skip<QString>();
+        skip<QString>();
+        skip<QString>();
+        skip<QString>();
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    case TLValue::FoundGifCached:
+        skip<QString>();
+        skip<TLPhoto>();
+        skip<TLDocument>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLHelpSupport *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::HelpSupport:
+        skip<QString>();
+        skip<TLUser>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLMessageAction *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::MessageActionEmpty:
+    case TLValue::MessageActionChatDeletePhoto:
+        break;
+    case TLValue::MessageActionChatCreate:
+        skip<QString>();
+        skip<TLVector<quint32>>();
+        break;
+    case TLValue::MessageActionChatEditTitle:
+    case TLValue::MessageActionChannelCreate:
+        skip<QString>();
+        break;
+    case TLValue::MessageActionChatEditPhoto:
+        skip<TLPhoto>();
+        break;
+    case TLValue::MessageActionChatAddUser:
+        skip<TLVector<quint32>>();
+        break;
+    case TLValue::MessageActionChatDeleteUser:
+    case TLValue::MessageActionChatJoinedByLink:
+    case TLValue::MessageActionChatMigrateTo:
+        skip<quint32>();
+        break;
+    case TLValue::MessageActionChannelMigrateFrom:
+        skip<QString>();
+        skip<quint32>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLMessagesAllStickers *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::MessagesAllStickersNotModified:
+        break;
+    case TLValue::MessagesAllStickers:
+        skip<quint32>();
+        skip<TLVector<TLStickerSet>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLMessagesChatFull *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::MessagesChatFull:
+        skip<TLChatFull>();
+        skip<TLVector<TLChat>>();
+        skip<TLVector<TLUser>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLMessagesChats *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::MessagesChats:
+        skip<TLVector<TLChat>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLMessagesFoundGifs *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::MessagesFoundGifs:
+        skip<quint32>();
+        skip<TLVector<TLFoundGif>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLMessagesSavedGifs *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::MessagesSavedGifsNotModified:
+        break;
+    case TLValue::MessagesSavedGifs:
+        skip<quint32>();
+        skip<TLVector<TLDocument>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLMessagesStickerSet *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::MessagesStickerSet:
+        skip<TLStickerSet>();
+        skip<TLVector<TLStickerPack>>();
+        skip<TLVector<TLDocument>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLMessagesStickers *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::MessagesStickersNotModified:
+        break;
+    case TLValue::MessagesStickers:
+        skip<QString>();
+        skip<TLVector<TLDocument>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLPhotosPhoto *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::PhotosPhoto:
+        skip<TLPhoto>();
+        skip<TLVector<TLUser>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLPhotosPhotos *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::PhotosPhotos:
+        skip<TLVector<TLPhoto>>();
+        skip<TLVector<TLUser>>();
+        break;
+    case TLValue::PhotosPhotosSlice:
+        skip<quint32>();
+        skip<TLVector<TLPhoto>>();
+        skip<TLVector<TLUser>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLUserFull *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::UserFull:
+        skip<TLUser>();
+        skip<TLContactsLink>();
+        skip<TLPhoto>();
+        skip<TLPeerNotifySettings>();
+        skip<bool>();
+        skip<TLBotInfo>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLWebPage *)
+{
+    quint32 flags = 0;
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::WebPageEmpty:
+        skip<quint64>();
+        break;
+    case TLValue::WebPagePending:
+        skip<quint64>();
+        skip<quint32>();
+        break;
+    case TLValue::WebPage:
+        *this >> flags;
+        skip<quint64>();
+        skip<QString>();
+        skip<QString>();
+        if (flags & 1 << 0) {
+            skip<QString>();
+        }
+        if (flags & 1 << 1) {
+            skip<QString>();
+        }
+        if (flags & 1 << 2) {
+            skip<QString>();
+        }
+        if (flags & 1 << 3) {
+            skip<QString>();
+        }
+        if (flags & 1 << 4) {
+            skip<TLPhoto>();
+        }
+        if (flags & 1 << 5) {
+            skip<QString>();
+        }
+        if (flags & 1 << 5) {
+            skip<QString>();
+        }
+        if (flags & 1 << 6) {
+            skip<quint32>();
+        }
+        if (flags & 1 << 6) {
+            skip<quint32>();
+        }
+        if (flags & 1 << 7) {
+            skip<quint32>();
+        }
+        if (flags & 1 << 8) {
+            skip<QString>();
+        }
+        if (flags & 1 << 9) {
+            skip<TLDocument>();
+        }
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLBotInlineResult *)
+{
+    quint32 flags = 0;
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::BotInlineMediaResultDocument:
+        skip<QString>();
+        skip<QString>();
+        skip<TLDocument>();
+        skip<TLBotInlineMessage>();
+        break;
+    case TLValue::BotInlineMediaResultPhoto:
+        skip<QString>();
+        skip<QString>();
+        skip<TLPhoto>();
+        skip<TLBotInlineMessage>();
+        break;
+    case TLValue::BotInlineResult:
+        *this >> flags;
+        skip<QString>();
+        skip<QString>();
+        if (flags & 1 << 1) {
+            skip<QString>();
+        }
+        if (flags & 1 << 2) {
+            skip<QString>();
+        }
+        if (flags & 1 << 3) {
+            skip<QString>();
+        }
+        if (flags & 1 << 4) {
+            skip<QString>();
+        }
+        if (flags & 1 << 5) {
+            skip<QString>();
+        }
+        if (flags & 1 << 5) {
+            skip<QString>();
+        }
+        if (flags & 1 << 6) {
+            skip<quint32>();
+        }
+        if (flags & 1 << 6) {
+            skip<quint32>();
+        }
+        if (flags & 1 << 7) {
+            skip<quint32>();
+        }
+        skip<TLBotInlineMessage>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLMessageMedia *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::MessageMediaEmpty:
+    case TLValue::MessageMediaUnsupported:
+        break;
+    case TLValue::MessageMediaPhoto:
+        skip<TLPhoto>();
+        skip<QString>();
+        break;
+    case TLValue::MessageMediaVideo:
+        skip<TLVideo>();
+        skip<QString>();
+        break;
+    case TLValue::MessageMediaGeo:
+        skip<TLGeoPoint>();
+        break;
+    case TLValue::MessageMediaContact:
+        skip<QString>();
+        skip<QString>();
+        skip<QString>();
+        skip<quint32>();
+        break;
+    case TLValue::MessageMediaDocument:
+        skip<TLDocument>();
+        skip<QString>();
+        break;
+    case TLValue::MessageMediaAudio:
+        skip<TLAudio>();
+        break;
+    case TLValue::MessageMediaWebPage:
+        skip<TLWebPage>();
+        break;
+    case TLValue::MessageMediaVenue:
+        skip<TLGeoPoint>();
+        skip<QString>();
+        skip<QString>();
+        skip<QString>();
+        skip<QString>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLMessagesBotResults *)
+{
+    quint32 flags = 0;
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::MessagesBotResults:
+        *this >> flags;
+        skip<quint64>();
+        if (flags & 1 << 1) {
+            skip<QString>();
+        }
+        skip<TLVector<TLBotInlineResult>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLMessage *)
+{
+    quint32 flags = 0;
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::MessageEmpty:
+        skip<quint32>();
+        break;
+    case TLValue::Message:
+        *this >> flags;
+        skip<quint32>();
+        if (flags & 1 << 8) {
+            skip<quint32>();
+        }
+        skip<TLPeer>();
+        if (flags & 1 << 2) {
+            skip<TLPeer>();
+        }
+        if (flags & 1 << 2) {
+            skip<quint32>();
+        }
+        if (flags & 1 << 11) {
+            skip<quint32>();
+        }
+        if (flags & 1 << 3) {
+            skip<quint32>();
+        }
+        skip<quint32>();
+        skip<QString>();
+        if (flags & 1 << 9) {
+            skip<TLMessageMedia>();
+        }
+        if (flags & 1 << 6) {
+            skip<TLReplyMarkup>();
+        }
+        if (flags & 1 << 7) {
+            skip<TLVector<TLMessageEntity>>();
+        }
+        if (flags & 1 << 10) {
+            skip<quint32>();
+        }
+        break;
+    case TLValue::MessageService:
+        *this >> flags;
+        skip<quint32>();
+        if (flags & 1 << 8) {
+            skip<quint32>();
+        }
+        skip<TLPeer>();
+        skip<quint32>();
+        skip<TLMessageAction>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLMessagesDialogs *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::MessagesDialogs:
+        skip<TLVector<TLDialog>>();
+        skip<TLVector<TLMessage>>();
+        skip<TLVector<TLChat>>();
+        skip<TLVector<TLUser>>();
+        break;
+    case TLValue::MessagesDialogsSlice:
+        skip<quint32>();
+        skip<TLVector<TLDialog>>();
+        skip<TLVector<TLMessage>>();
+        skip<TLVector<TLChat>>();
+        skip<TLVector<TLUser>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLMessagesMessages *)
+{
+    quint32 flags = 0;
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::MessagesMessages:
+        skip<TLVector<TLMessage>>();
+        skip<TLVector<TLChat>>();
+        skip<TLVector<TLUser>>();
+        break;
+    case TLValue::MessagesMessagesSlice:
+        skip<quint32>();
+        skip<TLVector<TLMessage>>();
+        skip<TLVector<TLChat>>();
+        skip<TLVector<TLUser>>();
+        break;
+    case TLValue::MessagesChannelMessages:
+        *this >> flags;
+        skip<quint32>();
+        skip<quint32>();
+        skip<TLVector<TLMessage>>();
+        if (flags & 1 << 0) {
+            skip<TLVector<TLMessageGroup>>();
+        }
+        skip<TLVector<TLChat>>();
+        skip<TLVector<TLUser>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLUpdate *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::UpdateNewMessage:
+    case TLValue::UpdateNewChannelMessage:
+        skip<TLMessage>();
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    case TLValue::UpdateMessageID:
+        skip<quint32>();
+        skip<quint64>();
+        break;
+    case TLValue::UpdateDeleteMessages:
+    case TLValue::UpdateReadMessagesContents:
+        skip<TLVector<quint32>>();
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    case TLValue::UpdateUserTyping:
+        skip<quint32>();
+        skip<TLSendMessageAction>();
+        break;
+    case TLValue::UpdateChatUserTyping:
+        skip<quint32>();
+        skip<quint32>();
+        skip<TLSendMessageAction>();
+        break;
+    case TLValue::UpdateChatParticipants:
+        skip<TLChatParticipants>();
+        break;
+    case TLValue::UpdateUserStatus:
+        skip<quint32>();
+        skip<TLUserStatus>();
+        break;
+    case TLValue::UpdateUserName:
+        skip<quint32>();
+        skip<QString>();
+        skip<QString>();
+        skip<QString>();
+        break;
+    case TLValue::UpdateUserPhoto:
+        skip<quint32>();
+        skip<quint32>();
+        skip<TLUserProfilePhoto>();
+        skip<bool>();
+        break;
+    case TLValue::UpdateContactRegistered:
+    case TLValue::UpdateReadChannelInbox:
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    case TLValue::UpdateContactLink:
+        skip<quint32>();
+        skip<TLContactLink>();
+        skip<TLContactLink>();
+        break;
+    case TLValue::UpdateNewAuthorization:
+    case TLValue::UpdateBotInlineQuery:
+        skip<quint64>();
+        skip<quint32>();
+        skip<QString>();
+        skip<QString>();
+        break;
+    case TLValue::UpdateNewEncryptedMessage:
+        skip<TLEncryptedMessage>();
+        skip<quint32>();
+        break;
+    case TLValue::UpdateEncryptedChatTyping:
+    case TLValue::UpdateChannelTooLong:
+    case TLValue::UpdateChannel:
+        skip<quint32>();
+        break;
+    case TLValue::UpdateEncryption:
+        skip<TLEncryptedChat>();
+        skip<quint32>();
+        break;
+    case TLValue::UpdateEncryptedMessagesRead:
+    case TLValue::UpdateChatParticipantDelete:
+    case TLValue::UpdateChannelMessageViews:
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    case TLValue::UpdateChatParticipantAdd:
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    case TLValue::UpdateDcOptions:
+        skip<TLVector<TLDcOption>>();
+        break;
+    case TLValue::UpdateUserBlocked:
+        skip<quint32>();
+        skip<bool>();
+        break;
+    case TLValue::UpdateNotifySettings:
+        skip<TLNotifyPeer>();
+        skip<TLPeerNotifySettings>();
+        break;
+    case TLValue::UpdateServiceNotification:
+        skip<QString>();
+        skip<QString>();
+        skip<TLMessageMedia>();
+        skip<bool>();
+        break;
+    case TLValue::UpdatePrivacy:
+        skip<TLPrivacyKey>();
+        skip<TLVector<TLPrivacyRule>>();
+        break;
+    case TLValue::UpdateUserPhone:
+        skip<quint32>();
+        skip<QString>();
+        break;
+    case TLValue::UpdateReadHistoryInbox:
+    case TLValue::UpdateReadHistoryOutbox:
+        skip<TLPeer>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    case TLValue::UpdateWebPage:
+        skip<TLWebPage>();
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    case TLValue::UpdateChannelGroup:
+        skip<quint32>();
+        skip<TLMessageGroup>();
+        break;
+    case TLValue::UpdateDeleteChannelMessages:
+        skip<quint32>();
+        skip<TLVector<quint32>>();
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    case TLValue::UpdateChatAdmins:
+        skip<quint32>();
+        skip<bool>();
+        skip<quint32>();
+        break;
+    case TLValue::UpdateChatParticipantAdmin:
+        skip<quint32>();
+        skip<quint32>();
+        skip<bool>();
+        skip<quint32>();
+        break;
+    case TLValue::UpdateNewStickerSet:
+        skip<TLMessagesStickerSet>();
+        break;
+    case TLValue::UpdateStickerSetsOrder:
+        skip<TLVector<quint64>>();
+        break;
+    case TLValue::UpdateStickerSets:
+    case TLValue::UpdateSavedGifs:
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLUpdates *)
+{
+    quint32 flags = 0;
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::UpdatesTooLong:
+        break;
+    case TLValue::UpdateShortMessage:
+        *this >> flags;
+        skip<quint32>();
+        skip<quint32>();
+        skip<QString>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        if (flags & 1 << 2) {
+            skip<TLPeer>();
+        }
+        if (flags & 1 << 2) {
+            skip<quint32>();
+        }
+        if (flags & 1 << 11) {
+            skip<quint32>();
+        }
+        if (flags & 1 << 3) {
+            skip<quint32>();
+        }
+        if (flags & 1 << 7) {
+            skip<TLVector<TLMessageEntity>>();
+        }
+        break;
+    case TLValue::UpdateShortChatMessage:
+        *this >> flags;
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<QString>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        if (flags & 1 << 2) {
+            skip<TLPeer>();
+        }
+        if (flags & 1 << 2) {
+            skip<quint32>();
+        }
+        if (flags & 1 << 11) {
+            skip<quint32>();
+        }
+        if (flags & 1 << 3) {
+            skip<quint32>();
+        }
+        if (flags & 1 << 7) {
+            skip<TLVector<TLMessageEntity>>();
+        }
+        break;
+    case TLValue::UpdateShort:
+        skip<TLUpdate>();
+        skip<quint32>();
+        break;
+    case TLValue::UpdatesCombined:
+        skip<TLVector<TLUpdate>>();
+        skip<TLVector<TLUser>>();
+        skip<TLVector<TLChat>>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    case TLValue::Updates:
+        skip<TLVector<TLUpdate>>();
+        skip<TLVector<TLUser>>();
+        skip<TLVector<TLChat>>();
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    case TLValue::UpdateShortSentMessage:
+        *this >> flags;
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        if (flags & 1 << 9) {
+            skip<TLMessageMedia>();
+        }
+        if (flags & 1 << 7) {
+            skip<TLVector<TLMessageEntity>>();
+        }
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLUpdatesChannelDifference *)
+{
+    quint32 flags = 0;
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::UpdatesChannelDifferenceEmpty:
+        *this >> flags;
+        skip<quint32>();
+        if (flags & 1 << 1) {
+            skip<quint32>();
+        }
+        break;
+    case TLValue::UpdatesChannelDifferenceTooLong:
+        *this >> flags;
+        skip<quint32>();
+        if (flags & 1 << 1) {
+            skip<quint32>();
+        }
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<quint32>();
+        skip<TLVector<TLMessage>>();
+        skip<TLVector<TLChat>>();
+        skip<TLVector<TLUser>>();
+        break;
+    case TLValue::UpdatesChannelDifference:
+        *this >> flags;
+        skip<quint32>();
+        if (flags & 1 << 1) {
+            skip<quint32>();
+        }
+        skip<TLVector<TLMessage>>();
+        skip<TLVector<TLUpdate>>();
+        skip<TLVector<TLChat>>();
+        skip<TLVector<TLUser>>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::skip(const TLUpdatesDifference *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    switch (tlType) {
+    case TLValue::UpdatesDifferenceEmpty:
+        skip<quint32>();
+        skip<quint32>();
+        break;
+    case TLValue::UpdatesDifference:
+    case TLValue::UpdatesDifferenceSlice:
+        skip<TLVector<TLMessage>>();
+        skip<TLVector<TLEncryptedMessage>>();
+        skip<TLVector<TLUpdate>>();
+        skip<TLVector<TLChat>>();
+        skip<TLVector<TLUser>>();
+        skip<TLUpdatesState>();
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    return *this;
+}
+
+// End of generated skip functions implementation
+
+// Generated write operators implementation
+CTelegramStream &CTelegramStream::operator<<(const TLAccountDaysTTL &accountDaysTTLValue)
+{
+    *this << accountDaysTTLValue.tlType;
+
+    switch (accountDaysTTLValue.tlType) {
+    case TLValue::AccountDaysTTL:
+        *this << accountDaysTTLValue.days;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLAccountPasswordInputSettings &accountPasswordInputSettingsValue)
+{
+    *this << accountPasswordInputSettingsValue.tlType;
+
+    switch (accountPasswordInputSettingsValue.tlType) {
+    case TLValue::AccountPasswordInputSettings:
+        *this << accountPasswordInputSettingsValue.flags;
+        if (accountPasswordInputSettingsValue.flags & 1 << 0) {
+            *this << accountPasswordInputSettingsValue.newSalt;
+        }
+        if (accountPasswordInputSettingsValue.flags & 1 << 0) {
+            *this << accountPasswordInputSettingsValue.newPasswordHash;
+        }
+        if (accountPasswordInputSettingsValue.flags & 1 << 0) {
+            *this << accountPasswordInputSettingsValue.hint;
+        }
+        if (accountPasswordInputSettingsValue.flags & 1 << 1) {
+            *this << accountPasswordInputSettingsValue.email;
+        }
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLChannelParticipantRole &channelParticipantRoleValue)
+{
+    *this << channelParticipantRoleValue.tlType;
+
+    switch (channelParticipantRoleValue.tlType) {
+    case TLValue::ChannelRoleEmpty:
+    case TLValue::ChannelRoleModerator:
+    case TLValue::ChannelRoleEditor:
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLChannelParticipantsFilter &channelParticipantsFilterValue)
+{
+    *this << channelParticipantsFilterValue.tlType;
+
+    switch (channelParticipantsFilterValue.tlType) {
+    case TLValue::ChannelParticipantsRecent:
+    case TLValue::ChannelParticipantsAdmins:
+    case TLValue::ChannelParticipantsKicked:
+    case TLValue::ChannelParticipantsBots:
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLInputAppEvent &inputAppEventValue)
+{
+    *this << inputAppEventValue.tlType;
+
+    switch (inputAppEventValue.tlType) {
+    case TLValue::InputAppEvent:
+        *this << inputAppEventValue.time;
+        *this << inputAppEventValue.type;
+        *this << inputAppEventValue.peer;
+        *this << inputAppEventValue.data;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLInputAudio &inputAudioValue)
+{
+    *this << inputAudioValue.tlType;
+
+    switch (inputAudioValue.tlType) {
+    case TLValue::InputAudioEmpty:
+        break;
+    case TLValue::InputAudio:
+        *this << inputAudioValue.id;
+        *this << inputAudioValue.accessHash;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLInputChannel &inputChannelValue)
+{
+    *this << inputChannelValue.tlType;
+
+    switch (inputChannelValue.tlType) {
+    case TLValue::InputChannelEmpty:
+        break;
+    case TLValue::InputChannel:
+        *this << inputChannelValue.channelId;
+        *this << inputChannelValue.accessHash;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLInputContact &inputContactValue)
+{
+    *this << inputContactValue.tlType;
+
+    switch (inputContactValue.tlType) {
+    case TLValue::InputPhoneContact:
+        *this << inputContactValue.clientId;
+        *this << inputContactValue.phone;
+        *this << inputContactValue.firstName;
+        *this << inputContactValue.lastName;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLInputDocument &inputDocumentValue)
+{
+    *this << inputDocumentValue.tlType;
+
+    switch (inputDocumentValue.tlType) {
+    case TLValue::InputDocumentEmpty:
+        break;
+    case TLValue::InputDocument:
+        *this << inputDocumentValue.id;
+        *this << inputDocumentValue.accessHash;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLInputEncryptedChat &inputEncryptedChatValue)
+{
+    *this << inputEncryptedChatValue.tlType;
+
+    switch (inputEncryptedChatValue.tlType) {
+    case TLValue::InputEncryptedChat:
+        *this << inputEncryptedChatValue.chatId;
+        *this << inputEncryptedChatValue.accessHash;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLInputEncryptedFile &inputEncryptedFileValue)
+{
+    *this << inputEncryptedFileValue.tlType;
+
+    switch (inputEncryptedFileValue.tlType) {
+    case TLValue::InputEncryptedFileEmpty:
+        break;
+    case TLValue::InputEncryptedFileUploaded:
+        *this << inputEncryptedFileValue.id;
+        *this << inputEncryptedFileValue.parts;
+        *this << inputEncryptedFileValue.md5Checksum;
+        *this << inputEncryptedFileValue.keyFingerprint;
+        break;
+    case TLValue::InputEncryptedFile:
+        *this << inputEncryptedFileValue.id;
+        *this << inputEncryptedFileValue.accessHash;
+        break;
+    case TLValue::InputEncryptedFileBigUploaded:
+        *this << inputEncryptedFileValue.id;
+        *this << inputEncryptedFileValue.parts;
+        *this << inputEncryptedFileValue.keyFingerprint;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLInputFile &inputFileValue)
+{
+    *this << inputFileValue.tlType;
+
+    switch (inputFileValue.tlType) {
+    case TLValue::InputFile:
+        *this << inputFileValue.id;
+        *this << inputFileValue.parts;
+        *this << inputFileValue.name;
+        *this << inputFileValue.md5Checksum;
+        break;
+    case TLValue::InputFileBig:
+        *this << inputFileValue.id;
+        *this << inputFileValue.parts;
+        *this << inputFileValue.name;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLInputFileLocation &inputFileLocationValue)
+{
+    *this << inputFileLocationValue.tlType;
+
+    switch (inputFileLocationValue.tlType) {
+    case TLValue::InputFileLocation:
+        *this << inputFileLocationValue.volumeId;
+        *this << inputFileLocationValue.localId;
+        *this << inputFileLocationValue.secret;
+        break;
+    case TLValue::InputVideoFileLocation:
+    case TLValue::InputEncryptedFileLocation:
+    case TLValue::InputAudioFileLocation:
+    case TLValue::InputDocumentFileLocation:
+        *this << inputFileLocationValue.id;
+        *this << inputFileLocationValue.accessHash;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLInputGeoPoint &inputGeoPointValue)
+{
+    *this << inputGeoPointValue.tlType;
+
+    switch (inputGeoPointValue.tlType) {
+    case TLValue::InputGeoPointEmpty:
+        break;
+    case TLValue::InputGeoPoint:
+        *this << inputGeoPointValue.latitude;
+        *this << inputGeoPointValue.longitude;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLInputPeer &inputPeerValue)
+{
+    *this << inputPeerValue.tlType;
+
+    switch (inputPeerValue.tlType) {
+    case TLValue::InputPeerEmpty:
+    case TLValue::InputPeerSelf:
+        break;
+    case TLValue::InputPeerChat:
+        *this << inputPeerValue.chatId;
+        break;
+    case TLValue::InputPeerUser:
+        *this << inputPeerValue.userId;
+        *this << inputPeerValue.accessHash;
+        break;
+    case TLValue::InputPeerChannel:
+        *this << inputPeerValue.channelId;
+        *this << inputPeerValue.accessHash;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLInputPeerNotifySettings &inputPeerNotifySettingsValue)
+{
+    *this << inputPeerNotifySettingsValue.tlType;
+
+    switch (inputPeerNotifySettingsValue.tlType) {
+    case TLValue::InputPeerNotifySettings:
+        *this << inputPeerNotifySettingsValue.muteUntil;
+        *this << inputPeerNotifySettingsValue.sound;
+        *this << inputPeerNotifySettingsValue.showPreviews;
+        *this << inputPeerNotifySettingsValue.eventsMask;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLInputPhoto &inputPhotoValue)
+{
+    *this << inputPhotoValue.tlType;
+
+    switch (inputPhotoValue.tlType) {
+    case TLValue::InputPhotoEmpty:
+        break;
+    case TLValue::InputPhoto:
+        *this << inputPhotoValue.id;
+        *this << inputPhotoValue.accessHash;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLInputPhotoCrop &inputPhotoCropValue)
+{
+    *this << inputPhotoCropValue.tlType;
+
+    switch (inputPhotoCropValue.tlType) {
+    case TLValue::InputPhotoCropAuto:
+        break;
+    case TLValue::InputPhotoCrop:
+        *this << inputPhotoCropValue.cropLeft;
+        *this << inputPhotoCropValue.cropTop;
+        *this << inputPhotoCropValue.cropWidth;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLInputPrivacyKey &inputPrivacyKeyValue)
+{
+    *this << inputPrivacyKeyValue.tlType;
+
+    switch (inputPrivacyKeyValue.tlType) {
+    case TLValue::InputPrivacyKeyStatusTimestamp:
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLInputStickerSet &inputStickerSetValue)
+{
+    *this << inputStickerSetValue.tlType;
+
+    switch (inputStickerSetValue.tlType) {
+    case TLValue::InputStickerSetEmpty:
+        break;
+    case TLValue::InputStickerSetID:
+        *this << inputStickerSetValue.id;
+        *this << inputStickerSetValue.accessHash;
+        break;
+    case TLValue::InputStickerSetShortName:
+        *this << inputStickerSetValue.shortName;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLInputUser &inputUserValue)
+{
+    *this << inputUserValue.tlType;
+
+    switch (inputUserValue.tlType) {
+    case TLValue::InputUserEmpty:
+    case TLValue::InputUserSelf:
+        break;
+    case TLValue::InputUser:
         *this << inputUserValue.userId;
         *this << inputUserValue.accessHash;
         break;
@@ -4511,60 +8226,928 @@ CTelegramStream &CTelegramStream::operator<<(const TLInputUser &inputUserValue)
         break;
     }
 
-    return *this;
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLInputVideo &inputVideoValue)
+{
+    *this << inputVideoValue.tlType;
+
+    switch (inputVideoValue.tlType) {
+    case TLValue::InputVideoEmpty:
+        break;
+    case TLValue::InputVideo:
+        *this << inputVideoValue.id;
+        *this << inputVideoValue.accessHash;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLKeyboardButton &keyboardButtonValue)
+{
+    *this << keyboardButtonValue.tlType;
+
+    switch (keyboardButtonValue.tlType) {
+    case TLValue::KeyboardButton:
+        *this << keyboardButtonValue.text;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLKeyboardButtonRow &keyboardButtonRowValue)
+{
+    *this << keyboardButtonRowValue.tlType;
+
+    switch (keyboardButtonRowValue.tlType) {
+    case TLValue::KeyboardButtonRow:
+        *this << keyboardButtonRowValue.buttons;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLMessageEntity &messageEntityValue)
+{
+    *this << messageEntityValue.tlType;
+
+    switch (messageEntityValue.tlType) {
+    case TLValue::MessageEntityUnknown:
+    case TLValue::MessageEntityMention:
+    case TLValue::MessageEntityHashtag:
+    case TLValue::MessageEntityBotCommand:
+    case TLValue::MessageEntityUrl:
+    case TLValue::MessageEntityEmail:
+    case TLValue::MessageEntityBold:
+    case TLValue::MessageEntityItalic:
+    case TLValue::MessageEntityCode:
+        *this << messageEntityValue.offset;
+        *this << messageEntityValue.length;
+        break;
+    case TLValue::MessageEntityPre:
+        *this << messageEntityValue.offset;
+        *this << messageEntityValue.length;
+        *this << messageEntityValue.language;
+        break;
+    case TLValue::MessageEntityTextUrl:
+        *this << messageEntityValue.offset;
+        *this << messageEntityValue.length;
+        *this << messageEntityValue.url;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLMessageRange &messageRangeValue)
+{
+    *this << messageRangeValue.tlType;
+
+    switch (messageRangeValue.tlType) {
+    case TLValue::MessageRange:
+        *this << messageRangeValue.minId;
+        *this << messageRangeValue.maxId;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLMessagesFilter &messagesFilterValue)
+{
+    *this << messagesFilterValue.tlType;
+
+    switch (messagesFilterValue.tlType) {
+    case TLValue::InputMessagesFilterEmpty:
+    case TLValue::InputMessagesFilterPhotos:
+    case TLValue::InputMessagesFilterVideo:
+    case TLValue::InputMessagesFilterPhotoVideo:
+    case TLValue::InputMessagesFilterPhotoVideoDocuments:
+    case TLValue::InputMessagesFilterDocument:
+    case TLValue::InputMessagesFilterAudio:
+    case TLValue::InputMessagesFilterAudioDocuments:
+    case TLValue::InputMessagesFilterUrl:
+    case TLValue::InputMessagesFilterGif:
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLReportReason &reportReasonValue)
+{
+    *this << reportReasonValue.tlType;
+
+    switch (reportReasonValue.tlType) {
+    case TLValue::InputReportReasonSpam:
+    case TLValue::InputReportReasonViolence:
+    case TLValue::InputReportReasonPornography:
+        break;
+    case TLValue::InputReportReasonOther:
+        *this << reportReasonValue.text;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLSendMessageAction &sendMessageActionValue)
+{
+    *this << sendMessageActionValue.tlType;
+
+    switch (sendMessageActionValue.tlType) {
+    case TLValue::SendMessageTypingAction:
+    case TLValue::SendMessageCancelAction:
+    case TLValue::SendMessageRecordVideoAction:
+    case TLValue::SendMessageRecordAudioAction:
+    case TLValue::SendMessageGeoLocationAction:
+    case TLValue::SendMessageChooseContactAction:
+        break;
+    case TLValue::SendMessageUploadVideoAction:
+    case TLValue::SendMessageUploadAudioAction:
+    case TLValue::SendMessageUploadPhotoAction:
+    case TLValue::SendMessageUploadDocumentAction:
+        *this << sendMessageActionValue.progress;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLChannelMessagesFilter &channelMessagesFilterValue)
+{
+    *this << channelMessagesFilterValue.tlType;
+
+    switch (channelMessagesFilterValue.tlType) {
+    case TLValue::ChannelMessagesFilterEmpty:
+    case TLValue::ChannelMessagesFilterCollapsed:
+        break;
+    case TLValue::ChannelMessagesFilter:
+        *this << channelMessagesFilterValue.flags;
+        *this << channelMessagesFilterValue.ranges;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLDocumentAttribute &documentAttributeValue)
+{
+    *this << documentAttributeValue.tlType;
+
+    switch (documentAttributeValue.tlType) {
+    case TLValue::DocumentAttributeImageSize:
+        *this << documentAttributeValue.w;
+        *this << documentAttributeValue.h;
+        break;
+    case TLValue::DocumentAttributeAnimated:
+        break;
+    case TLValue::DocumentAttributeSticker:
+        *this << documentAttributeValue.alt;
+        *this << documentAttributeValue.stickerset;
+        break;
+    case TLValue::DocumentAttributeVideo:
+        *this << documentAttributeValue.duration;
+        *this << documentAttributeValue.w;
+        *this << documentAttributeValue.h;
+        break;
+    case TLValue::DocumentAttributeAudio:
+        *this << documentAttributeValue.duration;
+        *this << documentAttributeValue.title;
+        *this << documentAttributeValue.performer;
+        break;
+    case TLValue::DocumentAttributeFilename:
+        *this << documentAttributeValue.fileName;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLInputBotInlineMessage &inputBotInlineMessageValue)
+{
+    *this << inputBotInlineMessageValue.tlType;
+
+    switch (inputBotInlineMessageValue.tlType) {
+    case TLValue::InputBotInlineMessageMediaAuto:
+        *this << inputBotInlineMessageValue.caption;
+        break;
+    case TLValue::InputBotInlineMessageText:
+        *this << inputBotInlineMessageValue.flags;
+        *this << inputBotInlineMessageValue.message;
+        if (inputBotInlineMessageValue.flags & 1 << 1) {
+            *this << inputBotInlineMessageValue.entities;
+        }
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLInputBotInlineResult &inputBotInlineResultValue)
+{
+    *this << inputBotInlineResultValue.tlType;
+
+    switch (inputBotInlineResultValue.tlType) {
+    case TLValue::InputBotInlineResult:
+        *this << inputBotInlineResultValue.flags;
+        *this << inputBotInlineResultValue.id;
+        *this << inputBotInlineResultValue.type;
+        if (inputBotInlineResultValue.flags & 1 << 1) {
+            *this << inputBotInlineResultValue.title;
+        }
+        if (inputBotInlineResultValue.flags & 1 << 2) {
+            *this << inputBotInlineResultValue.description;
+        }
+        if (inputBotInlineResultValue.flags & 1 << 3) {
+            *this << inputBotInlineResultValue.url;
+        }
+        if (inputBotInlineResultValue.flags & 1 << 4) {
+            *this << inputBotInlineResultValue.thumbUrl;
+        }
+        if (inputBotInlineResultValue.flags & 1 << 5) {
+            *this << inputBotInlineResultValue.contentUrl;
+        }
+        if (inputBotInlineResultValue.flags & 1 << 5) {
+            *this << inputBotInlineResultValue.contentType;
+        }
+        if (inputBotInlineResultValue.flags & 1 << 6) {
+            *this << inputBotInlineResultValue.w;
+        }
+        if (inputBotInlineResultValue.flags & 1 << 6) {
+            *this << inputBotInlineResultValue.h;
+        }
+        if (inputBotInlineResultValue.flags & 1 << 7) {
+            *this << inputBotInlineResultValue.duration;
+        }
+        *this << inputBotInlineResultValue.sendMessage;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLInputChatPhoto &inputChatPhotoValue)
+{
+    *this << inputChatPhotoValue.tlType;
+
+    switch (inputChatPhotoValue.tlType) {
+    case TLValue::InputChatPhotoEmpty:
+        break;
+    case TLValue::InputChatUploadedPhoto:
+        *this << inputChatPhotoValue.file;
+        *this << inputChatPhotoValue.crop;
+        break;
+    case TLValue::InputChatPhoto:
+        *this << inputChatPhotoValue.id;
+        *this << inputChatPhotoValue.crop;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLInputMedia &inputMediaValue)
+{
+    *this << inputMediaValue.tlType;
+
+    switch (inputMediaValue.tlType) {
+    case TLValue::InputMediaEmpty:
+        break;
+    case TLValue::InputMediaUploadedPhoto:
+        *this << inputMediaValue.file;
+        *this << inputMediaValue.caption;
+        break;
+    case TLValue::InputMediaPhoto:
+        *this << inputMediaValue.inputPhotoId;
+        *this << inputMediaValue.caption;
+        break;
+    case TLValue::InputMediaGeoPoint:
+        *this << inputMediaValue.geoPoint;
+        break;
+    case TLValue::InputMediaContact:
+        *this << inputMediaValue.phoneNumber;
+        *this << inputMediaValue.firstName;
+        *this << inputMediaValue.lastName;
+        break;
+    case TLValue::InputMediaUploadedVideo:
+        *this << inputMediaValue.file;
+        *this << inputMediaValue.duration;
+        *this << inputMediaValue.w;
+        *this << inputMediaValue.h;
+        *this << inputMediaValue.mimeType;
+        *this << inputMediaValue.caption;
+        break;
+    case TLValue::InputMediaUploadedThumbVideo:
+        *this << inputMediaValue.file;
+        *this << inputMediaValue.thumb;
+        *this << inputMediaValue.duration;
+        *this << inputMediaValue.w;
+        *this << inputMediaValue.h;
+        *this << inputMediaValue.mimeType;
+        *this << inputMediaValue.caption;
+        break;
+    case TLValue::InputMediaVideo:
+        *this << inputMediaValue.inputVideoId;
+        *this << inputMediaValue.caption;
+        break;
+    case TLValue::InputMediaUploadedAudio:
+        *this << inputMediaValue.file;
+        *this << inputMediaValue.duration;
+        *this << inputMediaValue.mimeType;
+        break;
+    case TLValue::InputMediaAudio:
+        *this << inputMediaValue.inputAudioId;
+        break;
+    case TLValue::InputMediaUploadedDocument:
+        *this << inputMediaValue.file;
+        *this << inputMediaValue.mimeType;
+        *this << inputMediaValue.attributes;
+        *this << inputMediaValue.caption;
+        break;
+    case TLValue::InputMediaUploadedThumbDocument:
+        *this << inputMediaValue.file;
+        *this << inputMediaValue.thumb;
+        *this << inputMediaValue.mimeType;
+        *this << inputMediaValue.attributes;
+        *this << inputMediaValue.caption;
+        break;
+    case TLValue::InputMediaDocument:
+        *this << inputMediaValue.inputDocumentId;
+        *this << inputMediaValue.caption;
+        break;
+    case TLValue::InputMediaVenue:
+        *this << inputMediaValue.geoPoint;
+        *this << inputMediaValue.title;
+        *this << inputMediaValue.address;
+        *this << inputMediaValue.provider;
+        *this << inputMediaValue.venueId;
+        break;
+    case TLValue::InputMediaGifExternal:
+        *this << inputMediaValue.url;
+        *this << inputMediaValue.q;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLInputNotifyPeer &inputNotifyPeerValue)
+{
+    *this << inputNotifyPeerValue.tlType;
+
+    switch (inputNotifyPeerValue.tlType) {
+    case TLValue::InputNotifyPeer:
+        *this << inputNotifyPeerValue.peer;
+        break;
+    case TLValue::InputNotifyUsers:
+    case TLValue::InputNotifyChats:
+    case TLValue::InputNotifyAll:
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLInputPrivacyRule &inputPrivacyRuleValue)
+{
+    *this << inputPrivacyRuleValue.tlType;
+
+    switch (inputPrivacyRuleValue.tlType) {
+    case TLValue::InputPrivacyValueAllowContacts:
+    case TLValue::InputPrivacyValueAllowAll:
+    case TLValue::InputPrivacyValueDisallowContacts:
+    case TLValue::InputPrivacyValueDisallowAll:
+        break;
+    case TLValue::InputPrivacyValueAllowUsers:
+    case TLValue::InputPrivacyValueDisallowUsers:
+        *this << inputPrivacyRuleValue.users;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const TLReplyMarkup &replyMarkupValue)
+{
+    *this << replyMarkupValue.tlType;
+
+    switch (replyMarkupValue.tlType) {
+    case TLValue::ReplyKeyboardHide:
+    case TLValue::ReplyKeyboardForceReply:
+        *this << replyMarkupValue.flags;
+        break;
+    case TLValue::ReplyKeyboardMarkup:
+        *this << replyMarkupValue.flags;
+        *this << replyMarkupValue.rows;
+        break;
+    default:
+        break;
+    }
+
+    return *this;
+}
+
+// End of generated write operators implementation
+
+// Generated size functions implementation
+quint32 CTelegramStream::serializedSize(const TLAccountDaysTTL &accountDaysTTLValue)
+{
+    quint32 size = 4;
+
+    switch (accountDaysTTLValue.tlType) {
+    case TLValue::AccountDaysTTL:
+        size += serializedSize(accountDaysTTLValue.days);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+quint32 CTelegramStream::serializedSize(const TLAccountPasswordInputSettings &accountPasswordInputSettingsValue)
+{
+    quint32 size = 4;
+
+    switch (accountPasswordInputSettingsValue.tlType) {
+    case TLValue::AccountPasswordInputSettings:
+        size += serializedSize(accountPasswordInputSettingsValue.flags);
+        if (accountPasswordInputSettingsValue.flags & 1 << 0) {
+            size += serializedSize(accountPasswordInputSettingsValue.newSalt);
+        }
+        if (accountPasswordInputSettingsValue.flags & 1 << 0) {
+            size += serializedSize(accountPasswordInputSettingsValue.newPasswordHash);
+        }
+        if (accountPasswordInputSettingsValue.flags & 1 << 0) {
+            size += serializedSize(accountPasswordInputSettingsValue.hint);
+        }
+        if (accountPasswordInputSettingsValue.flags & 1 << 1) {
+            size += serializedSize(accountPasswordInputSettingsValue.email);
+        }
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+quint32 CTelegramStream::serializedSize(const TLChannelParticipantRole &channelParticipantRoleValue)
+{
+    quint32 size = 4;
+
+    switch (channelParticipantRoleValue.tlType) {
+    case TLValue::ChannelRoleEmpty:
+    case TLValue::ChannelRoleModerator:
+    case TLValue::ChannelRoleEditor:
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+quint32 CTelegramStream::serializedSize(const TLChannelParticipantsFilter &channelParticipantsFilterValue)
+{
+    quint32 size = 4;
+
+    switch (channelParticipantsFilterValue.tlType) {
+    case TLValue::ChannelParticipantsRecent:
+    case TLValue::ChannelParticipantsAdmins:
+    case TLValue::ChannelParticipantsKicked:
+    case TLValue::ChannelParticipantsBots:
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+quint32 CTelegramStream::serializedSize(const TLInputAppEvent &inputAppEventValue)
+{
+    quint32 size = 4;
+
+    switch (inputAppEventValue.tlType) {
+    case TLValue::InputAppEvent:
+        size += serializedSize(inputAppEventValue.time);
+        size += serializedSize(inputAppEventValue.type);
+        size += serializedSize(inputAppEventValue.peer);
+        size += serializedSize(inputAppEventValue.data);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+quint32 CTelegramStream::serializedSize(const TLInputAudio &inputAudioValue)
+{
+    quint32 size = 4;
+
+    switch (inputAudioValue.tlType) {
+    case TLValue::InputAudioEmpty:
+        break;
+    case TLValue::InputAudio:
+        size += serializedSize(inputAudioValue.id);
+        size += serializedSize(inputAudioValue.accessHash);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+quint32 CTelegramStream::serializedSize(const TLInputChannel &inputChannelValue)
+{
+    quint32 size = 4;
+
+    switch (inputChannelValue.tlType) {
+    case TLValue::InputChannelEmpty:
+        break;
+    case TLValue::InputChannel:
+        size += serializedSize(inputChannelValue.channelId);
+        size += serializedSize(inputChannelValue.accessHash);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+quint32 CTelegramStream::serializedSize(const TLInputContact &inputContactValue)
+{
+    quint32 size = 4;
+
+    switch (inputContactValue.tlType) {
+    case TLValue::InputPhoneContact:
+        size += serializedSize(inputContactValue.clientId);
+        size += serializedSize(inputContactValue.phone);
+        size += serializedSize(inputContactValue.firstName);
+        size += serializedSize(inputContactValue.lastName);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+quint32 CTelegramStream::serializedSize(const TLInputDocument &inputDocumentValue)
+{
+    quint32 size = 4;
+
+    switch (inputDocumentValue.tlType) {
+    case TLValue::InputDocumentEmpty:
+        break;
+    case TLValue::InputDocument:
+        size += serializedSize(inputDocumentValue.id);
+        size += serializedSize(inputDocumentValue.accessHash);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+quint32 CTelegramStream::serializedSize(const TLInputEncryptedChat &inputEncryptedChatValue)
+{
+    quint32 size = 4;
+
+    switch (inputEncryptedChatValue.tlType) {
+    case TLValue::InputEncryptedChat:
+        size += serializedSize(inputEncryptedChatValue.chatId);
+        size += serializedSize(inputEncryptedChatValue.accessHash);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+quint32 CTelegramStream::serializedSize(const TLInputEncryptedFile &inputEncryptedFileValue)
+{
+    quint32 size = 4;
+
+    switch (inputEncryptedFileValue.tlType) {
+    case TLValue::InputEncryptedFileEmpty:
+        break;
+    case TLValue::InputEncryptedFileUploaded:
+        size += serializedSize(inputEncryptedFileValue.id);
+        size += serializedSize(inputEncryptedFileValue.parts);
+        size += serializedSize(inputEncryptedFileValue.md5Checksum);
+        size += serializedSize(inputEncryptedFileValue.keyFingerprint);
+        break;
+    case TLValue::InputEncryptedFile:
+        size += serializedSize(inputEncryptedFileValue.id);
+        size += serializedSize(inputEncryptedFileValue.accessHash);
+        break;
+    case TLValue::InputEncryptedFileBigUploaded:
+        size += serializedSize(inputEncryptedFileValue.id);
+        size += serializedSize(inputEncryptedFileValue.parts);
+        size += serializedSize(inputEncryptedFileValue.keyFingerprint);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+quint32 CTelegramStream::serializedSize(const TLInputFile &inputFileValue)
+{
+    quint32 size = 4;
+
+    switch (inputFileValue.tlType) {
+    case TLValue::InputFile:
+        size += serializedSize(inputFileValue.id);
+        size += serializedSize(inputFileValue.parts);
+        size += serializedSize(inputFileValue.name);
+        size += serializedSize(inputFileValue.md5Checksum);
+        break;
+    case TLValue::InputFileBig:
+        size += serializedSize(inputFileValue.id);
+        size += serializedSize(inputFileValue.parts);
+        size += serializedSize(inputFileValue.name);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+quint32 CTelegramStream::serializedSize(const TLInputFileLocation &inputFileLocationValue)
+{
+    quint32 size = 4;
+
+    switch (inputFileLocationValue.tlType) {
+    case TLValue::InputFileLocation:
+        size += serializedSize(inputFileLocationValue.volumeId);
+        size += serializedSize(inputFileLocationValue.localId);
+        size += serializedSize(inputFileLocationValue.secret);
+        break;
+    case TLValue::InputVideoFileLocation:
+    case TLValue::InputEncryptedFileLocation:
+    case TLValue::InputAudioFileLocation:
+    case TLValue::InputDocumentFileLocation:
+        size += serializedSize(inputFileLocationValue.id);
+        size += serializedSize(inputFileLocationValue.accessHash);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+quint32 CTelegramStream::serializedSize(const TLInputGeoPoint &inputGeoPointValue)
+{
+    quint32 size = 4;
+
+    switch (inputGeoPointValue.tlType) {
+    case TLValue::InputGeoPointEmpty:
+        break;
+    case TLValue::InputGeoPoint:
+        size += serializedSize(inputGeoPointValue.latitude);
+        size += serializedSize(inputGeoPointValue.longitude);
+        break;
+    default:
+        break;
+    }
+
+    return size;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLInputVideo &inputVideoValue)
+quint32 CTelegramStream::serializedSize(const TLInputPeer &inputPeerValue)
 {
-    *this << inputVideoValue.tlType;
+    quint32 size = 4;
+
+    switch (inputPeerValue.tlType) {
+    case TLValue::InputPeerEmpty:
+    case TLValue::InputPeerSelf:
+        break;
+    case TLValue::InputPeerChat:
+        size += serializedSize(inputPeerValue.chatId);
+        break;
+    case TLValue::InputPeerUser:
+        size += serializedSize(inputPeerValue.userId);
+        size += serializedSize(inputPeerValue.accessHash);
+        break;
+    case TLValue::InputPeerChannel:
+        size += serializedSize(inputPeerValue.channelId);
+        size += serializedSize(inputPeerValue.accessHash);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+quint32 CTelegramStream::serializedSize(const TLInputPeerNotifySettings &inputPeerNotifySettingsValue)
+{
+    quint32 size = 4;
+
+    switch (inputPeerNotifySettingsValue.tlType) {
+    case TLValue::InputPeerNotifySettings:
+        size += serializedSize(inputPeerNotifySettingsValue.muteUntil);
+        size += serializedSize(inputPeerNotifySettingsValue.sound);
+        size += serializedSize(inputPeerNotifySettingsValue.showPreviews);
+        size += serializedSize(inputPeerNotifySettingsValue.eventsMask);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+quint32 CTelegramStream::serializedSize(const TLInputPhoto &inputPhotoValue)
+{
+    quint32 size = 4;
+
+    switch (inputPhotoValue.tlType) {
+    case TLValue::InputPhotoEmpty:
+        break;
+    case TLValue::InputPhoto:
+        size += serializedSize(inputPhotoValue.id);
+        size += serializedSize(inputPhotoValue.accessHash);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+quint32 CTelegramStream::serializedSize(const TLInputPhotoCrop &inputPhotoCropValue)
+{
+    quint32 size = 4;
+
+    switch (inputPhotoCropValue.tlType) {
+    case TLValue::InputPhotoCropAuto:
+        break;
+    case TLValue::InputPhotoCrop:
+        size += serializedSize(inputPhotoCropValue.cropLeft);
+        size += serializedSize(inputPhotoCropValue.cropTop);
+        size += serializedSize(inputPhotoCropValue.cropWidth);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+quint32 CTelegramStream::serializedSize(const TLInputPrivacyKey &inputPrivacyKeyValue)
+{
+    quint32 size = 4;
+
+    switch (inputPrivacyKeyValue.tlType) {
+    case TLValue::InputPrivacyKeyStatusTimestamp:
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+quint32 CTelegramStream::serializedSize(const TLInputStickerSet &inputStickerSetValue)
+{
+    quint32 size = 4;
+
+    switch (inputStickerSetValue.tlType) {
+    case TLValue::InputStickerSetEmpty:
+        break;
+    case TLValue::InputStickerSetID:
+        size += serializedSize(inputStickerSetValue.id);
+        size += serializedSize(inputStickerSetValue.accessHash);
+        break;
+    case TLValue::InputStickerSetShortName:
+        size += serializedSize(inputStickerSetValue.shortName);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+quint32 CTelegramStream::serializedSize(const TLInputUser &inputUserValue)
+{
+    quint32 size = 4;
+
+    switch (inputUserValue.tlType) {
+    case TLValue::InputUserEmpty:
+    case TLValue::InputUserSelf:
+        break;
+    case TLValue::InputUser:
+        size += serializedSize(inputUserValue.userId);
+        size += serializedSize(inputUserValue.accessHash);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+quint32 CTelegramStream::serializedSize(const TLInputVideo &inputVideoValue)
+{
+    quint32 size = 4;
 
     switch (inputVideoValue.tlType) {
     case TLValue::InputVideoEmpty:
         break;
     case TLValue::InputVideo:
-        *this << inputVideoValue.id;
-        *this << inputVideoValue.accessHash;
+        size += serializedSize(inputVideoValue.id);
+        size += serializedSize(inputVideoValue.accessHash);
         break;
     default:
         break;
     }
 
-    return *this;
+    return size;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLKeyboardButton &keyboardButtonValue)
+quint32 CTelegramStream::serializedSize(const TLKeyboardButton &keyboardButtonValue)
 {
-    *this << keyboardButtonValue.tlType;
+    quint32 size = 4;
 
     switch (keyboardButtonValue.tlType) {
     case TLValue::KeyboardButton:
-        *this << keyboardButtonValue.text;
+        size += serializedSize(keyboardButtonValue.text);
         break;
     default:
         break;
     }
 
-    return *this;
+    return size;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLKeyboardButtonRow &keyboardButtonRowValue)
+quint32 CTelegramStream::serializedSize(const TLKeyboardButtonRow &keyboardButtonRowValue)
 {
-    *this << keyboardButtonRowValue.tlType;
+    quint32 size = 4;
 
     switch (keyboardButtonRowValue.tlType) {
     case TLValue::KeyboardButtonRow:
-        *this << keyboardButtonRowValue.buttons;
+        size += serializedSize(keyboardButtonRowValue.buttons);
         break;
     default:
         break;
     }
 
-    return *this;
+    return size;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLMessageEntity &messageEntityValue)
+quint32 CTelegramStream::serializedSize(const TLMessageEntity &messageEntityValue)
 {
-    *this << messageEntityValue.tlType;
+    quint32 size = 4;
 
     switch (messageEntityValue.tlType) {
     case TLValue::MessageEntityUnknown:
@@ -4576,45 +9159,45 @@ CTelegramStream &CTelegramStream::operator<<(const TLMessageEntity &messageEntit
     case TLValue::MessageEntityBold:
     case TLValue::MessageEntityItalic:
     case TLValue::MessageEntityCode:
-        *this << messageEntityValue.offset;
-        *this << messageEntityValue.length;
+        size += serializedSize(messageEntityValue.offset);
+        size += serializedSize(messageEntityValue.length);
         break;
     case TLValue::MessageEntityPre:
-        *this << messageEntityValue.offset;
-        *this << messageEntityValue.length;
-        *this << messageEntityValue.language;
+        size += serializedSize(messageEntityValue.offset);
+        size += serializedSize(messageEntityValue.length);
+        size += serializedSize(messageEntityValue.language);
         break;
     case TLValue::MessageEntityTextUrl:
-        *this << messageEntityValue.offset;
-        *this << messageEntityValue.length;
-        *this << messageEntityValue.url;
+        size += serializedSize(messageEntityValue.offset);
+        size += serializedSize(messageEntityValue.length);
+        size += serializedSize(messageEntityValue.url);
         break;
     default:
         break;
     }
 
-    return *this;
+    return size;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLMessageRange &messageRangeValue)
+quint32 CTelegramStream::serializedSize(const TLMessageRange &messageRangeValue)
 {
-    *this << messageRangeValue.tlType;
+    quint32 size = 4;
 
     switch (messageRangeValue.tlType) {
     case TLValue::MessageRange:
-        *this << messageRangeValue.minId;
-        *this << messageRangeValue.maxId;
+        size += serializedSize(messageRangeValue.minId);
+        size += serializedSize(messageRangeValue.maxId);
         break;
     default:
         break;
     }
 
-    return *this;
+    return size;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLMessagesFilter &messagesFilterValue)
+quint32 CTelegramStream::serializedSize(const TLMessagesFilter &messagesFilterValue)
 {
-    *this << messagesFilterValue.tlType;
+    quint32 size = 4;
 
     switch (messagesFilterValue.tlType) {
     case TLValue::InputMessagesFilterEmpty:
@@ -4632,12 +9215,12 @@ CTelegramStream &CTelegramStream::operator<<(const TLMessagesFilter &messagesFil
         break;
     }
 
-    return *this;
+    return size;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLReportReason &reportReasonValue)
+quint32 CTelegramStream::serializedSize(const TLReportReason &reportReasonValue)
 {
-    *this << reportReasonValue.tlType;
+    quint32 size = 4;
 
     switch (reportReasonValue.tlType) {
     case TLValue::InputReportReasonSpam:
@@ -4645,18 +9228,18 @@ CTelegramStream &CTelegramStream::operator<<(const TLReportReason &reportReasonV
     case TLValue::InputReportReasonPornography:
         break;
     case TLValue::InputReportReasonOther:
-        *this << reportReasonValue.text;
+        size += serializedSize(reportReasonValue.text);
         break;
     default:
         break;
     }
 
-    return *this;
+    return size;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLSendMessageAction &sendMessageActionValue)
+quint32 CTelegramStream::serializedSize(const TLSendMessageAction &sendMessageActionValue)
 {
-    *this << sendMessageActionValue.tlType;
+    quint32 size = 4;
 
     switch (sendMessageActionValue.tlType) {
     case TLValue::SendMessageTypingAction:
@@ -4670,252 +9253,252 @@ CTelegramStream &CTelegramStream::operator<<(const TLSendMessageAction &sendMess
     case TLValue::SendMessageUploadAudioAction:
     case TLValue::SendMessageUploadPhotoAction:
     case TLValue::SendMessageUploadDocumentAction:
-        *this << sendMessageActionValue.progress;
+        size += serializedSize(sendMessageActionValue.progress);
         break;
     default:
         break;
     }
 
-    return *this;
+    return size;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLChannelMessagesFilter &channelMessagesFilterValue)
+quint32 CTelegramStream::serializedSize(const TLChannelMessagesFilter &channelMessagesFilterValue)
 {
-    *this << channelMessagesFilterValue.tlType;
+    quint32 size = 4;
 
     switch (channelMessagesFilterValue.tlType) {
     case TLValue::ChannelMessagesFilterEmpty:
     case TLValue::ChannelMessagesFilterCollapsed:
         break;
     case TLValue::ChannelMessagesFilter:
-        *this << channelMessagesFilterValue.flags;
-        *this << channelMessagesFilterValue.ranges;
+        size += serializedSize(channelMessagesFilterValue.flags);
+        size += serializedSize(channelMessagesFilterValue.ranges);
         break;
     default:
         break;
     }
 
-    return *this;
+    return size;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLDocumentAttribute &documentAttributeValue)
+quint32 CTelegramStream::serializedSize(const TLDocumentAttribute &documentAttributeValue)
 {
-    *this << documentAttributeValue.tlType;
+    quint32 size = 4;
 
     switch (documentAttributeValue.tlType) {
     case TLValue::DocumentAttributeImageSize:
-        *this << documentAttributeValue.w;
-        *this << documentAttributeValue.h;
+        size += serializedSize(documentAttributeValue.w);
+        size += serializedSize(documentAttributeValue.h);
         break;
     case TLValue::DocumentAttributeAnimated:
         break;
     case TLValue::DocumentAttributeSticker:
-        *this << documentAttributeValue.alt;
-        *this << documentAttributeValue.stickerset;
+        size += serializedSize(documentAttributeValue.alt);
+        size += serializedSize(documentAttributeValue.stickerset);
         break;
     case TLValue::DocumentAttributeVideo:
-        *this << documentAttributeValue.duration;
-        *this << documentAttributeValue.w;
-        *this << documentAttributeValue.h;
+        size += serializedSize(documentAttributeValue.duration);
+        size += serializedSize(documentAttributeValue.w);
+        size += serializedSize(documentAttributeValue.h);
         break;
     case TLValue::DocumentAttributeAudio:
-        *this << documentAttributeValue.duration;
-        *this << documentAttributeValue.title;
-        *this << documentAttributeValue.performer;
+        size += serializedSize(documentAttributeValue.duration);
+        size += serializedSize(documentAttributeValue.title);
+        size += serializedSize(documentAttributeValue.performer);
         break;
     case TLValue::DocumentAttributeFilename:
-        *this << documentAttributeValue.fileName;
+        size += serializedSize(documentAttributeValue.fileName);
         break;
     default:
         break;
     }
 
-    return *this;
+    return size;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLInputBotInlineMessage &inputBotInlineMessageValue)
+quint32 CTelegramStream::serializedSize(const TLInputBotInlineMessage &inputBotInlineMessageValue)
 {
-    *this << inputBotInlineMessageValue.tlType;
+    quint32 size = 4;
 
     switch (inputBotInlineMessageValue.tlType) {
     case TLValue::InputBotInlineMessageMediaAuto:
-        *this << inputBotInlineMessageValue.caption;
+        size += serializedSize(inputBotInlineMessageValue.caption);
         break;
     case TLValue::InputBotInlineMessageText:
-        *this << inputBotInlineMessageValue.flags;
-        *this << inputBotInlineMessageValue.message;
+        size += serializedSize(inputBotInlineMessageValue.flags);
+        size += serializedSize(inputBotInlineMessageValue.message);
         if (inputBotInlineMessageValue.flags & 1 << 1) {
-            *this << inputBotInlineMessageValue.entities;
+            size += serializedSize(inputBotInlineMessageValue.entities);
         }
         break;
     default:
         break;
     }
 
-    return *this;
+    return size;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLInputBotInlineResult &inputBotInlineResultValue)
+quint32 CTelegramStream::serializedSize(const TLInputBotInlineResult &inputBotInlineResultValue)
 {
-    *this << inputBotInlineResultValue.tlType;
+    quint32 size = 4;
 
     switch (inputBotInlineResultValue.tlType) {
     case TLValue::InputBotInlineResult:
-        *this << inputBotInlineResultValue.flags;
-        *this << inputBotInlineResultValue.id;
-        *this << inputBotInlineResultValue.type;
+        size += serializedSize(inputBotInlineResultValue.flags);
+        size += serializedSize(inputBotInlineResultValue.id);
+        size += serializedSize(inputBotInlineResultValue.type);
         if (inputBotInlineResultValue.flags & 1 << 1) {
-            *this << inputBotInlineResultValue.title;
+            size += serializedSize(inputBotInlineResultValue.title);
         }
         if (inputBotInlineResultValue.flags & 1 << 2) {
-            *this << inputBotInlineResultValue.description;
+            size += serializedSize(inputBotInlineResultValue.description);
         }
         if (inputBotInlineResultValue.flags & 1 << 3) {
-            *this << inputBotInlineResultValue.url;
+            size += serializedSize(inputBotInlineResultValue.url);
         }
         if (inputBotInlineResultValue.flags & 1 << 4) {
-            *this << inputBotInlineResultValue.thumbUrl;
+            size += serializedSize(inputBotInlineResultValue.thumbUrl);
         }
         if (inputBotInlineResultValue.flags & 1 << 5) {
-            *this << inputBotInlineResultValue.contentUrl;
+            size += serializedSize(inputBotInlineResultValue.contentUrl);
         }
         if (inputBotInlineResultValue.flags & 1 << 5) {
-            *this << inputBotInlineResultValue.contentType;
+            size += serializedSize(inputBotInlineResultValue.contentType);
         }
         if (inputBotInlineResultValue.flags & 1 << 6) {
-            *this << inputBotInlineResultValue.w;
+            size += serializedSize(inputBotInlineResultValue.w);
         }
         if (inputBotInlineResultValue.flags & 1 << 6) {
-            *this << inputBotInlineResultValue.h;
+            size += serializedSize(inputBotInlineResultValue.h);
         }
         if (inputBotInlineResultValue.flags & 1 << 7) {
-            *this << inputBotInlineResultValue.duration;
+            size += serializedSize(inputBotInlineResultValue.duration);
         }
-        *this << inputBotInlineResultValue.sendMessage;
+        size += serializedSize(inputBotInlineResultValue.sendMessage);
         break;
     default:
         break;
     }
 
-    return *this;
+    return size;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLInputChatPhoto &inputChatPhotoValue)
+quint32 CTelegramStream::serializedSize(const TLInputChatPhoto &inputChatPhotoValue)
 {
-    *this << inputChatPhotoValue.tlType;
+    quint32 size = 4;
 
     switch (inputChatPhotoValue.tlType) {
     case TLValue::InputChatPhotoEmpty:
         break;
     case TLValue::InputChatUploadedPhoto:
-        *this << inputChatPhotoValue.file;
-        *this << inputChatPhotoValue.crop;
+        size += serializedSize(inputChatPhotoValue.file);
+        size += serializedSize(inputChatPhotoValue.crop);
         break;
     case TLValue::InputChatPhoto:
-        *this << inputChatPhotoValue.id;
-        *this << inputChatPhotoValue.crop;
+        size += serializedSize(inputChatPhotoValue.id);
+        size += serializedSize(inputChatPhotoValue.crop);
         break;
     default:
         break;
     }
 
-    return *this;
+    return size;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLInputMedia &inputMediaValue)
+quint32 CTelegramStream::serializedSize(const TLInputMedia &inputMediaValue)
 {
-    *this << inputMediaValue.tlType;
+    quint32 size = 4;
 
     switch (inputMediaValue.tlType) {
     case TLValue::InputMediaEmpty:
         break;
     case TLValue::InputMediaUploadedPhoto:
-        *this << inputMediaValue.file;
-        *this << inputMediaValue.caption;
+        size += serializedSize(inputMediaValue.file);
+        size += serializedSize(inputMediaValue.caption);
         break;
     case TLValue::InputMediaPhoto:
-        *this << inputMediaValue.inputPhotoId;
-        *this << inputMediaValue.caption;
+        size += serializedSize(inputMediaValue.inputPhotoId);
+        size += serializedSize(inputMediaValue.caption);
         break;
     case TLValue::InputMediaGeoPoint:
-        *this << inputMediaValue.geoPoint;
+        size += serializedSize(inputMediaValue.geoPoint);
         break;
     case TLValue::InputMediaContact:
-        *this << inputMediaValue.phoneNumber;
-        *this << inputMediaValue.firstName;
-        *this << inputMediaValue.lastName;
+        size += serializedSize(inputMediaValue.phoneNumber);
+        size += serializedSize(inputMediaValue.firstName);
+        size += serializedSize(inputMediaValue.lastName);
         break;
     case TLValue::InputMediaUploadedVideo:
-        *this << inputMediaValue.file;
-        *this << inputMediaValue.duration;
-        *this << inputMediaValue.w;
-        *this << inputMediaValue.h;
-        *this << inputMediaValue.mimeType;
-        *this << inputMediaValue.caption;
+        size += serializedSize(inputMediaValue.file);
+        size += serializedSize(inputMediaValue.duration);
+        size += serializedSize(inputMediaValue.w);
+        size += serializedSize(inputMediaValue.h);
+        size += serializedSize(inputMediaValue.mimeType);
+        size += serializedSize(inputMediaValue.caption);
         break;
     case TLValue::InputMediaUploadedThumbVideo:
-        *this << inputMediaValue.file;
-        *this << inputMediaValue.thumb;
-        *this << inputMediaValue.duration;
-        *this << inputMediaValue.w;
-        *this << inputMediaValue.h;
-        *this << inputMediaValue.mimeType;
-        *this << inputMediaValue.caption;
+        size += serializedSize(inputMediaValue.file);
+        size += serializedSize(inputMediaValue.thumb);
+        size += serializedSize(inputMediaValue.duration);
+        size += serializedSize(inputMediaValue.w);
+        size += serializedSize(inputMediaValue.h);
+        size += serializedSize(inputMediaValue.mimeType);
+        size += serializedSize(inputMediaValue.caption);
         break;
     case TLValue::InputMediaVideo:
-        *this << inputMediaValue.inputVideoId;
-        *this << inputMediaValue.caption;
+        size += serializedSize(inputMediaValue.inputVideoId);
+        size += serializedSize(inputMediaValue.caption);
         break;
     case TLValue::InputMediaUploadedAudio:
-        *this << inputMediaValue.file;
-        *this << inputMediaValue.duration;
-        *this << inputMediaValue.mimeType;
+        size += serializedSize(inputMediaValue.file);
+        size += serializedSize(inputMediaValue.duration);
+        size += serializedSize(inputMediaValue.mimeType);
         break;
     case TLValue::InputMediaAudio:
-        *this << inputMediaValue.inputAudioId;
+        size += serializedSize(inputMediaValue.inputAudioId);
         break;
     case TLValue::InputMediaUploadedDocument:
-        *this << inputMediaValue.file;
-        *this << inputMediaValue.mimeType;
-        *this << inputMediaValue.attributes;
-        *this << inputMediaValue.caption;
+        size += serializedSize(inputMediaValue.file);
+        size += serializedSize(inputMediaValue.mimeType);
+        size += serializedSize(inputMediaValue.attributes);
+        size += serializedSize(inputMediaValue.caption);
         break;
     case TLValue::InputMediaUploadedThumbDocument:
-        *this << inputMediaValue.file;
-        *this << inputMediaValue.thumb;
-        *this << inputMediaValue.mimeType;
-        *this << inputMediaValue.attributes;
-        *this << inputMediaValue.caption;
+        size += serializedSize(inputMediaValue.file);
+        size += serializedSize(inputMediaValue.thumb);
+        size += serializedSize(inputMediaValue.mimeType);
+        size += serializedSize(inputMediaValue.attributes);
+        size += serializedSize(inputMediaValue.caption);
         break;
     case TLValue::InputMediaDocument:
-        *this << inputMediaValue.inputDocumentId;
-        *this << inputMediaValue.caption;
+        size += serializedSize(inputMediaValue.inputDocumentId);
+        size += serializedSize(inputMediaValue.caption);
         break;
     case TLValue::InputMediaVenue:
-        *this << inputMediaValue.geoPoint;
-        *this << inputMediaValue.title;
-        *this << inputMediaValue.address;
-        *this << inputMediaValue.provider;
-        *this << inputMediaValue.venueId;
+        size += serializedSize(inputMediaValue.geoPoint);
+        size += serializedSize(inputMediaValue.title);
+        size += serializedSize(inputMediaValue.address);
+        size += serializedSize(inputMediaValue.provider);
+        size += serializedSize(inputMediaValue.venueId);
         break;
     case TLValue::InputMediaGifExternal:
-        *this << inputMediaValue.url;
-        *this << inputMediaValue.q;
+        size += serializedSize(inputMediaValue.url);
+        size += serializedSize(inputMediaValue.q);
         break;
     default:
         break;
     }
 
-    return *this;
+    return size;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLInputNotifyPeer &inputNotifyPeerValue)
+quint32 CTelegramStream::serializedSize(const TLInputNotifyPeer &inputNotifyPeerValue)
 {
-    *this << inputNotifyPeerValue.tlType;
+    quint32 size = 4;
 
     switch (inputNotifyPeerValue.tlType) {
     case TLValue::InputNotifyPeer:
-        *this << inputNotifyPeerValue.peer;
+        size += serializedSize(inputNotifyPeerValue.peer);
         break;
     case TLValue::InputNotifyUsers:
     case TLValue::InputNotifyChats:
@@ -4925,12 +9508,12 @@ CTelegramStream &CTelegramStream::operator<<(const TLInputNotifyPeer &inputNotif
         break;
     }
 
-    return *this;
+    return size;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLInputPrivacyRule &inputPrivacyRuleValue)
+quint32 CTelegramStream::serializedSize(const TLInputPrivacyRule &inputPrivacyRuleValue)
 {
-    *this << inputPrivacyRuleValue.tlType;
+    quint32 size = 4;
 
     switch (inputPrivacyRuleValue.tlType) {
     case TLValue::InputPrivacyValueAllowContacts:
@@ -4940,33 +9523,33 @@ CTelegramStream &CTelegramStream::operator<<(const TLInputPrivacyRule &inputPriv
         break;
     case TLValue::InputPrivacyValueAllowUsers:
     case TLValue::InputPrivacyValueDisallowUsers:
-        *this << inputPrivacyRuleValue.users;
+        size += serializedSize(inputPrivacyRuleValue.users);
         break;
     default:
         break;
     }
 
-    return *this;
+    return size;
 }
 
-CTelegramStream &CTelegramStream::operator<<(const TLReplyMarkup &replyMarkupValue)
+quint32 CTelegramStream::serializedSize(const TLReplyMarkup &replyMarkupValue)
 {
-    *this << replyMarkupValue.tlType;
+    quint32 size = 4;
 
     switch (replyMarkupValue.tlType) {
     case TLValue::ReplyKeyboardHide:
     case TLValue::ReplyKeyboardForceReply:
-        *this << replyMarkupValue.flags;
+        size += serializedSize(replyMarkupValue.flags);
         break;
     case TLValue::ReplyKeyboardMarkup:
-        *this << replyMarkupValue.flags;
-        *this << replyMarkupValue.rows;
+        size += serializedSize(replyMarkupValue.flags);
+        size += serializedSize(replyMarkupValue.rows);
         break;
     default:
         break;
     }
 
-    return *this;
+    return size;
 }
 
-// End of generated write operators implementation
+// End of generated size functions implementation
@@ -22,6 +22,7 @@
 #include <QString>
 
 #include "CRawStream.hpp"
+#include "MessageProjection.hpp"
 #include "TLNumbers.hpp"
 #include "TLTypes.hpp"
 
@@ -57,6 +58,50 @@ public:
     template <int Size>
     CTelegramStream &operator>>(TLNumber<Size> &n);
 
+    // Skips the serialized value of the type without decoding it
+    template <typename T>
+    CTelegramStream &skip() { return skip(static_cast<const T *>(nullptr)); }
+    // Skips the value and returns its serialized data, to decode it on demand (see readBytesView())
+    template <typename T>
+    QByteArray readRawView();
+
+    CTelegramStream &skip(const bool *) { skipBytes(4); return *this; }
+    CTelegramStream &skip(const quint32 *) { skipBytes(4); return *this; }
+    CTelegramStream &skip(const quint64 *) { skipBytes(8); return *this; }
+    CTelegramStream &skip(const double *) { skipBytes(8); return *this; }
+    CTelegramStream &skip(const TLValue *) { skipBytes(4); return *this; }
+    CTelegramStream &skip(const QByteArray *);
+    CTelegramStream &skip(const QString *) { return skip(static_cast<const QByteArray *>(nullptr)); }
+    template <int Size>
+    CTelegramStream &skip(const TLNumber<Size> *) { skipBytes(Size / 8); return *this; }
+    template <typename T>
+    CTelegramStream &skip(const TLVector<T> *);
+
+    // The projection is used to read the messages instead of the full decoding, e.g.
+    // setMessageProjection(&CTelegramStream::readProjection<TLMessage::FieldId | TLMessage::FieldMessage>)
+    void setMessageProjection(MessageProjection projection) { m_messageProjection = projection; }
+    MessageProjection messageProjection() const { return m_messageProjection; }
+
+    // Generated projection functions
+    template <quint32 Fields>
+    CTelegramStream &readProjection(TLMessage &messageValue);
+    // End of generated projection functions
+
+    // The size of the serialized data, to reserve the output buffer at once
+    static quint32 serializedSize(bool) { return 4; }
+    static quint32 serializedSize(quint32) { return 4; }
+    static quint32 serializedSize(quint64) { return 8; }
+    static quint32 serializedSize(double) { return 8; }
+    static quint32 serializedSize(TLValue) { return 4; }
+    static quint32 serializedSize(const QByteArray &data);
+    static quint32 serializedSize(const QString &str);
+    template <int Size>
+    static quint32 serializedSize(const TLNumber<Size> &) { return Size / 8; }
+    template <typename T>
+    static quint32 serializedSize(const TLVector<T> &v);
+    template <typename T>
+    static quint32 serializedSize(const TLVector<T*> &v);
+
     // Generated read operators
     CTelegramStream &operator>>(TLAccountDaysTTL &accountDaysTTLValue);
     CTelegramStream &operator>>(TLAccountPassword &accountPasswordValue);
@@ -201,6 +246,150 @@ public:
     CTelegramStream &operator>>(TLUpdatesDifference &updatesDifferenceValue);
     // End of generated read operators
 
+    // Generated skip functions
+    CTelegramStream &skip(const TLAccountDaysTTL *);
+    CTelegramStream &skip(const TLAccountPassword *);
+    CTelegramStream &skip(const TLAccountPasswordInputSettings *);
+    CTelegramStream &skip(const TLAccountPasswordSettings *);
+    CTelegramStream &skip(const TLAccountSentChangePhoneCode *);
+    CTelegramStream &skip(const TLAudio *);
+    CTelegramStream &skip(const TLAuthCheckedPhone *);
+    CTelegramStream &skip(const TLAuthExportedAuthorization *);
+    CTelegramStream &skip(const TLAuthPasswordRecovery *);
+    CTelegramStream &skip(const TLAuthSentCode *);
+    CTelegramStream &skip(const TLAuthorization *);
+    CTelegramStream &skip(const TLBotCommand *);
+    CTelegramStream &skip(const TLBotInfo *);
+    CTelegramStream &skip(const TLChannelParticipant *);
+    CTelegramStream &skip(const TLChannelParticipantRole *);
+    CTelegramStream &skip(const TLChannelParticipantsFilter *);
+    CTelegramStream &skip(const TLChatParticipant *);
+    CTelegramStream &skip(const TLChatParticipants *);
+    CTelegramStream &skip(const TLContact *);
+    CTelegramStream &skip(const TLContactBlocked *);
+    CTelegramStream &skip(const TLContactLink *);
+    CTelegramStream &skip(const TLContactSuggested *);
+    CTelegramStream &skip(const TLDisabledFeature *);
+    CTelegramStream &skip(const TLEncryptedChat *);
+    CTelegramStream &skip(const TLEncryptedFile *);
+    CTelegramStream &skip(const TLEncryptedMessage *);
+    CTelegramStream &skip(const TLError *);
+    CTelegramStream &skip(const TLExportedChatInvite *);
+    CTelegramStream &skip(const TLFileLocation *);
+    CTelegramStream &skip(const TLGeoPoint *);
+    CTelegramStream &skip(const TLHelpAppChangelog *);
+    CTelegramStream &skip(const TLHelpAppUpdate *);
+    CTelegramStream &skip(const TLHelpInviteText *);
+    CTelegramStream &skip(const TLHelpTermsOfService *);
+    CTelegramStream &skip(const TLImportedContact *);
+    CTelegramStream &skip(const TLInputAppEvent *);
+    CTelegramStream &skip(const TLInputAudio *);
+    CTelegramStream &skip(const TLInputChannel *);
+    CTelegramStream &skip(const TLInputContact *);
+    CTelegramStream &skip(const TLInputDocument *);
+    CTelegramStream &skip(const TLInputEncryptedChat *);
+    CTelegramStream &skip(const TLInputEncryptedFile *);
+    CTelegramStream &skip(const TLInputFile *);
+    CTelegramStream &skip(const TLInputFileLocation *);
+    CTelegramStream &skip(const TLInputGeoPoint *);
+    CTelegramStream &skip(const TLInputPeer *);
+    CTelegramStream &skip(const TLInputPeerNotifyEvents *);
+    CTelegramStream &skip(const TLInputPeerNotifySettings *);
+    CTelegramStream &skip(const TLInputPhoto *);
+    CTelegramStream &skip(const TLInputPhotoCrop *);
+    CTelegramStream &skip(const TLInputPrivacyKey *);
+    CTelegramStream &skip(const TLInputStickerSet *);
+    CTelegramStream &skip(const TLInputUser *);
+    CTelegramStream &skip(const TLInputVideo *);
+    CTelegramStream &skip(const TLKeyboardButton *);
+    CTelegramStream &skip(const TLKeyboardButtonRow *);
+    CTelegramStream &skip(const TLMessageEntity *);
+    CTelegramStream &skip(const TLMessageGroup *);
+    CTelegramStream &skip(const TLMessageRange *);
+    CTelegramStream &skip(const TLMessagesAffectedHistory *);
+    CTelegramStream &skip(const TLMessagesAffectedMessages *);
+    CTelegramStream &skip(const TLMessagesDhConfig *);
+    CTelegramStream &skip(const TLMessagesFilter *);
+    CTelegramStream &skip(const TLMessagesSentEncryptedMessage *);
+    CTelegramStream &skip(const TLNearestDc *);
+    CTelegramStream &skip(const TLPeer *);
+    CTelegramStream &skip(const TLPeerNotifyEvents *);
+    CTelegramStream &skip(const TLPeerNotifySettings *);
+    CTelegramStream &skip(const TLPhotoSize *);
+    CTelegramStream &skip(const TLPrivacyKey *);
+    CTelegramStream &skip(const TLPrivacyRule *);
+    CTelegramStream &skip(const TLReceivedNotifyMessage *);
+    CTelegramStream &skip(const TLReportReason *);
+    CTelegramStream &skip(const TLSendMessageAction *);
+    CTelegramStream &skip(const TLStickerPack *);
+    CTelegramStream &skip(const TLStorageFileType *);
+    CTelegramStream &skip(const TLUpdatesState *);
+    CTelegramStream &skip(const TLUploadFile *);
+    CTelegramStream &skip(const TLUserProfilePhoto *);
+    CTelegramStream &skip(const TLUserStatus *);
+    CTelegramStream &skip(const TLVideo *);
+    CTelegramStream &skip(const TLWallPaper *);
+    CTelegramStream &skip(const TLAccountAuthorizations *);
+    CTelegramStream &skip(const TLBotInlineMessage *);
+    CTelegramStream &skip(const TLChannelMessagesFilter *);
+    CTelegramStream &skip(const TLChatPhoto *);
+    CTelegramStream &skip(const TLContactStatus *);
+    CTelegramStream &skip(const TLDcOption *);
+    CTelegramStream &skip(const TLDialog *);
+    CTelegramStream &skip(const TLDocumentAttribute *);
+    CTelegramStream &skip(const TLInputBotInlineMessage *);
+    CTelegramStream &skip(const TLInputBotInlineResult *);
+    CTelegramStream &skip(const TLInputChatPhoto *);
+    CTelegramStream &skip(const TLInputMedia *);
+    CTelegramStream &skip(const TLInputNotifyPeer *);
+    CTelegramStream &skip(const TLInputPrivacyRule *);
+    CTelegramStream &skip(const TLNotifyPeer *);
+    CTelegramStream &skip(const TLPhoto *);
+    CTelegramStream &skip(const TLReplyMarkup *);
+    CTelegramStream &skip(const TLStickerSet *);
+    CTelegramStream &skip(const TLUser *);
+    CTelegramStream &skip(const TLAccountPrivacyRules *);
+    CTelegramStream &skip(const TLAuthAuthorization *);
+    CTelegramStream &skip(const TLChannelsChannelParticipant *);
+    CTelegramStream &skip(const TLChannelsChannelParticipants *);
+    CTelegramStream &skip(const TLChat *);
+    CTelegramStream &skip(const TLChatFull *);
+    CTelegramStream &skip(const TLChatInvite *);
+    CTelegramStream &skip(const TLConfig *);
+    CTelegramStream &skip(const TLContactsBlocked *);
+    CTelegramStream &skip(const TLContactsContacts *);
+    CTelegramStream &skip(const TLContactsFound *);
+    CTelegramStream &skip(const TLContactsImportedContacts *);
+    CTelegramStream &skip(const TLContactsLink *);
+    CTelegramStream &skip(const TLContactsResolvedPeer *);
+    CTelegramStream &skip(const TLContactsSuggested *);
+    CTelegramStream &skip(const TLDocument *);
+    CTelegramStream &skip(const TLFoundGif *);
+    CTelegramStream &skip(const TLHelpSupport *);
+    CTelegramStream &skip(const TLMessageAction *);
+    CTelegramStream &skip(const TLMessagesAllStickers *);
+    CTelegramStream &skip(const TLMessagesChatFull *);
+    CTelegramStream &skip(const TLMessagesChats *);
+    CTelegramStream &skip(const TLMessagesFoundGifs *);
+    CTelegramStream &skip(const TLMessagesSavedGifs *);
+    CTelegramStream &skip(const TLMessagesStickerSet *);
+    CTelegramStream &skip(const TLMessagesStickers *);
+    CTelegramStream &skip(const TLPhotosPhoto *);
+    CTelegramStream &skip(const TLPhotosPhotos *);
+    CTelegramStream &skip(const TLUserFull *);
+    CTelegramStream &skip(const TLWebPage *);
+    CTelegramStream &skip(const TLBotInlineResult *);
+    CTelegramStream &skip(const TLMessageMedia *);
+    CTelegramStream &skip(const TLMessagesBotResults *);
+    CTelegramStream &skip(const TLMessage *);
+    CTelegramStream &skip(const TLMessagesDialogs *);
+    CTelegramStream &skip(const TLMessagesMessages *);
+    CTelegramStream &skip(const TLUpdate *);
+    CTelegramStream &skip(const TLUpdates *);
+    CTelegramStream &skip(const TLUpdatesChannelDifference *);
+    CTelegramStream &skip(const TLUpdatesDifference *);
+    // End of generated skip functions
+
     // Generated write operators
     CTelegramStream &operator<<(const TLAccountDaysTTL &accountDaysTTLValue);
     CTelegramStream &operator<<(const TLAccountPasswordInputSettings &accountPasswordInputSettingsValue);
@@ -241,6 +430,50 @@ public:
     CTelegramStream &operator<<(const TLInputPrivacyRule &inputPrivacyRuleValue);
     CTelegramStream &operator<<(const TLReplyMarkup &replyMarkupValue);
     // End of generated write operators
+
+    // Generated size functions
+    static quint32 serializedSize(const TLAccountDaysTTL &accountDaysTTLValue);
+    static quint32 serializedSize(const TLAccountPasswordInputSettings &accountPasswordInputSettingsValue);
+    static quint32 serializedSize(const TLChannelParticipantRole &channelParticipantRoleValue);
+    static quint32 serializedSize(const TLChannelParticipantsFilter &channelParticipantsFilterValue);
+    static quint32 serializedSize(const TLInputAppEvent &inputAppEventValue);
+    static quint32 serializedSize(const TLInputAudio &inputAudioValue);
+    static quint32 serializedSize(const TLInputChannel &inputChannelValue);
+    static quint32 serializedSize(const TLInputContact &inputContactValue);
+    static quint32 serializedSize(const TLInputDocument &inputDocumentValue);
+    static quint32 serializedSize(const TLInputEncryptedChat &inputEncryptedChatValue);
+    static quint32 serializedSize(const TLInputEncryptedFile &inputEncryptedFileValue);
+    static quint32 serializedSize(const TLInputFile &inputFileValue);
+    static quint32 serializedSize(const TLInputFileLocation &inputFileLocationValue);
+    static quint32 serializedSize(const TLInputGeoPoint &inputGeoPointValue);
+    static quint32 serializedSize(const TLInputPeer &inputPeerValue);
+    static quint32 serializedSize(const TLInputPeerNotifySettings &inputPeerNotifySettingsValue);
+    static quint32 serializedSize(const TLInputPhoto &inputPhotoValue);
+    static quint32 serializedSize(const TLInputPhotoCrop &inputPhotoCropValue);
+    static quint32 serializedSize(const TLInputPrivacyKey &inputPrivacyKeyValue);
+    static quint32 serializedSize(const TLInputStickerSet &inputStickerSetValue);
+    static quint32 serializedSize(const TLInputUser &inputUserValue);
+    static quint32 serializedSize(const TLInputVideo &inputVideoValue);
+    static quint32 serializedSize(const TLKeyboardButton &keyboardButtonValue);
+    static quint32 serializedSize(const TLKeyboardButtonRow &keyboardButtonRowValue);
+    static quint32 serializedSize(const TLMessageEntity &messageEntityValue);
+    static quint32 serializedSize(const TLMessageRange &messageRangeValue);
+    static quint32 serializedSize(const TLMessagesFilter &messagesFilterValue);
+    static quint32 serializedSize(const TLReportReason &reportReasonValue);
+    static quint32 serializedSize(const TLSendMessageAction &sendMessageActionValue);
+    static quint32 serializedSize(const TLChannelMessagesFilter &channelMessagesFilterValue);
+    static quint32 serializedSize(const TLDocumentAttribute &documentAttributeValue);
+    static quint32 serializedSize(const TLInputBotInlineMessage &inputBotInlineMessageValue);
+    static quint32 serializedSize(const TLInputBotInlineResult &inputBotInlineResultValue);
+    static quint32 serializedSize(const TLInputChatPhoto &inputChatPhotoValue);
+    static quint32 serializedSize(const TLInputMedia &inputMediaValue);
+    static quint32 serializedSize(const TLInputNotifyPeer &inputNotifyPeerValue);
+    static quint32 serializedSize(const TLInputPrivacyRule &inputPrivacyRuleValue);
+    static quint32 serializedSize(const TLReplyMarkup &replyMarkupValue);
+    // End of generated size functions
+
+protected:
+    MessageProjection m_messageProjection = nullptr;
 };
 
 inline CTelegramStream &CTelegramStream::operator>>(QString &str)
@@ -282,6 +515,203 @@ inline CTelegramStream &CTelegramStream::operator<<(const bool &data)
     return *this;
 }
 
+// Generated projection functions implementation
+template <quint32 Fields>
+inline CTelegramStream &CTelegramStream::readProjection(TLMessage &messageValue)
+{
+    TLMessage result;
+
+    *this >> result.tlType;
+
+    switch (result.tlType) {
+    case TLValue::MessageEmpty:
+        if (Fields & TLMessage::FieldId) {
+            *this >> result.id;
+        } else {
+            skip<quint32>();
+        }
+        break;
+    case TLValue::Message:
+        *this >> result.flags;
+        if (Fields & TLMessage::FieldId) {
+            *this >> result.id;
+        } else {
+            skip<quint32>();
+        }
+        if (result.flags & 1 << 8) {
+            if (Fields & TLMessage::FieldFromId) {
+                *this >> result.fromId;
+            } else {
+                skip<quint32>();
+            }
+        }
+        if (Fields & TLMessage::FieldToId) {
+            *this >> result.toId;
+        } else {
+            skip<TLPeer>();
+        }
+        if (result.flags & 1 << 2) {
+            if (Fields & TLMessage::FieldFwdFromId) {
+                *this >> result.fwdFromId;
+            } else {
+                skip<TLPeer>();
+            }
+        }
+        if (result.flags & 1 << 2) {
+            if (Fields & TLMessage::FieldFwdDate) {
+                *this >> result.fwdDate;
+            } else {
+                skip<quint32>();
+            }
+        }
+        if (result.flags & 1 << 11) {
+            if (Fields & TLMessage::FieldViaBotId) {
+                *this >> result.viaBotId;
+            } else {
+                skip<quint32>();
+            }
+        }
+        if (result.flags & 1 << 3) {
+            if (Fields & TLMessage::FieldReplyToMsgId) {
+                *this >> result.replyToMsgId;
+            } else {
+                skip<quint32>();
+            }
+        }
+        if (Fields & TLMessage::FieldDate) {
+            *this >> result.date;
+        } else {
+            skip<quint32>();
+        }
+        if (Fields & TLMessage::FieldMessage) {
+            *this >> result.message;
+        } else {
+            skip<QString>();
+        }
+        if (result.flags & 1 << 9) {
+            if (Fields & TLMessage::FieldMedia) {
+                *this >> result.media;
+            } else {
+                skip<TLMessageMedia>();
+            }
+        }
+        if (result.flags & 1 << 6) {
+            if (Fields & TLMessage::FieldReplyMarkup) {
+                *this >> result.replyMarkup;
+            } else {
+                skip<TLReplyMarkup>();
+            }
+        }
+        if (result.flags & 1 << 7) {
+            if (Fields & TLMessage::FieldEntities) {
+                *this >> result.entities;
+            } else {
+                skip<TLVector<TLMessageEntity>>();
+            }
+        }
+        if (result.flags & 1 << 10) {
+            if (Fields & TLMessage::FieldViews) {
+                *this >> result.views;
+            } else {
+                skip<quint32>();
+            }
+        }
+        break;
+    case TLValue::MessageService:
+        *this >> result.flags;
+        if (Fields & TLMessage::FieldId) {
+            *this >> result.id;
+        } else {
+            skip<quint32>();
+        }
+        if (result.flags & 1 << 8) {
+            if (Fields & TLMessage::FieldFromId) {
+                *this >> result.fromId;
+            } else {
+                skip<quint32>();
+            }
+        }
+        if (Fields & TLMessage::FieldToId) {
+            *this >> result.toId;
+        } else {
+            skip<TLPeer>();
+        }
+        if (Fields & TLMessage::FieldDate) {
+            *this >> result.date;
+        } else {
+            skip<quint32>();
+        }
+        if (Fields & TLMessage::FieldAction) {
+            *this >> result.action;
+        } else {
+            skip<TLMessageAction>();
+        }
+        break;
+    default:
+        setError();
+        break;
+    }
+
+    messageValue = std::move(result);
+
+    return *this;
+}
+
+// End of generated projection functions implementation
+
+template <typename T>
+inline QByteArray CTelegramStream::readRawView()
+{
+    const int start = position();
+    skip<T>();
+    const int size = position() - start;
+    seek(start);
+    return readBytesView(size);
+}
+
+template <typename T>
+inline CTelegramStream &CTelegramStream::skip(const TLVector<T> *)
+{
+    TLValue tlType;
+    *this >> tlType;
+
+    if (tlType == TLValue::Vector) {
+        quint32 length = 0;
+        *this >> length;
+        for (quint32 i = 0; (i < length) && !error(); ++i) {
+            skip<T>();
+        }
+    }
+
+    return *this;
+}
+
+template <typename T>
+inline quint32 CTelegramStream::serializedSize(const TLVector<T> &v)
+{
+    if (v.tlType != TLValue::Vector) {
+        return 4;
+    }
+    quint32 size = 8;
+    for (int i = 0; i < v.count(); ++i) {
+        size += serializedSize(v.at(i));
+    }
+    return size;
+}
+
+template <typename T>
+inline quint32 CTelegramStream::serializedSize(const TLVector<T*> &v)
+{
+    if (v.tlType != TLValue::Vector) {
+        return 4;
+    }
+    quint32 size = 8;
+    for (int i = 0; i < v.count(); ++i) {
+        size += serializedSize(*v.at(i));
+    }
+    return size;
+}
+
 inline CTelegramStream &CTelegramStream::operator>>(TLValue &v)
 {
     quint32 i;
@@ -30,14 +30,16 @@ CTelegramStream &CTelegramStream::operator>>(TLVector<T> &v)
     if (result.tlType == TLValue::Vector) {
         quint32 length = 0;
         *this >> length;
+        // Each item takes at least four bytes
+        result.reserve(qMin<quint32>(length, bytesAvailable() / 4));
         for (quint32 i = 0; i < length; ++i) {
             T value;
             *this >> value;
-            result.append(value);
+            result.append(std::move(value));
         }
     }
 
-    v = result;
+    v = std::move(result);
     return *this;
 }
 
@@ -51,6 +53,7 @@ CTelegramStream &CTelegramStream::operator>>(TLVector<T*> &v)
     if (result.tlType == TLValue::Vector) {
         quint32 length = 0;
         *this >> length;
+        result.reserve(qMin<quint32>(length, bytesAvailable() / 4));
         for (quint32 i = 0; i < length; ++i) {
             T *value = new T;
             *this >> *value;
@@ -16,9 +16,30 @@
 
 #include "CTelegramTransport.hpp"
 
+#include <QTimer>
+
+#include <QDebug>
+
+static const quint32 s_defaultConnectionTimeout = 15 * 1000; // 15 sec
+
 CTelegramTransport::CTelegramTransport(QObject *parent) :
-    QObject(parent)
+    QObject(parent),
+    m_connectionTimeout(s_defaultConnectionTimeout)
+{
+}
+
+void CTelegramTransport::setConnectionTimeout(quint32 ms)
+{
+    m_connectionTimeout = ms;
+}
+
+void CTelegramTransport::connectToHosts(const QVector<Telegram::DcOption> &addresses)
 {
+    if (addresses.isEmpty()) {
+        qWarning() << Q_FUNC_INFO << "The address list is empty";
+        return;
+    }
+    connectToHost(addresses.first().address, addresses.first().port);
 }
 
 quint64 CTelegramTransport::getNewMessageId(quint64 supposedId)
@@ -40,11 +61,49 @@ quint64 CTelegramTransport::getNewMessageId(quint64 supposedId)
     return m_lastMessageId;
 }
 
+void CTelegramTransport::setCorked(bool corked)
+{
+    if (m_corked == corked) {
+        return;
+    }
+    m_corked = corked;
+    if (!m_corked) {
+        flush();
+    }
+}
+
+quint64 CTelegramTransport::savedWriteCallsCount() const
+{
+    if (m_sentPackagesCount <= m_writeCallsCount) {
+        return 0;
+    }
+    return m_sentPackagesCount - m_writeCallsCount;
+}
+
 void CTelegramTransport::sendPackage(const QByteArray &package)
 {
     writeEvent();
     sendPackageImplementation(package);
+    ++m_sentPackagesCount;
     emit packageSent(package);
+
+    if (!m_corked) {
+        flush();
+    } else if (!m_flushScheduled) {
+        m_flushScheduled = true;
+        QTimer::singleShot(0, this, &CTelegramTransport::flush);
+    }
+}
+
+void CTelegramTransport::flush()
+{
+    m_flushScheduled = false;
+    flushImplementation();
+}
+
+void CTelegramTransport::setRemoteAddress(const Telegram::DcOption &address)
+{
+    m_remoteAddress = address;
 }
 
 void CTelegramTransport::setError(QAbstractSocket::SocketError e)
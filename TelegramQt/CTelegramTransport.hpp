@@ -22,6 +22,9 @@
 
 #include <QByteArray>
 #include <QAbstractSocket>
+#include <QVector>
+
+#include "TelegramNamespace.hpp"
 
 class CTelegramTransport : public QObject
 {
@@ -30,28 +33,58 @@ public:
     explicit CTelegramTransport(QObject *parent = nullptr);
     virtual void connectToHost(const QString &ipAddress, quint32 port) = 0;
     virtual void disconnectFromHost() = 0;
+
+    // Connect to the first reachable address of the given ones.
+    // The default implementation connects to the first address.
+    virtual void connectToHosts(const QVector<Telegram::DcOption> &addresses);
+
+    // The time given to establish a connection
+    quint32 connectionTimeout() const { return m_connectionTimeout; }
+    void setConnectionTimeout(quint32 ms);
+
+    // The address of the current (or the last) connection
+    Telegram::DcOption remoteAddress() const { return m_remoteAddress; }
     quint64 getNewMessageId(quint64 supposedId);
 
     QAbstractSocket::SocketError error() const { return m_error; }
     QAbstractSocket::SocketState state() const { return m_state; }
+
+    // In the corked mode the sent packages are gathered and written together
+    // at the end of the current event loop iteration.
+    bool isCorked() const { return m_corked; }
+    void setCorked(bool corked);
+
+    // The size of the sent data which is not written to the network yet
+    virtual qint64 bytesToWrite() const { return 0; }
+
+    quint64 sentPackagesCount() const { return m_sentPackagesCount; }
+    quint64 writeCallsCount() const { return m_writeCallsCount; }
+    quint64 savedWriteCallsCount() const;
+
 signals:
     void error(QAbstractSocket::SocketError error);
     void stateChanged(QAbstractSocket::SocketState state);
 
     void timeout();
 
+    // The package data can refer to the transport internal buffer and it is valid only during the signal emission.
     void packageReceived(const QByteArray &package);
     void packageSent(const QByteArray &package);
+    void bytesWritten(qint64 bytes);
 
 public slots:
     void sendPackage(const QByteArray &package);
+    void flush();
 
 protected slots:
     void setError(QAbstractSocket::SocketError error);
     virtual void setState(QAbstractSocket::SocketState state);
 
 protected:
+    void setRemoteAddress(const Telegram::DcOption &address);
+
     virtual void sendPackageImplementation(const QByteArray &package) = 0;
+    virtual void flushImplementation() {}
     virtual void readEvent() {}
     virtual void writeEvent() {}
 
@@ -59,6 +92,14 @@ private:
     QAbstractSocket::SocketError m_error;
     QAbstractSocket::SocketState m_state;
     quint64 m_lastMessageId = 0;
+    Telegram::DcOption m_remoteAddress;
+    quint32 m_connectionTimeout;
+    bool m_corked = false;
+    bool m_flushScheduled = false;
+
+protected:
+    quint64 m_sentPackagesCount = 0;
+    quint64 m_writeCallsCount = 0;
 
 };
 
@@ -56,10 +56,21 @@ void CTelegramTransportModule::setPingInterval(quint32 ms, quint32 serverDisconn
     m_pingServerAdditionDisconnectionTime = serverDisconnectionAdditionalTime;
 }
 
+void CTelegramTransportModule::setSessionType(CTcpTransport::SessionType sessionType)
+{
+    m_sessionType = sessionType;
+}
+
 void CTelegramTransportModule::onNewConnection(CTelegramConnection *connection)
 {
+    if (connection->transport()) {
+        // The transport is provided by the dispatcher transport factory
+        return;
+    }
     Client::TcpTransport *transport = new Client::TcpTransport(connection);
     transport->setProxy(m_proxy);
+    transport->setCorked(true);
+    transport->setPreferredSessionType(m_sessionType);
     connection->setTransport(transport);
 }
 
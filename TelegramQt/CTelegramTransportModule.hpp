@@ -19,6 +19,7 @@
 #define CTELEGRAMTRANSPORTMODULE_HPP
 
 #include "CTelegramModule.hpp"
+#include "CTcpTransport.hpp"
 
 #include <QNetworkProxy>
 
@@ -34,6 +35,9 @@ public:
     static quint32 defaultPingInterval();
     void setPingInterval(quint32 ms, quint32 serverDisconnectionAdditionalTime);
 
+    CTcpTransport::SessionType sessionType() const { return m_sessionType; }
+    void setSessionType(CTcpTransport::SessionType sessionType);
+
     void onNewConnection(CTelegramConnection *connection) override;
 
 protected:
@@ -43,6 +47,7 @@ protected:
 
     quint32 m_pingInterval;
     quint32 m_pingServerAdditionDisconnectionTime;
+    CTcpTransport::SessionType m_sessionType = CTcpTransport::Abridged;
 
 };
 
@@ -0,0 +1,172 @@
+/*
+   Copyright (C) 2026 agent <agent@local>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+
+#include "CTransportCapture.hpp"
+
+#include "CPackageDecoder.hpp"
+#include "CTelegramConnection.hpp"
+#include "CTelegramTransport.hpp"
+#include "RandomGenerator.hpp"
+
+#include <QDateTime>
+#include <QIODevice>
+#include <QtEndian>
+
+#include <QDebug>
+
+static const char s_captureMagic[4] = { 'T', 'Q', 'C', 'P' };
+static const quint32 s_captureFormatVersion = 1;
+static const int s_recordHeaderSize = 1 + 8 + 4;
+static const quint32 s_maxRecordSize = 64 * 1024 * 1024;
+
+CTransportCapture::CTransportCapture(QIODevice *device, QObject *parent) :
+    QObject(parent),
+    m_device(device),
+    m_recordsCount(0),
+    m_payloadCaptureEnabled(false),
+    m_headerWritten(false)
+{
+}
+
+void CTransportCapture::attachTransport(CTelegramTransport *transport)
+{
+    connect(transport, &CTelegramTransport::packageReceived, this, &CTransportCapture::onPackageReceived);
+    connect(transport, &CTelegramTransport::packageSent, this, &CTransportCapture::onPackageSent);
+}
+
+void CTransportCapture::addRecord(RecordType type, const QByteArray &data)
+{
+    if (!m_device || !m_device->isWritable()) {
+        return;
+    }
+    if (!m_headerWritten) {
+        writeHeader();
+    }
+
+    // The device buffers the data; there is no flush per record
+    uchar header[s_recordHeaderSize];
+    header[0] = static_cast<uchar>(type);
+    qToLittleEndian<qint64>(QDateTime::currentMSecsSinceEpoch(), header + 1);
+    qToLittleEndian<quint32>(data.size(), header + 9);
+    m_device->write(reinterpret_cast<const char *>(header), sizeof(header));
+    m_device->write(data.constData(), data.size());
+    ++m_recordsCount;
+}
+
+bool CTransportCapture::readRecords(QIODevice *device, QVector<Record> *records)
+{
+    char magic[sizeof(s_captureMagic)];
+    uchar version[4];
+    if ((device->read(magic, sizeof(magic)) != sizeof(magic)) || memcmp(magic, s_captureMagic, sizeof(magic))) {
+        qWarning() << Q_FUNC_INFO << "Invalid capture magic";
+        return false;
+    }
+    if (device->read(reinterpret_cast<char *>(version), sizeof(version)) != sizeof(version)) {
+        return false;
+    }
+    if (qFromLittleEndian<quint32>(version) > s_captureFormatVersion) {
+        qWarning() << Q_FUNC_INFO << "Unknown capture format version" << qFromLittleEndian<quint32>(version);
+        return false;
+    }
+
+    uchar header[s_recordHeaderSize];
+    while (device->read(reinterpret_cast<char *>(header), sizeof(header)) == sizeof(header)) {
+        Record record;
+        record.type = static_cast<RecordType>(header[0]);
+        record.time = qFromLittleEndian<qint64>(header + 1);
+        const quint32 size = qFromLittleEndian<quint32>(header + 9);
+        if (size > s_maxRecordSize) {
+            qWarning() << Q_FUNC_INFO << "Invalid record size" << size;
+            return false;
+        }
+        record.data = device->read(size);
+        if (quint32(record.data.size()) != size) {
+            qWarning() << Q_FUNC_INFO << "Unexpected end of the capture";
+            return false;
+        }
+        records->append(record);
+    }
+    return true;
+}
+
+int CTransportCapture::replayPackages(const QVector<Record> &records, CTelegramConnection *connection)
+{
+    Telegram::DeterministicGenerator generator;
+    Telegram::RandomGeneratorSetter generatorSetter(&generator);
+
+    CPackageDecoder decoder;
+    decoder.setAuthKey(connection->authKey());
+
+    bool sessionKnown = false;
+    int count = 0;
+    for (const Record &record : records) {
+        if (record.type != IncomingPackage) {
+            continue;
+        }
+        if ((record.data.size() < 8) || !qFromLittleEndian<quint64>(reinterpret_cast<const uchar *>(record.data.constData()))) {
+            // The plain messages of the auth key generation
+            continue;
+        }
+        if (!sessionKnown) {
+            CPackageDecoder::Message message;
+            if (!decoder.decode(record.data, &message)) {
+                qWarning() << Q_FUNC_INFO << "Unable to decode the package; the auth key is wrong or missing";
+                return 0;
+            }
+            connection->prepareReplay(message.sessionId);
+            sessionKnown = true;
+        }
+        connection->replayPackage(record.data);
+        ++count;
+    }
+    return count;
+}
+
+int CTransportCapture::replayPayloads(const QVector<Record> &records, CTelegramConnection *connection)
+{
+    Telegram::DeterministicGenerator generator;
+    Telegram::RandomGeneratorSetter generatorSetter(&generator);
+
+    int count = 0;
+    for (const Record &record : records) {
+        if (record.type != IncomingPayload) {
+            continue;
+        }
+        connection->replayPayload(record.data);
+        ++count;
+    }
+    return count;
+}
+
+void CTransportCapture::onPackageReceived(const QByteArray &package)
+{
+    addRecord(IncomingPackage, package);
+}
+
+void CTransportCapture::onPackageSent(const QByteArray &package)
+{
+    addRecord(OutgoingPackage, package);
+}
+
+void CTransportCapture::writeHeader()
+{
+    uchar version[4];
+    qToLittleEndian<quint32>(s_captureFormatVersion, version);
+    m_device->write(s_captureMagic, sizeof(s_captureMagic));
+    m_device->write(reinterpret_cast<const char *>(version), sizeof(version));
+    m_headerWritten = true;
+}
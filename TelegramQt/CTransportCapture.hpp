@@ -0,0 +1,86 @@
+/*
+   Copyright (C) 2026 agent <agent@local>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+
+#ifndef CTRANSPORTCAPTURE_HPP
+#define CTRANSPORTCAPTURE_HPP
+
+#include <QObject>
+#include <QByteArray>
+#include <QVector>
+
+QT_FORWARD_DECLARE_CLASS(QIODevice)
+
+class CTelegramConnection;
+class CTelegramTransport;
+
+// Binary capture of the transport traffic, suitable for an offline replay.
+// The capture starts with the magic and the format version, followed by the records:
+// quint8 type, qint64 time (ms since epoch), quint32 size and the data (little endian).
+class CTransportCapture : public QObject
+{
+    Q_OBJECT
+public:
+    enum RecordType {
+        InvalidRecord,
+        IncomingPackage,
+        OutgoingPackage,
+        IncomingPayload, // Decrypted message data
+        OutgoingPayload,
+    };
+
+    struct Record {
+        Record() : type(InvalidRecord), time(0) { }
+
+        RecordType type;
+        qint64 time;
+        QByteArray data;
+    };
+
+    explicit CTransportCapture(QIODevice *device, QObject *parent = nullptr);
+
+    void attachTransport(CTelegramTransport *transport);
+
+    // The decrypted messages contain the private data, so they are recorded only on demand
+    bool isPayloadCaptureEnabled() const { return m_payloadCaptureEnabled; }
+    void setPayloadCaptureEnabled(bool enabled) { m_payloadCaptureEnabled = enabled; }
+
+    quint64 recordsCount() const { return m_recordsCount; }
+
+    void addRecord(RecordType type, const QByteArray &data);
+
+    static bool readRecords(QIODevice *device, QVector<Record> *records);
+
+    // The replay installs DeterministicGenerator and feeds the incoming records to the connection.
+    // The packages need the capture auth key to be set on the connection; the payloads need no key.
+    static int replayPackages(const QVector<Record> &records, CTelegramConnection *connection);
+    static int replayPayloads(const QVector<Record> &records, CTelegramConnection *connection);
+
+protected slots:
+    void onPackageReceived(const QByteArray &package);
+    void onPackageSent(const QByteArray &package);
+
+protected:
+    void writeHeader();
+
+    QIODevice *m_device;
+    quint64 m_recordsCount;
+    bool m_payloadCaptureEnabled;
+    bool m_headerWritten;
+
+};
+
+#endif // CTRANSPORTCAPTURE_HPP
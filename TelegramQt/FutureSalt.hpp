@@ -0,0 +1,29 @@
+/*
+   Copyright (C) 2026 agent <agent@local>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+
+#ifndef FUTURESALT_HPP
+#define FUTURESALT_HPP
+
+#include <QtGlobal>
+
+struct SFutureSalt {
+    quint32 validSince;
+    quint32 validUntil;
+    quint64 salt;
+};
+
+#endif // FUTURESALT_HPP
@@ -0,0 +1,34 @@
+/*
+   Copyright (C) 2026 agent <agent@local>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+
+#ifndef MESSAGEPROJECTION_HPP
+#define MESSAGEPROJECTION_HPP
+
+#include <QtGlobal>
+
+// MSVC must know the inheritance model to lay out a pointer to a member of an incomplete class
+#ifdef Q_CC_MSVC
+class __single_inheritance CTelegramStream;
+#else
+class CTelegramStream;
+#endif
+struct TLMessage;
+
+// Reads only the fields of the mask and skips the rest, see CTelegramStream::setMessageProjection()
+typedef CTelegramStream &(CTelegramStream::*MessageProjection)(TLMessage &);
+
+#endif // MESSAGEPROJECTION_HPP
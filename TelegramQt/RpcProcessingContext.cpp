@@ -22,7 +22,8 @@ RpcProcessingContext::RpcProcessingContext(CTelegramStream &stream, quint64 requ
     m_storedStream(requestData),
     m_id(requestId),
     m_requestData(requestData),
-    m_succeed(false)
+    m_succeed(false),
+    m_decodedObject(nullptr)
 {
     if (hasRequestData()) {
         m_storedStream >> m_requestMethodId;
@@ -18,6 +18,7 @@
 #ifndef RPC_PROCESSING_CONTEXT_HPP
 #define RPC_PROCESSING_CONTEXT_HPP
 
+#include "CPackageDecoder.hpp"
 #include "CTelegramStream.hpp"
 
 class RpcProcessingContext
@@ -40,6 +41,9 @@ public:
     TLValue readCode() const { return m_code; }
     void setReadCode(const TLValue code);
 
+    // The result decoded in the decoding thread, if any, is taken instead of the read
+    void setDecodedObject(CPackageDecoder::DecodedObject *object) { m_decodedObject = object; }
+
     template <typename T>
     bool readRpcResult(T *result);
 
@@ -54,11 +58,18 @@ protected:
     bool m_succeed;
     TLValue m_code;
     TLValue m_requestMethodId;
+    CPackageDecoder::DecodedObject *m_decodedObject;
 };
 
 template<typename T>
 inline bool RpcProcessingContext::readRpcResult(T *result)
 {
+    if (m_decodedObject && m_decodedObject->take(result)) {
+        m_code = result->tlType;
+        m_succeed = result->isValid();
+        return m_succeed;
+    }
+
     inputStream() >> *result;
     m_code = result->tlType;
     m_succeed = result->isValid() && !inputStream().error();
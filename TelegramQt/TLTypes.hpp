@@ -23,6 +23,8 @@
 #include <QMetaType>
 #include <QVector>
 
+#include <utility>
+
 template <typename T>
 class TLVector : public QVector<T>
 {
@@ -31,6 +33,7 @@ public:
     explicit TLVector(int size) : QVector<T>(size), tlType(TLValue::Vector) { }
     TLVector(int size, const T &t) : QVector<T>(size, t), tlType(TLValue::Vector) { }
     TLVector(const TLVector<T> &v) : QVector<T>(v), tlType(v.tlType) { }
+    TLVector(TLVector<T> &&v) : QVector<T>(std::move(v)), tlType(v.tlType) { }
     TLVector(const QVector<T> &v) : QVector<T>(v), tlType(TLValue::Vector) { }
     TLVector(std::initializer_list<T> args) : QVector<T>(args), tlType(TLValue::Vector) { }
 
@@ -62,6 +65,12 @@ public:
         return *this;
     }
 
+    TLVector &operator=(TLVector &&v) {
+        tlType = v.tlType;
+        QVector<T>::operator =(std::move(v));
+        return *this;
+    }
+
     TLValue tlType;
 };
 
@@ -3240,6 +3249,23 @@ struct TLMessage {
         Views = 1 << 10,
         ViaBotId = 1 << 11,
     };
+    enum Fields {
+        FieldId = 1 << 0,
+        FieldFromId = 1 << 1,
+        FieldToId = 1 << 2,
+        FieldFwdFromId = 1 << 3,
+        FieldFwdDate = 1 << 4,
+        FieldViaBotId = 1 << 5,
+        FieldReplyToMsgId = 1 << 6,
+        FieldDate = 1 << 7,
+        FieldMessage = 1 << 8,
+        FieldMedia = 1 << 9,
+        FieldReplyMarkup = 1 << 10,
+        FieldEntities = 1 << 11,
+        FieldViews = 1 << 12,
+        FieldAction = 1 << 13,
+        FieldAll = (1 << 14) - 1,
+    };
     bool unread() const { return flags & Unread; }
     bool out() const { return flags & Out; }
     bool mentioned() const { return flags & Mentioned; }
@@ -43,6 +43,11 @@ SOURCES = CTelegramCore.cpp \
     CTelegramTransport.cpp \
     CTcpTransport.cpp \
     CClientTcpTransport.cpp \
+    CLoopbackTransport.cpp \
+    CPackageDecoder.cpp \
+    CMessageIdWindow.cpp \
+    CRequestTracker.cpp \
+    CTransportCapture.cpp \
     TelegramNamespace.cpp \
     CTelegramConnection.cpp \
     RandomGenerator.cpp \
@@ -73,10 +78,17 @@ HEADERS = CTelegramCore.hpp \
     CRawStream.hpp \
     Utils.hpp \
     FileRequestDescriptor.hpp \
+    FutureSalt.hpp \
+    MessageProjection.hpp \
     TelegramUtils.hpp \
     CTelegramTransport.hpp \
     CTcpTransport.hpp \
     CClientTcpTransport.hpp \
+    CLoopbackTransport.hpp \
+    CPackageDecoder.hpp \
+    CMessageIdWindow.hpp \
+    CRequestTracker.hpp \
+    CTransportCapture.hpp \
     TLTypes.hpp \
     TLNumbers.hpp \
     crypto-aes.hpp \
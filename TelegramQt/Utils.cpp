@@ -19,8 +19,10 @@
 
 #include <openssl/aes.h>
 #include <openssl/bn.h>
+#include <openssl/evp.h>
 #include <openssl/pem.h>
 #include <openssl/rsa.h>
+#include <openssl/sha.h>
 #include <openssl/opensslv.h>
 
 #include <zlib.h>
@@ -29,6 +31,7 @@
 #include <QCryptographicHash>
 #include <QDebug>
 #include <QFileInfo>
+#include <QtEndian>
 
 #include "CRawStream.hpp"
 #include "RandomGenerator.hpp"
@@ -348,83 +351,330 @@ QByteArray Utils::binaryNumberModExp(const QByteArray &data, const QByteArray &m
     return resultNum.toByteArray();
 }
 
-QByteArray Utils::aesDecrypt(const QByteArray &data, const SAesKey &key)
+// The EVP contexts are reused to avoid an allocation per call, and the key schedule is kept while
+// the key is the same. EVP selects the AES-NI implementation of the block cipher when it is available.
+struct AesContext
+{
+    AesContext() : context(EVP_CIPHER_CTX_new()) { }
+    ~AesContext() { EVP_CIPHER_CTX_free(context); }
+
+    EVP_CIPHER_CTX *context;
+    uchar key[SAesKeyData::KeySize];
+    bool hasKey = false;
+};
+
+static EVP_CIPHER_CTX *aesContext(const uchar *key, bool encrypt)
+{
+    static thread_local AesContext contexts[2];
+    AesContext &holder = contexts[encrypt ? 1 : 0];
+    if (holder.hasKey && !memcmp(holder.key, key, SAesKeyData::KeySize)) {
+        return holder.context;
+    }
+
+    holder.hasKey = false;
+    const int initResult = encrypt ? EVP_EncryptInit_ex(holder.context, EVP_aes_256_ecb(), nullptr, key, nullptr)
+                                   : EVP_DecryptInit_ex(holder.context, EVP_aes_256_ecb(), nullptr, key, nullptr);
+    if (!initResult) {
+        return nullptr;
+    }
+    EVP_CIPHER_CTX_set_padding(holder.context, 0);
+    memcpy(holder.key, key, SAesKeyData::KeySize);
+    holder.hasKey = true;
+    return holder.context;
+}
+
+static inline void xorBlock(uchar *result, const uchar *a, const uchar *b)
+{
+    for (int i = 0; i < AES_BLOCK_SIZE; ++i) {
+        result[i] = a[i] ^ b[i];
+    }
+}
+
+// IGE mode: c[i] = E(p[i] ^ c[i-1]) ^ p[i-1]; the IV is c[-1] followed by p[-1]
+static bool aesIgeInPlace(uchar *data, int size, const uchar *key, const uchar *iv, bool encrypt)
 {
-    if (data.length() % AES_BLOCK_SIZE) {
+    if (size % AES_BLOCK_SIZE) {
         qCritical() << Q_FUNC_INFO << "Data is not padded (size %" << AES_BLOCK_SIZE << "!= 0)";
+        return false;
+    }
+
+    // The ECB context keeps no state between the blocks, so it is reused as is for the same key
+    EVP_CIPHER_CTX *context = aesContext(key, encrypt);
+    if (!context) {
+        qCritical() << Q_FUNC_INFO << "Unable to initialize the cipher";
+        return false;
+    }
+
+    uchar previousCipherBlock[AES_BLOCK_SIZE];
+    uchar previousPlainBlock[AES_BLOCK_SIZE];
+    uchar inputBlock[AES_BLOCK_SIZE];
+    uchar block[AES_BLOCK_SIZE];
+    int blockSize = 0;
+    memcpy(previousCipherBlock, iv, AES_BLOCK_SIZE);
+    memcpy(previousPlainBlock, iv + AES_BLOCK_SIZE, AES_BLOCK_SIZE);
+
+    for (uchar *output = data; output < data + size; output += AES_BLOCK_SIZE) {
+        memcpy(inputBlock, output, AES_BLOCK_SIZE);
+        if (encrypt) {
+            xorBlock(block, inputBlock, previousCipherBlock);
+            if (!EVP_EncryptUpdate(context, block, &blockSize, block, AES_BLOCK_SIZE)) {
+                return false;
+            }
+            xorBlock(output, block, previousPlainBlock);
+            memcpy(previousCipherBlock, output, AES_BLOCK_SIZE);
+            memcpy(previousPlainBlock, inputBlock, AES_BLOCK_SIZE);
+        } else {
+            xorBlock(block, inputBlock, previousPlainBlock);
+            if (!EVP_DecryptUpdate(context, block, &blockSize, block, AES_BLOCK_SIZE)) {
+                return false;
+            }
+            xorBlock(output, block, previousCipherBlock);
+            memcpy(previousCipherBlock, inputBlock, AES_BLOCK_SIZE);
+            memcpy(previousPlainBlock, output, AES_BLOCK_SIZE);
+        }
+    }
+    return true;
+}
+
+static bool isValidAesKey(const SAesKey &key)
+{
+    if ((key.key.size() != SAesKeyData::KeySize) || (key.iv.size() != SAesKeyData::IvSize)) {
+        qCritical() << Q_FUNC_INFO << "Invalid AES key or IV size" << key.key.size() << key.iv.size();
+        return false;
+    }
+    return true;
+}
+
+bool Utils::aesIgeEncrypt(void *data, int size, const SAesKeyData &key)
+{
+    return aesIgeInPlace(static_cast<uchar *>(data), size, key.key, key.iv, /* encrypt */ true);
+}
+
+bool Utils::aesIgeDecrypt(void *data, int size, const SAesKeyData &key)
+{
+    return aesIgeInPlace(static_cast<uchar *>(data), size, key.key, key.iv, /* encrypt */ false);
+}
+
+QByteArray Utils::aesDecrypt(const QByteArray &data, const SAesKey &key)
+{
+    if (!isValidAesKey(key)) {
         return QByteArray();
     }
     QByteArray result = data;
-    QByteArray initVector = key.iv;
-    AES_KEY dec_key;
-    AES_set_decrypt_key((const uchar *) key.key.constData(), key.key.length() * 8, &dec_key);
-    AES_ige_encrypt((const uchar *) data.constData(), (uchar *) result.data(), data.length(), &dec_key, (uchar *) initVector.data(), AES_DECRYPT);
+    if (!aesIgeInPlace(reinterpret_cast<uchar *>(result.data()), result.size(),
+                       reinterpret_cast<const uchar *>(key.key.constData()), reinterpret_cast<const uchar *>(key.iv.constData()), /* encrypt */ false)) {
+        return QByteArray();
+    }
     return result;
 }
 
 QByteArray Utils::aesEncrypt(const QByteArray &data, const SAesKey &key)
 {
-    if (data.length() % AES_BLOCK_SIZE) {
-        qCritical() << Q_FUNC_INFO << "Data is not padded (the size %" << AES_BLOCK_SIZE << " is not zero)";
+    if (!isValidAesKey(key)) {
         return QByteArray();
     }
     QByteArray result = data;
-    QByteArray initVector = key.iv;
-    AES_KEY enc_key;
-    AES_set_encrypt_key((const uchar *) key.key.constData(), key.key.length() * 8, &enc_key);
-    AES_ige_encrypt((const uchar *) data.constData(), (uchar *) result.data(), data.length(), &enc_key, (uchar *) initVector.data(), AES_ENCRYPT);
+    if (!aesIgeInPlace(reinterpret_cast<uchar *>(result.data()), result.size(),
+                       reinterpret_cast<const uchar *>(key.key.constData()), reinterpret_cast<const uchar *>(key.iv.constData()), /* encrypt */ true)) {
+        return QByteArray();
+    }
     return result;
 }
 
-QByteArray Utils::unpackGZip(const QByteArray &data)
+QByteArray Utils::aesDecrypt(const QByteArray &data, const SAesKeyData &key)
 {
-    if (data.size() <= 4) {
-        qDebug() << Q_FUNC_INFO << "Input data is too small to be gzip package";
+    QByteArray result = data;
+    if (!aesIgeDecrypt(result.data(), result.size(), key)) {
+        return QByteArray();
+    }
+    return result;
+}
+
+QByteArray Utils::aesEncrypt(const QByteArray &data, const SAesKeyData &key)
+{
+    QByteArray result = data;
+    if (!aesIgeEncrypt(result.data(), result.size(), key)) {
         return QByteArray();
     }
+    return result;
+}
 
-    QByteArray result;
+void Utils::generateMessageAesKey(SAesKeyData *aesKey, const uchar *authKeyData, const uchar *messageKey, int x)
+{
+    // https://core.telegram.org/mtproto/description#defining-aes-key-and-initialization-vector
+    static const int messageKeySize = 16;
+    const uchar *authKey = authKeyData + x;
+
+    uchar sha1_a[SHA_DIGEST_LENGTH];
+    uchar sha1_b[SHA_DIGEST_LENGTH];
+    uchar sha1_c[SHA_DIGEST_LENGTH];
+    uchar sha1_d[SHA_DIGEST_LENGTH];
+    SHA_CTX context;
+
+    SHA1_Init(&context);
+    SHA1_Update(&context, messageKey, messageKeySize);
+    SHA1_Update(&context, authKey, 32);
+    SHA1_Final(sha1_a, &context);
+
+    SHA1_Init(&context);
+    SHA1_Update(&context, authKey + 32, 16);
+    SHA1_Update(&context, messageKey, messageKeySize);
+    SHA1_Update(&context, authKey + 48, 16);
+    SHA1_Final(sha1_b, &context);
+
+    SHA1_Init(&context);
+    SHA1_Update(&context, authKey + 64, 32);
+    SHA1_Update(&context, messageKey, messageKeySize);
+    SHA1_Final(sha1_c, &context);
+
+    SHA1_Init(&context);
+    SHA1_Update(&context, messageKey, messageKeySize);
+    SHA1_Update(&context, authKey + 96, 32);
+    SHA1_Final(sha1_d, &context);
+
+    // key = substr(sha1_a, 0, 8) + substr(sha1_b, 8, 12) + substr(sha1_c, 4, 12)
+    memcpy(aesKey->key, sha1_a, 8);
+    memcpy(aesKey->key + 8, sha1_b + 8, 12);
+    memcpy(aesKey->key + 20, sha1_c + 4, 12);
+
+    // iv = substr(sha1_a, 8, 12) + substr(sha1_b, 0, 8) + substr(sha1_c, 16, 4) + substr(sha1_d, 0, 8)
+    memcpy(aesKey->iv, sha1_a + 8, 12);
+    memcpy(aesKey->iv + 12, sha1_b, 8);
+    memcpy(aesKey->iv + 20, sha1_c + 16, 4);
+    memcpy(aesKey->iv + 24, sha1_d, 8);
+}
+
+// The zlib streams are reused to avoid the state allocation and initialization per call
+static z_stream *inflateStream()
+{
+    static thread_local struct StreamHolder {
+        StreamHolder()
+        {
+            stream.zalloc = Z_NULL;
+            stream.zfree = Z_NULL;
+            stream.opaque = Z_NULL;
+            stream.avail_in = 0;
+            stream.next_in = Z_NULL;
+            valid = inflateInit2(&stream, 15 + 32) == Z_OK; // gzip decoding
+        }
+        ~StreamHolder()
+        {
+            if (valid) {
+                inflateEnd(&stream);
+            }
+        }
+        z_stream stream;
+        bool valid;
+    } holder;
 
-    int inflateResult;
-    z_stream stream;
-    static const int CHUNK_SIZE = 1024;
-    char out[CHUNK_SIZE];
+    if (!holder.valid || (inflateReset(&holder.stream) != Z_OK)) {
+        return nullptr;
+    }
+    return &holder.stream;
+}
 
-    /* allocate inflate state */
-    stream.zalloc = Z_NULL;
-    stream.zfree = Z_NULL;
-    stream.opaque = Z_NULL;
-    stream.avail_in = data.size();
-    stream.next_in = (Bytef*)(data.data());
+static z_stream *deflateStream()
+{
+    static thread_local struct StreamHolder {
+        StreamHolder()
+        {
+            stream.zalloc = Z_NULL;
+            stream.zfree = Z_NULL;
+            stream.opaque = Z_NULL;
+            valid = deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK; // gzip encoding
+        }
+        ~StreamHolder()
+        {
+            if (valid) {
+                deflateEnd(&stream);
+            }
+        }
+        z_stream stream;
+        bool valid;
+    } holder;
 
-    inflateResult = inflateInit2(&stream, 15 + 32); // gzip decoding
+    if (!holder.valid || (deflateReset(&holder.stream) != Z_OK)) {
+        return nullptr;
+    }
+    return &holder.stream;
+}
 
-    if (inflateResult != Z_OK) {
+QByteArray Utils::unpackGZip(const QByteArray &data)
+{
+    if (data.size() <= 4) {
+        qDebug() << Q_FUNC_INFO << "Input data is too small to be gzip package";
+        return QByteArray();
+    }
+
+    z_stream *stream = inflateStream();
+    if (!stream) {
         return QByteArray();
     }
 
+    // The gzip trailer ends with the size of the uncompressed data. It is used as the output size hint,
+    // unless it exceeds the maximum deflate compression ratio or a sane limit (e.g. the data is corrupted).
+    static const int maxCompressionRatio = 1032;
+    static const quint32 maxSizeHint = 64 * 1024 * 1024;
+    static const int minimalOutputSize = 1024;
+    const quint32 sizeHint = qFromLittleEndian<quint32>(reinterpret_cast<const uchar *>(data.constData()) + data.size() - 4);
+    int outputSize;
+    if ((sizeHint > 0) && (sizeHint <= maxSizeHint) && (sizeHint / maxCompressionRatio <= quint32(data.size()))) {
+        outputSize = qMax<int>(sizeHint, minimalOutputSize);
+    } else {
+        outputSize = qMax(data.size() * 4, minimalOutputSize);
+    }
+
+    QByteArray result(outputSize, Qt::Uninitialized);
+
+    stream->avail_in = data.size();
+    stream->next_in = (Bytef*)(data.constData());
+
+    int inflateResult = Z_OK;
     do {
-        stream.avail_out = CHUNK_SIZE;
-        stream.next_out = (Bytef*)(out);
+        if (stream->total_out == uLong(result.size())) {
+            // The hint was wrong, grow the output geometrically
+            result.resize(result.size() * 2);
+        }
+        stream->next_out = (Bytef*)(result.data() + stream->total_out);
+        stream->avail_out = result.size() - stream->total_out;
 
-        inflateResult = inflate(&stream, Z_NO_FLUSH);
+        inflateResult = inflate(stream, Z_NO_FLUSH);
 
         switch (inflateResult) {
         case Z_NEED_DICT:
         case Z_DATA_ERROR:
         case Z_MEM_ERROR:
         case Z_STREAM_ERROR:
-            inflateEnd(&stream);
             return QByteArray();
         default:
             break;
         }
+    } while ((inflateResult != Z_STREAM_END) && (stream->avail_out == 0));
 
-        result.append(out, CHUNK_SIZE - stream.avail_out);
-    } while (stream.avail_out == 0);
+    // Truncated input results in the partially unpacked data
+    result.resize(stream->total_out);
+    return result;
+}
 
-    inflateEnd(&stream);
+QByteArray Utils::packGZip(const QByteArray &data)
+{
+    z_stream *stream = deflateStream();
+    if (!stream) {
+        return QByteArray();
+    }
 
+    QByteArray result;
+    result.resize(deflateBound(stream, data.size()));
+
+    stream->avail_in = data.size();
+    stream->next_in = (Bytef*)(data.constData());
+    stream->avail_out = result.size();
+    stream->next_out = (Bytef*)(result.data());
+
+    if (deflate(stream, Z_FINISH) != Z_STREAM_END) {
+        return QByteArray();
+    }
+    result.resize(stream->total_out);
     return result;
 }
 
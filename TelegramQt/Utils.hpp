@@ -64,7 +64,16 @@ QByteArray binaryNumberModExp(const QByteArray &data, const QByteArray &mod, con
 QByteArray rsa(const QByteArray &data, const Telegram::RsaKey &key);
 QByteArray aesDecrypt(const QByteArray &data, const SAesKey &key);
 QByteArray aesEncrypt(const QByteArray &data, const SAesKey &key);
+QByteArray aesDecrypt(const QByteArray &data, const SAesKeyData &key);
+QByteArray aesEncrypt(const QByteArray &data, const SAesKeyData &key);
+
+// In-place AES-256-IGE over a caller-owned buffer. The size must be a multiple of the AES block size.
+bool aesIgeEncrypt(void *data, int size, const SAesKeyData &key);
+bool aesIgeDecrypt(void *data, int size, const SAesKeyData &key);
+// MTProto message key derivation; the auth key data must be 256 bytes, x is 0 for client to server messages and 8 for the opposite direction
+void generateMessageAesKey(SAesKeyData *aesKey, const uchar *authKeyData, const uchar *messageKey, int x);
 QByteArray unpackGZip(const QByteArray &data);
+QByteArray packGZip(const QByteArray &data);
 
 }
 
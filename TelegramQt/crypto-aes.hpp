@@ -35,4 +35,17 @@ struct SAesKey {
     }
 };
 
+// AES-256 key and IV in fixed-size arrays. Can be derived and used without heap allocations.
+struct SAesKeyData {
+    enum { KeySize = 32, IvSize = 32 };
+    uchar key[KeySize];
+    uchar iv[IvSize];
+
+    SAesKey toAesKey() const
+    {
+        return SAesKey(QByteArray(reinterpret_cast<const char *>(key), KeySize),
+                       QByteArray(reinterpret_cast<const char *>(iv), IvSize));
+    }
+};
+
 #endif // CRYPTOAES_HPP
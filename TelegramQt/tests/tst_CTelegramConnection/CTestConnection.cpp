@@ -24,6 +24,12 @@ CTestConnection::CTestConnection(QObject *parent) :
     setTransport(new Telegram::Client::TcpTransport(this));
 }
 
+CTestConnection::CTestConnection(const CAppInformation *appInfo, QObject *parent) :
+    CTelegramConnection(appInfo, parent)
+{
+    setTransport(new Telegram::Client::TcpTransport(this));
+}
+
 void CTestConnection::setClientNonce(TLNumber128 newClientNonce)
 {
     m_clientNonce = newClientNonce;
@@ -41,7 +47,7 @@ void CTestConnection::setNewNonce(TLNumber256 newNewNonce)
 
 void CTestConnection::setAuthKey(const QByteArray &newKey)
 {
-    m_authKey = newKey;
+    CTelegramConnection::setAuthKey(newKey);
 }
 
 void CTestConnection::setGA(const QByteArray &newGA)
@@ -64,6 +70,11 @@ SAesKey CTestConnection::testGenerateClientToServerAesKey(const QByteArray &mess
     return generateClientToServerAesKey(messageKey);
 }
 
+void CTestConnection::testGenerateClientToServerAesKey(SAesKeyData *aesKey, const QByteArray &messageKey) const
+{
+    generateClientToServerAesKey(aesKey, messageKey);
+}
+
 quint64 CTestConnection::testNewMessageId()
 {
     return newMessageId();
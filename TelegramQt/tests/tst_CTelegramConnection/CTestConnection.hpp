@@ -20,11 +20,14 @@
 
 #include "CTelegramConnection.hpp"
 
+#include <QTimer>
+
 class CTestConnection : public CTelegramConnection
 {
     Q_OBJECT
 public:
     explicit CTestConnection(QObject *parent = nullptr);
+    explicit CTestConnection(const CAppInformation *appInfo, QObject *parent = nullptr);
 
     inline CTelegramTransport *transport() const { return m_transport; }
 
@@ -37,8 +40,20 @@ public:
     void setB(const QByteArray &newB);
 
     SAesKey testGenerateClientToServerAesKey(const QByteArray &messageKey) const;
+    void testGenerateClientToServerAesKey(SAesKeyData *aesKey, const QByteArray &messageKey) const;
     quint64 testNewMessageId();
 
+    int sentContainersCount() const { return m_sentContainers.count(); }
+    const CRequestTracker &requestTracker() const { return m_requestTracker; }
+    bool pingTimerActive() const { return m_pingTimer && m_pingTimer->isActive(); }
+    bool pongTimerActive() const { return m_pongTimer && m_pongTimer->isActive(); }
+
+    using CTelegramConnection::addRttSample;
+    using CTelegramConnection::processRpcQuery;
+    using CTelegramConnection::processDecodedMessage;
+    using CTelegramConnection::gzipPackedMessage;
+    using CTelegramConnection::onFutureSaltsTimeout;
+
 };
 
 #endif // CTESTCONNECTION_HPP
@@ -18,13 +18,26 @@
 #include <QObject>
 
 #include "CTestConnection.hpp"
+#include "CAppInformation.hpp"
+#include "CLoopbackTransport.hpp"
+#include "CMessageIdWindow.hpp"
+#include "CPackageDecoder.hpp"
+#include "CRawStream.hpp"
+#include "CRequestTracker.hpp"
+#include "CTelegramStream.hpp"
 #include "CTelegramTransport.hpp"
+#include "CTransportCapture.hpp"
 #include "TelegramUtils.hpp"
+#include "TLValues.hpp"
+#include "Utils.hpp"
 
 #include <QTest>
 #include <QDebug>
 
+#include <QBuffer>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QThread>
 
 class tst_CTelegramConnection : public QObject
 {
@@ -37,6 +50,32 @@ private slots:
     void testTimestampConversion();
     void testAuth();
     void testAesKeyGeneration();
+    void benchmarkAesKeyGeneration_data();
+    void benchmarkAesKeyGeneration();
+    void testRttEstimation();
+    void testPackageDecoding();
+    void benchmarkPackageDecoding_data();
+    void benchmarkPackageDecoding();
+    void benchmarkRpcResultProcessing_data();
+    void benchmarkRpcResultProcessing();
+    void testGzipPackedMessage();
+    void testRequestTracker();
+    void testFutureSalts();
+    void testTransportCapture();
+    void testMessageIdWindow();
+    void testBackpressure();
+    void testRequestsHolding();
+    void testRequestFailure();
+    void testRttSampleExcludesQueueTime();
+    void testPongTimeoutLiveness();
+    void testContainerResend();
+    void testMessagesStateInfo();
+    void testPriorityOrder();
+    void testPriorityByteBudget();
+    void testBulkReleaseGating();
+    void testContainerFormat();
+    void testAckPiggybacking();
+    void testMessageNewDetailedInfo();
 
 };
 
@@ -352,6 +391,1357 @@ void tst_CTelegramConnection::testAesKeyGeneration()
 
     QCOMPARE(result.key, aesKeyArray);
     QCOMPARE(result.iv , aesIvArray);
+
+    SAesKeyData resultData;
+    core.testGenerateClientToServerAesKey(&resultData, messageKeyArray);
+    QCOMPARE(QByteArray(reinterpret_cast<const char *>(resultData.key), SAesKeyData::KeySize), aesKeyArray);
+    QCOMPARE(QByteArray(reinterpret_cast<const char *>(resultData.iv), SAesKeyData::IvSize), aesIvArray);
+}
+
+// The AES key derivation implementation based on QByteArray concatenations
+static SAesKey generateAesKeyReference(const QByteArray &authKey, const QByteArray &messageKey, int x)
+{
+    QByteArray sha1_a = Telegram::Utils::sha1(messageKey + authKey.mid(x, 32));
+    QByteArray sha1_b = Telegram::Utils::sha1(authKey.mid(32 + x, 16) + messageKey + authKey.mid(48 + x, 16));
+    QByteArray sha1_c = Telegram::Utils::sha1(authKey.mid(64 + x, 32) + messageKey);
+    QByteArray sha1_d = Telegram::Utils::sha1(messageKey + authKey.mid(96 + x, 32));
+
+    const QByteArray key = sha1_a.mid(0, 8) + sha1_b.mid(8, 12) + sha1_c.mid(4, 12);
+    const QByteArray iv  = sha1_a.mid(8, 12) + sha1_b.mid(0, 8) + sha1_c.mid(16, 4) + sha1_d.mid(0, 8);
+
+    return SAesKey(key, iv);
+}
+
+void tst_CTelegramConnection::benchmarkAesKeyGeneration_data()
+{
+    QTest::addColumn<bool>("fixedSize");
+    QTest::newRow("QByteArray") << false;
+    QTest::newRow("fixed-size") << true;
+}
+
+void tst_CTelegramConnection::benchmarkAesKeyGeneration()
+{
+    QFETCH(bool, fixedSize);
+
+    QByteArray authKey(256, Qt::Uninitialized);
+    for (int i = 0; i < authKey.size(); ++i) {
+        authKey[i] = char(i * 13);
+    }
+    const QByteArray messageKey(16, char(0x5a));
+
+    CTestConnection connection;
+    connection.setAuthKey(authKey);
+
+    SAesKeyData keyData;
+    connection.testGenerateClientToServerAesKey(&keyData, messageKey);
+    QCOMPARE(keyData.toAesKey().key, generateAesKeyReference(authKey, messageKey, 0).key);
+    QCOMPARE(keyData.toAesKey().iv, generateAesKeyReference(authKey, messageKey, 0).iv);
+
+    if (fixedSize) {
+        QBENCHMARK {
+            connection.testGenerateClientToServerAesKey(&keyData, messageKey);
+        }
+    } else {
+        SAesKey key;
+        QBENCHMARK {
+            key = generateAesKeyReference(authKey, messageKey, 0);
+        }
+    }
+}
+
+void tst_CTelegramConnection::testRttEstimation()
+{
+    CTestConnection connection;
+    connection.setKeepAliveSettings(15000, 10000);
+
+    // No samples yet: the timeouts are the default ones, the pong is awaited longer than the ping interval
+    QCOMPARE(connection.smoothedRtt(), qint64(0));
+    QCOMPARE(connection.retransmissionTimeout(), quint32(15000));
+    QCOMPARE(connection.pongTimeout(), quint32(25000));
+
+    connection.addRttSample(100);
+    QCOMPARE(connection.smoothedRtt(), qint64(100));
+    QCOMPARE(connection.rttVariance(), qint64(50));
+    QCOMPARE(connection.retransmissionTimeout(), quint32(1000)); // 300 ms is less than the minimal timeout
+
+    for (int i = 0; i < 50; ++i) {
+        connection.addRttSample(100);
+    }
+    QCOMPARE(connection.smoothedRtt(), qint64(100));
+    QCOMPARE(connection.connectionTimeout(), quint32(3000));
+    QCOMPARE(connection.pongTimeout(), quint32(2000));
+
+    // Slow link
+    for (int i = 0; i < 50; ++i) {
+        connection.addRttSample(i % 2 ? 4000 : 6000);
+    }
+    QVERIFY(connection.smoothedRtt() > 4000);
+    QVERIFY(connection.retransmissionTimeout() > quint32(connection.smoothedRtt()));
+    QVERIFY(connection.pongTimeout() > connection.retransmissionTimeout());
+    QVERIFY(connection.pongTimeout() <= quint32(25000));
+
+    // Invalid samples are ignored
+    const qint64 smoothedRtt = connection.smoothedRtt();
+    connection.addRttSample(-1);
+    connection.addRttSample(24 * 3600 * 1000);
+    QCOMPARE(connection.smoothedRtt(), smoothedRtt);
+}
+
+static QByteArray testAuthKey()
+{
+    QByteArray authKey(256, Qt::Uninitialized);
+    for (int i = 0; i < authKey.size(); ++i) {
+        authKey[i] = char(i * 7 + 3);
+    }
+    return authKey;
+}
+
+static QByteArray encryptServerMessage(const QByteArray &authKey, quint64 sessionId, quint64 messageId, const QByteArray &payload)
+{
+    QByteArray innerData;
+    CRawStream innerStream(&innerData, /* write */ true);
+    innerStream << quint64(0x1122334455667788ull); // Server salt
+    innerStream << sessionId;
+    innerStream << messageId;
+    innerStream << quint32(1); // Sequence number
+    innerStream << quint32(payload.size());
+    innerStream << payload;
+    const int contentSize = innerData.size();
+    innerStream << QByteArray((16 - contentSize % 16) % 16, char(0)); // Padding
+
+    const QByteArray messageKey = Utils::sha1(innerData.left(contentSize)).mid(4);
+    SAesKeyData key;
+    Utils::generateMessageAesKey(&key, reinterpret_cast<const uchar *>(authKey.constData()), reinterpret_cast<const uchar *>(messageKey.constData()), 8);
+    Utils::aesIgeEncrypt(innerData.data(), innerData.size(), key);
+
+    QByteArray package;
+    CRawStream packageStream(&package, /* write */ true);
+    packageStream << Utils::getFingerprints(authKey, Utils::Lower64Bits);
+    packageStream << messageKey;
+    packageStream << innerData;
+    return package;
+}
+
+static QByteArray rpcResult(quint64 requestId, const QByteArray &result, bool packed)
+{
+    QByteArray payload;
+    CRawStreamEx stream(&payload, /* write */ true);
+    stream << quint32(TLValue::RpcResult);
+    stream << requestId;
+    if (packed) {
+        stream << quint32(TLValue::GzipPacked);
+        stream << Utils::packGZip(result);
+    } else {
+        static_cast<CRawStream &>(stream) << result;
+    }
+    return payload;
+}
+
+static bool decryptClientMessage(const QByteArray &authKey, const QByteArray &package, CPackageDecoder::Message *message)
+{
+    if ((package.size() < 24 + 32) || ((package.size() - 24) % 16)) {
+        return false;
+    }
+    const QByteArray messageKey = package.mid(8, 16);
+    QByteArray innerData = package.mid(24);
+    SAesKeyData key;
+    Utils::generateMessageAesKey(&key, reinterpret_cast<const uchar *>(authKey.constData()), reinterpret_cast<const uchar *>(messageKey.constData()), 0);
+    Utils::aesIgeDecrypt(innerData.data(), innerData.size(), key);
+
+    CRawStream innerStream(innerData);
+    quint32 length = 0;
+    innerStream >> message->serverSalt;
+    innerStream >> message->sessionId;
+    innerStream >> message->messageId;
+    innerStream >> message->sequence;
+    innerStream >> length;
+    if (int(length) > innerData.size() - 32) {
+        return false;
+    }
+    message->payload = innerData.mid(32, length);
+    return Utils::sha1(innerData.left(32 + length)).mid(4) == messageKey;
+}
+
+static QVector<CPackageDecoder::Message> containerMessages(const QByteArray &container)
+{
+    QVector<CPackageDecoder::Message> messages;
+    CRawStream stream(container);
+    quint32 type = 0;
+    quint32 count = 0;
+    stream >> type;
+    if (type != TLValue::MsgContainer) {
+        return messages;
+    }
+    stream >> count;
+    for (quint32 i = 0; i < count; ++i) {
+        CPackageDecoder::Message message;
+        quint32 length = 0;
+        stream >> message.messageId;
+        stream >> message.sequence;
+        stream >> length;
+        message.payload = stream.readBytes(length);
+        messages.append(message);
+    }
+    return messages;
+}
+
+// The items of a container or the message itself
+static QVector<CPackageDecoder::Message> packageMessages(const CPackageDecoder::Message &package)
+{
+    const QVector<CPackageDecoder::Message> items = containerMessages(package.payload);
+    return items.isEmpty() ? QVector<CPackageDecoder::Message>({ package }) : items;
+}
+
+// The amount of the not written data is set by the test
+class BufferedLoopbackTransport : public CLoopbackTransport
+{
+public:
+    explicit BufferedLoopbackTransport(QObject *parent = nullptr) :
+        CLoopbackTransport(parent)
+    {
+    }
+
+    qint64 bytesToWrite() const override { return m_bytesToWrite; }
+    void setBytesToWrite(qint64 bytes) { m_bytesToWrite = bytes; }
+
+protected:
+    qint64 m_bytesToWrite = 0;
+
+};
+
+// The server side of an in-process link; decrypts the messages sent by the connection
+class LoopbackServer
+{
+public:
+    explicit LoopbackServer(CTestConnection *connection, CLoopbackTransport *clientTransport = nullptr) :
+        m_connection(connection),
+        m_authKey(testAuthKey()),
+        m_transport(new CLoopbackTransport(connection)),
+        m_clientTransport(clientTransport ? clientTransport : new CLoopbackTransport(connection))
+    {
+        CLoopbackTransport::connectPeers(m_clientTransport, m_transport);
+        m_connection->setTransport(m_clientTransport);
+        m_connection->setAuthKey(m_authKey);
+        QObject::connect(m_transport, &CTelegramTransport::packageReceived, m_transport, [this](const QByteArray &package) {
+            CPackageDecoder::Message message;
+            if (decryptClientMessage(m_authKey, package, &message)) {
+                m_messages.append(message);
+            }
+        });
+    }
+
+    CLoopbackTransport *transport() const { return m_transport; }
+    CLoopbackTransport *clientTransport() const { return m_clientTransport; }
+    int messagesCount() const { return m_messages.count(); }
+
+    bool waitForMessages(int count)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        while ((m_messages.count() < count) && (timer.elapsed() < 5000)) {
+            QTest::qWait(10);
+        }
+        return m_messages.count() >= count;
+    }
+
+    // The initial message (get_future_salts with initConnection) is dropped
+    bool connectClient()
+    {
+        m_connection->connectToDc();
+        if (!waitForMessages(1)) {
+            return false;
+        }
+        m_messages.clear();
+        return m_connection->status() >= CTelegramConnection::ConnectionStatusConnected;
+    }
+
+    QVector<CPackageDecoder::Message> takeMessages()
+    {
+        const QVector<CPackageDecoder::Message> messages = m_messages;
+        m_messages.clear();
+        return messages;
+    }
+
+    void sendMessage(const QByteArray &payload)
+    {
+        m_lastMessageId = qMax(m_lastMessageId + 4, (quint64(QDateTime::currentMSecsSinceEpoch() / 1000) << 32) | 1);
+        m_transport->sendPackage(encryptServerMessage(m_authKey, m_connection->sessionId(), m_lastMessageId, payload));
+    }
+
+protected:
+    CTestConnection *m_connection;
+    QByteArray m_authKey;
+    CLoopbackTransport *m_transport;
+    CLoopbackTransport *m_clientTransport;
+    QVector<CPackageDecoder::Message> m_messages;
+    quint64 m_lastMessageId = 0;
+
+};
+
+void tst_CTelegramConnection::testPackageDecoding()
+{
+    const QByteArray authKey = testAuthKey();
+    const QByteArray result = QByteArray("The result of an RPC call. ").repeated(64);
+    const QByteArray packedResult = rpcResult(0x1001, result, /* packed */ true);
+    const QByteArray package = encryptServerMessage(authKey, 0x2002, 0x3003, packedResult);
+
+    CPackageDecoder decoder;
+    CPackageDecoder::Message message;
+    QVERIFY(!decoder.decode(package, &message)); // No auth key
+
+    decoder.setAuthKey(authKey);
+    QVERIFY(decoder.decode(package, &message));
+    QCOMPARE(message.serverSalt, quint64(0x1122334455667788ull));
+    QCOMPARE(message.sessionId, quint64(0x2002));
+    QCOMPARE(message.messageId, quint64(0x3003));
+    QCOMPARE(message.sequence, quint32(1));
+    QCOMPARE(message.payload, packedResult);
+
+    QCOMPARE(CPackageDecoder::unpackGzipPayloads(packedResult), rpcResult(0x1001, result, /* packed */ false));
+
+    // The container items are unpacked as well
+    const QByteArray plainItem = rpcResult(0x1002, QByteArray(8, 'x'), /* packed */ false);
+    QByteArray container;
+    QByteArray expectedContainer;
+    CRawStream containerStream(&container, /* write */ true);
+    CRawStream expectedStream(&expectedContainer, /* write */ true);
+    containerStream << quint32(TLValue::MsgContainer);
+    containerStream << quint32(2);
+    expectedStream << quint32(TLValue::MsgContainer);
+    expectedStream << quint32(2);
+    const QVector<QByteArray> items = { packedResult, plainItem };
+    const QVector<QByteArray> expectedItems = { rpcResult(0x1001, result, /* packed */ false), plainItem };
+    for (int i = 0; i < items.count(); ++i) {
+        containerStream << quint64(0x4000 + i);
+        containerStream << quint32(i * 2 + 1);
+        containerStream << quint32(items.at(i).size());
+        containerStream << items.at(i);
+        expectedStream << quint64(0x4000 + i);
+        expectedStream << quint32(i * 2 + 1);
+        expectedStream << quint32(expectedItems.at(i).size());
+        expectedStream << expectedItems.at(i);
+    }
+    QCOMPARE(CPackageDecoder::unpackGzipPayloads(container), expectedContainer);
+
+    // The bulky objects are decoded ahead, keyed by the request id of the RPC result or by the message id
+    QByteArray history;
+    CRawStream historyStream(&history, /* write */ true);
+    historyStream << quint32(TLValue::MessagesMessages);
+    for (int i = 0; i < 3; ++i) {
+        historyStream << quint32(TLValue::Vector);
+        historyStream << quint32(0);
+    }
+    QByteArray updatesTooLong;
+    CRawStream updatesStream(&updatesTooLong, /* write */ true);
+    updatesStream << quint32(TLValue::UpdatesTooLong);
+    CPackageDecoder::Message decodedMessage;
+    decodedMessage.messageId = 0x5001;
+    decodedMessage.payload = expectedContainer;
+    CPackageDecoder::decodeObjects(&decodedMessage, nullptr);
+    QVERIFY(decodedMessage.objects.isEmpty()); // No bulky objects in the container
+    decodedMessage.payload = rpcResult(0x1003, history, /* packed */ false);
+    CPackageDecoder::decodeObjects(&decodedMessage, nullptr);
+    decodedMessage.payload = updatesTooLong;
+    CPackageDecoder::decodeObjects(&decodedMessage, nullptr);
+    QCOMPARE(decodedMessage.objects.count(), 2);
+    QCOMPARE(decodedMessage.objects.at(0).id, quint64(0x1003));
+    QCOMPARE(decodedMessage.objects.at(1).id, quint64(0x5001));
+    TLMessagesMessages decodedHistory;
+    TLUpdates decodedUpdates;
+    QVERIFY(!decodedMessage.objects[0].take(&decodedUpdates));
+    QVERIFY(decodedMessage.objects[0].take(&decodedHistory));
+    QVERIFY(decodedHistory.tlType == TLValue::MessagesMessages);
+    QVERIFY(!decodedMessage.objects[0].take(&decodedHistory)); // Taken once
+    QVERIFY(decodedMessage.objects[1].take(&decodedUpdates));
+    QVERIFY(decodedUpdates.tlType == TLValue::UpdatesTooLong);
+
+    // Corrupted package is rejected
+    QByteArray corruptedPackage = package;
+    corruptedPackage[40] = corruptedPackage.at(40) ^ 1;
+    QVERIFY(!decoder.decode(corruptedPackage, &message));
+}
+
+void tst_CTelegramConnection::benchmarkPackageDecoding_data()
+{
+    QTest::addColumn<bool>("threaded");
+    QTest::newRow("connection thread") << false;
+    QTest::newRow("worker thread") << true;
+}
+
+// The result is the time spent in the main (connection) thread per megabyte of the decoded payload
+void tst_CTelegramConnection::benchmarkPackageDecoding()
+{
+    QFETCH(bool, threaded);
+
+    static const int packageSize = 32 * 1024;
+    static const int packagesCount = 1024 * 1024 / packageSize;
+    static const int iterations = 20;
+
+    const QByteArray authKey = testAuthKey();
+    QByteArray result(packageSize, Qt::Uninitialized);
+    quint32 seed = 1;
+    for (int i = 0; i < result.size(); ++i) {
+        // Moderately compressible data, as a typical TL content
+        seed = seed * 1103515245 + 12345;
+        result[i] = char('a' + (seed >> 16) % 16);
+    }
+
+    QVector<QByteArray> packages;
+    for (int i = 0; i < packagesCount; ++i) {
+        packages.append(encryptServerMessage(authKey, 1, 4 * i, rpcResult(i, result, /* packed */ true)));
+    }
+
+    qint64 receivedBytes = 0;
+    qint64 mainThreadTime = 0;
+    QElapsedTimer timer;
+
+    if (threaded) {
+        QThread thread;
+        thread.start();
+        CPackageDecodingWorker *worker = new CPackageDecodingWorker();
+        worker->setAuthKey(authKey);
+        worker->moveToThread(&thread);
+
+        int decodedCount = 0;
+        QObject receiver;
+        connect(worker, &CPackageDecodingWorker::messageDecoded, &receiver, [&](const CPackageDecoder::Message &message) {
+            timer.start();
+            receivedBytes += message.payload.size();
+            ++decodedCount;
+            mainThreadTime += timer.nsecsElapsed();
+        });
+
+        for (int i = 0; i < iterations; ++i) {
+            for (const QByteArray &package : packages) {
+                timer.start();
+                QMetaObject::invokeMethod(worker, "decodePackage", Qt::QueuedConnection,
+                                          Q_ARG(QByteArray, QByteArray(package.constData(), package.size())));
+                mainThreadTime += timer.nsecsElapsed();
+            }
+        }
+        QTRY_COMPARE_WITH_TIMEOUT(decodedCount, packagesCount * iterations, 60000);
+
+        worker->deleteLater();
+        thread.quit();
+        thread.wait();
+    } else {
+        CPackageDecoder decoder;
+        decoder.setAuthKey(authKey);
+        CPackageDecoder::Message message;
+        for (int i = 0; i < iterations; ++i) {
+            for (const QByteArray &package : packages) {
+                timer.start();
+                QVERIFY(decoder.decode(package, &message));
+                message.payload = CPackageDecoder::unpackGzipPayloads(message.payload);
+                receivedBytes += message.payload.size();
+                mainThreadTime += timer.nsecsElapsed();
+            }
+        }
+    }
+
+    QVERIFY(receivedBytes > qint64(packageSize) * packagesCount * iterations);
+    const double megabytes = double(receivedBytes) / (1024 * 1024);
+    QTest::setBenchmarkResult(mainThreadTime / 1000000.0 / megabytes, QTest::WalltimeMilliseconds);
+}
+
+static QByteArray messagesHistory(int count)
+{
+    QByteArray data;
+    CRawStreamEx stream(&data, /* write */ true);
+    stream << quint32(TLValue::MessagesMessages);
+    stream << quint32(TLValue::Vector);
+    stream << quint32(count);
+    for (int i = 0; i < count; ++i) {
+        QByteArray text("The text of the message number ");
+        text.append(QByteArray::number(i));
+        stream << quint32(TLValue::Message);
+        stream << quint32(0); // Flags
+        stream << quint32(i + 1); // Id
+        stream << quint32(TLValue::PeerUser);
+        stream << quint32(1000); // User id
+        stream << quint32(1500000000 + i); // Date
+        stream << text;
+    }
+    stream << quint32(TLValue::Vector);
+    stream << quint32(0); // Chats
+    stream << quint32(TLValue::Vector);
+    stream << quint32(0); // Users
+    return data;
+}
+
+void tst_CTelegramConnection::benchmarkRpcResultProcessing_data()
+{
+    QTest::addColumn<bool>("threaded");
+    QTest::newRow("connection thread") << false;
+    QTest::newRow("worker thread") << true;
+}
+
+// The result is the time spent in the main (connection) thread per megabyte of the received messages.getHistory
+// results. With the threaded decoding, the decryption, inflation and TL decoding are done by the worker,
+// so only the processing of the decoded objects is left to the connection thread.
+void tst_CTelegramConnection::benchmarkRpcResultProcessing()
+{
+    QFETCH(bool, threaded);
+
+    static const int messagesCount = 1000;
+    static const int iterations = 50;
+
+    const QByteArray authKey = testAuthKey();
+    const QByteArray history = messagesHistory(messagesCount);
+
+    CAppInformation appInfo;
+    CTestConnection connection(&appInfo);
+    connection.setAuthKey(authKey);
+    CPackageDecoder decoder;
+    decoder.setAuthKey(authKey);
+    int historiesCount = 0;
+    int historyMessagesCount = 0;
+    connect(&connection, &CTelegramConnection::messagesHistoryReceived, [&](const TLMessagesMessages &history) {
+        ++historiesCount;
+        historyMessagesCount = history.messages.count();
+    });
+
+    TLInputPeer peer;
+    peer.tlType = TLValue::InputPeerSelf;
+
+    qint64 receivedBytes = 0;
+    qint64 mainThreadTime = 0;
+    QElapsedTimer timer;
+    for (int i = 0; i < iterations; ++i) {
+        const quint64 requestId = connection.messagesGetHistory(peer, 0, 0, messagesCount, 0, 0);
+        const QByteArray package = encryptServerMessage(authKey, connection.sessionId(), 4 * i + 1, rpcResult(requestId, history, /* packed */ true));
+
+        CPackageDecoder::Message message;
+        if (threaded) {
+            // The worker part is not measured
+            QVERIFY(decoder.decode(package, &message));
+            message.payload = CPackageDecoder::unpackGzipPayloads(message.payload);
+            CPackageDecoder::decodeObjects(&message, connection.messageProjection());
+            QCOMPARE(message.objects.count(), 1);
+
+            timer.start();
+            connection.processDecodedMessage(message);
+            mainThreadTime += timer.nsecsElapsed();
+        } else {
+            timer.start();
+            QVERIFY(decoder.decode(package, &message));
+            message.payload = CPackageDecoder::unpackGzipPayloads(message.payload);
+            connection.processDecodedMessage(message);
+            mainThreadTime += timer.nsecsElapsed();
+        }
+        QCOMPARE(connection.pendingRequestsCount(), 0);
+        QCOMPARE(historiesCount, i + 1);
+        QCOMPARE(historyMessagesCount, messagesCount);
+
+        receivedBytes += message.payload.size();
+    }
+
+    const double megabytes = double(receivedBytes) / (1024 * 1024);
+    QTest::setBenchmarkResult(mainThreadTime / 1000000.0 / megabytes, QTest::WalltimeMilliseconds);
+}
+
+void tst_CTelegramConnection::testGzipPackedMessage()
+{
+    QByteArray body;
+    CRawStream stream(&body, /* write */ true);
+    stream << quint32(TLValue::ContactsImportContacts);
+    for (int i = 0; i < 100; ++i) {
+        stream << QByteArray("+7900000");
+        stream << QByteArray::number(1000 + i);
+    }
+
+    const QByteArray packedBody = CTestConnection::gzipPackedMessage(body);
+    QVERIFY(!packedBody.isEmpty());
+    QVERIFY(packedBody.size() < body.size());
+    QVERIFY(TLValue::firstFromArray(packedBody) == TLValue::GzipPacked);
+    QCOMPARE(CPackageDecoder::unpackGzipPayloads(packedBody), body);
+
+    // Incompressible data is sent as is
+    QByteArray randomBody(2048, Qt::Uninitialized);
+    Utils::randomBytes(&randomBody);
+    QVERIFY(CTestConnection::gzipPackedMessage(randomBody).isEmpty());
+
+    // File parts are never packed
+    QByteArray filePart = body;
+    const quint32 filePartType = TLValue::UploadSaveFilePart;
+    filePart.replace(0, 4, reinterpret_cast<const char *>(&filePartType), 4);
+    QVERIFY(CTestConnection::gzipPackedMessage(filePart).isEmpty());
+}
+
+static CRequestTracker::Request trackedRequest(int size, qint64 sentTime, qint64 deadline = 0)
+{
+    CRequestTracker::Request request;
+    request.data = QByteArray(size, 'r');
+    request.sentTime = sentTime;
+    request.deadline = deadline;
+    return request;
+}
+
+void tst_CTelegramConnection::testRequestTracker()
+{
+    CRequestTracker tracker;
+    tracker.insert(100, trackedRequest(10, 1000, 5000));
+    tracker.insert(104, trackedRequest(20, 2000, 3000));
+    tracker.insert(108, trackedRequest(30, 3000));
+    QCOMPARE(tracker.count(), 3);
+    QCOMPARE(tracker.totalSize(), qint64(60));
+    QCOMPARE(tracker.oldestSentTime(), qint64(0)); // Nothing is sent yet
+
+    tracker.setFileRequestId(104, 7);
+    QCOMPARE(tracker.fileRequestId(104), quint32(7));
+    QCOMPARE(tracker.data(108), QByteArray(30, 'r'));
+    QVERIFY(tracker.data(112).isEmpty());
+
+    // The queued requests never expire
+    QCOMPARE(tracker.expiredRequests(5000), QVector<quint64>());
+    tracker.setSent(104);
+    QCOMPARE(tracker.oldestSentTime(), qint64(2000));
+    QCOMPARE(tracker.queuedRequests().count(), 2);
+    QVERIFY(!tracker.queuedRequests().contains(104));
+    QCOMPARE(tracker.expiredRequests(2999), QVector<quint64>());
+    QCOMPARE(tracker.expiredRequests(3000), QVector<quint64>({ 104 }));
+
+    // Only the requests with the state check time set are due for a check
+    tracker.request(100)->stateCheckTime = 2500;
+    tracker.request(108)->stateCheckTime = 4000;
+    QCOMPARE(tracker.requestsToCheck(2499), QVector<quint64>());
+    QCOMPARE(tracker.requestsToCheck(2500), QVector<quint64>({ 100 }));
+
+    // The sent requests are counted on all ways out of the tracker
+    tracker.setSent(100);
+    tracker.setSent(104);
+    tracker.setSent(104);
+    QCOMPARE(tracker.sentCount(), 2);
+    QCOMPARE(tracker.oldestSentTime(), qint64(1000));
+
+    const CRequestTracker::Request request = tracker.take(100);
+    QCOMPARE(request.data.size(), 10);
+    QVERIFY(!tracker.contains(100));
+    QCOMPARE(tracker.sentCount(), 1);
+    QCOMPARE(tracker.totalSize(), qint64(50));
+    QCOMPARE(tracker.oldestSentTime(), qint64(2000));
+
+    // The oldest sent requests are dropped on overflow, to be reported as failed
+    tracker.setMaxCount(2);
+    tracker.insert(112, trackedRequest(40, 4000));
+    QCOMPARE(tracker.count(), 2);
+    QVERIFY(!tracker.contains(104));
+    QCOMPARE(tracker.droppedCount(), quint64(1));
+    QCOMPARE(tracker.sentCount(), 0);
+    QCOMPARE(tracker.takeDroppedRequests(), (QVector<QPair<quint64, quint32> >({ qMakePair(quint64(104), quint32(7)) })));
+    QVERIFY(tracker.takeDroppedRequests().isEmpty());
+
+    // The queued requests are never dropped
+    tracker.setMaxTotalSize(50);
+    QCOMPARE(tracker.count(), 2);
+    tracker.insert(116, trackedRequest(5, 5000));
+    QCOMPARE(tracker.count(), 3);
+    QCOMPARE(tracker.droppedCount(), quint64(1));
+    tracker.remove(116);
+
+    tracker.setSent(108);
+    tracker.setMaxTotalSize(50);
+    QCOMPARE(tracker.count(), 1);
+    QVERIFY(tracker.contains(112));
+    QCOMPARE(tracker.totalSize(), qint64(40));
+    QCOMPARE(tracker.droppedCount(), quint64(2));
+
+    // The queue of the removed ids does not grow
+    tracker.setMaxCount(4096);
+    tracker.setMaxTotalSize(1024 * 1024);
+    for (quint64 id = 1000; id < 100000; id += 4) {
+        tracker.insert(id, trackedRequest(1, 5000));
+        tracker.remove(id);
+    }
+    QCOMPARE(tracker.count(), 1);
+    QCOMPARE(tracker.oldestSentTime(), qint64(0));
+    tracker.setSent(112);
+    QCOMPARE(tracker.oldestSentTime(), qint64(4000));
+}
+
+static QByteArray futureSaltsAnswer(quint64 requestId, quint32 now, const QVector<SFutureSalt> &salts)
+{
+    QByteArray data;
+    CRawStream stream(&data, /* write */ true);
+    stream << quint32(TLValue::FutureSalts);
+    stream << requestId;
+    stream << now;
+    stream << quint32(salts.count());
+    for (const SFutureSalt &salt : salts) {
+        stream << salt.validSince;
+        stream << salt.validUntil;
+        stream << salt.salt;
+    }
+    return data;
+}
+
+void tst_CTelegramConnection::testFutureSalts()
+{
+    CTestConnection connection;
+    connection.setServerSalt(1);
+
+    const quint32 now = QDateTime::currentMSecsSinceEpoch() / 1000;
+    QVector<SFutureSalt> salts = {
+        { now + 1800, now + 5400, 4 },
+        { now - 1800, now + 1800, 3 },
+        { now - 3600, now + 30, 2 }, // Expires within the switch margin
+    };
+    connection.setFutureSalts(salts);
+    QCOMPARE(connection.serverSalt(), quint64(3));
+    QCOMPARE(connection.futureSalts().count(), 2);
+    QCOMPARE(connection.futureSalts().first().salt, quint64(3));
+
+    // The latest valid salt is preferred
+    salts[0].validSince = now - 60;
+    connection.setFutureSalts(salts);
+    QCOMPARE(connection.serverSalt(), quint64(4));
+
+    // Only the answer to the pending request is accepted
+    CAppInformation appInfo;
+    CTestConnection client(&appInfo);
+    LoopbackServer server(&client);
+    QVERIFY(server.connectClient());
+    const quint64 requestId = client.getFutureSalts(1);
+    QCOMPARE(client.futureSaltsRequestId(), requestId);
+    const QVector<SFutureSalt> answerSalts = { { now - 60, now + 3600, 5 } };
+    client.processRpcQuery(futureSaltsAnswer(requestId + 4, now, answerSalts));
+    QVERIFY(client.serverSalt() != quint64(5));
+    QCOMPARE(client.futureSaltsRequestId(), requestId);
+    client.processRpcQuery(futureSaltsAnswer(requestId, now, answerSalts));
+    QCOMPARE(client.serverSalt(), quint64(5));
+    QCOMPARE(client.futureSaltsRequestId(), quint64(0));
+
+    // The request without an answer is forgotten in time, so the salts can be requested again
+    client.getFutureSalts(1);
+    QVERIFY(client.futureSaltsRequestId());
+    client.onFutureSaltsTimeout();
+    QVERIFY(client.futureSaltsRequestId() != requestId);
+    client.processRpcQuery(futureSaltsAnswer(requestId, now, { { now - 60, now + 3600, 6 } }));
+    QCOMPARE(client.serverSalt(), quint64(5));
+}
+
+void tst_CTelegramConnection::testTransportCapture()
+{
+    const QByteArray authKey = testAuthKey();
+    const QByteArray result = QByteArray("The result of an RPC call. ").repeated(4);
+    const QVector<QByteArray> packages = {
+        encryptServerMessage(authKey, 0x2002, 0x3005, rpcResult(0x1001, result, /* packed */ false)),
+        encryptServerMessage(authKey, 0x2002, 0x3009, rpcResult(0x1002, result, /* packed */ true)),
+    };
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    CTransportCapture capture(&buffer);
+    capture.addRecord(CTransportCapture::IncomingPackage, QByteArray(24, char(0))); // Plain message
+    capture.addRecord(CTransportCapture::OutgoingPackage, QByteArray(40, 'o'));
+    capture.addRecord(CTransportCapture::IncomingPackage, packages.at(0));
+    capture.addRecord(CTransportCapture::IncomingPackage, packages.at(1));
+    capture.addRecord(CTransportCapture::IncomingPayload, rpcResult(0x1003, result, /* packed */ false));
+    QCOMPARE(capture.recordsCount(), quint64(5));
+    buffer.close();
+
+    QVector<CTransportCapture::Record> records;
+    buffer.open(QIODevice::ReadOnly);
+    QVERIFY(CTransportCapture::readRecords(&buffer, &records));
+    QCOMPARE(records.count(), 5);
+    QCOMPARE(records.at(1).type, CTransportCapture::OutgoingPackage);
+    QCOMPARE(records.at(1).data, QByteArray(40, 'o'));
+    QCOMPARE(records.at(3).data, packages.at(1));
+
+    // A truncated capture is rejected
+    QVector<CTransportCapture::Record> truncatedRecords;
+    QByteArray truncatedData = buffer.data();
+    truncatedData.chop(1);
+    QBuffer truncatedBuffer(&truncatedData);
+    truncatedBuffer.open(QIODevice::ReadOnly);
+    QVERIFY(!CTransportCapture::readRecords(&truncatedBuffer, &truncatedRecords));
+
+    CTestConnection connection;
+    QCOMPARE(CTransportCapture::replayPackages(records, &connection), 0); // No auth key
+
+    connection.setAuthKey(authKey);
+    QCOMPARE(CTransportCapture::replayPackages(records, &connection), 2);
+    QCOMPARE(connection.sessionId(), quint64(0x2002));
+    QCOMPARE(CTransportCapture::replayPayloads(records, &connection), 1);
+
+    // The replay connection stays passive
+    QVERIFY(connection.authState() < CTelegramConnection::AuthStateHaveAKey);
+    QVERIFY(!connection.pingTimerActive());
+    QCOMPARE(connection.futureSaltsRequestId(), quint64(0));
+
+    // The replayed results reach their handlers
+    int historiesCount = 0;
+    connect(&connection, &CTelegramConnection::messagesHistoryReceived, [&historiesCount](const TLMessagesMessages &history) {
+        if (history.messages.count() == 3) {
+            ++historiesCount;
+        }
+    });
+    TLInputPeer peer;
+    peer.tlType = TLValue::InputPeerSelf;
+    QVector<CTransportCapture::Record> historyRecords(2);
+    historyRecords[0].type = CTransportCapture::IncomingPackage;
+    historyRecords[0].data = encryptServerMessage(authKey, 0x2002, 0x300d,
+                                                  rpcResult(connection.messagesGetHistory(peer, 0, 0, 3, 0, 0), messagesHistory(3), /* packed */ true));
+    historyRecords[1].type = CTransportCapture::IncomingPayload;
+    historyRecords[1].data = rpcResult(connection.messagesGetHistory(peer, 0, 0, 3, 0, 0), messagesHistory(3), /* packed */ false);
+    QCOMPARE(connection.pendingRequestsCount(), 2);
+
+    QCOMPARE(CTransportCapture::replayPackages(historyRecords, &connection), 1);
+    QCOMPARE(historiesCount, 1);
+    QCOMPARE(CTransportCapture::replayPayloads(historyRecords, &connection), 1);
+    QCOMPARE(historiesCount, 2);
+    QCOMPARE(connection.pendingRequestsCount(), 0);
+}
+
+void tst_CTelegramConnection::testMessageIdWindow()
+{
+    CMessageIdWindow window(/* windowSeconds */ 300);
+    const quint64 time = quint64(1500000000) << 32;
+
+    QCOMPARE(window.insert(time + 1), CMessageIdWindow::Accepted);
+    QCOMPARE(window.insert(time + 5), CMessageIdWindow::Accepted);
+    QCOMPARE(window.insert(time + 1), CMessageIdWindow::Duplicate);
+    QVERIFY(window.contains(time + 5));
+    QVERIFY(!window.contains(time + 9));
+    QCOMPARE(window.check(time + 9), CMessageIdWindow::Accepted);
+    QVERIFY(!window.contains(time + 9)); // The check does not insert the id
+
+    // The slot of the same second in the next cycle is reused
+    const quint64 nextCycleTime = time + (quint64(300) << 32);
+    QCOMPARE(window.insert(nextCycleTime + 1), CMessageIdWindow::Accepted);
+    QVERIFY(!window.contains(time + 5));
+    QCOMPARE(window.check(time + 5), CMessageIdWindow::TooOld);
+    QCOMPARE(window.insert(time + 9), CMessageIdWindow::TooOld);
+
+    // The late ids within the window are accepted
+    QCOMPARE(window.insert(nextCycleTime - (quint64(10) << 32) + 3), CMessageIdWindow::Accepted);
+    QCOMPARE(window.droppedCount(), quint64(2));
+
+    window.clear();
+    QCOMPARE(window.insert(time + 1), CMessageIdWindow::Accepted);
+    QCOMPARE(window.droppedCount(), quint64(2));
+}
+
+void tst_CTelegramConnection::testBackpressure()
+{
+    CAppInformation appInfo;
+    CTestConnection connection(&appInfo);
+    LoopbackServer server(&connection);
+    QVERIFY(server.connectClient());
+    connection.setMaxInFlightRequests(0);
+
+    QStringList events;
+    connect(&connection, &CTelegramConnection::backpressureChanged, [&events](bool active, int queuedMessages) {
+        events.append(QString(QLatin1String("backpressure %1 %2")).arg(active).arg(queuedMessages));
+    });
+    connect(&connection, &CTelegramConnection::statusChanged, [&events](CTelegramConnection::ConnectionStatus status) {
+        events.append(QString(QLatin1String("status %1")).arg(status));
+    });
+
+    // The messages are queued till the end of the event loop iteration
+    for (int i = 0; i < 255; ++i) {
+        connection.helpGetConfig();
+    }
+    QVERIFY(!connection.isBackpressureActive());
+    connection.helpGetConfig();
+    QVERIFY(connection.isBackpressureActive());
+    QCOMPARE(events, QStringList({ QLatin1String("backpressure 1 256") }));
+
+    QTRY_VERIFY(!connection.isBackpressureActive());
+    QCOMPARE(events.count(), 2);
+    QCOMPARE(events.last(), QLatin1String("backpressure 0 0"));
+    QVERIFY(server.waitForMessages(1));
+    events.clear();
+
+    // The held requests keep the backpressure till the queue is half drained
+    const int inFlightCount = connection.inFlightRequestsCount();
+    QCOMPARE(inFlightCount, 256);
+    connection.setMaxInFlightRequests(inFlightCount + 100);
+    for (int i = 0; i < 300; ++i) {
+        connection.helpGetConfig();
+    }
+    QVERIFY(connection.isBackpressureActive());
+    QTRY_COMPARE(connection.queuedMessagesCount(), 200);
+    QVERIFY(connection.isBackpressureActive());
+    connection.setMaxInFlightRequests(inFlightCount + 172);
+    QTRY_COMPARE(connection.queuedMessagesCount(), 128);
+    QVERIFY(!connection.isBackpressureActive());
+    QCOMPARE(events, QStringList({ QLatin1String("backpressure 1 256"), QLatin1String("backpressure 0 128") }));
+    events.clear();
+
+    // The queue drained by a disconnection is reported after the status change
+    connection.setMaxInFlightRequests(1);
+    for (int i = 0; i < 128; ++i) {
+        connection.helpGetConfig();
+    }
+    QVERIFY(connection.isBackpressureActive());
+    server.transport()->disconnectFromHost();
+    QCOMPARE(connection.status(), CTelegramConnection::ConnectionStatusDisconnected);
+    QVERIFY(!connection.isBackpressureActive());
+    QCOMPARE(events, QStringList({
+                                     QLatin1String("backpressure 1 256"),
+                                     QString(QLatin1String("status %1")).arg(CTelegramConnection::ConnectionStatusDisconnected),
+                                     QLatin1String("backpressure 0 0"),
+                                 }));
+}
+
+void tst_CTelegramConnection::testRequestsHolding()
+{
+    CAppInformation appInfo;
+    CTestConnection connection(&appInfo);
+    LoopbackServer server(&connection);
+    QVERIFY(server.connectClient());
+    connection.setMaxInFlightRequests(8);
+    connection.setRequestTimeout(1);
+
+    for (int i = 0; i < 20; ++i) {
+        connection.helpGetConfig();
+    }
+    QTRY_COMPARE(connection.inFlightRequestsCount(), 8);
+    QCOMPARE(connection.queuedMessagesCount(), 12);
+    QCOMPARE(connection.pendingRequestsCount(), 20);
+
+    // Only the sent requests expire, the held ones take the freed room
+    QTRY_COMPARE(connection.expiredRequestsCount(), quint64(8));
+    QCOMPARE(connection.pendingRequestsCount(), 12);
+    QTRY_COMPARE(connection.queuedMessagesCount(), 4);
+    QCOMPARE(connection.inFlightRequestsCount(), 8);
+    QVERIFY(connection.oldestPendingRequestAge() < 1000);
+
+    // The held requests would never be sent, so they fail on the disconnection; the sent ones expire as usual
+    int failedCount = 0;
+    connect(&connection, &CTelegramConnection::requestFailed, [&failedCount]() {
+        ++failedCount;
+    });
+    server.transport()->disconnectFromHost();
+    QCOMPARE(connection.status(), CTelegramConnection::ConnectionStatusDisconnected);
+    QCOMPARE(failedCount, 4);
+    QCOMPARE(connection.queuedMessagesCount(), 0);
+    QCOMPARE(connection.pendingRequestsCount(), 8);
+    QTRY_COMPARE(connection.pendingRequestsCount(), 0);
+    QCOMPARE(failedCount, 12);
+}
+
+void tst_CTelegramConnection::testRequestFailure()
+{
+    CAppInformation appInfo;
+    CTestConnection connection(&appInfo);
+    LoopbackServer server(&connection);
+    QVERIFY(server.connectClient());
+    connection.setRequestTimeout(1);
+
+    QVector<QPair<quint64, quint32> > failedRequests;
+    connect(&connection, &CTelegramConnection::requestFailed, [&](quint64 requestId, quint32 fileRequestId) {
+        failedRequests.append(qMakePair(requestId, fileRequestId));
+    });
+
+    TLInputFileLocation location;
+    location.tlType = TLValue::InputFileLocation;
+    connection.downloadFile(location, 0, 1024, 42);
+    const quint64 configRequestId = connection.helpGetConfig();
+
+    // The expired requests are reported along with the file request id, if any
+    QTRY_COMPARE(failedRequests.count(), 2);
+    QCOMPARE(connection.expiredRequestsCount(), quint64(2));
+    QCOMPARE(connection.pendingRequestsCount(), 0);
+    QVERIFY(failedRequests.removeOne(qMakePair(configRequestId, quint32(0))));
+    QCOMPARE(failedRequests.first().second, quint32(42));
+}
+
+void tst_CTelegramConnection::testRttSampleExcludesQueueTime()
+{
+    CAppInformation appInfo;
+    CTestConnection connection(&appInfo);
+    LoopbackServer server(&connection);
+    QVERIFY(server.connectClient());
+    server.transport()->setLatency(50);
+    server.clientTransport()->setLatency(50);
+
+    // The second request is held in the queue by the in-flight limit
+    connection.setMaxInFlightRequests(1);
+    connection.helpGetConfig();
+    const quint64 heldRequestId = connection.helpGetConfig();
+    QVERIFY(server.waitForMessages(1));
+    QTest::qWait(500);
+    QCOMPARE(connection.queuedMessagesCount(), 1);
+
+    connection.setMaxInFlightRequests(2);
+    QVERIFY(server.waitForMessages(2));
+    QCOMPARE(server.takeMessages().last().messageId, heldRequestId);
+    server.sendMessage(rpcResult(heldRequestId, QByteArray(16, char(0)), /* packed */ false));
+    QTRY_VERIFY(connection.smoothedRtt() > 0);
+    QVERIFY(connection.smoothedRtt() >= 100);
+    QVERIFY(connection.smoothedRtt() < 400);
+}
+
+void tst_CTelegramConnection::testContainerResend()
+{
+    CAppInformation appInfo;
+    CTestConnection connection(&appInfo);
+    LoopbackServer server(&connection);
+    QVERIFY(server.connectClient());
+
+    QVector<quint64> requestIds;
+    for (int i = 0; i < 3; ++i) {
+        requestIds.append(connection.helpGetConfig());
+    }
+    QVERIFY(server.waitForMessages(1));
+    const CPackageDecoder::Message container = server.takeMessages().first();
+    const QVector<CPackageDecoder::Message> items = containerMessages(container.payload);
+    QCOMPARE(items.count(), 3);
+
+    quint64 lastId = 0;
+    quint32 lastSequence = 0;
+    for (int i = 0; i < items.count(); ++i) {
+        QCOMPARE(items.at(i).messageId, requestIds.at(i));
+        QVERIFY(items.at(i).sequence & 1);
+        QVERIFY(items.at(i).sequence > lastSequence);
+        lastId = items.at(i).messageId;
+        lastSequence = items.at(i).sequence;
+    }
+
+    // The server has not received the container
+    QByteArray notification;
+    CRawStream notificationStream(&notification, /* write */ true);
+    notificationStream << quint32(TLValue::BadMsgNotification);
+    notificationStream << container.messageId;
+    notificationStream << container.sequence;
+    notificationStream << quint32(16); // Id too low
+    server.sendMessage(notification);
+
+    QVERIFY(server.waitForMessages(1));
+    const CPackageDecoder::Message resentContainer = server.takeMessages().first();
+    QVector<CPackageDecoder::Message> resentItems;
+    for (const CPackageDecoder::Message &item : containerMessages(resentContainer.payload)) {
+        if (TLValue::firstFromArray(item.payload) == TLValue::HelpGetConfig) {
+            resentItems.append(item);
+        }
+    }
+    QCOMPARE(resentItems.count(), 3);
+    for (const CPackageDecoder::Message &item : resentItems) {
+        QVERIFY(!requestIds.contains(item.messageId));
+        QVERIFY(item.messageId > lastId);
+        QVERIFY(item.sequence & 1);
+        QVERIFY(item.sequence > lastSequence);
+        lastId = item.messageId;
+        lastSequence = item.sequence;
+    }
+    QCOMPARE(connection.pendingRequestsCount(), 3);
+}
+
+void tst_CTelegramConnection::testMessagesStateInfo()
+{
+    CAppInformation appInfo;
+    CTestConnection connection(&appInfo);
+    LoopbackServer server(&connection);
+    QVERIFY(server.connectClient());
+
+    const quint64 lostRequestId = connection.helpGetConfig();
+    const quint64 receivedRequestId = connection.helpGetConfig();
+    QVERIFY(server.waitForMessages(1));
+    const quint32 lastSequence = containerMessages(server.takeMessages().first().payload).last().sequence;
+
+    const quint64 stateRequestId = connection.requestMessagesState(TLVector<quint64>({ lostRequestId, receivedRequestId }));
+    QVERIFY(server.waitForMessages(1));
+    QCOMPARE(server.takeMessages().first().messageId, stateRequestId);
+
+    QByteArray info;
+    CRawStreamEx infoStream(&info, /* write */ true);
+    infoStream << quint32(TLValue::MsgsStateInfo);
+    infoStream << stateRequestId;
+    infoStream << QByteArray("\x02\x04"); // Not received, received
+    server.sendMessage(info);
+
+    QVERIFY(server.waitForMessages(1));
+    CPackageDecoder::Message resentRequest;
+    for (const CPackageDecoder::Message &item : packageMessages(server.takeMessages().first())) {
+        if (TLValue::firstFromArray(item.payload) == TLValue::HelpGetConfig) {
+            resentRequest = item;
+        }
+    }
+    QVERIFY(resentRequest.messageId > stateRequestId);
+    QVERIFY(resentRequest.sequence & 1);
+    QVERIFY(resentRequest.sequence > lastSequence);
+    QCOMPARE(connection.recoveredRequestsCount(), quint64(1));
+
+    QVERIFY(!connection.requestTracker().contains(lostRequestId));
+    QCOMPARE(connection.requestTracker().request(resentRequest.messageId)->retries, 1);
+    QCOMPARE(connection.requestTracker().request(receivedRequestId)->stateCheckTime, qint64(0));
+
+    // The result of the resent request is not used as an RTT sample
+    server.sendMessage(rpcResult(resentRequest.messageId, QByteArray(16, char(0)), /* packed */ false));
+    QTRY_COMPARE(connection.pendingRequestsCount(), 1);
+    QCOMPARE(connection.smoothedRtt(), qint64(0));
+}
+
+static QVector<TLValue> messageTypes(const CPackageDecoder::Message &package)
+{
+    QVector<TLValue> types;
+    for (const CPackageDecoder::Message &item : packageMessages(package)) {
+        types.append(TLValue::firstFromArray(item.payload));
+    }
+    return types;
+}
+
+void tst_CTelegramConnection::testPongTimeoutLiveness()
+{
+    CAppInformation appInfo;
+    CTestConnection connection(&appInfo);
+    LoopbackServer server(&connection);
+    QVERIFY(server.connectClient());
+
+    const auto waitForPing = [&server]() {
+        for (int i = 0; i < 10; ++i) {
+            if (!server.waitForMessages(1)) {
+                return false;
+            }
+            for (const CPackageDecoder::Message &package : server.takeMessages()) {
+                if (messageTypes(package).contains(TLValue::PingDelayDisconnect)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+
+    connection.setKeepAliveSettings(200, 100);
+    QVERIFY(connection.pongTimeout() > 200);
+    QVERIFY(waitForPing());
+    QVERIFY(connection.pongTimerActive());
+
+    // A late pong for an older ping proves the connection liveness as well
+    QByteArray pong;
+    CTelegramStream pongStream(&pong, /* write */ true);
+    pongStream << TLValue::Pong;
+    pongStream << quint64(0);
+    pongStream << quint64(0x42);
+    server.sendMessage(pong);
+    QTRY_VERIFY(!connection.pongTimerActive());
+
+    // The next ping restarts the timer and any other message stops it
+    QVERIFY(waitForPing());
+    QVERIFY(connection.pongTimerActive());
+    QByteArray ack;
+    CTelegramStream ackStream(&ack, /* write */ true);
+    ackStream << TLValue::MsgsAck;
+    ackStream << TLVector<quint64>();
+    server.sendMessage(ack);
+    QTRY_VERIFY(!connection.pongTimerActive());
+    QVERIFY(connection.status() >= CTelegramConnection::ConnectionStatusConnected);
+}
+
+void tst_CTelegramConnection::testPriorityOrder()
+{
+    CAppInformation appInfo;
+    CTestConnection connection(&appInfo);
+    LoopbackServer server(&connection);
+    QVERIFY(server.connectClient());
+
+    // The messages are queued in the reversed priority order
+    connection.uploadGetFile(TLInputFileLocation(), 0, 1024);
+    connection.messagesGetDialogs(0, 0, TLInputPeer(), 10);
+    connection.helpGetConfig();
+    connection.ping();
+    QCOMPARE(connection.queuedMessagesCount(), 4);
+
+    QVERIFY(server.waitForMessages(1));
+    QTest::qWait(50);
+    const QVector<CPackageDecoder::Message> packages = server.takeMessages();
+    QCOMPARE(packages.count(), 1);
+    QCOMPARE(messageTypes(packages.first()), QVector<TLValue>({
+                                                                  TLValue::Ping,
+                                                                  TLValue::HelpGetConfig,
+                                                                  TLValue::MessagesGetDialogs,
+                                                                  TLValue::UploadGetFile,
+                                                              }));
+    QCOMPARE(connection.releasedMessagesCount(CTelegramConnection::PriorityControl), quint64(2)); // And get_future_salts
+    QCOMPARE(connection.releasedMessagesCount(CTelegramConnection::PriorityBulk), quint64(1));
+}
+
+void tst_CTelegramConnection::testPriorityByteBudget()
+{
+    CAppInformation appInfo;
+    CTestConnection connection(&appInfo);
+    LoopbackServer server(&connection);
+    QVERIFY(server.connectClient());
+    connection.setGzipPackingThreshold(0);
+
+    // Five file parts fit into the bulk budget per flush
+    const QByteArray filePart(12 * 1024, 'f');
+    for (int i = 0; i < 6; ++i) {
+        connection.uploadSaveFilePart(1, i, filePart);
+    }
+    QVERIFY(server.waitForMessages(2));
+    const QVector<CPackageDecoder::Message> packages = server.takeMessages();
+    QCOMPARE(packages.count(), 2);
+    QCOMPARE(messageTypes(packages.at(0)), QVector<TLValue>(5, TLValue::UploadSaveFilePart));
+    QCOMPARE(messageTypes(packages.at(1)), QVector<TLValue>({ TLValue::UploadSaveFilePart }));
+    QCOMPARE(connection.queuedMessagesCount(), 0);
+}
+
+void tst_CTelegramConnection::testBulkReleaseGating()
+{
+    CAppInformation appInfo;
+    CTestConnection connection(&appInfo);
+    BufferedLoopbackTransport *transport = new BufferedLoopbackTransport(&connection);
+    LoopbackServer server(&connection, transport);
+    QVERIFY(server.connectClient());
+
+    // The bulk messages wait for the transport buffer to drain
+    transport->setBytesToWrite(32 * 1024);
+    connection.uploadGetFile(TLInputFileLocation(), 0, 1024);
+    connection.helpGetConfig();
+    QVERIFY(server.waitForMessages(1));
+    QTest::qWait(50);
+    QCOMPARE(server.messagesCount(), 1);
+    QCOMPARE(messageTypes(server.takeMessages().first()), QVector<TLValue>({ TLValue::HelpGetConfig }));
+    QCOMPARE(connection.queuedMessagesCount(), 1);
+
+    // The written bytes notification releases the bulk messages
+    transport->setBytesToWrite(1024);
+    emit transport->bytesWritten(31 * 1024);
+    QVERIFY(server.waitForMessages(1));
+    QCOMPARE(messageTypes(server.takeMessages().first()), QVector<TLValue>({ TLValue::UploadGetFile }));
+    QCOMPARE(connection.queuedMessagesCount(), 0);
+}
+
+void tst_CTelegramConnection::testContainerFormat()
+{
+    CAppInformation appInfo;
+    CTestConnection connection(&appInfo);
+    LoopbackServer server(&connection);
+    QVERIFY(server.connectClient());
+    connection.setMaxInFlightRequests(0);
+
+    QVector<quint64> requestIds;
+    for (int i = 0; i < 3; ++i) {
+        requestIds.append(connection.helpGetConfig());
+    }
+    QVERIFY(server.waitForMessages(1));
+    const CPackageDecoder::Message container = server.takeMessages().first();
+    QCOMPARE(TLValue::firstFromArray(container.payload), TLValue::MsgContainer);
+
+    // Type, count and the items with the id, sequence number and length headers
+    QByteArray helpGetConfigData;
+    CRawStream helpGetConfigStream(&helpGetConfigData, /* write */ true);
+    helpGetConfigStream << quint32(TLValue::HelpGetConfig);
+    const QVector<CPackageDecoder::Message> items = containerMessages(container.payload);
+    QCOMPARE(items.count(), 3);
+    QCOMPARE(container.payload.size(), 8 + 3 * (16 + helpGetConfigData.size()));
+    for (int i = 0; i < items.count(); ++i) {
+        QCOMPARE(items.at(i).messageId, requestIds.at(i));
+        QCOMPARE(items.at(i).payload, helpGetConfigData);
+    }
+
+    // The container is not content-related and its id is greater than the ids of the items
+    QVERIFY(container.messageId > requestIds.last());
+    QCOMPARE(container.sequence, items.last().sequence + 1);
+    QCOMPARE(connection.sentContainersCount(), 1);
+
+    // Only the latest containers are remembered for a resend
+    for (int i = 0; i < 70; ++i) {
+        connection.helpGetConfig();
+        connection.helpGetConfig();
+        QVERIFY(server.waitForMessages(1));
+        server.takeMessages();
+    }
+    QCOMPARE(connection.sentContainersCount(), 64);
+}
+
+// The ids of msgs_ack or msg_resend_req
+static QVector<quint64> messageIds(const QByteArray &payload)
+{
+    CRawStream stream(payload);
+    quint32 type = 0;
+    quint32 count = 0;
+    stream >> type; // msgs_ack or msg_resend_req
+    stream >> type; // Vector
+    stream >> count;
+    QVector<quint64> ids(count);
+    for (quint64 &id : ids) {
+        stream >> id;
+    }
+    return ids;
+}
+
+void tst_CTelegramConnection::testAckPiggybacking()
+{
+    CAppInformation appInfo;
+    CTestConnection connection(&appInfo);
+    LoopbackServer server(&connection);
+    QVERIFY(server.connectClient());
+
+    QVector<quint64> requestIds;
+    for (int i = 0; i < 9; ++i) {
+        requestIds.append(connection.helpGetConfig());
+    }
+    QVERIFY(server.waitForMessages(1));
+    server.takeMessages();
+
+    // The results are acknowledged along with the next outgoing message
+    for (int i = 0; i < 2; ++i) {
+        server.sendMessage(rpcResult(requestIds.at(i), QByteArray(16, char(0)), /* packed */ false));
+    }
+    QTRY_COMPARE(connection.pendingRequestsCount(), 7);
+    QTest::qWait(50);
+    QCOMPARE(server.messagesCount(), 0);
+
+    const quint64 requestId = connection.helpGetConfig();
+    QVERIFY(server.waitForMessages(1));
+    const CPackageDecoder::Message container = server.takeMessages().first();
+    const QVector<CPackageDecoder::Message> items = containerMessages(container.payload);
+    QCOMPARE(items.count(), 2);
+    QCOMPARE(items.at(0).messageId, requestId);
+    QCOMPARE(TLValue::firstFromArray(items.at(1).payload), TLValue::MsgsAck);
+    QCOMPARE(messageIds(items.at(1).payload).count(), 2);
+    QVERIFY(!(items.at(1).sequence & 1));
+    QCOMPARE(connection.savedAckPackagesCount(), quint64(1));
+
+    // Without outgoing traffic the acks are sent on overflow
+    for (int i = 2; i < 9; ++i) {
+        server.sendMessage(rpcResult(requestIds.at(i), QByteArray(16, char(0)), /* packed */ false));
+    }
+    QVERIFY(server.waitForMessages(1));
+    const CPackageDecoder::Message ack = server.takeMessages().first();
+    QCOMPARE(TLValue::firstFromArray(ack.payload), TLValue::MsgsAck);
+    QCOMPARE(messageIds(ack.payload).count(), 7);
+    QCOMPARE(connection.savedAckPackagesCount(), quint64(1));
+}
+
+void tst_CTelegramConnection::testMessageNewDetailedInfo()
+{
+    CAppInformation appInfo;
+    CTestConnection connection(&appInfo);
+    LoopbackServer server(&connection);
+    QVERIFY(server.connectClient());
+
+    const quint64 currentTime = QDateTime::currentMSecsSinceEpoch() / 1000;
+    const quint64 unknownAnswerId = (currentTime << 32) | 0x10001;
+    const quint64 tooOldAnswerId = ((currentTime - 400) << 32) | 1;
+    for (const quint64 answerId : { unknownAnswerId, tooOldAnswerId }) {
+        QByteArray info;
+        CRawStream infoStream(&info, /* write */ true);
+        infoStream << quint32(TLValue::MsgNewDetailedInfo);
+        infoStream << answerId;
+        infoStream << quint32(128); // Bytes
+        infoStream << quint32(0); // Status
+        server.sendMessage(info);
+    }
+
+    // The unknown answer is requested again and the answer older than the window is acknowledged
+    QVERIFY(server.waitForMessages(1));
+    QVector<quint64> resendIds;
+    QVector<quint64> ackIds;
+    for (const CPackageDecoder::Message &item : packageMessages(server.takeMessages().first())) {
+        const TLValue type = TLValue::firstFromArray(item.payload);
+        if (type == TLValue::MsgResendReq) {
+            resendIds += messageIds(item.payload);
+        } else if (type == TLValue::MsgsAck) {
+            ackIds += messageIds(item.payload);
+        }
+    }
+    QCOMPARE(resendIds, QVector<quint64>({ unknownAnswerId }));
+    QCOMPARE(ackIds, QVector<quint64>({ tooOldAnswerId }));
 }
 
 QTEST_MAIN(tst_CTelegramConnection)
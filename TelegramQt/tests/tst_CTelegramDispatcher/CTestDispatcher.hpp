@@ -29,6 +29,8 @@ public:
     void testProcessUpdate(const TLUpdate &update);
     void testSetDcConfiguration(const QVector<TLDcOption> newDcConfiguration);
     QVector<TLDcOption> testGetDcConfiguration() const { return m_dcConfiguration; }
+    MessageProjection testMessageProjection() const { return m_messageProjection; }
+    quint32 testDecodedMessageFields() const { return m_decodedMessageFields; }
 
 };
 
@@ -18,8 +18,16 @@
 #include <QObject>
 
 #include "CTestDispatcher.hpp"
+#include "CAppInformation.hpp"
+#include "CLoopbackTransport.hpp"
+#include "CTelegramConnection.hpp"
+#include "CTelegramMediaModule.hpp"
+#include "CRawStream.hpp"
+#include "Utils.hpp"
 
 #include <QBuffer>
+#include <QDateTime>
+#include <QSignalSpy>
 #include <QTest>
 #include <QDebug>
 
@@ -31,6 +39,9 @@ public:
 
 private slots:
     void testUpdateDcOptions();
+    void testMessageProjection();
+    void testTransportFactory();
+    void testSecretInfo();
 
 };
 
@@ -99,6 +110,124 @@ void tst_CTelegramDispatcher::testUpdateDcOptions()
     }
 }
 
+class CEntitiesModule : public CTelegramModule
+{
+public:
+    quint32 requiredMessageFields() const override { return TLMessage::FieldEntities; }
+};
+
+void tst_CTelegramDispatcher::testMessageProjection()
+{
+    CTelegramMediaModule mediaModule;
+    CEntitiesModule entitiesModule;
+    CTestDispatcher dispatcher;
+    dispatcher.plugModule(&mediaModule);
+
+    // All the types are acceptable by default, so the media is decoded
+    const MessageProjection mediaProjection = dispatcher.testMessageProjection();
+    QVERIFY(mediaProjection);
+    QVERIFY(dispatcher.testDecodedMessageFields() & TLMessage::FieldMedia);
+
+    // The media module needs no media if the text messages are the only acceptable ones
+    dispatcher.setAcceptableMessageTypes(TelegramNamespace::MessageTypeText);
+    const MessageProjection textProjection = dispatcher.testMessageProjection();
+    QVERIFY(textProjection);
+    QVERIFY(textProjection != mediaProjection);
+    QVERIFY(dispatcher.testDecodedMessageFields() & TLMessage::FieldMessage);
+    QVERIFY(!(dispatcher.testDecodedMessageFields() & TLMessage::FieldMedia));
+
+    dispatcher.setAcceptableMessageTypes(TelegramNamespace::MessageTypeText | TelegramNamespace::MessageTypePhoto);
+    QVERIFY(dispatcher.testMessageProjection() == mediaProjection);
+
+    // No projection has the entities, so the messages are decoded in full
+    dispatcher.plugModule(&entitiesModule);
+    QVERIFY(!dispatcher.testMessageProjection());
+    QCOMPARE(dispatcher.testDecodedMessageFields(), quint32(TLMessage::FieldAll));
+}
+
+void tst_CTelegramDispatcher::testTransportFactory()
+{
+    CTestDispatcher dispatcher;
+    CLoopbackTransport serverTransport;
+    CTelegramConnection *factoryConnection = nullptr;
+    CLoopbackTransport *clientTransport = nullptr;
+    dispatcher.setTransportFactory([&](CTelegramConnection *connection) {
+        factoryConnection = connection;
+        clientTransport = new CLoopbackTransport(connection);
+        CLoopbackTransport::connectPeers(clientTransport, &serverTransport);
+        return clientTransport;
+    });
+
+    CTelegramConnection *connection = dispatcher.createConnection(constructDcOption(2, QLatin1String("149.154.167.51"), 443));
+    QVERIFY(connection);
+    QCOMPARE(factoryConnection, connection);
+    QCOMPARE(connection->transport(), static_cast<CTelegramTransport *>(clientTransport));
+    QCOMPARE(connection->dcInfo().id, quint32(2));
+
+    // The connection talks through the transport of the factory
+    QSignalSpy serverPackagesSpy(&serverTransport, &CTelegramTransport::packageReceived);
+    connection->connectToDc();
+    QTRY_COMPARE(clientTransport->state(), QAbstractSocket::ConnectedState);
+    QTRY_VERIFY(serverPackagesSpy.count() > 0);
+
+    connection->disconnectFromDc();
+    delete connection;
+}
+
+void tst_CTelegramDispatcher::testSecretInfo()
+{
+    QByteArray authKey(256, Qt::Uninitialized);
+    for (int i = 0; i < authKey.size(); ++i) {
+        authKey[i] = char(i * 7 + 3);
+    }
+    const quint32 now = QDateTime::currentMSecsSinceEpoch() / 1000;
+    // The salts are not valid yet, so the saved server salt is kept in use
+    const QVector<SFutureSalt> futureSalts = {
+        { now + 3600, now + 7200, 0x1002 },
+        { now + 7200, now + 10800, 0x1003 },
+    };
+
+    // Format v5
+    QByteArray secret;
+    CRawStreamEx stream(&secret, /* write */ true);
+    stream << quint32(5);
+    stream << qint32(-12); // Delta time
+    stream << quint32(2); // DC id
+    stream << QByteArray("149.154.167.51");
+    stream << quint32(443);
+    stream << authKey;
+    stream << Telegram::Utils::getFingerprints(authKey, Telegram::Utils::Lower64Bits);
+    stream << quint64(0x1001); // Server salt
+    stream << quint32(10) << quint32(20) << quint32(30); // Updates state
+    stream << quint32(0); // Dialogs count
+    stream << quint32(futureSalts.count());
+    for (const SFutureSalt &salt : futureSalts) {
+        stream << salt.validSince;
+        stream << salt.validUntil;
+        stream << salt.salt;
+    }
+
+    CAppInformation appInfo;
+    CTestDispatcher dispatcher;
+    dispatcher.setAppInformation(&appInfo);
+    CLoopbackTransport serverTransport;
+    dispatcher.setTransportFactory([&](CTelegramConnection *connection) {
+        CLoopbackTransport *transport = new CLoopbackTransport(connection);
+        CLoopbackTransport::connectPeers(transport, &serverTransport);
+        return transport;
+    });
+
+    QVERIFY(dispatcher.connectionSecretInfo().isEmpty()); // No connection
+    QVERIFY(!dispatcher.setSecretInfo(QByteArray::fromHex("06000000"))); // Unknown format
+    QVERIFY(dispatcher.setSecretInfo(secret));
+
+    // The restored session is saved as is
+    QVERIFY(dispatcher.connectToServer());
+    QCOMPARE(dispatcher.connectionSecretInfo(), secret);
+
+    dispatcher.disconnectFromServer();
+}
+
 QTEST_MAIN(tst_CTelegramDispatcher)
 
 #include "tst_CTelegramDispatcher.moc"
@@ -18,8 +18,11 @@
 #include <QObject>
 
 #include "CTelegramStream_p.hpp"
+#include "CPackageDecoder.hpp"
+#include "CTransportCapture.hpp"
 
 #include <QBuffer>
+#include <QFile>
 #include <QTest>
 #include <QDebug>
 
@@ -47,6 +50,19 @@ private slots:
     void tlNumbersSerialization();
     void tlDcOptionDeserialization();
     void readError();
+    void bytesView();
+    void spanWrite();
+    void serializedSize();
+    void skipValues();
+    void messageProjection();
+    void benchmarkRead_data();
+    void benchmarkRead();
+    void benchmarkReadDcOptions_data();
+    void benchmarkReadDcOptions();
+    void benchmarkWrite_data();
+    void benchmarkWrite();
+    void benchmarkMessagesDecoding_data();
+    void benchmarkMessagesDecoding();
 
 };
 
@@ -522,6 +538,505 @@ void tst_CTelegramStream::readError()
 
 }
 
+void tst_CTelegramStream::bytesView()
+{
+    static const char input[16] = { char(4), 'v', 'i', 'e', 'w', 0, 0, 0, 0x11, 0x22, 0x33, 0x44, 'a', 'b', 'c', 'd' };
+    const QByteArray data(input, sizeof(input));
+
+    CTelegramStream stream(data);
+
+    const QByteArray bytes = stream.readSerializedBytesView();
+    QCOMPARE(bytes, QByteArray("view"));
+    QCOMPARE(bytes.constData(), data.constData() + 1); // No copy
+
+    quint32 value;
+    stream >> value;
+    QCOMPARE(value, quint32(0x44332211));
+
+    const QByteArray rawBytes = stream.readBytesView(4);
+    QCOMPARE(rawBytes, QByteArray("abcd"));
+    QCOMPARE(rawBytes.constData(), data.constData() + 12);
+    QVERIFY(!stream.error());
+    QVERIFY(stream.atEnd());
+
+    stream.readBytesView(1);
+    QVERIFY2(stream.error(), "Read after the end should be an error.");
+}
+
+void tst_CTelegramStream::spanWrite()
+{
+    QByteArray data("prefix");
+    CTelegramStream stream(&data, /* write */ true);
+    stream << quint32(0x44332211);
+    stream << QByteArray("view");
+    stream << QString();
+    QCOMPARE(data, QByteArray("prefix\x11\x22\x33\x44\x04view\0\0\0\0\0\0\0", 22));
+    QCOMPARE(stream.getData(), data);
+    QVERIFY(!stream.error());
+
+    CTelegramStream writeOnlyStream(CTelegramStream::WriteOnly, 16);
+    writeOnlyStream << quint64(1) << QByteArray("data");
+    QCOMPARE(writeOnlyStream.getData(), QByteArray("\x01\0\0\0\0\0\0\0\x04" "data\0\0\0", 16));
+}
+
+void tst_CTelegramStream::serializedSize()
+{
+    TLInputPeer peer;
+    peer.tlType = TLValue::InputPeerUser;
+    peer.userId = 123;
+    peer.accessHash = 456;
+
+    TLMessageEntity entity;
+    entity.tlType = TLValue::MessageEntityTextUrl;
+    entity.url = QStringLiteral("https://example.org/\u00e9\u4e2d");
+
+    TLVector<TLMessageEntity> entities;
+    entities << entity << entity;
+
+    const QString text = QStringLiteral("\u00e9\u4e2d text").repeated(40); // Longer than 254 bytes
+
+    QByteArray data;
+    CTelegramStream stream(&data, /* write */ true);
+    stream << peer;
+    QCOMPARE(CTelegramStream::serializedSize(peer), quint32(data.size()));
+
+    data.clear();
+    stream << entities;
+    QCOMPARE(CTelegramStream::serializedSize(entities), quint32(data.size()));
+
+    data.clear();
+    stream << text;
+    QCOMPARE(CTelegramStream::serializedSize(text), quint32(data.size()));
+
+    data.clear();
+    stream << QByteArray(3, 'x');
+    QCOMPARE(CTelegramStream::serializedSize(QByteArray(3, 'x')), quint32(data.size()));
+}
+
+static TLVector<TLDcOption> benchmarkDcOptions()
+{
+    TLVector<TLDcOption> options;
+    for (int i = 0; i < 2048; ++i) {
+        TLDcOption option;
+        option.flags = i & 3;
+        option.id = i % 5 + 1;
+        option.ipAddress = QStringLiteral("149.154.%1.%2").arg(i % 256).arg(i / 8);
+        option.port = 443;
+        options.append(option);
+    }
+    return options;
+}
+
+// Unwraps the objects from the containers and the RPC results
+static void appendCapturedObjects(const QByteArray &payload, QVector<QByteArray> *objects)
+{
+    CRawStream stream(payload);
+    quint32 value = 0;
+    stream >> value;
+    switch (value) {
+    case TLValue::MsgContainer: {
+        quint32 count = 0;
+        stream >> count;
+        for (quint32 i = 0; (i < count) && !stream.error(); ++i) {
+            quint64 id;
+            quint32 seqNo;
+            quint32 size;
+            stream >> id;
+            stream >> seqNo;
+            stream >> size;
+            appendCapturedObjects(stream.readBytes(size), objects);
+        }
+        break;
+    }
+    case TLValue::RpcResult:
+        appendCapturedObjects(payload.mid(4 + 8), objects);
+        break;
+    default:
+        objects->append(payload);
+        break;
+    }
+}
+
+template <typename T>
+static bool readCapturedObject(CTelegramStream &stream)
+{
+    T object;
+    stream >> object;
+    return object.isValid() && !stream.error();
+}
+
+// Reads the object if its type is known without the request
+static bool readCapturedObject(CTelegramStream &stream, TLValue type)
+{
+    switch (type) {
+    case TLValue::UpdatesTooLong:
+    case TLValue::UpdateShortMessage:
+    case TLValue::UpdateShortChatMessage:
+    case TLValue::UpdateShortSentMessage:
+    case TLValue::UpdateShort:
+    case TLValue::UpdatesCombined:
+    case TLValue::Updates:
+        return readCapturedObject<TLUpdates>(stream);
+    case TLValue::UpdatesDifferenceEmpty:
+    case TLValue::UpdatesDifference:
+    case TLValue::UpdatesDifferenceSlice:
+        return readCapturedObject<TLUpdatesDifference>(stream);
+    case TLValue::UpdatesState:
+        return readCapturedObject<TLUpdatesState>(stream);
+    case TLValue::MessagesMessages:
+    case TLValue::MessagesMessagesSlice:
+    case TLValue::MessagesChannelMessages:
+        return readCapturedObject<TLMessagesMessages>(stream);
+    case TLValue::MessagesDialogs:
+    case TLValue::MessagesDialogsSlice:
+        return readCapturedObject<TLMessagesDialogs>(stream);
+    case TLValue::MessagesChats:
+        return readCapturedObject<TLMessagesChats>(stream);
+    case TLValue::MessagesChatFull:
+        return readCapturedObject<TLMessagesChatFull>(stream);
+    case TLValue::ContactsContactsNotModified:
+    case TLValue::ContactsContacts:
+        return readCapturedObject<TLContactsContacts>(stream);
+    case TLValue::UserFull:
+        return readCapturedObject<TLUserFull>(stream);
+    case TLValue::AuthAuthorization:
+        return readCapturedObject<TLAuthAuthorization>(stream);
+    case TLValue::Config:
+        return readCapturedObject<TLConfig>(stream);
+    case TLValue::NearestDc:
+        return readCapturedObject<TLNearestDc>(stream);
+    case TLValue::UploadFile:
+        return readCapturedObject<TLUploadFile>(stream);
+    default:
+        return false;
+    }
+}
+
+// The objects of TELEGRAMQT_BENCHMARK_CAPTURE (see CTransportCapture) payloads, which types are known without the request
+static QVector<QByteArray> benchmarkCapturedObjects(QString *fileName)
+{
+    QVector<QByteArray> objects;
+    *fileName = QString::fromLocal8Bit(qgetenv("TELEGRAMQT_BENCHMARK_CAPTURE"));
+    if (fileName->isEmpty()) {
+        return objects;
+    }
+    QFile file(*fileName);
+    QVector<CTransportCapture::Record> records;
+    if (!file.open(QIODevice::ReadOnly) || !CTransportCapture::readRecords(&file, &records)) {
+        qWarning() << "Unable to read the capture" << *fileName;
+        return objects;
+    }
+    QVector<QByteArray> capturedObjects;
+    for (const CTransportCapture::Record &record : records) {
+        if (record.type == CTransportCapture::IncomingPayload) {
+            appendCapturedObjects(CPackageDecoder::unpackGzipPayloads(record.data), &capturedObjects);
+        }
+    }
+    for (const QByteArray &object : capturedObjects) {
+        CTelegramStream stream(object);
+        if (readCapturedObject(stream, TLValue::firstFromArray(object))) {
+            objects.append(object);
+        }
+    }
+    return objects;
+}
+
+void tst_CTelegramStream::skipValues()
+{
+    static const quint32 marker = 0xdeadbeef;
+
+    QByteArray data;
+    CTelegramStream stream(&data, /* write */ true);
+    stream << TLValue::Vector;
+    stream << quint32(2);
+    for (int i = 0; i < 2; ++i) {
+        stream << TLValue::Message;
+        stream << quint32(TLMessage::FromId);
+        stream << quint32(1000 + i); // id
+        stream << quint32(12345); // from_id
+        stream << TLValue::PeerUser;
+        stream << quint32(54321); // user_id
+        stream << quint32(1500000000 + i); // date
+        stream << QString(300, QLatin1Char('a' + i)); // long enough for the four bytes length
+    }
+    stream << marker;
+
+    CTelegramStream skipStream(data);
+    skipStream.skip<TLVector<TLMessage> >();
+    quint32 value = 0;
+    skipStream >> value;
+    QCOMPARE(value, marker);
+    QVERIFY(skipStream.atEnd());
+    QVERIFY(!skipStream.error());
+
+    CTelegramStream viewStream(data);
+    TLValue vectorType;
+    quint32 count = 0;
+    viewStream >> vectorType;
+    viewStream >> count;
+    viewStream.readRawView<TLMessage>();
+    const QByteArray secondMessageData = viewStream.readRawView<TLMessage>();
+    viewStream >> value;
+    QCOMPARE(value, marker);
+
+    CTelegramStream messageStream(secondMessageData);
+    TLMessage message;
+    messageStream >> message;
+    QVERIFY(messageStream.atEnd());
+    QCOMPARE(message.id, quint32(1001));
+    QCOMPARE(message.date, quint32(1500000001));
+    QCOMPARE(message.message, QString(300, QLatin1Char('b')));
+
+    // An unknown type can not be skipped and must not be silently accepted
+    QByteArray unknownData;
+    CTelegramStream unknownStream(&unknownData, /* write */ true);
+    unknownStream << TLValue::PeerUser;
+    unknownStream << marker;
+
+    CTelegramStream unknownSkipStream(unknownData);
+    unknownSkipStream.skip<TLMessage>();
+    QVERIFY(unknownSkipStream.error());
+}
+
+void tst_CTelegramStream::messageProjection()
+{
+    TLMessageEntity entity;
+    entity.tlType = TLValue::MessageEntityBold;
+    entity.offset = 4;
+    entity.length = 4;
+
+    QByteArray data;
+    CTelegramStream stream(&data, /* write */ true);
+    stream << TLValue::Vector;
+    stream << quint32(1);
+    stream << TLValue::Message;
+    stream << quint32(TLMessage::FromId | TLMessage::Entities | TLMessage::Views);
+    stream << quint32(1000); // id
+    stream << quint32(12345); // from_id
+    stream << TLValue::PeerUser;
+    stream << quint32(54321); // user_id
+    stream << quint32(1500000000); // date
+    stream << QStringLiteral("Text");
+    stream << TLVector<TLMessageEntity>({ entity });
+    stream << quint32(7); // views
+
+    CTelegramStream fullStream(data);
+    TLVector<TLMessage> fullMessages;
+    fullStream >> fullMessages;
+    QCOMPARE(fullMessages.count(), 1);
+    QCOMPARE(fullMessages.first().entities.count(), 1);
+    QCOMPARE(fullMessages.first().views, quint32(7));
+
+    // The projection is used for the nested values as well
+    CTelegramStream projectionStream(data);
+    projectionStream.setMessageProjection(&CTelegramStream::readProjection<TLMessage::FieldId | TLMessage::FieldMessage>);
+    TLVector<TLMessage> messages;
+    projectionStream >> messages;
+    QVERIFY(projectionStream.atEnd());
+    QVERIFY(!projectionStream.error());
+    QCOMPARE(messages.count(), 1);
+
+    const TLMessage &message = messages.first();
+    QVERIFY(message.tlType == TLValue::Message);
+    QCOMPARE(message.flags, fullMessages.first().flags);
+    QCOMPARE(message.id, quint32(1000));
+    QCOMPARE(message.message, QStringLiteral("Text"));
+    QCOMPARE(message.fromId, quint32(0));
+    QCOMPARE(message.date, quint32(0));
+    QVERIFY(message.entities.isEmpty());
+    QCOMPARE(message.views, quint32(0));
+
+    // A value of other type can not be projected
+    QByteArray peerData;
+    CTelegramStream peerStream(&peerData, /* write */ true);
+    peerStream << TLValue::PeerUser;
+    peerStream << quint32(54321);
+
+    CTelegramStream wrongTypeStream(peerData);
+    TLMessage wrongTypeMessage;
+    wrongTypeStream.readProjection<TLMessage::FieldId>(wrongTypeMessage);
+    QVERIFY(wrongTypeStream.error());
+}
+
+void tst_CTelegramStream::benchmarkRead_data()
+{
+    QTest::addColumn<bool>("span");
+    QTest::newRow("device") << false;
+    QTest::newRow("span") << true;
+}
+
+// The payloads of TELEGRAMQT_BENCHMARK_CAPTURE are decoded
+void tst_CTelegramStream::benchmarkRead()
+{
+    QFETCH(bool, span);
+
+    QString fileName;
+    const QVector<QByteArray> capturedObjects = benchmarkCapturedObjects(&fileName);
+    if (fileName.isEmpty()) {
+        QSKIP("Set TELEGRAMQT_BENCHMARK_CAPTURE to a capture file with the incoming payloads (see CTransportCapture)");
+    }
+    if (capturedObjects.isEmpty()) {
+        QSKIP("The capture has no incoming payloads of the known types");
+    }
+
+    int bytes = 0;
+    for (const QByteArray &object : capturedObjects) {
+        bytes += object.size();
+    }
+
+    int decodedCount = 0;
+    QBENCHMARK {
+        decodedCount = 0;
+        for (const QByteArray &object : capturedObjects) {
+            QBuffer device;
+            device.setData(object);
+            device.open(QIODevice::ReadOnly);
+            CTelegramStream stream(object);
+            if (!span) {
+                stream.setDevice(&device);
+            }
+            if (readCapturedObject(stream, TLValue::firstFromArray(object))) {
+                ++decodedCount;
+            }
+        }
+    }
+    QCOMPARE(decodedCount, capturedObjects.count());
+    qDebug() << "Decoded" << decodedCount << "objects," << bytes << "bytes of" << fileName;
+}
+
+void tst_CTelegramStream::benchmarkReadDcOptions_data()
+{
+    benchmarkRead_data();
+}
+
+void tst_CTelegramStream::benchmarkReadDcOptions()
+{
+    QFETCH(bool, span);
+
+    QByteArray data;
+    CTelegramStream outputStream(&data, /* write */ true);
+    outputStream << benchmarkDcOptions();
+
+    QBENCHMARK {
+        QBuffer device;
+        device.setData(data);
+        device.open(QIODevice::ReadOnly);
+        CTelegramStream stream(data);
+        if (!span) {
+            stream.setDevice(&device);
+        }
+        TLVector<TLDcOption> options;
+        stream >> options;
+        QCOMPARE(options.count(), 2048);
+    }
+}
+
+void tst_CTelegramStream::benchmarkWrite_data()
+{
+    benchmarkRead_data();
+}
+
+void tst_CTelegramStream::benchmarkWrite()
+{
+    QFETCH(bool, span);
+
+    const TLVector<TLDcOption> options = benchmarkDcOptions();
+    int size = 0;
+    QBENCHMARK {
+        if (span) {
+            QByteArray data;
+            CTelegramStream stream(&data, /* write */ true);
+            stream << options;
+            size = data.size();
+        } else {
+            QBuffer device;
+            device.open(QIODevice::WriteOnly);
+            CTelegramStream stream(&device);
+            stream << options;
+            size = device.data().size();
+        }
+    }
+    QVERIFY(size > 2048 * 16);
+}
+
+// The copies made by the decoders before the move-based ones: each level is decoded into a local value
+// and copy-assigned to the target, and the vector items are appended by copy
+static void copyAssignLevels(const TLMessagesMessages &decoded, TLMessagesMessages *target)
+{
+    TLVector<TLMessage> messages;
+    for (const TLMessage &message : decoded.messages) {
+        TLVector<TLMessageEntity> entities;
+        for (const TLMessageEntity &entity : message.entities) {
+            TLMessageEntity entityResult;
+            entityResult = entity;
+            entities.append(entityResult);
+        }
+        TLPeer peerResult;
+        peerResult = message.toId;
+
+        TLMessage messageResult;
+        messageResult = message;
+        messageResult.toId = peerResult;
+        messageResult.entities = entities;
+        messages.append(messageResult);
+    }
+    TLMessagesMessages result;
+    result = decoded;
+    result.messages = messages;
+    *target = result;
+}
+
+void tst_CTelegramStream::benchmarkMessagesDecoding_data()
+{
+    QTest::addColumn<bool>("copyAssign");
+    QTest::newRow("move") << false;
+    QTest::newRow("copy assign (baseline)") << true;
+}
+
+void tst_CTelegramStream::benchmarkMessagesDecoding()
+{
+    QFETCH(bool, copyAssign);
+
+    static const int messagesCount = 100;
+
+    // messages.messages with the typical text messages
+    QByteArray data;
+    CTelegramStream stream(&data, /* write */ true);
+    stream << TLValue::MessagesMessages;
+    stream << TLValue::Vector;
+    stream << quint32(messagesCount);
+    for (int i = 0; i < messagesCount; ++i) {
+        stream << TLValue::Message;
+        stream << quint32(TLMessage::FromId | TLMessage::Entities);
+        stream << quint32(1000 + i); // id
+        stream << quint32(12345); // from_id
+        stream << TLValue::PeerUser;
+        stream << quint32(54321); // user_id
+        stream << quint32(1500000000 + i); // date
+        stream << QStringLiteral("The text of the message number %1, long enough to be a typical one.").arg(i);
+
+        TLMessageEntity entity;
+        entity.tlType = TLValue::MessageEntityBold;
+        entity.offset = 4;
+        entity.length = 4;
+        stream << TLVector<TLMessageEntity>({ entity, entity });
+    }
+    stream << TLVector<quint32>(); // chats
+    stream << TLVector<quint32>(); // users
+
+    QBENCHMARK {
+        CTelegramStream inputStream(data);
+        TLMessagesMessages messages;
+        inputStream >> messages;
+        if (copyAssign) {
+            TLMessagesMessages copiedMessages;
+            copyAssignLevels(messages, &copiedMessages);
+            messages = copiedMessages;
+        }
+        QCOMPARE(messages.messages.count(), messagesCount);
+    }
+}
+
 QTEST_APPLESS_MAIN(tst_CTelegramStream)
 
 #include "tst_CTelegramStream.moc"
@@ -18,6 +18,9 @@
 #include <QObject>
 
 #include "CTelegramTransport.hpp"
+#include "CTcpTransport.hpp"
+#include "CLoopbackTransport.hpp"
+#include "CClientTcpTransport.hpp"
 #include "CTelegramConnection.hpp"
 #include "TelegramUtils.hpp"
 
@@ -25,6 +28,8 @@
 #include <QDebug>
 
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QTcpServer>
 
 class NullTransport : public CTelegramTransport
 {
@@ -47,6 +52,119 @@ protected:
     }
 };
 
+class FeedSocket : public QAbstractSocket
+{
+    Q_OBJECT
+public:
+    explicit FeedSocket(QObject *parent = nullptr) :
+        QAbstractSocket(QAbstractSocket::TcpSocket, parent)
+    {
+        setOpenMode(QIODevice::ReadWrite|QIODevice::Unbuffered);
+        setSocketState(QAbstractSocket::ConnectedState);
+    }
+
+    void feed(const QByteArray &data)
+    {
+        m_data = data;
+        m_position = 0;
+    }
+
+    qint64 bytesAvailable() const override { return m_data.size() - m_position; }
+    bool waitForBytesWritten(int msecs) override { Q_UNUSED(msecs) return true; }
+    void disconnectFromHost() override { }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        const qint64 size = qMin(maxSize, bytesAvailable());
+        memcpy(data, m_data.constData() + m_position, size);
+        m_position += size;
+        return size;
+    }
+
+    qint64 writeData(const char *data, qint64 maxSize) override
+    {
+        m_written.append(data, maxSize);
+        return maxSize;
+    }
+
+public:
+    QByteArray m_written;
+
+protected:
+    QByteArray m_data;
+    qint64 m_position = 0;
+};
+
+class FeedTransport : public CTcpTransport
+{
+    Q_OBJECT
+public:
+    explicit FeedTransport(SessionType sessionType = Abridged, QObject *parent = nullptr) :
+        CTcpTransport(parent),
+        m_feedSocket(new FeedSocket(this))
+    {
+        setSocket(m_feedSocket);
+        setSessionType(sessionType);
+    }
+
+    void feed(const QByteArray &data)
+    {
+        m_feedSocket->feed(data);
+        onReadyRead();
+    }
+
+    QByteArray writtenData() const { return m_feedSocket->m_written; }
+    int readBufferSize() const { return m_readBuffer.size(); }
+
+protected:
+    FeedSocket *m_feedSocket;
+};
+
+class RacingTransport : public Telegram::Client::TcpTransport
+{
+public:
+    explicit RacingTransport(QObject *parent = nullptr) : TcpTransport(parent) { }
+
+    int racingSocketsCount() const { return m_racingSockets.count(); }
+    int pendingAddressesCount() const { return m_racingAddresses.count(); }
+};
+
+static Telegram::DcOption localAddress(quint16 port)
+{
+    return Telegram::DcOption(QStringLiteral("127.0.0.1"), port);
+}
+
+// A port with nothing listening on it, so the connection is refused
+static quint16 closedPort()
+{
+    QTcpServer server;
+    server.listen(QHostAddress::LocalHost);
+    return server.serverPort();
+}
+
+static QByteArray frame(const QByteArray &package, CTcpTransport::SessionType sessionType = CTcpTransport::Abridged)
+{
+    QByteArray result;
+    if (sessionType == CTcpTransport::Intermediate) {
+        const quint32 length = package.size();
+        for (int i = 0; i < 4; ++i) {
+            result.append(char((length >> (i * 8)) & 0xff));
+        }
+        return result + package;
+    }
+    const quint32 length = package.size() / 4;
+    if (length < 0x7f) {
+        result.append(char(length));
+    } else {
+        result.append(char(0x7f));
+        result.append(char(length & 0xff));
+        result.append(char((length >> 8) & 0xff));
+        result.append(char((length >> 16) & 0xff));
+    }
+    return result + package;
+}
+
 class tst_CTelegramTransport : public QObject
 {
     Q_OBJECT
@@ -56,6 +174,20 @@ public:
 private slots:
     void testNewMessageId();
     void testNewMessageIdExtra();
+    void testFramedRead_data();
+    void testFramedRead();
+    void testInvalidFrameLength_data();
+    void testInvalidFrameLength();
+    void testQuickAckSkipped();
+    void testReadBufferBound();
+    void benchmarkFramedRead_data();
+    void benchmarkFramedRead();
+    void testCorkedWrite();
+    void testLoopbackTransport();
+    void testRacingFirstWinner();
+    void testRacingStaggeredStart();
+    void testRacingFailFast();
+    void testRacingAllFailed();
 
 };
 
@@ -124,6 +256,274 @@ void tst_CTelegramTransport::testNewMessageIdExtra()
     }
 }
 
+void tst_CTelegramTransport::testFramedRead_data()
+{
+    QTest::addColumn<CTcpTransport::SessionType>("sessionType");
+    QTest::newRow("abridged") << CTcpTransport::Abridged;
+    QTest::newRow("intermediate") << CTcpTransport::Intermediate;
+}
+
+void tst_CTelegramTransport::testFramedRead()
+{
+    QFETCH(CTcpTransport::SessionType, sessionType);
+
+    QVector<QByteArray> packages;
+    QByteArray stream;
+    for (int size : { 4, 16, 0x7e * 4, 0x7f * 4, 4096, 64 * 1024 + 4, 8 }) {
+        QByteArray package(size, Qt::Uninitialized);
+        for (int i = 0; i < size; ++i) {
+            package[i] = char(i * 7 + size);
+        }
+        packages.append(package);
+        stream.append(frame(package, sessionType));
+    }
+
+    // Feed the stream in chunks of various sizes to cover split headers and payloads
+    for (int chunkSize : { 1, 3, 5, 1000, stream.size() }) {
+        FeedTransport transport(sessionType);
+        QVector<QByteArray> received;
+        connect(&transport, &CTelegramTransport::packageReceived, [&received](const QByteArray &package) {
+            received.append(QByteArray(package.constData(), package.size()));
+        });
+        for (int offset = 0; offset < stream.size(); offset += chunkSize) {
+            transport.feed(stream.mid(offset, chunkSize));
+        }
+        QCOMPARE(received, packages);
+    }
+}
+
+void tst_CTelegramTransport::testInvalidFrameLength_data()
+{
+    QTest::addColumn<QByteArray>("header");
+    QTest::newRow("oversized") << QByteArray("\xf0\xff\xff\x7f", 4);
+    QTest::newRow("unaligned") << QByteArray("\x06\0\0\0", 4);
+}
+
+void tst_CTelegramTransport::testInvalidFrameLength()
+{
+    QFETCH(QByteArray, header);
+
+    FeedTransport transport(CTcpTransport::Intermediate);
+    int received = 0;
+    int errors = 0;
+    connect(&transport, &CTelegramTransport::packageReceived, [&received](const QByteArray &package) {
+        Q_UNUSED(package)
+        ++received;
+    });
+    connect(&transport, static_cast<void (CTelegramTransport::*)(QAbstractSocket::SocketError)>(&CTelegramTransport::error),
+            [&errors](QAbstractSocket::SocketError error) {
+        Q_UNUSED(error)
+        ++errors;
+    });
+
+    transport.feed(header + QByteArray(64, 'x') + frame(QByteArray(8, 'y'), CTcpTransport::Intermediate));
+    QCOMPARE(received, 0);
+    QCOMPARE(errors, 1);
+}
+
+void tst_CTelegramTransport::testQuickAckSkipped()
+{
+    FeedTransport transport(CTcpTransport::Intermediate);
+    QVector<QByteArray> received;
+    connect(&transport, &CTelegramTransport::packageReceived, [&received](const QByteArray &package) {
+        received.append(QByteArray(package.constData(), package.size()));
+    });
+
+    const QByteArray package(8, 'y');
+    transport.feed(QByteArray("\x01\x02\x03\x84", 4) + frame(package, CTcpTransport::Intermediate));
+    QCOMPARE(received, QVector<QByteArray>({ package }));
+}
+
+void tst_CTelegramTransport::testReadBufferBound()
+{
+    static const int packageSize = 8 * 1024 * 1024;
+    static const int packagesCount = 4;
+
+    QByteArray stream;
+    for (int i = 0; i < packagesCount; ++i) {
+        stream.append(frame(QByteArray(packageSize, char('a' + i)), CTcpTransport::Intermediate));
+    }
+
+    FeedTransport transport(CTcpTransport::Intermediate);
+    QVector<char> received;
+    connect(&transport, &CTelegramTransport::packageReceived, [&received](const QByteArray &package) {
+        QCOMPARE(package.size(), packageSize);
+        received.append(package.at(0));
+    });
+
+    // The socket has all the data at once, but it is read in bounded chunks
+    transport.feed(stream);
+    QCOMPARE(received, QVector<char>({ 'a', 'b', 'c', 'd' }));
+    QVERIFY(transport.readBufferSize() <= 2 * (16 * 1024 * 1024 + 4));
+}
+
+void tst_CTelegramTransport::benchmarkFramedRead_data()
+{
+    testFramedRead_data();
+}
+
+void tst_CTelegramTransport::benchmarkFramedRead()
+{
+    QFETCH(CTcpTransport::SessionType, sessionType);
+
+    // A mix of small RPC answers and large file chunks
+    QByteArray chunk;
+    int packagesInChunk = 0;
+    for (int i = 0; i < 64; ++i) {
+        chunk.append(frame(QByteArray(i % 8 ? 96 : 128 * 1024, char(i)), sessionType));
+        ++packagesInChunk;
+    }
+
+    FeedTransport transport(sessionType);
+    int received = 0;
+    connect(&transport, &CTelegramTransport::packageReceived, [&received](const QByteArray &package) {
+        Q_UNUSED(package)
+        ++received;
+    });
+
+    QBENCHMARK {
+        for (int offset = 0; offset < chunk.size(); offset += 16 * 1024) {
+            transport.feed(QByteArray::fromRawData(chunk.constData() + offset, qMin(16 * 1024, chunk.size() - offset)));
+        }
+    }
+    QVERIFY(received > 0);
+    QCOMPARE(received % packagesInChunk, 0);
+}
+
+void tst_CTelegramTransport::testCorkedWrite()
+{
+    FeedTransport transport;
+    transport.setCorked(true);
+
+    QByteArray expectedData;
+    for (int i = 1; i <= 10; ++i) {
+        const QByteArray package(i * 4 * 0x10, char(i));
+        transport.sendPackage(package);
+        expectedData.append(frame(package));
+    }
+    QVERIFY(transport.writtenData().isEmpty());
+    QCOMPARE(transport.writeCallsCount(), quint64(0));
+
+    // The packages are written together at the end of the event loop iteration
+    QTRY_COMPARE(transport.writeCallsCount(), quint64(1));
+    QCOMPARE(transport.writtenData(), expectedData);
+    QCOMPARE(transport.sentPackagesCount(), quint64(10));
+    QCOMPARE(transport.savedWriteCallsCount(), quint64(9));
+
+    // Uncorked transport writes every package immediately
+    transport.setCorked(false);
+    transport.sendPackage(QByteArray(8, char(0x42)));
+    QCOMPARE(transport.writeCallsCount(), quint64(2));
+    QCOMPARE(transport.writtenData(), expectedData + frame(QByteArray(8, char(0x42))));
+}
+
+void tst_CTelegramTransport::testLoopbackTransport()
+{
+    CLoopbackTransport client;
+    CLoopbackTransport server;
+    CLoopbackTransport::connectPeers(&client, &server);
+
+    client.connectToHost(QStringLiteral("127.0.0.1"), 443);
+    QCOMPARE(client.state(), QAbstractSocket::ConnectingState);
+    QTRY_COMPARE(client.state(), QAbstractSocket::ConnectedState);
+    QCOMPARE(server.state(), QAbstractSocket::ConnectedState);
+
+    QVector<QByteArray> received;
+    connect(&server, &CTelegramTransport::packageReceived, [&received](const QByteArray &package) {
+        received.append(package);
+    });
+
+    const QVector<QByteArray> packages = { QByteArray(16, char(1)), QByteArray(1024, char(2)), QByteArray(8, char(3)) };
+
+    client.setLatency(50);
+    QElapsedTimer timer;
+    timer.start();
+    for (const QByteArray &package : packages) {
+        client.sendPackage(package);
+    }
+    QVERIFY(received.isEmpty());
+    QTRY_COMPARE(received.count(), packages.count());
+    QVERIFY(timer.elapsed() >= 50);
+    QCOMPARE(received, packages);
+
+    client.setLatency(0);
+    client.setLossRate(1);
+    client.sendPackage(packages.first());
+    QCOMPARE(client.lostPackagesCount(), quint64(1));
+
+    client.disconnectFromHost();
+    QCOMPARE(client.state(), QAbstractSocket::UnconnectedState);
+    QCOMPARE(server.state(), QAbstractSocket::UnconnectedState);
+}
+
+void tst_CTelegramTransport::testRacingFirstWinner()
+{
+    QTcpServer first;
+    QTcpServer second;
+    QVERIFY(first.listen(QHostAddress::LocalHost));
+    QVERIFY(second.listen(QHostAddress::LocalHost));
+
+    RacingTransport transport;
+    transport.connectToHosts({ localAddress(first.serverPort()), localAddress(second.serverPort()) });
+    QTRY_COMPARE(transport.state(), QAbstractSocket::ConnectedState);
+    QCOMPARE(transport.remoteAddress().port, quint32(first.serverPort()));
+    QCOMPARE(transport.racingSocketsCount(), 0);
+    QCOMPARE(transport.pendingAddressesCount(), 0);
+    QTRY_VERIFY(first.hasPendingConnections());
+    QVERIFY(!second.hasPendingConnections());
+}
+
+void tst_CTelegramTransport::testRacingStaggeredStart()
+{
+    QTcpServer servers[3];
+    QVector<Telegram::DcOption> addresses;
+    for (QTcpServer &server : servers) {
+        QVERIFY(server.listen(QHostAddress::LocalHost));
+        addresses.append(localAddress(server.serverPort()));
+    }
+
+    RacingTransport transport;
+    transport.connectToHosts(addresses);
+
+    // Only the first attempt is started, the next ones wait for the stagger interval
+    QCOMPARE(transport.state(), QAbstractSocket::ConnectingState);
+    QCOMPARE(transport.racingSocketsCount(), 1);
+    QCOMPARE(transport.pendingAddressesCount(), 2);
+
+    QTRY_COMPARE(transport.state(), QAbstractSocket::ConnectedState);
+    QCOMPARE(transport.remoteAddress().port, quint32(servers[0].serverPort()));
+}
+
+void tst_CTelegramTransport::testRacingFailFast()
+{
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    RacingTransport transport;
+    // The next address would not be tried within the test timeout without the fail-fast
+    transport.setRacingStaggerInterval(60 * 1000);
+    transport.connectToHosts({ localAddress(closedPort()), localAddress(server.serverPort()) });
+    QTRY_COMPARE_WITH_TIMEOUT(transport.state(), QAbstractSocket::ConnectedState, 5000);
+    QCOMPARE(transport.remoteAddress().port, quint32(server.serverPort()));
+}
+
+void tst_CTelegramTransport::testRacingAllFailed()
+{
+    RacingTransport transport;
+    int errors = 0;
+    connect(&transport, static_cast<void (CTelegramTransport::*)(QAbstractSocket::SocketError)>(&CTelegramTransport::error),
+            [&errors](QAbstractSocket::SocketError error) {
+        Q_UNUSED(error)
+        ++errors;
+    });
+
+    transport.connectToHosts({ localAddress(closedPort()), localAddress(closedPort()) });
+    QTRY_COMPARE(errors, 1);
+    QCOMPARE(transport.error(), QAbstractSocket::ConnectionRefusedError);
+    QCOMPARE(transport.state(), QAbstractSocket::UnconnectedState);
+    QCOMPARE(transport.racingSocketsCount(), 0);
+}
+
 QTEST_MAIN(tst_CTelegramTransport)
 
 #include "tst_CTelegramTransport.moc"
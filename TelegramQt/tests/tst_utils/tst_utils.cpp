@@ -21,11 +21,14 @@
 #include "TelegramNamespace.hpp"
 #include "RandomGenerator.hpp"
 
+#include <QElapsedTimer>
 #include <QTest>
 #include <QDebug>
 
 #include "keys_data.hpp"
 
+#include <openssl/aes.h>
+
 using namespace Telegram;
 
 class tst_utils : public QObject
@@ -35,6 +38,14 @@ private slots:
     void initTestCase();
     void cleanupTestCase();
     void testAesEncryption();
+    void testAesIgeInPlace();
+    void benchmarkAesIge_data();
+    void benchmarkAesIge();
+    void benchmarkAesIgeThroughput_data();
+    void benchmarkAesIgeThroughput();
+    void testGZip();
+    void benchmarkGZip_data();
+    void benchmarkGZip();
     void testRsaLoad();
     void testRsaFingersprint();
     void testRsaEncryption();
@@ -66,6 +77,199 @@ void tst_utils::testAesEncryption()
     QCOMPARE(sourceData, decodedData);
 }
 
+static SAesKeyData testAesKeyData()
+{
+    SAesKeyData key;
+    for (int i = 0; i < SAesKeyData::KeySize; ++i) {
+        key.key[i] = uchar(i * 7);
+    }
+    for (int i = 0; i < SAesKeyData::IvSize; ++i) {
+        key.iv[i] = uchar(i * 11 + 3);
+    }
+    return key;
+}
+
+static QByteArray testPlainData(int size)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i) {
+        data[i] = char(i * 31 + (i >> 8));
+    }
+    return data;
+}
+
+// The reference OpenSSL IGE implementation
+static QByteArray legacyAesIge(const QByteArray &data, const SAesKeyData &key, bool encrypt)
+{
+    QByteArray result(data.size(), Qt::Uninitialized);
+    uchar initVector[SAesKeyData::IvSize];
+    memcpy(initVector, key.iv, sizeof(initVector));
+    AES_KEY aesKey;
+    if (encrypt) {
+        AES_set_encrypt_key(key.key, SAesKeyData::KeySize * 8, &aesKey);
+    } else {
+        AES_set_decrypt_key(key.key, SAesKeyData::KeySize * 8, &aesKey);
+    }
+    AES_ige_encrypt((const uchar *) data.constData(), (uchar *) result.data(), data.size(), &aesKey, initVector, encrypt ? AES_ENCRYPT : AES_DECRYPT);
+    return result;
+}
+
+void tst_utils::testAesIgeInPlace()
+{
+    const SAesKeyData key = testAesKeyData();
+    const QByteArray sourceData = testPlainData(4096);
+
+    QByteArray data = sourceData;
+    QVERIFY(Utils::aesIgeEncrypt(data.data(), data.size(), key));
+    QCOMPARE(data, legacyAesIge(sourceData, key, /* encrypt */ true));
+
+    QVERIFY(Utils::aesIgeDecrypt(data.data(), data.size(), key));
+    QCOMPARE(data, sourceData);
+
+    QVERIFY(!Utils::aesIgeEncrypt(data.data(), 15, key));
+
+    // The key schedule is kept for the same key, so check the key switches
+    SAesKeyData otherKey = key;
+    otherKey.key[0] ^= 0x5a;
+    for (const SAesKeyData &currentKey : { key, otherKey, key }) {
+        data = sourceData;
+        QVERIFY(Utils::aesIgeEncrypt(data.data(), data.size(), currentKey));
+        QCOMPARE(data, legacyAesIge(sourceData, currentKey, /* encrypt */ true));
+        QVERIFY(Utils::aesIgeDecrypt(data.data(), data.size(), currentKey));
+        QCOMPARE(data, sourceData);
+    }
+}
+
+void tst_utils::benchmarkAesIge_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<bool>("legacy");
+
+    for (int size : { 1, 4, 16, 64, 128, 512 }) {
+        QTest::newRow(QStringLiteral("%1 KB in-place").arg(size).toLatin1().constData()) << size * 1024 << false;
+        QTest::newRow(QStringLiteral("%1 KB legacy").arg(size).toLatin1().constData()) << size * 1024 << true;
+    }
+}
+
+void tst_utils::benchmarkAesIge()
+{
+    QFETCH(int, size);
+    QFETCH(bool, legacy);
+
+    const SAesKeyData key = testAesKeyData();
+    QByteArray data = testPlainData(size);
+
+    if (legacy) {
+        QBENCHMARK {
+            data = legacyAesIge(data, key, /* encrypt */ true);
+        }
+    } else {
+        QBENCHMARK {
+            Utils::aesIgeEncrypt(data.data(), data.size(), key);
+        }
+    }
+}
+
+void tst_utils::benchmarkAesIgeThroughput_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<bool>("legacy");
+
+    for (int size : { 256, 4096, 64 * 1024 }) {
+        QTest::newRow(QStringLiteral("%1 B in-place").arg(size).toLatin1().constData()) << size << false;
+        QTest::newRow(QStringLiteral("%1 B legacy").arg(size).toLatin1().constData()) << size << true;
+    }
+}
+
+// Reports the throughput with a new key for each chunk, as each message has its own key
+void tst_utils::benchmarkAesIgeThroughput()
+{
+    QFETCH(int, size);
+    QFETCH(bool, legacy);
+
+    static const qint64 totalSize = 64 * 1024 * 1024;
+    SAesKeyData key = testAesKeyData();
+    QByteArray data = testPlainData(size);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (qint64 processed = 0; processed < totalSize; processed += size) {
+        ++key.key[0];
+        if (legacy) {
+            data = legacyAesIge(data, key, /* encrypt */ true);
+        } else if (!Utils::aesIgeEncrypt(data.data(), data.size(), key)) {
+            QFAIL("Unable to encrypt the data");
+        }
+    }
+    const qint64 elapsed = qMax<qint64>(1, timer.nsecsElapsed());
+    QTest::setBenchmarkResult(qreal(totalSize) * 1000000000 / elapsed, QTest::BytesPerSecond);
+}
+
+// Text-like data with repetitions, compressible as a typical TL content
+static QByteArray testCompressibleData(int size)
+{
+    QByteArray data;
+    data.reserve(size + 32);
+    for (int i = 0; data.size() < size; ++i) {
+        data.append("user");
+        data.append(QByteArray::number(i % 97));
+        data.append(i % 3 ? " sent a message; " : " is online; ");
+    }
+    data.truncate(size);
+    return data;
+}
+
+void tst_utils::testGZip()
+{
+    for (int size : { 1, 100, 4096, 300000 }) {
+        const QByteArray data = testCompressibleData(size);
+        const QByteArray packed = Utils::packGZip(data);
+        QVERIFY(!packed.isEmpty());
+        QCOMPARE(Utils::unpackGZip(packed), data);
+    }
+
+    // Truncated input results in the partially unpacked data
+    const QByteArray data = testCompressibleData(100000);
+    const QByteArray packed = Utils::packGZip(data);
+    const QByteArray unpacked = Utils::unpackGZip(packed.left(packed.size() / 2));
+    QVERIFY(!unpacked.isEmpty());
+    QVERIFY(data.startsWith(unpacked));
+
+    QVERIFY(Utils::unpackGZip(QByteArray(32, 'x')).isEmpty());
+}
+
+void tst_utils::benchmarkGZip_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<bool>("pack");
+
+    for (int size : { 1, 16, 256 }) {
+        QTest::newRow(QStringLiteral("%1 KB unpack").arg(size).toLatin1().constData()) << size * 1024 << false;
+        QTest::newRow(QStringLiteral("%1 KB pack").arg(size).toLatin1().constData()) << size * 1024 << true;
+    }
+}
+
+void tst_utils::benchmarkGZip()
+{
+    QFETCH(int, size);
+    QFETCH(bool, pack);
+
+    const QByteArray data = testCompressibleData(size);
+    QByteArray result;
+
+    if (pack) {
+        QBENCHMARK {
+            result = Utils::packGZip(data);
+        }
+    } else {
+        const QByteArray packed = Utils::packGZip(data);
+        QBENCHMARK {
+            result = Utils::unpackGZip(packed);
+        }
+        QCOMPARE(result, data);
+    }
+}
+
 void tst_utils::testRsaLoad()
 {
     const RsaKey privateKey = Utils::loadRsaPrivateKeyFromFile(TestKeyData::privateKeyFileName());
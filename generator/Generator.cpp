@@ -55,6 +55,11 @@ static const QStringList typesBlackList = QStringList()
         << tlTrueType
            ;
 
+// The types with the field mask projection decoders (see CTelegramStream::readProjection())
+static const QStringList projectionTypes = QStringList()
+        << QLatin1String("TLMessage")
+           ;
+
 QString ensureGoodName(const QString &name, const QVariantHash &context)
 {
     static const QStringList badNames = QStringList()
@@ -515,6 +520,11 @@ QString Generator::generateTLTypeDefinition(const TLType &type, bool addSpecSour
         code.append(memberFlags);
         code.append(spacing + "};\n");
     }
+    if (projectionTypes.contains(type.name)) {
+        code.append(spacing + "enum Fields {\n");
+        code.append(joinLinesWithPrepend(generateTLTypeMemberFields(type), doubleSpacing));
+        code.append(spacing + "};\n");
+    }
     if (constExpr) {
         code.append(joinLinesWithPrepend(generateTLTypeMemberGetters(type), spacing + constExprSpace));
     } else {
@@ -596,6 +606,51 @@ QStringList Generator::generateTLTypeMembers(const TLType &type)
     return membersCode;
 }
 
+QStringList Generator::generateTLTypeMemberFields(const TLType &type)
+{
+    const QStringList members = projectionMembers(type);
+    QStringList memberFields;
+    for (int i = 0; i < members.count(); ++i) {
+        memberFields.append(projectionFieldName(members.at(i)) + QStringLiteral(" = 1 << %1,").arg(i));
+    }
+    memberFields.append(QStringLiteral("FieldAll = (1 << %1) - 1,").arg(members.count()));
+    return memberFields;
+}
+
+QStringList Generator::projectionMembers(const TLType &type)
+{
+    // The flags are always read, as the rest of the value layout depends on them
+    QStringList flagMembers;
+    foreach (const TLSubType &subType, type.subTypes) {
+        foreach (const TLParam &member, subType.members) {
+            if (member.dependOnFlag() && !flagMembers.contains(member.flagMember)) {
+                flagMembers.append(member.flagMember);
+            }
+        }
+    }
+
+    QStringList members;
+    foreach (const TLSubType &subType, type.subTypes) {
+        foreach (const TLParam &member, subType.members) {
+            if (members.contains(member.getAlias()) || flagMembers.contains(member.getAlias())) {
+                continue;
+            }
+            if (member.dependOnFlag() && (member.type() == tlTrueType)) {
+                continue; // No extra data behind the flag
+            }
+            members.append(member.getAlias());
+        }
+    }
+    return members;
+}
+
+QString Generator::projectionFieldName(const QString &memberName)
+{
+    QString name = memberName;
+    name[0] = name.at(0).toUpper();
+    return QLatin1String("Field") + name;
+}
+
 QString Generator::streamReadImplementationHead(const QString &argName, const QString &typeName)
 {
     QString code;
@@ -609,7 +664,15 @@ QString Generator::streamReadImplementationEnd(const QString &argName)
 {
     QString code;
     code.append(QString("%1default:\n%1%1break;\n%1}\n\n").arg(spacing));
-    code.append(QString("%1%2 = result;\n\n%1return *this;\n}\n\n").arg(spacing, argName));
+    code.append(QString("%1%2 = std::move(result);\n\n%1return *this;\n}\n\n").arg(spacing, argName));
+    return code;
+}
+
+QString Generator::streamProjectionImplementationEnd(const QString &argName)
+{
+    QString code;
+    code.append(QString("%1default:\n%1%1setError();\n%1%1break;\n%1}\n\n").arg(spacing));
+    code.append(QString("%1%2 = std::move(result);\n\n%1return *this;\n}\n\n").arg(spacing, argName));
     return code;
 }
 
@@ -663,6 +726,16 @@ QString Generator::streamWriteImplementationEnd(const QString &argName)
     return code;
 }
 
+QString Generator::streamSkipImplementationEnd(const QString &argName)
+{
+    Q_UNUSED(argName)
+
+    QString code;
+    code.append(QString("%1default:\n%1%1setError();\n%1%1break;\n%1}\n\n").arg(spacing));
+    code.append(spacing + QString("return *this;\n}\n\n"));
+    return code;
+}
+
 QString Generator::streamWriteFreeImplementationEnd(const QString &argName)
 {
     Q_UNUSED(argName)
@@ -705,6 +778,82 @@ QString Generator::streamWritePerTypeImplementationBase(const QString &argName,
     return code;
 }
 
+QString Generator::streamSizeImplementationHead(const QString &argName, const QString &typeName)
+{
+    QString code;
+    code.append(QString("quint32 %1::serializedSize(const %2 &%3)\n{\n").arg(streamClassName, typeName, argName));
+    code.append(QString("%1quint32 size = 4;\n\n%1switch (%2.tlType) {\n").arg(spacing, argName));
+    return code;
+}
+
+QString Generator::streamSizeImplementationEnd(const QString &argName)
+{
+    Q_UNUSED(argName)
+
+    QString code;
+    code.append(QString("%1default:\n%1%1break;\n%1}\n\n").arg(spacing));
+    code.append(spacing + QString("return size;\n}\n\n"));
+    return code;
+}
+
+QString Generator::streamSizePerTypeImplementation(const QString &argName, const TLSubType &subType)
+{
+    QString code;
+    foreach (const TLParam &member, subType.members) {
+        if (member.dependOnFlag()) {
+            if (member.type() == tlTrueType) {
+                continue;
+            }
+            code.append(doubleSpacing + QString("if (%1.%2 & 1 << %3) {\n").arg(argName).arg(member.flagMember).arg(member.flagBit));
+            code.append(doubleSpacing + spacing + QString("size += serializedSize(%1.%2);\n").arg(argName).arg(member.getAlias()));
+            code.append(doubleSpacing + QLatin1Literal("}\n"));
+        } else {
+            if (member.accessByPointer() && !member.isVector()) {
+                code.append(doubleSpacing + QString("size += serializedSize(*%1.%2);\n").arg(argName).arg(member.getAlias()));
+            } else {
+                code.append(doubleSpacing + QString("size += serializedSize(%1.%2);\n").arg(argName).arg(member.getAlias()));
+            }
+        }
+    }
+    code.append(QString("%1break;\n").arg(doubleSpacing));
+    return code;
+}
+
+QStringList Generator::streamSkipFlagMembers(const TLSubType &subType)
+{
+    // Only the flags of the members with data are needed to skip the value
+    QStringList flagMembers;
+    foreach (const TLParam &member, subType.members) {
+        if (member.dependOnFlag() && (member.type() != tlTrueType) && !flagMembers.contains(member.flagMember)) {
+            flagMembers.append(member.flagMember);
+        }
+    }
+    return flagMembers;
+}
+
+QString Generator::streamSkipPerTypeImplementation(const QString &argName, const TLSubType &subType)
+{
+    Q_UNUSED(argName)
+    const QStringList flagMembers = streamSkipFlagMembers(subType);
+    QString code;
+    foreach (const TLParam &member, subType.members) {
+        if (member.dependOnFlag()) {
+            if (member.type() == tlTrueType) {
+                continue;
+            }
+            code.append(doubleSpacing + QString("if (%1 & 1 << %2) {\n").arg(member.flagMember).arg(member.flagBit));
+            code.append(doubleSpacing + spacing + QString("skip<%1>();\n").arg(member.type()));
+            code.append(doubleSpacing + QLatin1Literal("}\n"));
+        } else if (flagMembers.contains(member.getAlias())) {
+            code.append(doubleSpacing + QString("*this >> %1;\n").arg(member.getAlias()));
+        } else {
+            code.append(doubleSpacing + QString("skip<%1>();\n").arg(member.type()));
+        }
+    }
+    code.append(QString("%1break;\n").arg(doubleSpacing));
+    return code;
+}
+
 QString Generator::generateStreamOperatorDefinition(const TLType &type, std::function<QString (const QString &, const QString &)> head,
                                                     std::function<QString (const QString &, const TLSubType &)> generateSubtypeCode,
                                                     std::function<QString (const QString &)> end)
@@ -758,7 +907,19 @@ QString Generator::generateStreamReadFreeOperatorDeclaration(const NameWithEntit
 
 QString Generator::generateStreamReadOperatorDefinition(const TLType &type)
 {
-    return generateStreamOperatorDefinition(type, streamReadImplementationHead, streamReadPerTypeImplementation, streamReadImplementationEnd);
+    if (!projectionTypes.contains(type.name)) {
+        return generateStreamOperatorDefinition(type, streamReadImplementationHead, streamReadPerTypeImplementation, streamReadImplementationEnd);
+    }
+
+    // The projection set on the stream replaces the full decoding
+    const auto head = [](const QString &argName, const QString &typeName) {
+        QString code = streamReadImplementationHead(argName, typeName);
+        const QString projectionMember = QStringLiteral("m_%1Projection").arg(argName.left(argName.size() - 5));
+        code.insert(code.indexOf(QLatin1String("{\n")) + 2,
+                    QString("%1if (%2) {\n%1%1return (this->*%2)(%3);\n%1}\n\n").arg(spacing, projectionMember, argName));
+        return code;
+    };
+    return generateStreamOperatorDefinition(type, head, streamReadPerTypeImplementation, streamReadImplementationEnd);
 }
 
 QString Generator::generateStreamReadVectorTemplate(const QString &type)
@@ -793,6 +954,104 @@ QString Generator::generateStreamWriteFreeOperatorDefinition(const TLType &type)
     return generateStreamOperatorDefinition(type, streamWriteFreeImplementationHead, streamWritePerTypeFreeImplementation, streamWriteFreeImplementationEnd);
 }
 
+QString Generator::generateStreamSizeDeclaration(const TLType &type)
+{
+    QString argName = removePrefix(type.name);
+    argName[0] = argName.at(0).toLower();
+    argName += QLatin1String("Value");
+    return spacing + QString("static quint32 serializedSize(const %1 &%2);\n").arg(type.name).arg(argName);
+}
+
+QString Generator::generateStreamSizeDefinition(const TLType &type)
+{
+    return generateStreamOperatorDefinition(type, streamSizeImplementationHead, streamSizePerTypeImplementation, streamSizeImplementationEnd);
+}
+
+QString Generator::generateStreamSkipDeclaration(const TLType &type)
+{
+    return spacing + QString("%1 &skip(const %2 *);\n").arg(streamClassName, type.name);
+}
+
+QString Generator::generateStreamSkipDefinition(const TLType &type)
+{
+    QStringList flagMembers;
+    foreach (const TLSubType &subType, type.subTypes) {
+        foreach (const QString &flagMember, streamSkipFlagMembers(subType)) {
+            if (!flagMembers.contains(flagMember)) {
+                flagMembers.append(flagMember);
+            }
+        }
+    }
+
+    const auto head = [&flagMembers](const QString &argName, const QString &typeName) {
+        Q_UNUSED(argName)
+        QString code;
+        code.append(QString("%1 &%1::skip(const %2 *)\n{\n").arg(streamClassName, typeName));
+        foreach (const QString &flagMember, flagMembers) {
+            code.append(spacing + QString("quint32 %1 = 0;\n").arg(flagMember));
+        }
+        code.append(QString("%1%2 tlType;\n%1*this >> tlType;\n\n%1switch (tlType) {\n").arg(spacing, tlValueName));
+        return code;
+    };
+    return generateStreamOperatorDefinition(type, head, streamSkipPerTypeImplementation, streamSkipImplementationEnd);
+}
+
+QString Generator::generateStreamProjectionDeclaration(const TLType &type)
+{
+    QString argName = removePrefix(type.name);
+    argName[0] = argName.at(0).toLower();
+    argName += QLatin1String("Value");
+    return spacing + QLatin1String("template <quint32 Fields>\n")
+            + spacing + QString("%1 &readProjection(%2 &%3);\n").arg(streamClassName, type.name, argName);
+}
+
+QString Generator::generateStreamProjectionDefinition(const TLType &type)
+{
+    const QStringList members = projectionMembers(type);
+
+    const auto head = [](const QString &argName, const QString &typeName) {
+        QString code = streamReadImplementationHead(argName, typeName);
+        code.replace(0, code.indexOf(QLatin1Char('\n')),
+                     QString("template <quint32 Fields>\ninline %1 &%1::readProjection(%2 &%3)").arg(streamClassName, typeName, argName));
+        return code;
+    };
+
+    const QString typeName = type.name;
+    const auto perType = [&members, &typeName](const QString &argName, const TLSubType &subType) {
+        Q_UNUSED(argName)
+        QString code;
+        foreach (const TLParam &member, subType.members) {
+            if (member.dependOnFlag() && (member.type() == tlTrueType)) {
+                continue;
+            }
+            if (!members.contains(member.getAlias())) {
+                code.append(doubleSpacing + QString("*this >> result.%1;\n").arg(member.getAlias()));
+                continue;
+            }
+            QString indent = doubleSpacing;
+            if (member.dependOnFlag()) {
+                code.append(indent + QString("if (result.%1 & 1 << %2) {\n").arg(member.flagMember).arg(member.flagBit));
+                indent += spacing;
+            }
+            code.append(indent + QString("if (Fields & %1::%2) {\n").arg(typeName, projectionFieldName(member.getAlias())));
+            if (member.accessByPointer() && !member.isVector()) {
+                code.append(indent + spacing + QString("*this >> *result.%1;\n").arg(member.getAlias()));
+            } else {
+                code.append(indent + spacing + QString("*this >> result.%1;\n").arg(member.getAlias()));
+            }
+            code.append(indent + QLatin1String("} else {\n"));
+            code.append(indent + spacing + QString("skip<%1>();\n").arg(member.type()));
+            code.append(indent + QLatin1String("}\n"));
+            if (member.dependOnFlag()) {
+                code.append(doubleSpacing + QLatin1Literal("}\n"));
+            }
+        }
+        code.append(QString("%1break;\n").arg(doubleSpacing));
+        return code;
+    };
+    return generateStreamOperatorDefinition(type, head, perType, streamProjectionImplementationEnd);
+}
+
 QString Generator::generateStreamWriteVectorTemplate(const QString &type)
 {
     return QString(QLatin1String("template %1 &%1::operator<<(const TLVector<%2> &v);")).arg(streamClassName).arg(type);
@@ -887,22 +1146,26 @@ QString Generator::generateConnectionMethodDefinition(const TLMethod &method, QS
 {
     QString result;
     result += QString("quint64 %1::%2(%3)\n{\n").arg(methodsClassName).arg(method.name).arg(formatMethodParams(method));
-    result += spacing + QLatin1String("QByteArray output;\n");
-    result += spacing + streamClassName + QLatin1String(" outputStream(&output, /* write */ true);\n");
 
-    result += spacing + QString("outputStream << %1::%2;\n").arg(tlValueName, formatName(method.name, FirstLetterCase::Upper));
+    // The output is allocated once, with the exact size of the serialized method
+    QString sizeCode = spacing + QLatin1String("quint32 outputSize = 4;\n");
+    QString writeCode = spacing + QString("outputStream << %1::%2;\n").arg(tlValueName, formatName(method.name, FirstLetterCase::Upper));
 
     foreach (const TLParam &param, method.params) {
         if (param.dependOnFlag()) {
             if (param.type() == tlTrueType) {
-                result += spacing + QString("// (%1 & 1 << %2) stands for %3 \"true\" value\n").arg(param.flagMember).arg(param.flagBit).arg(param.getAlias());
+                writeCode += spacing + QString("// (%1 & 1 << %2) stands for %3 \"true\" value\n").arg(param.flagMember).arg(param.flagBit).arg(param.getAlias());
             } else {
-                result += spacing + QString("if (%1 & 1 << %2) {\n").arg(param.flagMember).arg(param.flagBit);
-                result += spacing + spacing + QString("outputStream << %1;\n").arg(param.getAlias());
-                result += spacing + QLatin1String("}\n");
+                sizeCode += spacing + QString("if (%1 & 1 << %2) {\n").arg(param.flagMember).arg(param.flagBit);
+                sizeCode += spacing + spacing + QString("outputSize += %1::serializedSize(%2);\n").arg(streamClassName, param.getAlias());
+                sizeCode += spacing + QLatin1String("}\n");
+                writeCode += spacing + QString("if (%1 & 1 << %2) {\n").arg(param.flagMember).arg(param.flagBit);
+                writeCode += spacing + spacing + QString("outputStream << %1;\n").arg(param.getAlias());
+                writeCode += spacing + QLatin1String("}\n");
             }
         } else {
-            result += spacing + QString("outputStream << %1;\n").arg(param.getAlias());
+            sizeCode += spacing + QString("outputSize += %1::serializedSize(%2);\n").arg(streamClassName, param.getAlias());
+            writeCode += spacing + QString("outputStream << %1;\n").arg(param.getAlias());
         }
 
         if (!nativeTypes.contains(param.bareType())) {
@@ -910,6 +1173,11 @@ QString Generator::generateConnectionMethodDefinition(const TLMethod &method, QS
         }
     }
 
+    result += sizeCode;
+    result += spacing + QLatin1String("QByteArray output;\n");
+    result += spacing + QLatin1String("output.reserve(outputSize);\n");
+    result += spacing + streamClassName + QLatin1String(" outputStream(&output, /* write */ true);\n");
+    result += writeCode;
     result += spacing + QLatin1String("return sendEncryptedPackage(output);\n}\n\n");
 
     return result;
@@ -1347,6 +1615,12 @@ void Generator::generate()
     codeStreamWriteDeclarations.clear();
     codeStreamWriteDefinitions.clear();
     codeStreamWriteTemplateInstancing.clear();
+    codeStreamSizeDeclarations.clear();
+    codeStreamSizeDefinitions.clear();
+    codeStreamSkipDeclarations.clear();
+    codeStreamSkipDefinitions.clear();
+    codeStreamProjectionDeclarations.clear();
+    codeStreamProjectionDefinitions.clear();
     codeConnectionDeclarations.clear();
     codeConnectionDefinitions.clear();
     codeRpcProcessDeclarations.clear();
@@ -1520,10 +1794,18 @@ void Generator::generate()
 
         codeStreamReadDeclarations.append(generateStreamReadOperatorDeclaration(type));
         codeStreamReadDefinitions.append(generateStreamReadOperatorDefinition(type));
+        codeStreamSkipDeclarations.append(generateStreamSkipDeclaration(type));
+        codeStreamSkipDefinitions.append(generateStreamSkipDefinition(type));
+        if (projectionTypes.contains(type.name)) {
+            codeStreamProjectionDeclarations.append(generateStreamProjectionDeclaration(type));
+            codeStreamProjectionDefinitions.append(generateStreamProjectionDefinition(type));
+        }
 
         if (typesUsedForWrite.contains(type.name)) {
             codeStreamWriteDeclarations.append(generateStreamWriteOperatorDeclaration(type));
             codeStreamWriteDefinitions.append(generateStreamWriteOperatorDefinition(type));
+            codeStreamSizeDeclarations.append(generateStreamSizeDeclaration(type));
+            codeStreamSizeDefinitions.append(generateStreamSizeDefinition(type));
         } else {
             codeStreamExtraWriteDeclarations.append(generateStreamWriteFreeOperatorDeclaration(&type));
             codeStreamExtraWriteDefinitions .append(generateStreamWriteFreeOperatorDefinition(type));
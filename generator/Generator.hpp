@@ -161,10 +161,14 @@ public:
     static QStringList generateTLTypeMemberFlags(const TLType &type);
     static QStringList generateTLTypeMemberGetters(const TLType &type);
     static QStringList generateTLTypeMembers(const TLType &type);
+    static QStringList generateTLTypeMemberFields(const TLType &type);
+    static QStringList projectionMembers(const TLType &type);
+    static QString projectionFieldName(const QString &memberName);
 
     static QString streamReadImplementationHead(const QString &argName, const QString &typeName);
     static QString streamReadImplementationEnd(const QString &argName);
     static QString streamReadPerTypeImplementation(const QString &argName, const TLSubType &subType);
+    static QString streamProjectionImplementationEnd(const QString &argName);
 
     static QString streamWriteImplementationHead(const QString &argName, const QString &typeName);
     static QString streamWriteFreeImplementationHead(const QString &argName, const QString &typeName);
@@ -174,6 +178,14 @@ public:
     static QString streamWritePerTypeFreeImplementation(const QString &argName, const TLSubType &subType);
     static QString streamWritePerTypeImplementationBase(const QString &argName, const TLSubType &subType, const QString &streamGetter);
 
+    static QString streamSizeImplementationHead(const QString &argName, const QString &typeName);
+    static QString streamSizeImplementationEnd(const QString &argName);
+    static QString streamSizePerTypeImplementation(const QString &argName, const TLSubType &subType);
+
+    static QStringList streamSkipFlagMembers(const TLSubType &subType);
+    static QString streamSkipPerTypeImplementation(const QString &argName, const TLSubType &subType);
+    static QString streamSkipImplementationEnd(const QString &argName);
+
     static QString generateStreamOperatorDefinition(const TLType &type,
                                                     std::function<QString(const QString &argName, const QString &typeName)> head,
                                                     std::function<QString(const QString &argName, const TLSubType &subType)> generateSubtypeCode,
@@ -188,6 +200,12 @@ public:
     static QString generateStreamWriteOperatorDefinition(const TLType &type);
     static QString generateStreamWriteFreeOperatorDefinition(const TLType &type);
     static QString generateStreamWriteVectorTemplate(const QString &type);
+    static QString generateStreamSizeDeclaration(const TLType &type);
+    static QString generateStreamSizeDefinition(const TLType &type);
+    static QString generateStreamSkipDeclaration(const TLType &type);
+    static QString generateStreamSkipDefinition(const TLType &type);
+    static QString generateStreamProjectionDeclaration(const TLType &type);
+    static QString generateStreamProjectionDefinition(const TLType &type);
     static QString generateStreamWriteFreeVectorTemplate(const QString &type);
 
     static QString generateDebugWriteOperatorDeclaration(const TLType &type);
@@ -218,6 +236,12 @@ public:
     QString codeStreamWriteDeclarations;
     QString codeStreamWriteDefinitions;
     QString codeStreamWriteTemplateInstancing;
+    QString codeStreamSizeDeclarations;
+    QString codeStreamSizeDefinitions;
+    QString codeStreamSkipDeclarations;
+    QString codeStreamSkipDefinitions;
+    QString codeStreamProjectionDeclarations;
+    QString codeStreamProjectionDefinitions;
     QString codeStreamExtraReadDeclarations;
     QString codeStreamExtraWriteDeclarations;
     QString codeStreamExtraWriteDefinitions;
@@ -421,9 +421,15 @@ StatusCode generate(SchemaFormat format, const QString &specFileName)
     replacingHelper(QLatin1String("CTelegramStream.hpp"), 4, QLatin1String("read operators"), generator.codeStreamReadDeclarations);
     replacingHelper(QLatin1String("CTelegramStream.cpp"), 0, QLatin1String("read operators implementation"), generator.codeStreamReadDefinitions);
     replacingHelper(QLatin1String("CTelegramStream.cpp"), 0, QLatin1String("vector read templates instancing"), generator.codeStreamReadTemplateInstancing);
+    replacingHelper(QLatin1String("CTelegramStream.hpp"), 4, QLatin1String("skip functions"), generator.codeStreamSkipDeclarations);
+    replacingHelper(QLatin1String("CTelegramStream.cpp"), 0, QLatin1String("skip functions implementation"), generator.codeStreamSkipDefinitions);
+    replacingHelper(QLatin1String("CTelegramStream.hpp"), 4, QLatin1String("projection functions"), generator.codeStreamProjectionDeclarations);
+    replacingHelper(QLatin1String("CTelegramStream.hpp"), 0, QLatin1String("projection functions implementation"), generator.codeStreamProjectionDefinitions);
     replacingHelper(QLatin1String("CTelegramStream.hpp"), 4, QLatin1String("write operators"), generator.codeStreamWriteDeclarations);
     replacingHelper(QLatin1String("CTelegramStream.cpp"), 0, QLatin1String("write operators implementation"), generator.codeStreamWriteDefinitions);
     replacingHelper(QLatin1String("CTelegramStream.cpp"), 0, QLatin1String("vector write templates instancing"), generator.codeStreamWriteTemplateInstancing);
+    replacingHelper(QLatin1String("CTelegramStream.hpp"), 4, QLatin1String("size functions"), generator.codeStreamSizeDeclarations);
+    replacingHelper(QLatin1String("CTelegramStream.cpp"), 0, QLatin1String("size functions implementation"), generator.codeStreamSizeDefinitions);
 
     replacingHelper(QLatin1String("CTelegramStreamExtraOperators.hpp"), 0, QLatin1String("write operators"), generator.codeStreamExtraWriteDeclarations);
     replacingHelper(QLatin1String("CTelegramStreamExtraOperators.cpp"), 0, QLatin1String("write operators implementation"), generator.codeStreamExtraWriteDefinitions);